@@ -0,0 +1,326 @@
+/**
+ * @file pollreplybench.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Host benchmark of the ArtPollReply, the cost per reply with and without the ready-to-send reply of each page.
+ * - Cached: the node replies from its ready-to-send replies, only the status fields are updated.
+ * - Rebuild: as before the cache, the port fields and the NodeReport of each page are rebuilt for each reply.
+ *   The rebuild is done by the simulated network when the reply is sent, with the code of the previous release.
+ * The cached replies are checked against the rebuilt ones.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#if defined (__x86_64__) || defined (__i386__)
+# include <x86intrin.h>
+#endif
+
+#include "hardware.h"
+#include "ledblink.h"
+
+#include "artnetnode.h"
+#include "lightset.h"
+#include "packets.h"
+#include "artnetnode_internal.h"
+
+#include "simnetwork.h"
+
+static constexpr uint8_t PAGES = 4;
+static constexpr uint32_t POLLS = 100000;
+static constexpr uint32_t RUNS = 5;
+static constexpr uint32_t REPLY_COUNT = 1;	// The reply sent by Start
+
+static uint32_t s_nFailures;
+
+static void Check(bool bCondition, const char *pText) {
+	printf("%s : %s\n", bCondition ? "PASS" : "FAIL", pText);
+
+	if (!bCondition) {
+		s_nFailures++;
+	}
+}
+
+static uint64_t Cycles(void) {
+#if defined (__x86_64__) || defined (__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static uint64_t Nanos(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+class SimLightSet final: public LightSet {
+public:
+	void Start(__attribute__((unused)) uint8_t nPort) override {
+	}
+	void Stop(__attribute__((unused)) uint8_t nPort) override {
+	}
+	void SetData(__attribute__((unused)) uint8_t nPort, __attribute__((unused)) const uint8_t *pData, __attribute__((unused)) uint16_t nLength) override {
+	}
+};
+
+/*
+ * The fields the previous release filled for each reply, from the state of the node
+ */
+static void Rebuild(struct TArtPollReply *pPollReply, uint32_t nPage) {
+	ArtNetNode *pNode = ArtNetNode::Get();
+
+	pPollReply->NetSwitch = pNode->GetNetSwitch(static_cast<uint8_t>(nPage));
+	pPollReply->SubSwitch = pNode->GetSubnetSwitch(static_cast<uint8_t>(nPage));
+
+	pPollReply->BindIndex = static_cast<uint8_t>(nPage + 1);
+
+	const uint32_t nPortIndexStart = nPage * artnet::MAX_PORTS;
+
+	uint32_t NumPortsLo = 0;
+
+	for (uint32_t nPortIndex = nPortIndexStart; nPortIndex < (nPortIndexStart + artnet::MAX_PORTS); nPortIndex++) {
+		const uint32_t nIndex = nPortIndex - nPortIndexStart;
+		uint8_t nAddress;
+
+		pPollReply->PortTypes[nIndex] = 0;
+
+		if (pNode->GetUniverseSwitch(static_cast<uint8_t>(nPortIndex), nAddress, ARTNET_OUTPUT_PORT)) {
+			pPollReply->PortTypes[nIndex] = ARTNET_ENABLE_OUTPUT | ARTNET_PORT_DMX;
+			NumPortsLo++;
+		}
+
+		pPollReply->SwOut[nIndex] = nAddress;
+
+		if (nPortIndex < artnet::MAX_PORTS) {
+			if (pNode->GetUniverseSwitch(static_cast<uint8_t>(nPortIndex), nAddress, ARTNET_INPUT_PORT)) {
+				pPollReply->PortTypes[nIndex] |= ARTNET_ENABLE_INPUT | ARTNET_PORT_DMX;
+				NumPortsLo++;
+			}
+
+			pPollReply->SwIn[nIndex] = nAddress;
+		}
+	}
+
+	pPollReply->NumPortsLo = static_cast<uint8_t>(NumPortsLo);
+
+	uint8_t nLength;
+	snprintf(reinterpret_cast<char*>(pPollReply->NodeReport), ARTNET_REPORT_LENGTH, "%04x [%04d] %s AvV", static_cast<int>(ARTNET_RCPOWEROK), static_cast<int>(REPLY_COUNT), Hardware::Get()->GetSysName(nLength));
+}
+
+/*
+ * Counts the ArtPollReply packets sent by the node, and rebuilds or checks them
+ */
+class ControllerNetwork final: public SimNetwork {
+public:
+	void SetRebuild(bool bRebuild) {
+		m_bRebuild = bRebuild;
+	}
+
+	void SetVerify(bool bVerify) {
+		m_bVerify = bVerify;
+	}
+
+	uint32_t GetReplies(void) const {
+		return m_nReplies;
+	}
+
+	uint32_t GetMismatches(void) const {
+		return m_nMismatches;
+	}
+
+protected:
+	void Sent(const uint8_t *pBuffer, uint16_t nLength, __attribute__((unused)) uint32_t nToIp, __attribute__((unused)) uint16_t nRemotePort) override {
+		const struct TArtPollReply *pPollReply = reinterpret_cast<const struct TArtPollReply*>(pBuffer);
+
+		if ((nLength != sizeof(struct TArtPollReply)) || (pPollReply->OpCode != OP_POLLREPLY)) {
+			return;
+		}
+
+		m_nReplies++;
+
+		const uint32_t nPage = static_cast<uint32_t>(pPollReply->BindIndex - 1);
+
+		if (m_bRebuild) {
+			Rebuild(&m_PollReply, nPage);
+		}
+
+		if (m_bVerify) {
+			memcpy(&m_PollReply, pBuffer, nLength);
+
+			m_PollReply.NetSwitch = 0;
+			m_PollReply.SubSwitch = 0;
+			memset(m_PollReply.PortTypes, 0, sizeof(m_PollReply.PortTypes));
+			memset(m_PollReply.SwIn, 0, sizeof(m_PollReply.SwIn));
+			memset(m_PollReply.SwOut, 0, sizeof(m_PollReply.SwOut));
+			m_PollReply.NumPortsLo = 0;
+			memset(m_PollReply.NodeReport, 0, sizeof(m_PollReply.NodeReport));
+
+			Rebuild(&m_PollReply, nPage);
+
+			if (memcmp(&m_PollReply, pBuffer, nLength) != 0) {
+				m_nMismatches++;
+			}
+		}
+	}
+
+private:
+	struct TArtPollReply m_PollReply;
+	uint32_t m_nReplies{0};
+	uint32_t m_nMismatches{0};
+	bool m_bRebuild{false};
+	bool m_bVerify{false};
+};
+
+static void PushArtPoll(ControllerNetwork &network) {
+	struct TArtPoll artPoll;
+
+	memset(&artPoll, 0, sizeof(struct TArtPoll));
+	memcpy(artPoll.Id, "Art-Net", 8);
+	artPoll.OpCode = OP_POLL;
+	artPoll.ProtVerLo = artnet::PROTOCOL_REVISION;
+
+	network.Push(&artPoll, sizeof(struct TArtPoll), artnet::UDP_PORT);
+}
+
+struct BenchResult {
+	double fNanosPerReply;
+	double fCyclesPerReply;
+};
+
+/*
+ * The time of the ArtPoll handling, divided by the replies sent. Best of RUNS.
+ */
+static BenchResult Bench(ArtNetNode &node, ControllerNetwork &network, bool bRebuild) {
+	BenchResult result = {1e12, 1e12};
+
+	network.SetRebuild(bRebuild);
+
+	for (uint32_t nRun = 0; nRun < RUNS; nRun++) {
+		uint64_t nNanos = 0;
+		uint64_t nCycles = 0;
+
+		const uint32_t nReplies = network.GetReplies();
+
+		for (uint32_t i = 0; i < POLLS; i++) {
+			PushArtPoll(network);
+
+			const uint64_t nStartNanos = Nanos();
+			const uint64_t nStartCycles = Cycles();
+
+			node.Run();
+
+			nCycles += Cycles() - nStartCycles;
+			nNanos += Nanos() - nStartNanos;
+		}
+
+		const double fReplies = static_cast<double>(network.GetReplies() - nReplies);
+
+		if ((static_cast<double>(nNanos) / fReplies) < result.fNanosPerReply) {
+			result.fNanosPerReply = static_cast<double>(nNanos) / fReplies;
+			result.fCyclesPerReply = static_cast<double>(nCycles) / fReplies;
+		}
+	}
+
+	network.SetRebuild(false);
+
+	return result;
+}
+
+static void Print(const char *pText, const BenchResult &result) {
+	printf("%-8s : %7.1f ns per reply", pText, result.fNanosPerReply);
+
+	if (result.fCyclesPerReply != 0) {
+		printf(", %7.0f cycles (TSC) per reply", result.fCyclesPerReply);
+	}
+
+	puts("");
+}
+
+int main(void) {
+	Hardware hw;
+	LedBlink lb;
+	ControllerNetwork network;
+	SimLightSet lightSet;
+
+	ArtNetNode node(3, PAGES);
+
+	node.SetOutput(&lightSet);
+
+	for (uint32_t nPortIndex = 0; nPortIndex < (PAGES * artnet::MAX_PORTS); nPortIndex++) {
+		node.SetUniverseSwitch(static_cast<uint8_t>(nPortIndex), ARTNET_OUTPUT_PORT, static_cast<uint8_t>(nPortIndex & 0x0F));
+	}
+
+	for (uint32_t nPage = 0; nPage < PAGES; nPage++) {
+		node.SetSubnetSwitch(static_cast<uint8_t>(nPage), static_cast<uint8_t>(nPage));
+	}
+
+	node.Start();
+
+	puts("The cached replies");
+
+	network.SetVerify(true);
+
+	const uint32_t nReplies = network.GetReplies();
+	PushArtPoll(network);
+	node.Run();
+
+	Check(network.GetReplies() == (nReplies + PAGES), "one reply per page");
+	Check(network.GetMismatches() == 0, "each reply is equal to a rebuilt reply");
+
+	node.SetUniverseSwitch(1, ARTNET_OUTPUT_PORT, 0x0A);
+	node.SetSubnetSwitch(0x07, 2);
+	PushArtPoll(network);
+	node.Run();
+
+	Check(network.GetMismatches() == 0, "a changed Port-Address is in the next reply");
+
+	node.SetUniverseSwitch(1, ARTNET_OUTPUT_PORT, 1);
+	node.SetSubnetSwitch(2, 2);
+
+	network.SetVerify(false);
+
+	printf("%u pages, %u ArtPoll, best of %u\n", PAGES, POLLS, RUNS);
+
+	const BenchResult cached = Bench(node, network, false);
+	const BenchResult rebuild = Bench(node, network, true);
+
+	Print("Cached", cached);
+	Print("Rebuild", rebuild);
+
+	printf("The cached reply costs %.0f %% of a rebuilt one\n", 100.0 * cached.fNanosPerReply / rebuild.fNanosPerReply);
+
+	node.Stop();
+
+	if (s_nFailures != 0) {
+		printf("%u failures\n", s_nFailures);
+		return 1;
+	}
+
+	puts("All tests passed");
+	return 0;
+}
@@ -0,0 +1,400 @@
+/**
+ * @file rdmqueue.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Host test of the ArtRdm queue of the node, with a simulated RDM line and responder.
+ * - The DMX output is not started while an RDM transaction is active, it is resumed when the transaction has finished.
+ * - A broadcast request has no response, the DMX output is resumed directly.
+ * - A request without a responder times out and the DMX output is resumed.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hardware.h"
+#include "ledblink.h"
+
+#include "artnetnode.h"
+#include "artnetrdm.h"
+#include "artnetrdmqueue.h"
+#include "lightset.h"
+#include "packets.h"
+
+#include "simnetwork.h"
+
+static constexpr uint8_t UNIVERSE = 1;
+static constexpr uint32_t RESPONSE_MILLIS = 3;
+static constexpr uint8_t RESPONDER_UID[6] = {0x7F, 0xF0, 0x00, 0x00, 0x00, 0x01};
+static constexpr uint8_t ABSENT_UID[6] = {0x7F, 0xF0, 0x00, 0x00, 0x00, 0x02};
+static constexpr uint8_t BROADCAST_UID[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+static uint32_t s_nFailures;
+
+static void Check(bool bCondition, const char *pText) {
+	printf("%s : %s\n", bCondition ? "PASS" : "FAIL", pText);
+
+	if (!bCondition) {
+		s_nFailures++;
+	}
+}
+
+/*
+ * The DMX output of port 0, it records a start while the RDM controller owns the line
+ */
+class SimLightSet final: public LightSet {
+public:
+	void Start(uint8_t nPort) override;
+	void Stop(__attribute__((unused)) uint8_t nPort) override {
+		m_bIsRunning = false;
+	}
+	void SetData(__attribute__((unused)) uint8_t nPort, __attribute__((unused)) const uint8_t *pData, __attribute__((unused)) uint16_t nLength) override {
+	}
+
+	bool IsRunning(void) const {
+		return m_bIsRunning;
+	}
+
+	uint32_t m_nStartMillis{0};
+	uint32_t m_nViolations{0};
+
+private:
+	bool m_bIsRunning{false};
+};
+
+/*
+ * One responder on port 0. The line is busy from the request until the response is read,
+ * or for the RDM timeout when there is no response.
+ */
+class SimRdm final: public ArtNetRdm {
+public:
+	void Full(__attribute__((unused)) uint8_t nPort) override {
+	}
+	uint32_t GetUidCount(__attribute__((unused)) uint8_t nPort) override {
+		return 0;
+	}
+	void Copy(__attribute__((unused)) uint8_t nPort, __attribute__((unused)) uint8_t *pTod, __attribute__((unused)) uint32_t nIndex, __attribute__((unused)) uint32_t nCount) override {
+	}
+
+	void StartDiscovery(__attribute__((unused)) uint8_t nPort, __attribute__((unused)) bool bIncremental) override {
+	}
+	bool RunDiscovery(__attribute__((unused)) uint8_t nPort) override {
+		return false;
+	}
+	bool IsDiscoveryRunning(__attribute__((unused)) uint8_t nPort) override {
+		return false;
+	}
+	bool IsDiscoveryWaiting(__attribute__((unused)) uint8_t nPort) override {
+		return false;
+	}
+	bool IsTodChanged(__attribute__((unused)) uint8_t nPort) override {
+		return false;
+	}
+
+	bool StartPoll(__attribute__((unused)) uint8_t nPort) override {
+		return false;
+	}
+	bool RunPoll(__attribute__((unused)) uint8_t nPort) override {
+		return false;
+	}
+	bool IsPollRunning(__attribute__((unused)) uint8_t nPort) override {
+		return false;
+	}
+	uint32_t GetPollCount(__attribute__((unused)) uint8_t nPort) override {
+		return 0;
+	}
+	uint32_t CopyPoll(__attribute__((unused)) uint8_t nPort, __attribute__((unused)) struct TArtNetRdmPollEntry *pEntries, __attribute__((unused)) uint32_t nIndex, __attribute__((unused)) uint32_t nCount) override {
+		return 0;
+	}
+
+	const uint8_t *Handler(__attribute__((unused)) uint8_t nPort, __attribute__((unused)) const uint8_t *pRdmData) override {
+		return 0;
+	}
+
+	void SendRequest(uint8_t nPort, const uint8_t *pRdmData) override {
+		if (m_pLightSet->IsRunning()) {
+			m_nViolations++;	// DMX was not stopped
+		}
+
+		m_nRequests++;
+		m_nSendMillis = Hardware::Get()->Millis();
+
+		const uint8_t *pDestination = &pRdmData[2];
+
+		if (memcmp(&pDestination[2], &BROADCAST_UID[2], 4) == 0) {
+			m_tLine = Line::IDLE;
+		} else if (memcmp(pDestination, RESPONDER_UID, sizeof(RESPONDER_UID)) == 0) {
+			m_tLine = Line::RESPONSE;
+			MakeResponse(pRdmData);
+		} else {
+			m_tLine = Line::NO_RESPONSE;
+		}
+
+		m_nPort = nPort;
+	}
+
+	const uint8_t *ReceiveResponse(__attribute__((unused)) uint8_t nPort) override {
+		if ((m_tLine == Line::RESPONSE) && ((Hardware::Get()->Millis() - m_nSendMillis) >= RESPONSE_MILLIS)) {
+			m_tLine = Line::IDLE;
+			m_nResponses++;
+			return m_aResponse;
+		}
+
+		return 0;
+	}
+
+	bool IsLineBusy(uint8_t nPort) const {
+		if (nPort != m_nPort) {
+			return false;
+		}
+
+		if (m_tLine == Line::RESPONSE) {
+			return true;
+		}
+
+		return (m_tLine == Line::NO_RESPONSE) && ((Hardware::Get()->Millis() - m_nSendMillis) < ArtNetRdmQueueConst::TIMEOUT_MILLIS);
+	}
+
+	void SetLightSet(SimLightSet *pLightSet) {
+		m_pLightSet = pLightSet;
+	}
+
+	uint32_t m_nRequests{0};
+	uint32_t m_nResponses{0};
+	uint32_t m_nSendMillis{0};
+	uint32_t m_nViolations{0};
+
+private:
+	void MakeResponse(const uint8_t *pRdmData) {
+		m_aResponse[0] = 0xCC;					// START Code
+		m_aResponse[1] = 0x01;					// Sub START Code
+		m_aResponse[2] = 24;					// Message length, no parameter data
+		memcpy(&m_aResponse[3], &pRdmData[8], 6);	// Destination is the source of the request
+		memcpy(&m_aResponse[9], RESPONDER_UID, 6);
+		m_aResponse[15] = pRdmData[14];			// Transaction number
+		m_aResponse[16] = 0x00;					// RESPONSE_TYPE_ACK
+		m_aResponse[17] = 0;					// Message count
+		m_aResponse[18] = pRdmData[17];			// Sub-device
+		m_aResponse[19] = pRdmData[18];
+		m_aResponse[20] = static_cast<uint8_t>(pRdmData[19] + 1);	// Command class response
+		m_aResponse[21] = pRdmData[20];			// Parameter id
+		m_aResponse[22] = pRdmData[21];
+		m_aResponse[23] = 0;					// Parameter data length
+
+		uint16_t nChecksum = 0;
+
+		for (uint32_t i = 0; i < 24; i++) {
+			nChecksum = static_cast<uint16_t>(nChecksum + m_aResponse[i]);
+		}
+
+		m_aResponse[24] = static_cast<uint8_t>(nChecksum >> 8);
+		m_aResponse[25] = static_cast<uint8_t>(nChecksum);
+	}
+
+	enum class Line {
+		IDLE, RESPONSE, NO_RESPONSE
+	};
+
+	SimLightSet *m_pLightSet{0};
+	Line m_tLine{Line::IDLE};
+	uint8_t m_nPort{0};
+	uint8_t m_aResponse[26];
+};
+
+static SimRdm s_Rdm;
+
+void SimLightSet::Start(uint8_t nPort) {
+	if (s_Rdm.IsLineBusy(nPort)) {
+		m_nViolations++;
+	}
+
+	m_bIsRunning = true;
+	m_nStartMillis = Hardware::Get()->Millis();
+}
+
+/*
+ * Counts the ArtRdm and ArtTodData packets sent to the controller
+ */
+class ControllerNetwork final: public SimNetwork {
+public:
+	uint32_t GetRdmSent(void) const {
+		return m_nRdmSent;
+	}
+
+	uint32_t GetTodDataSent(void) const {
+		return m_nTodDataSent;
+	}
+
+protected:
+	void Sent(const uint8_t *pBuffer, uint16_t nLength, __attribute__((unused)) uint32_t nToIp, __attribute__((unused)) uint16_t nRemotePort) override {
+		if (nLength < 10) {
+			return;
+		}
+
+		const uint16_t nOpCode = static_cast<uint16_t>(pBuffer[8] | (pBuffer[9] << 8));
+
+		if (nOpCode == OP_RDM) {
+			m_nRdmSent++;
+		} else if (nOpCode == OP_TODDATA) {
+			m_nTodDataSent++;
+		}
+	}
+
+private:
+	uint32_t m_nRdmSent{0};
+	uint32_t m_nTodDataSent{0};
+};
+
+static void PushArtDmx(ControllerNetwork &network) {
+	static uint8_t nSequence;
+	struct TArtDmx artDmx;
+
+	memset(&artDmx, 0, sizeof(struct TArtDmx));
+	memcpy(artDmx.Id, "Art-Net", 8);
+	artDmx.OpCode = OP_DMX;
+	artDmx.ProtVerLo = artnet::PROTOCOL_REVISION;
+	artDmx.Sequence = ++nSequence;
+	artDmx.PortAddress = UNIVERSE;
+	artDmx.LengthHi = 0x02;
+	artDmx.Length = 0x00;
+	artDmx.Data[0] = nSequence;
+
+	network.Push(&artDmx, sizeof(struct TArtDmx), artnet::UDP_PORT);
+}
+
+static void PushArtRdm(ControllerNetwork &network, const uint8_t *pDestination, uint8_t nCommandClass) {
+	static uint8_t nTransaction;
+	struct TArtRdm artRdm;
+
+	memset(&artRdm, 0, sizeof(struct TArtRdm));
+	memcpy(artRdm.Id, "Art-Net", 8);
+	artRdm.OpCode = OP_RDM;
+	artRdm.ProtVerLo = artnet::PROTOCOL_REVISION;
+	artRdm.RdmVer = 0x01;
+	artRdm.Net = 0;
+	artRdm.Address = UNIVERSE;
+
+	uint8_t *p = artRdm.RdmPacket;
+	p[0] = 0x01;							// Sub START Code
+	p[1] = 24;								// Message length
+	memcpy(&p[2], pDestination, 6);
+	const uint8_t aSource[6] = {0x7F, 0xF0, 0x00, 0x00, 0x00, 0xFF};
+	memcpy(&p[8], aSource, 6);
+	p[14] = ++nTransaction;
+	p[15] = 1;								// Port id
+	p[19] = nCommandClass;
+	p[20] = 0x00;							// DEVICE_INFO, IDENTIFY_DEVICE for SET
+	p[21] = (nCommandClass == 0x20) ? 0x60 : 0x00;
+	p[23] = 0;								// Parameter data length
+
+	network.Push(&artRdm, sizeof(struct TArtRdm), artnet::UDP_PORT);
+}
+
+template<typename Predicate>
+static bool RunUntil(ArtNetNode &node, Predicate predicate, uint32_t nTimeoutMillis) {
+	const uint32_t nStart = Hardware::Get()->Millis();
+
+	while (!predicate()) {
+		if ((Hardware::Get()->Millis() - nStart) > nTimeoutMillis) {
+			return false;
+		}
+		node.Run();
+	}
+
+	return true;
+}
+
+int main(void) {
+	Hardware hw;
+	LedBlink lb;
+	ControllerNetwork network;
+	SimLightSet lightSet;
+
+	s_Rdm.SetLightSet(&lightSet);
+
+	ArtNetNode node;
+
+	node.SetOutput(&lightSet);
+	node.SetUniverseSwitch(0, ARTNET_OUTPUT_PORT, UNIVERSE);
+	node.SetRdmHandler(&s_Rdm);
+	node.SetRdmDiscoveryInterval(0);
+	node.Start();
+
+	puts("DMX received while a transaction is active");
+
+	PushArtRdm(network, RESPONDER_UID, 0x20);	// GET_COMMAND
+	Check(RunUntil(node, [] { return s_Rdm.m_nRequests == 1; }, 100), "the request is sent");
+
+	PushArtDmx(network);
+	node.Run();
+	Check(!lightSet.IsRunning(), "the DMX output is not started during the transaction");
+
+	Check(RunUntil(node, [&] { return lightSet.IsRunning(); }, 100), "the DMX output is started when the response is received");
+	Check((s_Rdm.m_nResponses == 1) && (network.GetRdmSent() == 1), "the response is sent to the controller");
+	Check((lightSet.m_nStartMillis - s_Rdm.m_nSendMillis) >= RESPONSE_MILLIS, "the DMX output is started after the response");
+
+	puts("Broadcast requests");
+
+	uint32_t nBusyMillisMax = 0;
+
+	for (uint32_t i = 0; i < ArtNetRdmQueueConst::DEPTH; i++) {
+		const uint32_t nRequests = s_Rdm.m_nRequests;
+
+		PushArtRdm(network, BROADCAST_UID, 0x30);	// SET_COMMAND
+		Check(RunUntil(node, [&] { return s_Rdm.m_nRequests == (nRequests + 1); }, 100), "the broadcast request is sent");
+		Check(RunUntil(node, [&] { return lightSet.IsRunning(); }, 100), "the DMX output is resumed");
+
+		const uint32_t nBusyMillis = lightSet.m_nStartMillis - s_Rdm.m_nSendMillis;
+
+		if (nBusyMillis > nBusyMillisMax) {
+			nBusyMillisMax = nBusyMillis;
+		}
+	}
+
+	printf("Broadcast: DMX stopped for %u ms max\n", nBusyMillisMax);
+	Check(nBusyMillisMax < ArtNetRdmQueueConst::TIMEOUT_MILLIS, "a broadcast request does not wait for the timeout");
+	Check(network.GetRdmSent() == 1, "no response is sent for a broadcast request");
+
+	puts("Request without a responder");
+
+	PushArtRdm(network, ABSENT_UID, 0x20);
+	Check(RunUntil(node, [&] { return !lightSet.IsRunning(); }, 100), "the DMX output is stopped for the request");
+	PushArtDmx(network);
+	node.Run();
+	Check(RunUntil(node, [&] { return lightSet.IsRunning(); }, 100), "the DMX output is resumed after the timeout");
+	Check((lightSet.m_nStartMillis - s_Rdm.m_nSendMillis) >= ArtNetRdmQueueConst::TIMEOUT_MILLIS, "the DMX output is resumed at the timeout");
+
+	Check((lightSet.m_nViolations == 0) && (s_Rdm.m_nViolations == 0), "DMX and RDM never share the line");
+
+	printf("%u requests, %u responses\n", s_Rdm.m_nRequests, s_Rdm.m_nResponses);
+
+	if (s_nFailures != 0) {
+		printf("%u failures\n", s_nFailures);
+		return 1;
+	}
+
+	puts("All tests passed");
+	return 0;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file syncjitter.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Host test of the ArtSync presentation scheduler, with simulated ArtSync jitter and loss.
+ * The main loop is polled every 50 us, the ArtSync arrives at 44 Hz with a uniform jitter.
+ * - The period estimate converges, and the presentation jitter is less than the ArtSync jitter.
+ * - A missing ArtSync is presented on the extrapolated cadence, up to EXTRAPOLATE_MAX in a row.
+ * - A late ArtSync of an extrapolated frame is absorbed, the cadence is kept. It arrives after the
+ *   extrapolated presentation, and less than half a period after its expected time.
+ * The time starts just before the 32-bit wrap of the microseconds.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "artnetsyncscheduler.h"
+
+static constexpr uint32_t PERIOD_MICROS = 22727;	// 44 Hz
+static constexpr uint32_t LATENCY_MICROS = ArtNetSyncSchedulerConst::LATENCY_MICROS;
+static constexpr uint32_t POLL_MICROS = 50;
+static constexpr uint32_t START_MICROS = 0xFFFF0000;
+static constexpr uint32_t FRAMES = 2000;
+static constexpr uint32_t WARM_UP_FRAMES = 100;
+
+static uint32_t s_nFailures;
+
+static void Check(bool bCondition, const char *pText) {
+	printf("%s : %s\n", bCondition ? "PASS" : "FAIL", pText);
+
+	if (!bCondition) {
+		s_nFailures++;
+	}
+}
+
+/*
+ * Deterministic, the results do not depend on the host
+ */
+static uint32_t s_nRandom = 1;
+
+static uint32_t Random(uint32_t nRange) {
+	s_nRandom = (s_nRandom * 1103515245U) + 12345U;
+	return (s_nRandom >> 8) % nRange;
+}
+
+struct Network {
+	uint32_t nJitterMicros;		///< The ArtSync arrives up to this late
+	uint32_t nLossPercent;
+	uint32_t nLossFrom;			///< Frames [nLossFrom, nLossTo) are lost, in addition to the random loss
+	uint32_t nLossTo;
+	uint32_t nLateFrame;		///< This ArtSync is delayed by nLateMicros, 0 is none
+	uint32_t nLateMicros;
+};
+
+struct Result {
+	uint32_t nSyncs;
+	uint32_t nMissing;				///< Frames after the warm up without a presentation
+	uint32_t nDouble;				///< Frames after the warm up with more than one presentation
+	uint32_t nLast;					///< The last frame presented
+	int32_t nSyncJitterMax;			///< Interval between consecutive ArtSync against the period
+	int32_t nOutputJitterMax;		///< Interval between consecutive presentations against the period
+	uint32_t nPeriodMicros;
+};
+
+/*
+ * The ideal time of ArtSync k is START_MICROS + k * PERIOD_MICROS
+ */
+static Result Simulate(const Network& network) {
+	ArtNetSyncScheduler scheduler(LATENCY_MICROS);
+	Result result = {};
+
+	static uint8_t aPresented[FRAMES + 16];
+
+	for (auto& nPresented : aPresented) {
+		nPresented = 0;
+	}
+
+	uint32_t nFrame = 0;
+	uint32_t nArrivalMicros = START_MICROS;
+	bool bIsLost = false;
+	uint32_t nLastSyncFrame = 0;
+	uint32_t nLastSyncMicros = 0;
+	uint32_t nLastPresentedFrame = 0;
+	uint32_t nLastPresentedMicros = 0;
+
+	for (uint32_t nElapsed = 0; nElapsed < (FRAMES * PERIOD_MICROS); nElapsed += POLL_MICROS) {
+		const uint32_t nNowMicros = START_MICROS + nElapsed;
+
+		if (static_cast<int32_t>(nNowMicros - nArrivalMicros) >= 0) {
+			if (!bIsLost) {
+				scheduler.Sync(nNowMicros);
+				result.nSyncs++;
+
+				const int32_t nJitter = static_cast<int32_t>((nNowMicros - nLastSyncMicros) - PERIOD_MICROS);
+
+				if ((nFrame >= WARM_UP_FRAMES) && (nFrame == (nLastSyncFrame + 1)) && (abs(nJitter) > result.nSyncJitterMax)) {
+					result.nSyncJitterMax = abs(nJitter);
+				}
+
+				nLastSyncFrame = nFrame;
+				nLastSyncMicros = nNowMicros;
+			}
+
+			nFrame++;
+			nArrivalMicros = START_MICROS + (nFrame * PERIOD_MICROS);
+
+			if (network.nJitterMicros != 0) {
+				nArrivalMicros += Random(network.nJitterMicros);
+			}
+
+			if ((network.nLateFrame != 0) && (nFrame == network.nLateFrame)) {
+				nArrivalMicros += network.nLateMicros;
+			}
+
+			bIsLost = (Random(100) < network.nLossPercent) || ((nFrame >= network.nLossFrom) && (nFrame < network.nLossTo));
+		}
+
+		if (scheduler.IsDue(nNowMicros)) {
+			scheduler.Presented(nNowMicros, false);
+
+			// The frame of the nearest ideal presentation
+			const uint32_t nSince = nNowMicros - (START_MICROS + LATENCY_MICROS);
+			const uint32_t nPresentedFrame = (nSince + (PERIOD_MICROS / 2)) / PERIOD_MICROS;
+
+			if (nPresentedFrame < (sizeof(aPresented) / sizeof(aPresented[0]))) {
+				aPresented[nPresentedFrame]++;
+			}
+
+			result.nLast = nPresentedFrame;
+
+			const int32_t nJitter = static_cast<int32_t>((nNowMicros - nLastPresentedMicros) - PERIOD_MICROS);
+
+			if ((nPresentedFrame >= WARM_UP_FRAMES) && (nPresentedFrame == (nLastPresentedFrame + 1)) && (abs(nJitter) > result.nOutputJitterMax)) {
+				result.nOutputJitterMax = abs(nJitter);
+			}
+
+			// The interval is from the first presentation of a frame
+			if (nPresentedFrame != nLastPresentedFrame) {
+				nLastPresentedFrame = nPresentedFrame;
+				nLastPresentedMicros = nNowMicros;
+			}
+		}
+	}
+
+	for (uint32_t i = WARM_UP_FRAMES; i < (FRAMES - 1); i++) {
+		if (aPresented[i] == 0) {
+			result.nMissing++;
+		} else if (aPresented[i] > 1) {
+			result.nDouble++;
+		}
+	}
+
+	result.nPeriodMicros = scheduler.GetPeriodMicros();
+
+	scheduler.Print();
+
+	return result;
+}
+
+static void Print(const Result& result) {
+	printf("%u ArtSync, period %u us, jitter max: ArtSync %d us, output %d us, %u missing, %u double\n",
+			result.nSyncs, result.nPeriodMicros, result.nSyncJitterMax, result.nOutputJitterMax, result.nMissing, result.nDouble);
+}
+
+int main(void) {
+	puts("Jitter");
+	{
+		const Result result = Simulate({2000, 0, 0, 0, 0, 0});
+		Print(result);
+
+		Check(abs(static_cast<int32_t>(result.nPeriodMicros - PERIOD_MICROS)) < 100, "the period estimate is within 100 us");
+		Check((result.nMissing == 0) && (result.nDouble == 0), "each frame is presented once");
+		Check((result.nOutputJitterMax * 2) < result.nSyncJitterMax, "the output jitter is less than half the ArtSync jitter");
+	}
+
+	puts("Loss");
+	{
+		const Result result = Simulate({2000, 10, 0, 0, 0, 0});
+		Print(result);
+
+		Check(result.nSyncs < (FRAMES * 95 / 100), "ArtSync is lost");
+		Check(abs(static_cast<int32_t>(result.nPeriodMicros - PERIOD_MICROS)) < 100, "the period estimate is within 100 us");
+		Check((result.nMissing == 0) && (result.nDouble == 0), "each frame is presented once, a lost ArtSync is extrapolated");
+	}
+
+	puts("Loss of more than EXTRAPOLATE_MAX in a row");
+	{
+		const uint32_t nLossFrom = FRAMES - ArtNetSyncSchedulerConst::EXTRAPOLATE_MAX - 20;
+		const Result result = Simulate({0, 0, nLossFrom, FRAMES, 0, 0});
+		Print(result);
+
+		Check(result.nLast == (nLossFrom - 1 + ArtNetSyncSchedulerConst::EXTRAPOLATE_MAX), "EXTRAPOLATE_MAX frames are extrapolated, then the output stops");
+	}
+
+	puts("Late ArtSync");
+	{
+		const Result result = Simulate({500, 0, 0, 0, 1000, PERIOD_MICROS / 3});
+		Print(result);
+
+		Check(result.nMissing == 0, "the late frame is presented on the extrapolated cadence");
+		Check(result.nDouble == 1, "the data of the late ArtSync is presented once more");
+		Check(result.nOutputJitterMax < 1000, "the cadence is kept after the late ArtSync");
+		Check(abs(static_cast<int32_t>(result.nPeriodMicros - PERIOD_MICROS)) < 100, "the period estimate is not disturbed");
+	}
+
+	if (s_nFailures != 0) {
+		printf("%u failures\n", s_nFailures);
+		return 1;
+	}
+
+	puts("All tests passed");
+	return 0;
+}
@@ -59,6 +59,7 @@ public:
 	void Print(void);
 
 	void HandleDmxOut(uint16_t nUniverse, const uint8_t *pDmxData, uint16_t nLength, uint8_t nPortIndex = 0);
+	void HandleDmxOutInPlace(uint16_t nUniverse, uint8_t *pDmxData, uint16_t nLength, uint8_t nPortIndex = 0);
 	void HandleSync(void);
 	void HandleBlackout(void);
 
@@ -105,6 +106,7 @@ private:
 	void HandlePoll(void);
 	void HandlePollReply(void);
 	void HandleTrigger(void);
+	void SendDmx(struct TArtDmx *pArtDmx, uint16_t nUniverse, uint16_t nLength, uint8_t nPortIndex, uint32_t nSize);
 	void ActiveUniversesAdd(uint16_t nUniverse);
 	void ActiveUniversesClear(void);
 
@@ -31,6 +31,11 @@
 
 #include <stdint.h>
 
+struct ArtNetDmxConst {
+	static constexpr uint32_t KEEP_ALIVE_MILLIS = 1000;	///< Unchanged data is re-transmitted between 800 ms and 1000 ms
+	static constexpr uint32_t MIN_GAP_MILLIS = 23;		///< The DMX512 refresh rate of 44 Hz
+};
+
 class ArtNetDmx {
 public:
 	virtual ~ArtNetDmx(void) {}
@@ -41,6 +41,8 @@
 #include "artnettimecode.h"
 #include "artnettimesync.h"
 #include "artnetrdm.h"
+#include "artnetrdmqueue.h"
+#include "artnetsyncscheduler.h"
 #include "artnetipprog.h"
 #include "artnetstore.h"
 #include "artnetdisplay.h"
@@ -149,6 +151,15 @@ struct TInputPort {
 	TGenericPort port;
 	uint8_t nSequence;
 	uint32_t nDestinationIp;
+	uint8_t data[artnet::DMX_LENGTH];	///< The latest data received
+	uint16_t nLength;					///< Even, in the range 2 – 512
+	uint32_t nMillis;					///< The latest time an ArtDmx was sent
+	bool bIsDataPending;				///< Changed data waiting for the minimum gap
+	uint32_t nFramesReceived;
+	uint32_t nFramesUnchanged;
+	uint32_t nFramesCoalesced;			///< Overwritten while pending
+	uint32_t nPacketsSent;
+	uint32_t nPacketsKeepAlive;
 };
 
 class ArtNetNode {
@@ -186,6 +197,8 @@ public:
 		return m_State.nActiveOutputPorts;
 	}
 
+	void SetSyncScheduler(bool bEnable, uint32_t nLatencyMicros = ArtNetSyncSchedulerConst::LATENCY_MICROS);
+
 	void SetDirectUpdate(bool bDirectUpdate) {
 		m_bDirectUpdate = bDirectUpdate;
 	}
@@ -247,6 +260,16 @@ public:
 		m_pArtNetTimeSync = pArtNetTimeSync;
 	}
 	void SetRdmHandler(ArtNetRdm *, bool isResponder = false);
+	void SetRdmDiscoveryInterval(uint32_t nSeconds) {
+		m_nRdmDiscoveryIntervalMillis = nSeconds * 1000;
+	}
+	void SetRdmPoll(bool bEnable, uint32_t nDmxFpsMin = ArtNetRdmConst::POLL_DMX_FPS_MIN) {
+		m_bRdmPoll = bEnable;
+		m_nRdmPollDmxFpsMin = nDmxFpsMin;
+	}
+	ArtNetRdm *GetRdmHandler(void) {
+		return m_pArtNetRdm;
+	}
 	void SetIpProgHandler(ArtNetIpProg *);
 	void SetArtNetStore(ArtNetStore *pArtNetStore) {
 		m_pArtNetStore = pArtNetStore;
@@ -270,6 +293,12 @@ public:
 	}
 
 	void SetDestinationIp(uint8_t nPortIndex, uint32_t nDestinationIp);
+	void SetDmxInKeepAlive(uint32_t nMillis) {
+		m_nDmxInKeepAliveMillis = nMillis;
+	}
+	void SetDmxInMinGap(uint32_t nMillis) {
+		m_nDmxInMinGapMillis = nMillis;
+	}
 	uint32_t GetDestinationIp(uint8_t nPortIndex) {
 		if (nPortIndex < ARTNET_NODE_MAX_PORTS_INPUT) {
 			return m_InputPorts[nPortIndex].nDestinationIp;
@@ -284,6 +313,8 @@ public:
 
 private:
 	void FillPollReply(void);
+	void UpdatePollReplyPorts(void);
+	void UpdatePollReplyNodeReport(void);
 #if defined ( ENABLE_SENDDIAG )
 	void FillDiagData(void);
 #endif
@@ -293,14 +324,26 @@ private:
 	void HandlePoll(void);
 	void HandleDmx(void);
 	void HandleSync(void);
+	void HandleSyncScheduler(void);
+	void SyncOutput(void);
 	void HandleAddress(void);
 	void HandleTimeCode(void);
 	void HandleTimeSync(void);
 	void HandleTodRequest(void);
 	void HandleTodControl(void);
 	void HandleRdm(void);
+	void HandleRdmQueue(void);
+	void HandleRdmDiscovery(void);
+	void StartRdmDiscovery(uint32_t nPort, bool bIncremental);
+	void HandleRdmPoll(void);
+	bool IsRdmLightSetRunning(uint32_t nPort);
+	bool IsRdmBusy(uint32_t nPort);
+	bool IsRdmDiscoverySlot(uint32_t nPort);
+	void StartLightSet(uint32_t nPort);
+	void SendRdmResponse(struct TArtRdm *pArtRdm, const uint8_t *pResponse, uint32_t nIPAddressTo);
 	void HandleIpProg(void);
 	void HandleDmxIn(void);
+	void SendDmxIn(uint32_t nPortIndex, uint32_t nMillis);
 	void HandleTrigger(void);
 
 	uint16_t MakePortAddress(uint16_t, uint8_t nPage = 0);
@@ -334,13 +377,18 @@ private:
 	struct TArtNetNodeState m_State;
 
 	struct TArtNetPacket m_ArtNetPacket;
-	struct TArtPollReply m_PollReply;
 #if defined ( ENABLE_SENDDIAG )
 	struct TArtDiagData m_DiagData;
 #endif
 	struct TArtTimeCode *m_pTimeCodeData;
 	struct TArtTodData *m_pTodData;
+	ArtNetRdmQueue *m_pArtNetRdmQueue;
+	ArtNetSyncScheduler *m_pArtNetSyncScheduler;
 	struct TArtIpProgReply *m_pIpProgReply;
+	struct TArtPollReply *m_pPollReply;	///< Ready to send, one per page
+	bool m_bPollReplyPortsChanged;
+	TArtNetNodeReportCode m_tPollReplyReportCode;
+	uint32_t m_nPollReplyCount;
 
 	struct TOutputPort m_OutputPorts[ARTNET_NODE_MAX_PORTS_OUTPUT];
 	struct TInputPort m_InputPorts[ARTNET_NODE_MAX_PORTS_INPUT];
@@ -355,6 +403,20 @@ private:
 	bool m_IsLightSetRunning[ARTNET_NODE_MAX_PORTS_OUTPUT];
 	bool m_IsRdmResponder;
 
+	uint32_t m_nRdmDiscoveryIntervalMillis;
+	uint32_t m_nRdmDiscoveryMillis[ARTNET_NODE_MAX_PORTS_OUTPUT];
+	uint32_t m_nRdmDiscoverySlotMillis[ARTNET_NODE_MAX_PORTS_OUTPUT];
+	bool m_bRdmDiscoveryGap[ARTNET_NODE_MAX_PORTS_OUTPUT];
+
+	bool m_bRdmPoll;
+	uint32_t m_nRdmPollDmxFpsMin;
+	uint32_t m_nRdmPollStartMillis[ARTNET_NODE_MAX_PORTS_OUTPUT];
+	uint32_t m_nRdmPollEndMillis[ARTNET_NODE_MAX_PORTS_OUTPUT];
+	uint32_t m_nRdmPollGapMillis[ARTNET_NODE_MAX_PORTS_OUTPUT];
+
+	uint32_t m_nDmxInKeepAliveMillis;
+	uint32_t m_nDmxInMinGapMillis;
+
 	alignas(uint32_t) char m_aSysName[16];
 	alignas(uint32_t) char m_aDefaultNodeLongName[artnet::LONG_NAME_LENGTH];
 
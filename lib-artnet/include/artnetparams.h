@@ -59,7 +59,13 @@ struct TArtNetParams {
 	uint8_t nProtocolPort[artnet::MAX_PORTS];				///< 4	117
 	bool bEnableNoChangeUpdate;								///< 1	118
 	uint8_t nDirection;										///< 1	119
-	uint32_t nDestinationIpPort[artnet::MAX_PORTS];			///< 16	135
+	/*
+	 * nSyncLatency is in the alignment padding before nDestinationIpPort, the offsets of the other fields are unchanged.
+	 * A store written by a previous release has undefined bytes here. The value is only used when SYNC_LATENCY
+	 * (bit 29) is set in nSetList, which a previous release never sets, and each Update writes the whole struct.
+	 */
+	uint16_t nSyncLatency;									///< 2	121	In the padding when not packed
+	uint32_t nDestinationIpPort[artnet::MAX_PORTS];			///< 16	137
 #if defined (__linux__)
 }__attribute__((packed));
 #else
@@ -103,6 +109,7 @@ struct ArtnetParamsMask {
 	static constexpr auto PROTOCOL_D = (1U << 26);
 	static constexpr auto ENABLE_NO_CHANGE_OUTPUT = (1U << 27);
 	static constexpr auto DIRECTION = (1U << 28);
+	static constexpr auto SYNC_LATENCY = (1U << 29);
 };
 
 class ArtNetParamsStore {
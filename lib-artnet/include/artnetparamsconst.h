@@ -50,6 +50,7 @@ public:
 	static const char PROTOCOL[];
 	static const char PROTOCOL_PORT[artnet::MAX_PORTS][16];
 	static const char DIRECTION[];
+	static const char SYNC_LATENCY[];
 	static const char DESTINATION_IP_PORT[artnet::MAX_PORTS][24];
 };
 
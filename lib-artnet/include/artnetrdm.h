@@ -31,15 +31,63 @@
 
 #include <stdint.h>
 
+struct ArtNetRdmConst {
+	static constexpr uint32_t DISCOVERY_INTERVAL_SECONDS = 60;	///< Incremental discovery, 0 is disabled
+	static constexpr uint32_t DISCOVERY_SLOT_MILLIS = 10;		///< Discovery steps between two DMX frames
+	static constexpr uint32_t POLL_SENSORS = 4;
+	static constexpr uint32_t POLL_DMX_FPS_MIN = 30;				///< Default DMX refresh rate floor while polling
+	static constexpr uint32_t POLL_AGE_UNKNOWN = 0xFFFFFFFF;
+};
+
+/**
+ * The cached sensor and status values of a polled responder, ages are in milliseconds
+ */
+struct TArtNetRdmPollEntry {
+	uint8_t aUid[6];
+	uint8_t nMessageCount;
+	uint8_t nSensorCount;
+	uint32_t nSensorAge;
+	int16_t aSensorValue[ArtNetRdmConst::POLL_SENSORS];
+	uint32_t nStatusAge;
+	uint8_t nStatusMessages;
+	uint8_t aStatusMessage[9];	///< The last STATUS_MESSAGES entry
+} __attribute__((packed));
+
 class ArtNetRdm {
 public:
 	virtual ~ArtNetRdm(void) {}
 
 	virtual void Full(uint8_t nPort)=0;
-	virtual uint8_t GetUidCount(uint8_t nPort)=0;
-	virtual void Copy(uint8_t nPort, uint8_t *)=0;
+	virtual uint32_t GetUidCount(uint8_t nPort)=0;
+	virtual void Copy(uint8_t nPort, uint8_t *pTod, uint32_t nIndex, uint32_t nCount)=0;
+
+	/*
+	 * Non-blocking discovery, RunDiscovery does one step and returns false when the discovery has finished.
+	 * IsDiscoveryWaiting is true while a discovery request is waiting for its response
+	 */
+	virtual void StartDiscovery(uint8_t nPort, bool bIncremental)=0;
+	virtual bool RunDiscovery(uint8_t nPort)=0;
+	virtual bool IsDiscoveryRunning(uint8_t nPort)=0;
+	virtual bool IsDiscoveryWaiting(uint8_t nPort)=0;
+	virtual bool IsTodChanged(uint8_t nPort)=0;
+
+	/*
+	 * Background polling of the discovered responders, StartPoll sends one request and returns false when there is nothing to poll.
+	 * RunPoll returns false when the transaction has finished
+	 */
+	virtual bool StartPoll(uint8_t nPort)=0;
+	virtual bool RunPoll(uint8_t nPort)=0;
+	virtual bool IsPollRunning(uint8_t nPort)=0;
+	virtual uint32_t GetPollCount(uint8_t nPort)=0;
+	virtual uint32_t CopyPoll(uint8_t nPort, struct TArtNetRdmPollEntry *pEntries, uint32_t nIndex, uint32_t nCount)=0;
 
 	virtual const uint8_t *Handler(uint8_t nPort, const uint8_t *)=0;
+
+	/*
+	 * Non-blocking transaction, ReceiveResponse returns 0 until the response is received
+	 */
+	virtual void SendRequest(uint8_t nPort, const uint8_t *)=0;
+	virtual const uint8_t *ReceiveResponse(uint8_t nPort)=0;
 };
 
 #endif /* ARTNETRDM_H_ */
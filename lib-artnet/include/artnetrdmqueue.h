@@ -0,0 +1,124 @@
+/**
+ * @file artnetrdmqueue.h
+ *
+ */
+/**
+ * Art-Net Designed by and Copyright Artistic Licence Holdings Ltd.
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef ARTNETRDMQUEUE_H_
+#define ARTNETRDMQUEUE_H_
+
+#include <stdint.h>
+
+#include "artnet.h"
+#include "packets.h"
+
+struct ArtNetRdmQueueConst {
+	static constexpr uint32_t DEPTH = 4;			///< Requests per port, including the active one
+	static constexpr uint32_t TIMEOUT_MILLIS = 20;
+	static constexpr uint32_t DMX_FRAME_MILLIS = 25;	///< DMX output resumes for at least one frame between transactions
+};
+
+struct TArtNetRdmRequest {
+	struct TArtRdm ArtRdm;
+	uint32_t nIPAddressFrom;
+	uint32_t nQueuedMillis;
+};
+
+/**
+ * Per port FIFO of ArtRdm requests for the RDM controller.
+ * The head of the queue is the active transaction, it is started and completed from the main loop.
+ */
+class ArtNetRdmQueue {
+public:
+	ArtNetRdmQueue();
+
+	bool Push(uint32_t nPort, const struct TArtRdm *pArtRdm, uint32_t nIPAddressFrom, uint32_t nMillis);
+
+	bool IsEmpty(uint32_t nPort) const {
+		return m_aPort[nPort].nCount == 0;
+	}
+
+	bool IsActive(uint32_t nPort) const {
+		return m_aPort[nPort].bIsActive;
+	}
+
+	struct TArtNetRdmRequest *Front(uint32_t nPort) {
+		return &m_aPort[nPort].aRequest[m_aPort[nPort].nHead];
+	}
+
+	/**
+	 * A request to the broadcast device id (all manufacturers or one manufacturer) has no response
+	 */
+	static bool IsResponseExpected(const struct TArtRdm *pArtRdm) {
+		// RdmPacket: sub start code, message length, destination UID (manufacturer id, device id)
+		const uint8_t *pDeviceId = &pArtRdm->RdmPacket[4];
+		return !((pDeviceId[0] == 0xFF) && (pDeviceId[1] == 0xFF) && (pDeviceId[2] == 0xFF) && (pDeviceId[3] == 0xFF));
+	}
+
+	bool IsDmxFrameSent(uint32_t nPort, uint32_t nMillis) const {
+		return (nMillis - m_aPort[nPort].nEndMillis) >= ArtNetRdmQueueConst::DMX_FRAME_MILLIS;
+	}
+	void DmxResumed(uint32_t nPort, uint32_t nMillis) {
+		m_aPort[nPort].nEndMillis = nMillis;
+	}
+
+	void Start(uint32_t nPort, uint32_t nMillis);
+	bool IsTimedOut(uint32_t nPort, uint32_t nMillis) const {
+		return (nMillis - m_aPort[nPort].nStartMillis) >= ArtNetRdmQueueConst::TIMEOUT_MILLIS;
+	}
+	void Complete(uint32_t nPort, uint32_t nMillis);
+	void TimeOut(uint32_t nPort, uint32_t nMillis);
+	void NoResponse(uint32_t nPort, uint32_t nMillis);
+	void Abort(uint32_t nPort);
+
+	void Print();
+
+private:
+	void Pop(uint32_t nPort);
+
+private:
+	struct TPort {
+		struct TArtNetRdmRequest aRequest[ArtNetRdmQueueConst::DEPTH];
+		uint32_t nHead;
+		uint32_t nCount;
+		uint32_t nStartMillis;
+		uint32_t nEndMillis;
+		bool bIsActive;
+	};
+
+	TPort m_aPort[artnet::MAX_PORTS];
+
+	uint32_t m_nQueued{0};
+	uint32_t m_nDropped{0};
+	uint32_t m_nCompleted{0};
+	uint32_t m_nTimedOut{0};
+	uint32_t m_nNoResponse{0};
+	uint32_t m_nAborted{0};
+	uint32_t m_nDepthMax{0};
+	uint32_t m_nLatencyMillisTotal{0};
+	uint32_t m_nLatencyMillisMax{0};
+};
+
+#endif /* ARTNETRDMQUEUE_H_ */
@@ -0,0 +1,109 @@
+/**
+ * @file artnetsyncscheduler.h
+ *
+ */
+/**
+ * Art-Net Designed by and Copyright Artistic Licence Holdings Ltd.
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef ARTNETSYNCSCHEDULER_H_
+#define ARTNETSYNCSCHEDULER_H_
+
+#include <stdint.h>
+
+struct ArtNetSyncSchedulerConst {
+	static constexpr uint32_t LATENCY_MICROS = 5000;			///< Fixed delay between the (filtered) ArtSync and the output
+	static constexpr uint32_t PERIOD_MIN_MICROS = 5000;			///< 200 Hz
+	static constexpr uint32_t PERIOD_MAX_MICROS = 1000000;		///< 1 Hz
+	static constexpr uint32_t FILTER_SHIFT = 3;					///< Period and phase follow 1/8 of the error
+	static constexpr uint32_t EXTRAPOLATE_MAX = 8;				///< Consecutive missing ArtSync presented on the estimated cadence
+	static constexpr uint32_t HISTOGRAM_BINS = 8;
+};
+
+/**
+ * Presentation scheduler for synchronous mode.
+ * The ArtSync period and phase are estimated, the buffered frame is presented at the filtered
+ * ArtSync time plus a fixed latency. A missing ArtSync is extrapolated from the estimated period.
+ * A latency which is not less than the estimated period is rejected: the frame is then
+ * presented at the filtered ArtSync time, before the next ArtSync.
+ * Sync is called on ArtSync, IsDue and Presented from the main loop.
+ */
+class ArtNetSyncScheduler {
+public:
+	ArtNetSyncScheduler(uint32_t nLatencyMicros = ArtNetSyncSchedulerConst::LATENCY_MICROS);
+
+	void Reset();
+
+	void Sync(uint32_t nNowMicros);
+	bool IsDue(uint32_t nNowMicros);
+	void Presented(uint32_t nNowMicros, bool bIsEarly);
+
+	bool IsPending() const {
+		return m_bIsPending;
+	}
+
+	uint32_t GetPeriodMicros() const {
+		return m_nPeriodMicros;
+	}
+
+	void Print();
+
+private:
+	uint32_t GetLatencyMicros() const {
+		return IsLatencyRejected() ? 0 : m_nLatencyMicros;
+	}
+
+	bool IsLatencyRejected() const {
+		return m_nLatencyMicros >= m_nPeriodMicros;
+	}
+
+	void Schedule(uint32_t nPresentMicros) {
+		m_nPresentMicros = nPresentMicros;
+		m_bIsPending = true;
+	}
+
+	static void Count(uint32_t *pHistogram, int32_t nErrorMicros);
+	static void PrintHistogram(const char *pName, const uint32_t *pHistogram);
+
+private:
+	uint32_t m_nLatencyMicros;
+
+	uint32_t m_nPeriodMicros{0};		///< 0 is not known yet
+	uint32_t m_nLastSyncMicros{0};
+	uint32_t m_nNextMicros{0};			///< Filtered time of the next ArtSync
+	uint32_t m_nPresentMicros{0};
+	uint32_t m_nExtrapolatedCount{0};	///< Since the last ArtSync
+	bool m_bHasSync{false};
+	bool m_bIsPending{false};
+
+	uint32_t m_nSyncs{0};
+	uint32_t m_nResyncs{0};
+	uint32_t m_nLate{0};
+	uint32_t m_nExtrapolated{0};
+	uint32_t m_nPresented{0};
+	uint32_t m_nEarly{0};
+	uint32_t m_aSyncJitter[ArtNetSyncSchedulerConst::HISTOGRAM_BINS]{};		///< ArtSync arrival against the prediction
+	uint32_t m_aOutputJitter[ArtNetSyncSchedulerConst::HISTOGRAM_BINS]{};	///< Presentation against the schedule
+};
+
+#endif /* ARTNETSYNCSCHEDULER_H_ */
@@ -27,6 +27,7 @@
  */
 
 #include <stdint.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdio.h>
 #include <cassert>
@@ -130,12 +131,60 @@ void ArtNetController::Stop(void) {
 void ArtNetController::HandleDmxOut(uint16_t nUniverse, const uint8_t *pDmxData, uint16_t nLength, uint8_t nPortIndex) {
 	DEBUG_ENTRY
 
+	if (__builtin_expect((m_nMaster == DMX_MAX_VALUE), 1)) {
+		memcpy(m_pArtDmx->Data, pDmxData, nLength);
+	} else if (m_nMaster == 0) {
+		memset(m_pArtDmx->Data, 0, nLength);
+	} else {
+		for (uint32_t i = 0; i < nLength; i++) {
+			m_pArtDmx->Data[i] = ((m_nMaster * static_cast<uint32_t>(pDmxData[i])) / DMX_MAX_VALUE) & 0xFF;
+		}
+	}
+
+	SendDmx(m_pArtDmx, nUniverse, nLength, nPortIndex, sizeof(struct TArtDmx));
+
+	DEBUG_EXIT
+}
+
+/**
+ * Zero copy variant of HandleDmxOut, the ArtDmx header is written in front of pDmxData.
+ * The caller must own the ArtDmx header size of bytes in front of pDmxData,
+ * and one byte after the data when nLength is odd.
+ */
+void ArtNetController::HandleDmxOutInPlace(uint16_t nUniverse, uint8_t *pDmxData, uint16_t nLength, uint8_t nPortIndex) {
+	DEBUG_ENTRY
+
+	struct TArtDmx *pArtDmx = reinterpret_cast<struct TArtDmx*>(pDmxData - offsetof(struct TArtDmx, Data));
+
+	// The length should be an even number
+	if ((nLength & 0x1) != 0) {
+		pDmxData[nLength++] = 0;
+	}
+
+	if (__builtin_expect((m_nMaster != DMX_MAX_VALUE), 0)) {
+		if (m_nMaster == 0) {
+			memset(pDmxData, 0, nLength);
+		} else {
+			for (uint32_t i = 0; i < nLength; i++) {
+				pDmxData[i] = ((m_nMaster * static_cast<uint32_t>(pDmxData[i])) / DMX_MAX_VALUE) & 0xFF;
+			}
+		}
+	}
+
+	memcpy(pArtDmx, m_pArtDmx, offsetof(struct TArtDmx, Sequence));
+
+	SendDmx(pArtDmx, nUniverse, nLength, nPortIndex, offsetof(struct TArtDmx, Data) + nLength);
+
+	DEBUG_EXIT
+}
+
+void ArtNetController::SendDmx(struct TArtDmx *pArtDmx, uint16_t nUniverse, uint16_t nLength, uint8_t nPortIndex, uint32_t nSize) {
 	ActiveUniversesAdd(nUniverse);
 
-	m_pArtDmx->Physical = nPortIndex;
-	m_pArtDmx->PortAddress = nUniverse;
-	m_pArtDmx->LengthHi = static_cast<uint8_t>((nLength & 0xFF00) >> 8);
-	m_pArtDmx->Length = static_cast<uint8_t>(nLength & 0xFF);
+	pArtDmx->Physical = nPortIndex;
+	pArtDmx->PortAddress = nUniverse;
+	pArtDmx->LengthHi = static_cast<uint8_t>((nLength & 0xFF00) >> 8);
+	pArtDmx->Length = static_cast<uint8_t>(nLength & 0xFF);
 
 	// The sequence number is used to ensure that ArtDmx packets are used in the correct order.
 	// This field is incremented in the range 0x01 to 0xff to allow the receiving node to resequence packets.
@@ -145,24 +194,15 @@ void ArtNetController::HandleDmxOut(uint16_t nUniverse, const uint8_t *pDmxData,
 		m_pArtDmx->Sequence = 1;
 	}
 
-	if (__builtin_expect((m_nMaster == DMX_MAX_VALUE), 1)) {
-		memcpy(m_pArtDmx->Data, pDmxData, nLength);
-	} else if (m_nMaster == 0) {
-		memset(m_pArtDmx->Data, 0, nLength);
-	} else {
-		for (uint32_t i = 0; i < nLength; i++) {
-			m_pArtDmx->Data[i] = ((m_nMaster * static_cast<uint32_t>(pDmxData[i])) / DMX_MAX_VALUE) & 0xFF;
-		}
-	}
+	pArtDmx->Sequence = m_pArtDmx->Sequence;
 
 	uint32_t nCount = 0;
-	struct TArtNetPollTableUniverses *IpAddresses = const_cast<struct TArtNetPollTableUniverses*>(GetIpAddress(nUniverse));
+	const struct TArtNetPollTableUniverses *IpAddresses = GetIpAddress(nUniverse);
 
 	if (m_bUnicast) {
 		if (IpAddresses != 0) {
 			nCount = IpAddresses->nCount;
 		} else {
-			DEBUG_EXIT
 			return;
 		}
 	}
@@ -171,22 +211,16 @@ void ArtNetController::HandleDmxOut(uint16_t nUniverse, const uint8_t *pDmxData,
 
 	if (m_bUnicast && (nCount <= 40)) {
 		for (uint32_t nIndex = 0; nIndex < nCount; nIndex++) {
-			Network::Get()->SendTo(m_nHandle, m_pArtDmx, sizeof(struct TArtDmx), IpAddresses->pIpAddresses[nIndex], artnet::UDP_PORT);
+			Network::Get()->SendTo(m_nHandle, pArtDmx, nSize, IpAddresses->pIpAddresses[nIndex], artnet::UDP_PORT);
 		}
 
 		m_bDmxHandled = true;
-
-		DEBUG_EXIT
 		return;
 	}
 
-	if (!m_bUnicast || (nCount > 40)) {
-		Network::Get()->SendTo(m_nHandle, m_pArtDmx, sizeof(struct TArtDmx), m_tArtNetController.nIPAddressBroadcast, artnet::UDP_PORT);
+	Network::Get()->SendTo(m_nHandle, pArtDmx, nSize, m_tArtNetController.nIPAddressBroadcast, artnet::UDP_PORT);
 
-		m_bDmxHandled = true;
-	}
-
-	DEBUG_EXIT
+	m_bDmxHandled = true;
 }
 
 void ArtNetController::HandleSync(void) {
@@ -75,9 +75,11 @@ void ArtNetNode::HandleIpProg(void) {
 		m_Node.IPAddressBroadcast = m_Node.IPAddressLocal | ~(Network::Get()->GetNetmask());
 		m_Node.Status2 = (m_Node.Status2 & (~(ArtNetStatus2::IP_DHCP))) | (Network::Get()->IsDhcpUsed() ? ArtNetStatus2::IP_DHCP : ArtNetStatus2::IP_MANUALY);
 		// Update PollReply for new IPAddress
-		memcpy(m_PollReply.IPAddress, &m_pIpProgReply->ProgIpHi, ARTNET_IP_SIZE);
-		if (m_nVersion > 3) {
-			memcpy(m_PollReply.BindIp, &m_pIpProgReply->ProgIpHi, ARTNET_IP_SIZE);
+		for (uint32_t nPage = 0; nPage < m_nPages; nPage++) {
+			memcpy(m_pPollReply[nPage].IPAddress, &m_pIpProgReply->ProgIpHi, ARTNET_IP_SIZE);
+			if (m_nVersion > 3) {
+				memcpy(m_pPollReply[nPage].BindIp, &m_pIpProgReply->ProgIpHi, ARTNET_IP_SIZE);
+			}
 		}
 
 		if (m_State.SendArtPollReplyOnChange) {
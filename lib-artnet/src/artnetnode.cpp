@@ -49,6 +49,7 @@
 #include "hardware.h"
 #include "network.h"
 #include "ledblink.h"
+#include "packettrace.h"
 
 #include "artnetnode_internal.h"
 
@@ -89,11 +90,22 @@ ArtNetNode::ArtNetNode(uint8_t nVersion, uint8_t nPages) :
 	m_pArtNet4Handler(0),
 	m_pTimeCodeData(0),
 	m_pTodData(0),
+	m_pArtNetRdmQueue(0),
+	m_pArtNetSyncScheduler(0),
 	m_pIpProgReply(0),
+	m_pPollReply(0),
+	m_bPollReplyPortsChanged(true),
+	m_tPollReplyReportCode(ARTNET_RCPOWEROK),
+	m_nPollReplyCount(0),
 	m_bDirectUpdate(false),
 	m_nCurrentPacketMillis(0),
 	m_nPreviousPacketMillis(0),
-	m_IsRdmResponder(false)
+	m_IsRdmResponder(false),
+	m_nRdmDiscoveryIntervalMillis(ArtNetRdmConst::DISCOVERY_INTERVAL_SECONDS * 1000),
+	m_bRdmPoll(false),
+	m_nRdmPollDmxFpsMin(ArtNetRdmConst::POLL_DMX_FPS_MIN),
+	m_nDmxInKeepAliveMillis(ArtNetDmxConst::KEEP_ALIVE_MILLIS),
+	m_nDmxInMinGapMillis(ArtNetDmxConst::MIN_GAP_MILLIS)
 {
 	assert(Hardware::Get() != 0);
 	assert(Network::Get() != 0);
@@ -112,6 +124,12 @@ ArtNetNode::ArtNetNode(uint8_t nVersion, uint8_t nPages) :
 
 	for (uint32_t i = 0; i < ARTNET_NODE_MAX_PORTS_OUTPUT; i++) {
 		m_IsLightSetRunning[i] = false;
+		m_nRdmDiscoveryMillis[i] = 0;
+		m_nRdmDiscoverySlotMillis[i] = 0;
+		m_bRdmDiscoveryGap[i] = false;
+		m_nRdmPollStartMillis[i] = 0;
+		m_nRdmPollEndMillis[i] = 0;
+		m_nRdmPollGapMillis[i] = 0;
 		memset(&m_OutputPorts[i], 0 , sizeof(struct TOutputPort));
 	}
 
@@ -120,6 +138,11 @@ ArtNetNode::ArtNetNode(uint8_t nVersion, uint8_t nPages) :
 		m_InputPorts[i].nDestinationIp = Network::Get()->GetIp() | ~(Network::Get()->GetNetmask());
 	}
 
+	m_pPollReply = new struct TArtPollReply[m_nPages];
+	assert(m_pPollReply != 0);
+
+	memset(m_pPollReply, 0, m_nPages * sizeof(struct TArtPollReply));
+
 	SetShortName(NODE_DEFAULT_SHORT_NAME);
 
 	uint8_t nBoardNameLength;
@@ -143,6 +166,14 @@ ArtNetNode::~ArtNetNode(void) {
 		delete m_pTodData;
 	}
 
+	if (m_pArtNetRdmQueue != 0) {
+		delete m_pArtNetRdmQueue;
+	}
+
+	if (m_pArtNetSyncScheduler != 0) {
+		delete m_pArtNetSyncScheduler;
+	}
+
 	if (m_pIpProgReply != 0) {
 		delete m_pIpProgReply;
 	}
@@ -150,6 +181,8 @@ ArtNetNode::~ArtNetNode(void) {
 	if (m_pTimeCodeData != 0) {
 		delete m_pTimeCodeData;
 	}
+
+	delete[] m_pPollReply;
 }
 
 void ArtNetNode::Start(void) {
@@ -222,6 +255,8 @@ int ArtNetNode::SetUniverseSwitch(uint8_t nPortIndex, TArtNetPortDir dir, uint8_
 	assert(nPortIndex < (artnet::MAX_PORTS * m_nPages));
 	assert(dir <= ARTNET_DISABLE_PORT);
 
+	m_bPollReplyPortsChanged = true;
+
 	if (dir == ARTNET_DISABLE_PORT) {
 
 		if (nPortIndex < ARTNET_NODE_MAX_PORTS_OUTPUT) {
@@ -316,6 +351,8 @@ bool ArtNetNode::GetUniverseSwitch(uint8_t nPortIndex, uint8_t &nAddress, TArtNe
 void ArtNetNode::SetSubnetSwitch(uint8_t nAddress, uint8_t nPage) {
 	assert(nPage < artnet::MAX_PAGES);
 
+	m_bPollReplyPortsChanged = true;
+
 	m_Node.SubSwitch[nPage] = nAddress;
 
 	const uint32_t nPortIndexStart = nPage * artnet::MAX_PORTS;
@@ -340,6 +377,8 @@ uint8_t ArtNetNode::GetSubnetSwitch(uint8_t nPage) const {
 void ArtNetNode::SetNetSwitch(uint8_t nAddress, uint8_t nPage) {
 	assert(nPage < artnet::MAX_PAGES);
 
+	m_bPollReplyPortsChanged = true;
+
 	m_Node.NetSwitch[nPage] = nAddress;
 
 	const uint32_t nPortIndexStart = nPage * artnet::MAX_PORTS;
@@ -454,7 +493,9 @@ void ArtNetNode::SetShortName(const char *pShortName) {
 	strncpy(m_Node.ShortName, pShortName, artnet::SHORT_NAME_LENGTH - 1);
 	m_Node.ShortName[artnet::SHORT_NAME_LENGTH - 1] = '\0';
 
-	memcpy(m_PollReply.ShortName, m_Node.ShortName, artnet::SHORT_NAME_LENGTH);
+	for (uint32_t nPage = 0; nPage < m_nPages; nPage++) {
+		memcpy(m_pPollReply[nPage].ShortName, m_Node.ShortName, artnet::SHORT_NAME_LENGTH);
+	}
 
 	if (m_State.status == ARTNET_ON) {
 		if (m_pArtNetStore != 0) {
@@ -472,7 +513,9 @@ void ArtNetNode::SetLongName(const char *pLongName) {
 	strncpy(m_Node.LongName, pLongName, artnet::LONG_NAME_LENGTH - 1);
 	m_Node.LongName[artnet::LONG_NAME_LENGTH - 1] = '\0';
 
-	memcpy(m_PollReply.LongName, m_Node.LongName, artnet::LONG_NAME_LENGTH);
+	for (uint32_t nPage = 0; nPage < m_nPages; nPage++) {
+		memcpy(m_pPollReply[nPage].LongName, m_Node.LongName, artnet::LONG_NAME_LENGTH);
+	}
 
 	if (m_State.status == ARTNET_ON) {
 		if (m_pArtNetStore != 0) {
@@ -491,68 +534,145 @@ void ArtNetNode::SetOemValue(const uint8_t *pOem) {
 	m_Node.Oem[1] = pOem[1];
 }
 
+/**
+ * The fields which do not change while running are filled once per page
+ */
 void ArtNetNode::FillPollReply(void) {
-	memset(&m_PollReply, 0, sizeof(struct TArtPollReply));
+	ip.u32 = m_Node.IPAddressLocal;
 
-	memcpy(m_PollReply.Id, NODE_ID, sizeof m_PollReply.Id);
+	for (uint32_t nPage = 0; nPage < m_nPages; nPage++) {
+		struct TArtPollReply *pPollReply = &m_pPollReply[nPage];
 
-	m_PollReply.OpCode = OP_POLLREPLY;
+		memset(pPollReply, 0, sizeof(struct TArtPollReply));
 
-	ip.u32 = m_Node.IPAddressLocal;
-	memcpy(m_PollReply.IPAddress, ip.u8, sizeof m_PollReply.IPAddress);
+		memcpy(pPollReply->Id, NODE_ID, sizeof pPollReply->Id);
 
-	m_PollReply.Port = artnet::UDP_PORT;
+		pPollReply->OpCode = OP_POLLREPLY;
 
-	m_PollReply.VersInfoH = DEVICE_SOFTWARE_VERSION[0];
-	m_PollReply.VersInfoL = DEVICE_SOFTWARE_VERSION[1];
+		memcpy(pPollReply->IPAddress, ip.u8, sizeof pPollReply->IPAddress);
 
-	m_PollReply.OemHi = m_Node.Oem[0];
-	m_PollReply.Oem = m_Node.Oem[1];
+		pPollReply->Port = artnet::UDP_PORT;
 
-	m_PollReply.Status1 = m_Node.Status1;
+		pPollReply->VersInfoH = DEVICE_SOFTWARE_VERSION[0];
+		pPollReply->VersInfoL = DEVICE_SOFTWARE_VERSION[1];
 
-	m_PollReply.EstaMan[0] = ArtNetConst::ESTA_ID[1];
-	m_PollReply.EstaMan[1] = ArtNetConst::ESTA_ID[0];
+		pPollReply->OemHi = m_Node.Oem[0];
+		pPollReply->Oem = m_Node.Oem[1];
 
-	memcpy(m_PollReply.ShortName, m_Node.ShortName, sizeof m_PollReply.ShortName);
-	memcpy(m_PollReply.LongName, m_Node.LongName, sizeof m_PollReply.LongName);
+		pPollReply->Status1 = m_Node.Status1;
 
-	// Disable all input
-	for (uint32_t i = 0; i < artnet::MAX_PORTS; i++) {
-		m_PollReply.GoodInput[i] = PORT_IN_STATUS_DISABLED_MASK;
+		pPollReply->EstaMan[0] = ArtNetConst::ESTA_ID[1];
+		pPollReply->EstaMan[1] = ArtNetConst::ESTA_ID[0];
+
+		memcpy(pPollReply->ShortName, m_Node.ShortName, sizeof pPollReply->ShortName);
+		memcpy(pPollReply->LongName, m_Node.LongName, sizeof pPollReply->LongName);
+
+		// Disable all input
+		for (uint32_t i = 0; i < artnet::MAX_PORTS; i++) {
+			pPollReply->GoodInput[i] = PORT_IN_STATUS_DISABLED_MASK;
+		}
+
+		pPollReply->Style = ARTNET_ST_NODE;
+
+		memcpy(pPollReply->MAC, m_Node.MACAddressLocal, sizeof pPollReply->MAC);
+
+		if (m_nVersion > 3) {
+			memcpy(pPollReply->BindIp, ip.u8, sizeof pPollReply->BindIp);
+		}
+
+		pPollReply->BindIndex = nPage + 1;
+
+		pPollReply->Status2 = m_Node.Status2;
 	}
 
-	m_PollReply.Style = ARTNET_ST_NODE;
+	m_bPollReplyPortsChanged = true;
+	m_tPollReplyReportCode = m_State.reportCode;
+	m_nPollReplyCount = m_State.ArtPollReplyCount - 1;	// Force the NodeReport
+}
+
+/**
+ * The port configuration, only after a change of a Port-Address or a port direction
+ */
+void ArtNetNode::UpdatePollReplyPorts(void) {
+	for (uint32_t nPage = 0; nPage < m_nPages; nPage++) {
+		struct TArtPollReply *pPollReply = &m_pPollReply[nPage];
 
-	memcpy(m_PollReply.MAC, m_Node.MACAddressLocal, sizeof m_PollReply.MAC);
+		pPollReply->NetSwitch = m_Node.NetSwitch[nPage];
+		pPollReply->SubSwitch = m_Node.SubSwitch[nPage];
 
-	if (m_nVersion > 3) {
-		memcpy(m_PollReply.BindIp, ip.u8, sizeof m_PollReply.BindIp);
+		const uint32_t nPortIndexStart = nPage * artnet::MAX_PORTS;
+
+		uint32_t NumPortsLo = 0;
+
+		for (uint32_t nPortIndex = nPortIndexStart; nPortIndex < (nPortIndexStart + artnet::MAX_PORTS); nPortIndex++) {
+			const uint32_t nIndex = nPortIndex - nPortIndexStart;
+
+			pPollReply->PortTypes[nIndex] = 0;
+
+			if (m_OutputPorts[nPortIndex].bIsEnabled) {
+				pPollReply->PortTypes[nIndex] = ARTNET_ENABLE_OUTPUT | ARTNET_PORT_DMX;
+				NumPortsLo++;
+			}
+
+			pPollReply->SwOut[nIndex] = m_OutputPorts[nPortIndex].port.nDefaultAddress;
+
+			if (nPortIndex < artnet::MAX_PORTS) {
+				if (m_InputPorts[nPortIndex].bIsEnabled) {
+					pPollReply->PortTypes[nIndex] |= ARTNET_ENABLE_INPUT | ARTNET_PORT_DMX;
+					NumPortsLo++;
+				}
+
+				pPollReply->SwIn[nIndex] = m_InputPorts[nPortIndex].port.nDefaultAddress;
+			}
+		}
+
+		pPollReply->NumPortsLo = NumPortsLo;
+		assert(NumPortsLo <= 4);
 	}
 
-	m_PollReply.Status2 = m_Node.Status2;
+	m_bPollReplyPortsChanged = false;
+}
 
-	m_PollReply.NumPortsLo = 4; // Default
+/**
+ * The NodeReport is formatted only when the report code or the counter has changed
+ */
+void ArtNetNode::UpdatePollReplyNodeReport(void) {
+	if ((m_tPollReplyReportCode == m_State.reportCode) && (m_nPollReplyCount == m_State.ArtPollReplyCount)) {
+		return;
+	}
+
+	m_tPollReplyReportCode = m_State.reportCode;
+	m_nPollReplyCount = m_State.ArtPollReplyCount;
+
+	snprintf(reinterpret_cast<char*>(m_pPollReply[0].NodeReport), ARTNET_REPORT_LENGTH, "%04x [%04d] %s AvV", static_cast<int>(m_State.reportCode), static_cast<int>(m_State.ArtPollReplyCount), m_aSysName);
+
+	for (uint32_t nPage = 1; nPage < m_nPages; nPage++) {
+		memcpy(m_pPollReply[nPage].NodeReport, m_pPollReply[0].NodeReport, ARTNET_REPORT_LENGTH);
+	}
 }
 
+/**
+ * Only the status fields are updated here, they depend on the time the data was received
+ */
 void ArtNetNode::SendPollRelply(bool bResponse) {
 	if (!bResponse && m_State.status == ARTNET_ON) {
 		m_State.ArtPollReplyCount++;
 	}
 
-	m_PollReply.Status1 = m_Node.Status1;
+	if (m_bPollReplyPortsChanged) {
+		UpdatePollReplyPorts();
+	}
+
+	UpdatePollReplyNodeReport();
 
 	for (uint32_t nPage = 0; nPage < m_nPages; nPage++) {
+		struct TArtPollReply *pPollReply = &m_pPollReply[nPage];
 
-		m_PollReply.NetSwitch = m_Node.NetSwitch[nPage];
-		m_PollReply.SubSwitch = m_Node.SubSwitch[nPage];
-
-		m_PollReply.BindIndex = nPage + 1;
+		pPollReply->Status1 = m_Node.Status1;
+		pPollReply->Status2 = m_Node.Status2;
 
 		const uint32_t nPortIndexStart = nPage * artnet::MAX_PORTS;
 
-		uint32_t NumPortsLo = 0;
-
 		for (uint32_t nPortIndex = nPortIndexStart; nPortIndex < (nPortIndexStart + artnet::MAX_PORTS); nPortIndex++) {
 			uint8_t nStatus = m_OutputPorts[nPortIndex].port.nStatus;
 
@@ -585,32 +705,14 @@ void ArtNetNode::SendPollRelply(bool bResponse) {
 
 			m_OutputPorts[nPortIndex].port.nStatus = nStatus;
 
-			if (m_OutputPorts[nPortIndex].bIsEnabled) {
-				m_PollReply.PortTypes[nPortIndex - nPortIndexStart] = ARTNET_ENABLE_OUTPUT | ARTNET_PORT_DMX;
-				NumPortsLo++;
-			}
-
-			m_PollReply.GoodOutput[nPortIndex - nPortIndexStart] = m_OutputPorts[nPortIndex].port.nStatus;
-			m_PollReply.SwOut[nPortIndex - nPortIndexStart] = m_OutputPorts[nPortIndex].port.nDefaultAddress;
+			pPollReply->GoodOutput[nPortIndex - nPortIndexStart] = nStatus;
 
 			if (nPortIndex < artnet::MAX_PORTS) {
-				if (m_InputPorts[nPortIndex].bIsEnabled) {
-					m_PollReply.PortTypes[nPortIndex - nPortIndexStart] |= ARTNET_ENABLE_INPUT | ARTNET_PORT_DMX;
-					NumPortsLo++;
-				}
-
-				m_PollReply.GoodInput[nPortIndex - nPortIndexStart] = m_InputPorts[nPortIndex].port.nStatus;
-				m_PollReply.SwIn[nPortIndex - nPortIndexStart] = m_InputPorts[nPortIndex].port.nDefaultAddress;
+				pPollReply->GoodInput[nPortIndex - nPortIndexStart] = m_InputPorts[nPortIndex].port.nStatus;
 			}
-
 		}
 
-		m_PollReply.NumPortsLo = NumPortsLo;
-		assert(NumPortsLo <= 4);
-
-		snprintf(reinterpret_cast<char*>(m_PollReply.NodeReport), ARTNET_REPORT_LENGTH, "%04x [%04d] %s AvV", static_cast<int>(m_State.reportCode), static_cast<int>(m_State.ArtPollReplyCount), m_aSysName);
-
-		Network::Get()->SendTo(m_nHandle, &m_PollReply, sizeof(struct TArtPollReply), m_Node.IPAddressBroadcast, artnet::UDP_PORT);
+		Network::Get()->SendTo(m_nHandle, pPollReply, sizeof(struct TArtPollReply), m_Node.IPAddressBroadcast, artnet::UDP_PORT);
 	}
 
 	m_State.IsChanged = false;
@@ -765,6 +867,12 @@ void ArtNetNode::HandleDmx(void) {
 
 			bool sendNewData = false;
 
+			if ((m_pArtNetSyncScheduler != 0) && m_pArtNetSyncScheduler->IsPending()) {
+				// The next frame would overwrite the one waiting for its presentation time
+				SyncOutput();
+				m_pArtNetSyncScheduler->Presented(Hardware::Get()->Micros(), true);
+			}
+
 			m_OutputPorts[i].port.nStatus = m_OutputPorts[i].port.nStatus | GO_DATA_IS_BEING_TRANSMITTED;
 
 			if (m_State.IsMergeMode) {
@@ -829,16 +937,25 @@ void ArtNetNode::HandleDmx(void) {
 #if defined ( ENABLE_SENDDIAG )
 				SendDiag("8. Source matches both buffers, this shouldn't be happening!", ARTNET_DP_LOW);
 #endif
+				if (PacketTrace::Get() != 0) {
+					PacketTrace::Get()->SetResult(PacketTraceResult::DISCARDED);
+				}
 				return;
 			} else if (ipA != m_ArtNetPacket.IPAddressFrom && ipB != m_ArtNetPacket.IPAddressFrom) {
 #if defined ( ENABLE_SENDDIAG )
 				SendDiag("9. More than two sources, discarding data", ARTNET_DP_LOW);
 #endif
+				if (PacketTrace::Get() != 0) {
+					PacketTrace::Get()->SetResult(PacketTraceResult::DISCARDED);
+				}
 				return;
 			} else {
 #if defined ( ENABLE_SENDDIAG )
 				SendDiag("0. No cases matched, this shouldn't happen!", ARTNET_DP_LOW);
 #endif
+				if (PacketTrace::Get() != 0) {
+					PacketTrace::Get()->SetResult(PacketTraceResult::DISCARDED);
+				}
 				return;
 			}
 
@@ -850,7 +967,7 @@ void ArtNetNode::HandleDmx(void) {
 					m_pLightSet->SetData(i, m_OutputPorts[i].data, m_OutputPorts[i].nLength);
 
 					if(!m_IsLightSetRunning[i]) {
-						m_pLightSet->Start(i);
+						StartLightSet(i);
 						m_State.IsChanged |= (!m_IsLightSetRunning[i]);
 						m_IsLightSetRunning[i] = true;
 					}
@@ -872,9 +989,41 @@ void ArtNetNode::HandleDmx(void) {
 }
 
 void ArtNetNode::HandleSync(void) {
+	if (m_pArtNetSyncScheduler == 0) {
+		m_State.IsSynchronousMode = true;
+		m_State.nArtSyncMillis = Hardware::Get()->Millis();
+		SyncOutput();
+		return;
+	}
+
+	if (!m_State.IsSynchronousMode) {
+		m_pArtNetSyncScheduler->Reset();
+	} else if (m_pArtNetSyncScheduler->IsPending()) {
+		SyncOutput();
+		m_pArtNetSyncScheduler->Presented(Hardware::Get()->Micros(), true);
+	}
+
 	m_State.IsSynchronousMode = true;
 	m_State.nArtSyncMillis = Hardware::Get()->Millis();
 
+	// The pending data is presented by HandleSyncScheduler
+	m_pArtNetSyncScheduler->Sync(Hardware::Get()->Micros());
+}
+
+void ArtNetNode::HandleSyncScheduler(void) {
+	if (!m_State.IsSynchronousMode) {
+		return;
+	}
+
+	const uint32_t nNowMicros = Hardware::Get()->Micros();
+
+	if (m_pArtNetSyncScheduler->IsDue(nNowMicros)) {
+		SyncOutput();
+		m_pArtNetSyncScheduler->Presented(nNowMicros, false);
+	}
+}
+
+void ArtNetNode::SyncOutput(void) {
 	for (uint32_t i = 0; i < (m_nPages * artnet::MAX_PORTS); i++) {
 		if  ((m_OutputPorts[i].tPortProtocol == PORT_ARTNET_ARTNET) &&  ((m_OutputPorts[i].IsDataPending) || (m_OutputPorts[i].bIsEnabled && m_bDirectUpdate) )) {
 #if defined ( ENABLE_SENDDIAG )
@@ -883,13 +1032,27 @@ void ArtNetNode::HandleSync(void) {
 			m_pLightSet->SetData(i, m_OutputPorts[i].data, 	m_OutputPorts[i].nLength);
 
 			if(!m_IsLightSetRunning[i]) {
-				m_pLightSet->Start(i);
+				StartLightSet(i);
 				m_IsLightSetRunning[i] = true;
 			}
 
 			m_OutputPorts[i].IsDataPending = false;
 		}
 	}
+
+	m_pLightSet->Sync();
+}
+
+void ArtNetNode::SetSyncScheduler(bool bEnable, uint32_t nLatencyMicros) {
+	if (m_pArtNetSyncScheduler != 0) {
+		delete m_pArtNetSyncScheduler;
+		m_pArtNetSyncScheduler = 0;
+	}
+
+	if (bEnable) {
+		m_pArtNetSyncScheduler = new ArtNetSyncScheduler(nLatencyMicros);
+		assert(m_pArtNetSyncScheduler != 0);
+	}
 }
 
 void ArtNetNode::HandleAddress(void) {
@@ -1005,7 +1168,7 @@ void ArtNetNode::HandleAddress(void) {
 	}
 
 	if ((nPort < artnet::MAX_PORTS) && (m_OutputPorts[nPort].tPortProtocol == PORT_ARTNET_ARTNET) && !m_IsLightSetRunning[nPort]) {
-		m_pLightSet->Start(nPort);
+		StartLightSet(nPort);
 		m_IsLightSetRunning[nPort] = true;
 		m_OutputPorts[nPort].port.nStatus |= GO_DATA_IS_BEING_TRANSMITTED;
 	}
@@ -1035,7 +1198,7 @@ void ArtNetNode::SetNetworkDataLossCondition(void) {
 }
 
 void ArtNetNode::GetType(void) {
-	char *data = reinterpret_cast<char*>(&(m_ArtNetPacket.ArtPacket));
+	const uint8_t *data = reinterpret_cast<uint8_t*>(&(m_ArtNetPacket.ArtPacket));
 
 	if (m_ArtNetPacket.length < ARTNET_MIN_HEADER_SIZE) {
 		m_ArtNetPacket.OpCode = OP_NOT_DEFINED;
@@ -1061,6 +1224,16 @@ void ArtNetNode::Run(void) {
 
 	m_nCurrentPacketMillis = Hardware::Get()->Millis();
 
+	if (m_pArtNetRdmQueue != 0) {
+		HandleRdmDiscovery();
+		HandleRdmQueue();
+		HandleRdmPoll();
+	}
+
+	if (m_pArtNetSyncScheduler != 0) {
+		HandleSyncScheduler();
+	}
+
 	if (__builtin_expect((nBytesReceived == 0), 1)) {
 		if ((m_State.nNetworkDataLossTimeoutMillis != 0) && ((m_nCurrentPacketMillis - m_nPreviousPacketMillis) >= m_State.nNetworkDataLossTimeoutMillis)) {
 			SetNetworkDataLossCondition();
@@ -1103,6 +1276,14 @@ void ArtNetNode::Run(void) {
 
 	GetType();
 
+	if (__builtin_expect((PacketTrace::Get() != 0), 0)) {
+		const bool bIsDmx = (m_ArtNetPacket.OpCode == OP_DMX);
+		const struct TArtDmx *pArtDmx = &(m_ArtNetPacket.ArtPacket.ArtDmx);
+		PacketTrace::Get()->Record(m_ArtNetPacket.IPAddressFrom, nForeignPort, artnet::UDP_PORT, m_ArtNetPacket.OpCode,
+				bIsDmx ? pArtDmx->PortAddress : 0, bIsDmx ? pArtDmx->Sequence : 0, static_cast<uint16_t>(nBytesReceived), &(m_ArtNetPacket.ArtPacket),
+				m_ArtNetPacket.OpCode == OP_NOT_DEFINED ? PacketTraceResult::INVALID : PacketTraceResult::ACCEPTED);
+	}
+
 	if (m_State.IsSynchronousMode) {
 		if (m_nCurrentPacketMillis - m_State.nArtSyncMillis >= (4 * 1000)) {
 			m_State.IsSynchronousMode = false;
@@ -1164,6 +1345,9 @@ void ArtNetNode::Run(void) {
 	default:
 		// ArtNet but OpCode is not implemented
 		// Just skip ... no error
+		if ((PacketTrace::Get() != 0) && (m_ArtNetPacket.OpCode != OP_NOT_DEFINED)) {
+			PacketTrace::Get()->SetResult(PacketTraceResult::IGNORED);
+		}
 		break;
 	}
 
@@ -5,7 +5,7 @@
 /**
  * Art-Net Designed by and Copyright Artistic Licence Holdings Ltd.
  */
-/* Copyright (C) 2019 by Arjan van Vught mailto:info@orangepi-dmx.nl
+/* Copyright (C) 2019-2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -46,43 +46,93 @@ void ArtNetNode::SetDestinationIp(uint8_t nPortIndex, uint32_t nDestinationIp) {
 	}
 }
 
+/**
+ * Only changed data is sent, the minimum gap coalesces fast changes and
+ * unchanged data is re-transmitted with the keep-alive interval.
+ */
 void ArtNetNode::HandleDmxIn(void) {
-	struct TArtDmx tArtDmx;
-
-	memcpy(tArtDmx.Id, NODE_ID, sizeof m_PollReply.Id);
-	tArtDmx.OpCode = OP_DMX;
-	tArtDmx.ProtVerHi = 0;
-	tArtDmx.ProtVerLo = artnet::PROTOCOL_REVISION;
+	const uint32_t nMillis = Hardware::Get()->Millis();
 
 	for (uint32_t i = 0; i < artnet::MAX_PORTS; i++) {
 		uint32_t nUpdatesPerSecond;
 
 		if (m_InputPorts[i].bIsEnabled){
+			TInputPort &InputPort = m_InputPorts[i];
 			uint16_t nLength;
 			const uint8_t *pDmxData = m_pArtNetDmx->Handler(i, nLength, nUpdatesPerSecond);
 
-			if (pDmxData != 0) {
-				tArtDmx.Sequence = 1 + m_InputPorts[i].nSequence++;
-				tArtDmx.Physical = i;
-				tArtDmx.PortAddress = m_InputPorts[i].port.nPortAddress;
-				tArtDmx.LengthHi = (nLength & 0xFF00) >> 8;
-				tArtDmx.Length = (nLength & 0xFF);
+			if ((pDmxData != 0) && (nLength != 0)) {
+				InputPort.nFramesReceived++;
 
-				memcpy(tArtDmx.Data, pDmxData, nLength);
+				// The length must be even, an odd frame is padded with a zero slot
+				const uint16_t nEvenLength = static_cast<uint16_t>((nLength + 1) & ~1);
 
-				m_InputPorts[i].port.nStatus = GI_DATA_RECIEVED;
+				if ((nEvenLength == InputPort.nLength) && (memcmp(InputPort.data, pDmxData, nLength) == 0)) {
+					InputPort.nFramesUnchanged++;
+				} else {
+					if (InputPort.bIsDataPending) {
+						InputPort.nFramesCoalesced++;
+					}
+
+					memcpy(InputPort.data, pDmxData, nLength);
 
-				Network::Get()->SendTo(m_nHandle, &tArtDmx, sizeof(struct TArtDmx), m_InputPorts[i].nDestinationIp, artnet::UDP_PORT);
+					if (nEvenLength != nLength) {
+						InputPort.data[nLength] = 0;
+					}
 
+					InputPort.nLength = nEvenLength;
+					InputPort.bIsDataPending = true;
+				}
+
+				InputPort.port.nStatus = GI_DATA_RECIEVED;
 				m_State.bIsReceivingDmx = true;
 			} else {
-				if ((m_InputPorts[i].port.nStatus & GO_DATA_IS_BEING_TRANSMITTED) == GO_DATA_IS_BEING_TRANSMITTED) {
+				if ((InputPort.port.nStatus & GO_DATA_IS_BEING_TRANSMITTED) == GO_DATA_IS_BEING_TRANSMITTED) {
 					if (nUpdatesPerSecond == 0) {
-						m_InputPorts[i].port.nStatus = m_InputPorts[i].port.nStatus & ~GI_DATA_RECIEVED;
+						InputPort.port.nStatus = InputPort.port.nStatus & ~GI_DATA_RECIEVED;
+						InputPort.bIsDataPending = false;
 						m_State.bIsReceivingDmx = false;
 					}
 				}
 			}
+
+			if ((InputPort.port.nStatus & GI_DATA_RECIEVED) != GI_DATA_RECIEVED) {
+				continue;
+			}
+
+			const uint32_t nElapsedMillis = nMillis - InputPort.nMillis;
+
+			if (InputPort.bIsDataPending) {
+				if (nElapsedMillis >= m_nDmxInMinGapMillis) {
+					SendDmxIn(i, nMillis);
+				}
+			} else if ((m_nDmxInKeepAliveMillis != 0) && (nElapsedMillis >= m_nDmxInKeepAliveMillis)) {
+				InputPort.nPacketsKeepAlive++;
+				SendDmxIn(i, nMillis);
+			}
 		}
 	}
 }
+
+void ArtNetNode::SendDmxIn(uint32_t nPortIndex, uint32_t nMillis) {
+	TInputPort &InputPort = m_InputPorts[nPortIndex];
+	struct TArtDmx tArtDmx;
+
+	memcpy(tArtDmx.Id, NODE_ID, sizeof tArtDmx.Id);
+	tArtDmx.OpCode = OP_DMX;
+	tArtDmx.ProtVerHi = 0;
+	tArtDmx.ProtVerLo = artnet::PROTOCOL_REVISION;
+	tArtDmx.Sequence = 1 + InputPort.nSequence++;
+	tArtDmx.Physical = nPortIndex;
+	tArtDmx.PortAddress = InputPort.port.nPortAddress;
+	tArtDmx.LengthHi = (InputPort.nLength & 0xFF00) >> 8;
+	tArtDmx.Length = (InputPort.nLength & 0xFF);
+
+	memcpy(tArtDmx.Data, InputPort.data, InputPort.nLength);
+
+	Network::Get()->SendTo(m_nHandle, &tArtDmx, sizeof(struct TArtDmx) - artnet::DMX_LENGTH + InputPort.nLength, InputPort.nDestinationIp, artnet::UDP_PORT);
+
+	InputPort.nMillis = nMillis;
+	InputPort.bIsDataPending = false;
+	InputPort.nPacketsSent++;
+}
@@ -81,7 +81,20 @@ void ArtNetNode::Print(void) {
 				const uint32_t nDestinationIp = (m_InputPorts[nPortIndex].nDestinationIp == 0 ? Network::Get()->GetBroadcastIp() : m_InputPorts[nPortIndex].nDestinationIp);
 
 				printf("  Port %2d %d:%-3d[%2x] -> " IPSTR "\n", nPortIndex, nNet, nSubSwitch * 16 + nAddress, nSubSwitch * 16 + nAddress, IP2STR(nDestinationIp));
+
+				const struct TInputPort *pInputPort = &m_InputPorts[nPortIndex];
+				printf("   Frames %d received, %d unchanged, %d coalesced; ArtDmx %d sent, %d keep-alive\n", static_cast<int>(pInputPort->nFramesReceived), static_cast<int>(pInputPort->nFramesUnchanged), static_cast<int>(pInputPort->nFramesCoalesced), static_cast<int>(pInputPort->nPacketsSent), static_cast<int>(pInputPort->nPacketsKeepAlive));
 			}
 		}
+
+		printf(" Input keep-alive %d ms, minimum gap %d ms\n", static_cast<int>(m_nDmxInKeepAliveMillis), static_cast<int>(m_nDmxInMinGapMillis));
+	}
+
+	if (m_pArtNetRdmQueue != 0) {
+		m_pArtNetRdmQueue->Print();
+	}
+
+	if (m_pArtNetSyncScheduler != 0) {
+		m_pArtNetSyncScheduler->Print();
 	}
 }
@@ -69,6 +69,7 @@ ArtNetParams::ArtNetParams(ArtNetParamsStore *pArtNetParamsStore): m_pArtNetPara
 	m_tArtNetParams.aOemValue[0] = ArtNetConst::OEM_ID[1];
 	m_tArtNetParams.aOemValue[1] = ArtNetConst::OEM_ID[0];
 	m_tArtNetParams.nDirection = ARTNET_OUTPUT_PORT;
+	m_tArtNetParams.nSyncLatency = ArtNetSyncSchedulerConst::LATENCY_MICROS;
 
 	DEBUG_EXIT
 }
@@ -271,6 +272,18 @@ void ArtNetParams::callbackFunction(const char *pLine) {
 		}
 	}
 
+	if (Sscan::Uint16(pLine, ArtNetParamsConst::SYNC_LATENCY, nValue16) == Sscan::OK) {
+		// Microseconds, 0 is without the ArtSync scheduler
+		if (nValue16 != 0) {
+			m_tArtNetParams.nSyncLatency = nValue16;
+			m_tArtNetParams.nSetList |= ArtnetParamsMask::SYNC_LATENCY;
+		} else {
+			m_tArtNetParams.nSyncLatency = ArtNetSyncSchedulerConst::LATENCY_MICROS;
+			m_tArtNetParams.nSetList &= ~ArtnetParamsMask::SYNC_LATENCY;
+		}
+		return;
+	}
+
 	if (Sscan::Uint8(pLine, LightSetConst::PARAMS_ENABLE_NO_CHANGE_UPDATE, nValue8) == Sscan::OK) {
 		m_tArtNetParams.bEnableNoChangeUpdate = (nValue8 != 0);
 		m_tArtNetParams.nSetList |= ArtnetParamsMask::ENABLE_NO_CHANGE_OUTPUT;
@@ -51,4 +51,5 @@ const char ArtNetParamsConst::MERGE_MODE_PORT[artnet::MAX_PORTS][18] = { "merge_
 const char ArtNetParamsConst::PROTOCOL[] = "protocol";
 const char ArtNetParamsConst::PROTOCOL_PORT[artnet::MAX_PORTS][16] = { "protocol_port_a", "protocol_port_b", "protocol_port_c", "protocol_port_d" };
 const char ArtNetParamsConst::DIRECTION[] = "direction";
+const char ArtNetParamsConst::SYNC_LATENCY[] = "sync_latency";
 const char ArtNetParamsConst::DESTINATION_IP_PORT[artnet::MAX_PORTS][24] = { "destination_ip_port_a", "destination_ip_port_b", "destination_ip_port_c", "destination_ip_port_d" };
@@ -121,6 +121,10 @@ void ArtNetParams::Dump() {
 		printf(" %s=%d [%s]\n", LightSetConst::PARAMS_ENABLE_NO_CHANGE_UPDATE, static_cast<int>(m_tArtNetParams.bEnableNoChangeUpdate), BOOL2STRING::Get(m_tArtNetParams.bEnableNoChangeUpdate));
 	}
 
+	if(isMaskSet(ArtnetParamsMask::SYNC_LATENCY)) {
+		printf(" %s=%d [us]\n", ArtNetParamsConst::SYNC_LATENCY, static_cast<int>(m_tArtNetParams.nSyncLatency));
+	}
+
 	if(isMaskSet(ArtnetParamsMask::DIRECTION)) {
 		printf(" %s=%d [%s]\n", ArtNetParamsConst::DIRECTION, static_cast<int>(m_tArtNetParams.nDirection), m_tArtNetParams.nDirection == ARTNET_INPUT_PORT ? "Input" : "Output");
 	}
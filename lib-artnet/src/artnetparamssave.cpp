@@ -91,6 +91,8 @@ void ArtNetParams::Builder(const struct TArtNetParams *pArtNetParams, char *pBuf
 	builder.Add(ArtNetParamsConst::NODE_DISABLE_MERGE_TIMEOUT, m_tArtNetParams.bDisableMergeTimeout, isMaskSet(ArtnetParamsMask::MERGE_TIMEOUT));
 
 	builder.Add(LightSetConst::PARAMS_ENABLE_NO_CHANGE_UPDATE, m_tArtNetParams.bEnableNoChangeUpdate, isMaskSet(ArtnetParamsMask::ENABLE_NO_CHANGE_OUTPUT));
+	// Not set, nSyncLatency can be the padding of a previous release
+	builder.Add(ArtNetParamsConst::SYNC_LATENCY, isMaskSet(ArtnetParamsMask::SYNC_LATENCY) ? m_tArtNetParams.nSyncLatency : static_cast<uint16_t>(ArtNetSyncSchedulerConst::LATENCY_MICROS), isMaskSet(ArtnetParamsMask::SYNC_LATENCY));
 
 	builder.AddComment("DMX Input");
 	for (uint32_t i = 0; i < ARTNET_NODE_MAX_PORTS_INPUT; i++) {
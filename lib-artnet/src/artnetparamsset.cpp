@@ -96,4 +96,8 @@ void ArtNetParams::Set(ArtNetNode *pArtNetNode) {
 	if (isMaskSet(ArtnetParamsMask::ENABLE_NO_CHANGE_OUTPUT)) {
 		pArtNetNode->SetDirectUpdate(m_tArtNetParams.bEnableNoChangeUpdate);
 	}
+
+	if (isMaskSet(ArtnetParamsMask::SYNC_LATENCY)) {
+		pArtNetNode->SetSyncScheduler(true, m_tArtNetParams.nSyncLatency);
+	}
 }
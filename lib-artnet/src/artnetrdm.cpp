@@ -5,7 +5,7 @@
 /**
  * Art-Net Designed by and Copyright Artistic Licence Holdings Ltd.
  */
-/* Copyright (C) 2017-2019 by Arjan van Vught mailto:info@orangepi-dmx.nl
+/* Copyright (C) 2017-2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -26,6 +26,8 @@
  * THE SOFTWARE.
  */
 
+#include <algorithm>
+#include <stdint.h>
 #include <string.h>
 #include <cassert>
 
@@ -36,6 +38,9 @@
 
 #include "artnetnode_internal.h"
 
+/*
+ * AtcFlush starts a full discovery, the TOD is sent when the discovery has finished.
+ */
 void ArtNetNode::HandleTodControl(void) {
 	const struct TArtTodControl *pArtTodControl =  &(m_ArtNetPacket.ArtPacket.ArtTodControl);
 	const uint16_t portAddress = static_cast<uint16_t>((pArtTodControl->Net << 8)) | static_cast<uint16_t>((pArtTodControl->Address));
@@ -43,19 +48,12 @@ void ArtNetNode::HandleTodControl(void) {
 	for (uint32_t i = 0; i < artnet::MAX_PORTS; i++) {
 		if ((portAddress == m_OutputPorts[i].port.nPortAddress) && m_OutputPorts[i].bIsEnabled) {
 
-			if (m_IsLightSetRunning[i] && (!m_IsRdmResponder)) {
-				m_pLightSet->Stop(i);
-			}
-
-			if (pArtTodControl->Command == 0x01) {	// AtcFlush
-				m_pArtNetRdm->Full(i);
+			if ((pArtTodControl->Command == 0x01) && (m_pArtNetRdmQueue != 0)) {	// AtcFlush
+				StartRdmDiscovery(i, false);
+				continue;
 			}
 
 			SendTod(i);
-
-			if (m_IsLightSetRunning[i] && (!m_IsRdmResponder)) {
-				m_pLightSet->Start(i);
-			}
 		}
 	}
 }
@@ -71,25 +69,39 @@ void ArtNetNode::HandleTodRequest(void) {
 	}
 }
 
+/*
+ * A TOD larger than one ArtTodData packet is sent in blocks, BlockCount is the block index.
+ */
 void ArtNetNode::SendTod(uint8_t nPortId) {
 	assert(nPortId < artnet::MAX_PORTS);
 
 	m_pTodData->Net = m_Node.NetSwitch[0];
 	m_pTodData->Address = m_OutputPorts[nPortId].port.nDefaultAddress;
+	m_pTodData->Port = 1 + nPortId;
 
-	const uint8_t discovered = m_pArtNetRdm->GetUidCount(nPortId);
+	const uint32_t nUidTotal = m_pArtNetRdm->GetUidCount(nPortId);
+	const uint32_t nUidsPerBlock = sizeof(m_pTodData->Tod) / sizeof(m_pTodData->Tod[0]);
 
-	m_pTodData->UidTotalHi = 0;
-	m_pTodData->UidTotalLo = discovered;
-	m_pTodData->BlockCount = 0;
-	m_pTodData->UidCount = discovered;
-	m_pTodData->Port = 1 + nPortId;
+	m_pTodData->UidTotalHi = static_cast<uint8_t>(nUidTotal >> 8);
+	m_pTodData->UidTotalLo = static_cast<uint8_t>(nUidTotal);
 
-	m_pArtNetRdm->Copy(nPortId, reinterpret_cast<uint8_t*>(m_pTodData->Tod));
+	uint32_t nIndex = 0;
+	uint8_t nBlockCount = 0;
 
-	const size_t nLength = sizeof(struct TArtTodData) - (sizeof m_pTodData->Tod) + (discovered * 6U);
+	do {
+		const uint32_t nUidCount = std::min(nUidTotal - nIndex, nUidsPerBlock);
 
-	Network::Get()->SendTo(m_nHandle, m_pTodData, nLength, m_Node.IPAddressBroadcast, artnet::UDP_PORT);
+		m_pTodData->BlockCount = nBlockCount++;
+		m_pTodData->UidCount = static_cast<uint8_t>(nUidCount);
+
+		m_pArtNetRdm->Copy(nPortId, reinterpret_cast<uint8_t*>(m_pTodData->Tod), nIndex, nUidCount);
+
+		const uint16_t nLength = static_cast<uint16_t>(sizeof(struct TArtTodData) - (sizeof m_pTodData->Tod) + (nUidCount * 6U));
+
+		Network::Get()->SendTo(m_nHandle, m_pTodData, nLength, m_Node.IPAddressBroadcast, artnet::UDP_PORT);
+
+		nIndex += nUidCount;
+	} while (nIndex < nUidTotal);
 }
 
 void ArtNetNode::SetRdmHandler(ArtNetRdm *pArtNetTRdm, bool IsResponder) {
@@ -111,9 +123,29 @@ void ArtNetNode::SetRdmHandler(ArtNetRdm *pArtNetTRdm, bool IsResponder) {
 			m_pTodData->ProtVerLo = artnet::PROTOCOL_REVISION;
 			m_pTodData->RdmVer = 0x01; // Devices that support RDM STANDARD V1.0 set field to 0x01.
 		}
+
+		if (!IsResponder) {
+			m_pArtNetRdmQueue = new ArtNetRdmQueue;
+			assert(m_pArtNetRdmQueue != 0);
+		}
 	}
 }
 
+void ArtNetNode::SendRdmResponse(struct TArtRdm *pArtRdm, const uint8_t *pResponse, uint32_t nIPAddressTo) {
+	pArtRdm->RdmVer = 0x01;
+
+	const uint16_t nMessageLength = pResponse[2] + 1;
+	memcpy(pArtRdm->RdmPacket, &pResponse[1], nMessageLength);
+
+	const uint16_t nLength = sizeof(struct TArtRdm) - sizeof(pArtRdm->RdmPacket) + nMessageLength;
+
+	Network::Get()->SendTo(m_nHandle, pArtRdm, nLength, nIPAddressTo, artnet::UDP_PORT);
+}
+
+/*
+ * The RDM controller queues the request, the transaction is run by HandleRdmQueue.
+ * The RDM responder is local, the response is sent immediately.
+ */
 void ArtNetNode::HandleRdm(void) {
 	struct TArtRdm *pArtRdm = &(m_ArtNetPacket.ArtPacket.ArtRdm);
 	const uint16_t portAddress = static_cast<uint16_t>((pArtRdm->Net << 8)) | static_cast<uint16_t>((pArtRdm->Address));
@@ -121,35 +153,255 @@ void ArtNetNode::HandleRdm(void) {
 	for (uint32_t i = 0; i < artnet::MAX_PORTS; i++) {
 		if ((portAddress == m_OutputPorts[i].port.nPortAddress) && m_OutputPorts[i].bIsEnabled) {
 
-			if (!m_IsRdmResponder) {
-				if ((m_OutputPorts[i].tPortProtocol == PORT_ARTNET_SACN) && (m_pArtNet4Handler != 0)) {
-					const uint8_t nMask = GO_OUTPUT_IS_MERGING | GO_DATA_IS_BEING_TRANSMITTED | GO_OUTPUT_IS_SACN;
-					m_IsLightSetRunning[i] = (m_pArtNet4Handler->GetStatus(i) & nMask) != 0;
-				}
+			if (m_pArtNetRdmQueue != 0) {
+				m_pArtNetRdmQueue->Push(i, pArtRdm, m_ArtNetPacket.IPAddressFrom, m_nCurrentPacketMillis);
+				continue;
+			}
+
+			const uint8_t *pResponse = m_pArtNetRdm->Handler(i, pArtRdm->RdmPacket);
+
+			if (pResponse != 0) {
+				SendRdmResponse(pArtRdm, pResponse, m_ArtNetPacket.IPAddressFrom);
+			}
+		}
+	}
+}
+
+/*
+ * Called from the main loop, it never waits for the RDM response.
+ * The DMX output of the port is stopped at the end of the current DMX frame,
+ * and it is resumed as soon as the response is received or the transaction has timed out.
+ * A broadcast request has no response, DMX is resumed directly after it has been sent.
+ */
+void ArtNetNode::HandleRdmQueue(void) {
+	for (uint32_t i = 0; i < artnet::MAX_PORTS; i++) {
+		if (IsRdmDiscoverySlot(i) || m_pArtNetRdm->IsPollRunning(i)) {
+			continue;
+		}
+
+		if (m_pArtNetRdmQueue->IsActive(i)) {
+			const uint8_t *pResponse = m_pArtNetRdm->ReceiveResponse(i);
+
+			if (pResponse != 0) {
+				struct TArtNetRdmRequest *pRequest = m_pArtNetRdmQueue->Front(i);
+				SendRdmResponse(&pRequest->ArtRdm, pResponse, pRequest->nIPAddressFrom);
+				m_pArtNetRdmQueue->Complete(i, m_nCurrentPacketMillis);
+			} else if (m_pArtNetRdmQueue->IsTimedOut(i, m_nCurrentPacketMillis)) {
+				m_pArtNetRdmQueue->TimeOut(i, m_nCurrentPacketMillis);
+			} else {
+				continue;
+			}
+
+			if (m_IsLightSetRunning[i]) {
+				m_pLightSet->Start(i); // Resume DMX
+			}
+
+			continue;
+		}
+
+		if (m_pArtNetRdmQueue->IsEmpty(i)) {
+			continue;
+		}
+
+		if (IsRdmLightSetRunning(i)) {
+			if (!m_pArtNetRdmQueue->IsDmxFrameSent(i, m_nCurrentPacketMillis)) {
+				continue;
+			}
+
+			m_pLightSet->Stop(i);
+		}
+
+		const struct TArtRdm *pArtRdm = &m_pArtNetRdmQueue->Front(i)->ArtRdm;
+
+		m_pArtNetRdm->SendRequest(i, pArtRdm->RdmPacket);
+
+		if (!ArtNetRdmQueue::IsResponseExpected(pArtRdm)) {
+			m_pArtNetRdmQueue->NoResponse(i, m_nCurrentPacketMillis);
+
+			if (m_IsLightSetRunning[i]) {
+				m_pLightSet->Start(i); // Resume DMX
+			}
+
+			continue;
+		}
+
+		m_pArtNetRdmQueue->Start(i, m_nCurrentPacketMillis);
+	}
+}
+
+void ArtNetNode::StartRdmDiscovery(uint32_t nPort, bool bIncremental) {
+	m_pArtNetRdmQueue->Abort(nPort);
+
+	while (m_pArtNetRdm->RunPoll(nPort)) {
+		// A poll transaction takes a few milliseconds at most
+	}
+
+	if (IsRdmLightSetRunning(nPort)) {
+		m_pLightSet->Stop(nPort);
+	}
+
+	m_pArtNetRdm->StartDiscovery(nPort, bIncremental);
+
+	m_nRdmDiscoverySlotMillis[nPort] = m_nCurrentPacketMillis;
+	m_bRdmDiscoveryGap[nPort] = false;
+}
+
+/*
+ * Called from the main loop, one discovery step per port.
+ * The discovery is interleaved with the DMX output, the DMX output of the port is stopped for a slot of
+ * DISCOVERY_SLOT_MILLIS and after each slot it runs for at least one DMX frame.
+ * An ArtRdm request can be handled in the gap between two slots.
+ * An incremental discovery is started periodically, ArtTodData is only sent when the TOD has changed.
+ */
+void ArtNetNode::HandleRdmDiscovery(void) {
+	for (uint32_t i = 0; i < artnet::MAX_PORTS; i++) {
+		if (!m_OutputPorts[i].bIsEnabled) {
+			continue;
+		}
 
-				if (m_IsLightSetRunning[i]) {
-					m_pLightSet->Stop(i); // Stop DMX if was running
+		if (m_pArtNetRdm->IsDiscoveryRunning(i)) {
+			if (m_bRdmDiscoveryGap[i] && !m_pArtNetRdmQueue->IsEmpty(i)) {
+				continue;	// The ArtRdm requests go first
+			}
+
+			if (!m_pArtNetRdm->IsDiscoveryWaiting(i)) {
+				if (m_bRdmDiscoveryGap[i]) {
+					if (!m_pArtNetRdmQueue->IsDmxFrameSent(i, m_nCurrentPacketMillis)) {
+						continue;
+					}
+
+					if (IsRdmLightSetRunning(i)) {
+						m_pLightSet->Stop(i);
+					}
+
+					m_nRdmDiscoverySlotMillis[i] = m_nCurrentPacketMillis;
+					m_bRdmDiscoveryGap[i] = false;
+				} else if ((m_nCurrentPacketMillis - m_nRdmDiscoverySlotMillis[i]) >= ArtNetRdmConst::DISCOVERY_SLOT_MILLIS) {
+					m_pArtNetRdmQueue->DmxResumed(i, m_nCurrentPacketMillis);
+					m_bRdmDiscoveryGap[i] = true;
+
+					if (m_IsLightSetRunning[i]) {
+						m_pLightSet->Start(i); // Resume DMX
+					}
+
+					continue;
 				}
 			}
 
-			const uint8_t *response = const_cast<uint8_t*>(m_pArtNetRdm->Handler(i, pArtRdm->RdmPacket));
+			if (m_pArtNetRdm->RunDiscovery(i)) {
+				continue;
+			}
+
+			m_nRdmDiscoveryMillis[i] = m_nCurrentPacketMillis;
+			m_pArtNetRdmQueue->DmxResumed(i, m_nCurrentPacketMillis);
+			m_bRdmDiscoveryGap[i] = false;
+
+			if (m_pArtNetRdm->IsTodChanged(i)) {
+				SendTod(i);
+			}
 
-			if (response != 0) {
-				pArtRdm->RdmVer = 0x01;
+			if (m_IsLightSetRunning[i]) {
+				m_pLightSet->Start(i); // Resume DMX
+			}
 
-				const uint16_t nMessageLength = response[2] + 1;
-				memcpy(pArtRdm->RdmPacket, &response[1], nMessageLength);
+			continue;
+		}
 
-				const uint16_t nLength = sizeof(struct TArtRdm) - sizeof(pArtRdm->RdmPacket) + nMessageLength;
+		if ((m_nRdmDiscoveryIntervalMillis == 0) || m_pArtNetRdmQueue->IsActive(i) || m_pArtNetRdm->IsPollRunning(i)) {
+			continue;
+		}
 
-				Network::Get()->SendTo(m_nHandle, pArtRdm, nLength, m_ArtNetPacket.IPAddressFrom, artnet::UDP_PORT);
-			} else {
-				//printf("\n==> No response <==\n");
+		if ((m_nCurrentPacketMillis - m_nRdmDiscoveryMillis[i]) >= m_nRdmDiscoveryIntervalMillis) {
+			StartRdmDiscovery(i, true);
+		}
+	}
+}
+
+/*
+ * Called from the main loop, the polling only uses the bus time left by the ArtRdm requests and the discovery.
+ * After each transaction the DMX output runs long enough to keep the refresh rate at or above m_nRdmPollDmxFpsMin.
+ */
+void ArtNetNode::HandleRdmPoll(void) {
+	const uint32_t nDmxFpsMax = 1000 / ArtNetRdmQueueConst::DMX_FRAME_MILLIS;
+
+	for (uint32_t i = 0; i < artnet::MAX_PORTS; i++) {
+		if (!m_OutputPorts[i].bIsEnabled) {
+			continue;
+		}
+
+		if (m_pArtNetRdm->IsPollRunning(i)) {
+			if (m_pArtNetRdm->RunPoll(i)) {
+				continue;
 			}
 
-			if (m_IsLightSetRunning[i] && (!m_IsRdmResponder)) {
-				m_pLightSet->Start(i); // Start DMX if was running
+			const uint32_t nDurationMillis = std::max(m_nCurrentPacketMillis - m_nRdmPollStartMillis[i], static_cast<uint32_t>(1));
+
+			m_nRdmPollGapMillis[i] = std::max((nDurationMillis * m_nRdmPollDmxFpsMin) / (nDmxFpsMax - m_nRdmPollDmxFpsMin), ArtNetRdmQueueConst::DMX_FRAME_MILLIS);
+			m_nRdmPollEndMillis[i] = m_nCurrentPacketMillis;
+
+			if (m_IsLightSetRunning[i]) {
+				m_pLightSet->Start(i); // Resume DMX
 			}
+
+			continue;
+		}
+
+		if (!m_bRdmPoll || (m_nRdmPollDmxFpsMin >= nDmxFpsMax)) {
+			continue;
+		}
+
+		if (m_pArtNetRdm->IsDiscoveryRunning(i) || !m_pArtNetRdmQueue->IsEmpty(i) || (m_pArtNetRdm->GetUidCount(i) == 0)) {
+			continue;
+		}
+
+		if (((m_nCurrentPacketMillis - m_nRdmPollEndMillis[i]) < m_nRdmPollGapMillis[i]) || !m_pArtNetRdmQueue->IsDmxFrameSent(i, m_nCurrentPacketMillis)) {
+			continue;
+		}
+
+		const bool bIsLightSetRunning = IsRdmLightSetRunning(i);
+
+		if (bIsLightSetRunning) {
+			m_pLightSet->Stop(i);
+		}
+
+		if (m_pArtNetRdm->StartPoll(i)) {
+			m_nRdmPollStartMillis[i] = m_nCurrentPacketMillis;
+		} else if (bIsLightSetRunning) {
+			m_pLightSet->Start(i);
 		}
 	}
 }
+
+/*
+ * The RDM controller owns the line while a transaction, a poll or a discovery slot is running.
+ * The DMX output is then not started, it is resumed when the RDM controller has finished.
+ */
+bool ArtNetNode::IsRdmBusy(uint32_t nPort) {
+	if ((m_pArtNetRdmQueue == 0) || (nPort >= artnet::MAX_PORTS)) {
+		return false;
+	}
+
+	return m_pArtNetRdmQueue->IsActive(nPort) || m_pArtNetRdm->IsPollRunning(nPort) || IsRdmDiscoverySlot(nPort);
+}
+
+bool ArtNetNode::IsRdmDiscoverySlot(uint32_t nPort) {
+	return m_pArtNetRdm->IsDiscoveryRunning(nPort) && !m_bRdmDiscoveryGap[nPort];
+}
+
+void ArtNetNode::StartLightSet(uint32_t nPort) {
+	if (!IsRdmBusy(nPort)) {
+		m_pLightSet->Start(nPort);
+	}
+}
+
+/*
+ * With sACN merged in, the DMX output can run without any Art-Net input
+ */
+bool ArtNetNode::IsRdmLightSetRunning(uint32_t nPort) {
+	if ((m_OutputPorts[nPort].tPortProtocol == PORT_ARTNET_SACN) && (m_pArtNet4Handler != 0)) {
+		const uint8_t nMask = GO_OUTPUT_IS_MERGING | GO_DATA_IS_BEING_TRANSMITTED | GO_OUTPUT_IS_SACN;
+		m_IsLightSetRunning[nPort] = (m_pArtNet4Handler->GetStatus(nPort) & nMask) != 0;
+	}
+
+	return m_IsLightSetRunning[nPort];
+}
@@ -0,0 +1,147 @@
+/**
+ * @file artnetrdmqueue.cpp
+ *
+ */
+/**
+ * Art-Net Designed by and Copyright Artistic Licence Holdings Ltd.
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cassert>
+
+#include "artnetrdmqueue.h"
+
+#include "debug.h"
+
+ArtNetRdmQueue::ArtNetRdmQueue() {
+	for (uint32_t i = 0; i < artnet::MAX_PORTS; i++) {
+		m_aPort[i].nHead = 0;
+		m_aPort[i].nCount = 0;
+		m_aPort[i].nStartMillis = 0;
+		m_aPort[i].nEndMillis = 0;
+		m_aPort[i].bIsActive = false;
+	}
+}
+
+bool ArtNetRdmQueue::Push(uint32_t nPort, const struct TArtRdm *pArtRdm, uint32_t nIPAddressFrom, uint32_t nMillis) {
+	assert(nPort < artnet::MAX_PORTS);
+	assert(pArtRdm != nullptr);
+
+	TPort &Port = m_aPort[nPort];
+
+	if (Port.nCount == ArtNetRdmQueueConst::DEPTH) {
+		m_nDropped++;
+		return false;
+	}
+
+	auto &Request = Port.aRequest[(Port.nHead + Port.nCount) % ArtNetRdmQueueConst::DEPTH];
+
+	memcpy(&Request.ArtRdm, pArtRdm, sizeof(struct TArtRdm));
+	Request.nIPAddressFrom = nIPAddressFrom;
+	Request.nQueuedMillis = nMillis;
+
+	Port.nCount++;
+	m_nQueued++;
+
+	if (Port.nCount > m_nDepthMax) {
+		m_nDepthMax = Port.nCount;
+	}
+
+	DEBUG_PRINTF("nPort=%d, nCount=%d", static_cast<int>(nPort), static_cast<int>(Port.nCount));
+	return true;
+}
+
+void ArtNetRdmQueue::Start(uint32_t nPort, uint32_t nMillis) {
+	assert(nPort < artnet::MAX_PORTS);
+	assert(!IsEmpty(nPort));
+
+	m_aPort[nPort].nStartMillis = nMillis;
+	m_aPort[nPort].bIsActive = true;
+}
+
+void ArtNetRdmQueue::Complete(uint32_t nPort, uint32_t nMillis) {
+	assert(nPort < artnet::MAX_PORTS);
+
+	const uint32_t nLatencyMillis = nMillis - Front(nPort)->nQueuedMillis;
+
+	m_nLatencyMillisTotal += nLatencyMillis;
+
+	if (nLatencyMillis > m_nLatencyMillisMax) {
+		m_nLatencyMillisMax = nLatencyMillis;
+	}
+
+	m_nCompleted++;
+	m_aPort[nPort].nEndMillis = nMillis;
+	Pop(nPort);
+}
+
+void ArtNetRdmQueue::TimeOut(uint32_t nPort, uint32_t nMillis) {
+	assert(nPort < artnet::MAX_PORTS);
+
+	m_nTimedOut++;
+	m_aPort[nPort].nEndMillis = nMillis;
+	Pop(nPort);
+}
+
+/*
+ * The request has been sent and no response is expected, the transaction is finished without waiting
+ */
+void ArtNetRdmQueue::NoResponse(uint32_t nPort, uint32_t nMillis) {
+	assert(nPort < artnet::MAX_PORTS);
+
+	m_nNoResponse++;
+	m_aPort[nPort].nEndMillis = nMillis;
+	Pop(nPort);
+}
+
+void ArtNetRdmQueue::Abort(uint32_t nPort) {
+	assert(nPort < artnet::MAX_PORTS);
+
+	if (m_aPort[nPort].bIsActive) {
+		m_nAborted++;
+		Pop(nPort);
+	}
+}
+
+void ArtNetRdmQueue::Pop(uint32_t nPort) {
+	TPort &Port = m_aPort[nPort];
+
+	assert(Port.nCount != 0);
+
+	Port.nHead = (Port.nHead + 1) % ArtNetRdmQueueConst::DEPTH;
+	Port.nCount--;
+	Port.bIsActive = false;
+}
+
+void ArtNetRdmQueue::Print() {
+	printf(" RDM queue\n");
+	printf("  Requests : %d queued, %d dropped, max depth %d\n", static_cast<int>(m_nQueued), static_cast<int>(m_nDropped), static_cast<int>(m_nDepthMax));
+	printf("  Replies  : %d completed, %d timed out, %d aborted\n", static_cast<int>(m_nCompleted), static_cast<int>(m_nTimedOut), static_cast<int>(m_nAborted));
+	printf("  No reply : %d broadcast\n", static_cast<int>(m_nNoResponse));
+
+	if (m_nCompleted != 0) {
+		printf("  Latency  : %d ms average, %d ms max\n", static_cast<int>(m_nLatencyMillisTotal / m_nCompleted), static_cast<int>(m_nLatencyMillisMax));
+	}
+}
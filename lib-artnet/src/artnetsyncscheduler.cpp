@@ -0,0 +1,184 @@
+/**
+ * @file artnetsyncscheduler.cpp
+ *
+ */
+/**
+ * Art-Net Designed by and Copyright Artistic Licence Holdings Ltd.
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cassert>
+
+#include "artnetsyncscheduler.h"
+
+#include "debug.h"
+
+namespace {
+// Upper bounds of the histogram bins in microseconds, the last bin is open ended
+constexpr uint32_t s_aBinMicros[ArtNetSyncSchedulerConst::HISTOGRAM_BINS - 1] = { 100, 250, 500, 1000, 2000, 5000, 10000 };
+}
+
+ArtNetSyncScheduler::ArtNetSyncScheduler(uint32_t nLatencyMicros) : m_nLatencyMicros(nLatencyMicros) {
+	DEBUG_PRINTF("m_nLatencyMicros=%d", static_cast<int>(m_nLatencyMicros));
+}
+
+/**
+ * Entering synchronous mode, the statistics are kept
+ */
+void ArtNetSyncScheduler::Reset() {
+	m_nPeriodMicros = 0;
+	m_nExtrapolatedCount = 0;
+	m_bHasSync = false;
+	m_bIsPending = false;
+}
+
+void ArtNetSyncScheduler::Sync(uint32_t nNowMicros) {
+	m_nSyncs++;
+
+	if (m_nPeriodMicros == 0) {
+		if (m_bHasSync) {
+			const uint32_t nInterval = nNowMicros - m_nLastSyncMicros;
+
+			if ((nInterval >= ArtNetSyncSchedulerConst::PERIOD_MIN_MICROS) && (nInterval <= ArtNetSyncSchedulerConst::PERIOD_MAX_MICROS)) {
+				m_nPeriodMicros = nInterval;
+				DEBUG_PRINTF("m_nPeriodMicros=%d", static_cast<int>(m_nPeriodMicros));
+			}
+		}
+
+		m_bHasSync = true;
+		m_nLastSyncMicros = nNowMicros;
+		m_nNextMicros = nNowMicros + m_nPeriodMicros;
+		Schedule(nNowMicros + GetLatencyMicros());
+		return;
+	}
+
+	// A missing ArtSync doubles the interval, it does not disturb the period estimate
+	const uint32_t nInterval = nNowMicros - m_nLastSyncMicros;
+	uint32_t nPeriods = (nInterval + (m_nPeriodMicros / 2)) / m_nPeriodMicros;
+
+	if (nPeriods == 0) {
+		nPeriods = 1;
+	}
+
+	const int32_t nDeviation = static_cast<int32_t>(nInterval / nPeriods) - static_cast<int32_t>(m_nPeriodMicros);
+
+	if (static_cast<uint32_t>(abs(nDeviation)) < (m_nPeriodMicros / 4)) {
+		m_nPeriodMicros = static_cast<uint32_t>(static_cast<int32_t>(m_nPeriodMicros) + (nDeviation / (1 << ArtNetSyncSchedulerConst::FILTER_SHIFT)));
+	}
+
+	m_nLastSyncMicros = nNowMicros;
+
+	const int32_t nHalfPeriod = static_cast<int32_t>(m_nPeriodMicros / 2);
+	int32_t nError = static_cast<int32_t>(nNowMicros - m_nNextMicros);
+
+	if ((m_nExtrapolatedCount != 0) && (nError < -nHalfPeriod)) {
+		// Late ArtSync of the frame which has been presented on the extrapolated cadence
+		nError += static_cast<int32_t>(m_nPeriodMicros);
+		m_nLate++;
+		Count(m_aSyncJitter, nError);
+
+		m_nNextMicros += static_cast<uint32_t>(nError / (1 << ArtNetSyncSchedulerConst::FILTER_SHIFT));
+		m_nExtrapolatedCount = 0;
+		// The data received after the extrapolated presentation
+		Schedule(nNowMicros);
+		return;
+	}
+
+	m_nExtrapolatedCount = 0;
+	Count(m_aSyncJitter, nError);
+
+	uint32_t nSyncMicros;
+
+	if (abs(nError) > nHalfPeriod) {
+		m_nResyncs++;
+		nSyncMicros = nNowMicros;
+	} else {
+		nSyncMicros = m_nNextMicros + static_cast<uint32_t>(nError / (1 << ArtNetSyncSchedulerConst::FILTER_SHIFT));
+	}
+
+	m_nNextMicros = nSyncMicros + m_nPeriodMicros;
+	Schedule(nSyncMicros + GetLatencyMicros());
+}
+
+/**
+ * @return true when the buffered frame must be presented now
+ */
+bool ArtNetSyncScheduler::IsDue(uint32_t nNowMicros) {
+	if (!m_bIsPending && (m_nPeriodMicros != 0) && (m_nExtrapolatedCount < ArtNetSyncSchedulerConst::EXTRAPOLATE_MAX)) {
+		const uint32_t nPresentMicros = m_nNextMicros + GetLatencyMicros();
+
+		if (static_cast<int32_t>(nNowMicros - nPresentMicros) >= 0) {
+			m_nExtrapolatedCount++;
+			m_nExtrapolated++;
+			m_nNextMicros += m_nPeriodMicros;
+			Schedule(nPresentMicros);
+		}
+	}
+
+	return m_bIsPending && (static_cast<int32_t>(nNowMicros - m_nPresentMicros) >= 0);
+}
+
+void ArtNetSyncScheduler::Presented(uint32_t nNowMicros, bool bIsEarly) {
+	assert(m_bIsPending);
+
+	m_bIsPending = false;
+	m_nPresented++;
+
+	if (bIsEarly) {
+		m_nEarly++;
+	}
+
+	Count(m_aOutputJitter, static_cast<int32_t>(nNowMicros - m_nPresentMicros));
+}
+
+void ArtNetSyncScheduler::Count(uint32_t *pHistogram, int32_t nErrorMicros) {
+	const uint32_t nMicros = static_cast<uint32_t>(abs(nErrorMicros));
+	uint32_t nBin = 0;
+
+	while ((nBin < (ArtNetSyncSchedulerConst::HISTOGRAM_BINS - 1)) && (nMicros >= s_aBinMicros[nBin])) {
+		nBin++;
+	}
+
+	pHistogram[nBin]++;
+}
+
+void ArtNetSyncScheduler::PrintHistogram(const char *pName, const uint32_t *pHistogram) {
+	printf("  %-8s :", pName);
+
+	for (uint32_t nBin = 0; nBin < (ArtNetSyncSchedulerConst::HISTOGRAM_BINS - 1); nBin++) {
+		printf(" <%d:%d", static_cast<int>(s_aBinMicros[nBin]), static_cast<int>(pHistogram[nBin]));
+	}
+
+	printf(" >=%d:%d us\n", static_cast<int>(s_aBinMicros[ArtNetSyncSchedulerConst::HISTOGRAM_BINS - 2]), static_cast<int>(pHistogram[ArtNetSyncSchedulerConst::HISTOGRAM_BINS - 1]));
+}
+
+void ArtNetSyncScheduler::Print() {
+	printf(" ArtSync scheduler\n");
+	printf("  Period   : %d us, latency %d us%s\n", static_cast<int>(m_nPeriodMicros), static_cast<int>(m_nLatencyMicros), ((m_nPeriodMicros != 0) && IsLatencyRejected()) ? " rejected, not less than the period" : "");
+	printf("  ArtSync  : %d received, %d resync, %d late, %d extrapolated\n", static_cast<int>(m_nSyncs), static_cast<int>(m_nResyncs), static_cast<int>(m_nLate), static_cast<int>(m_nExtrapolated));
+	printf("  Frames   : %d presented, %d early\n", static_cast<int>(m_nPresented), static_cast<int>(m_nEarly));
+	PrintHistogram("Jitter", m_aSyncJitter);
+	PrintHistogram("Output", m_aOutputJitter);
+}
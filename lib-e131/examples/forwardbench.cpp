@@ -0,0 +1,357 @@
+/**
+ * @file forwardbench.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Host benchmark of the E1.31 to Art-Net bridge (opi_emac_e131_artnet), 32 universes at 44 Hz.
+ * - A universe output on one port is forwarded in place, the ArtDmx header replaces the E1.31 layers.
+ * - A universe output on more than one port takes the copy path, it is sent on every port.
+ * - The last frame of each universe is checked on the network, for the copy path and for the forward path.
+ * The time in E131Bridge::Run() is measured per frame, the network is simulated in-process.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "hardware.h"
+#include "ledblink.h"
+
+#include "e131bridge.h"
+#include "e131packets.h"
+#include "e117const.h"
+
+#include "artnetcontroller.h"
+#include "artnetoutput.h"
+#include "packets.h"
+
+#include "simnetwork.h"
+
+static constexpr uint32_t REFRESH_HZ = 44;
+static constexpr uint32_t SECONDS = 60;
+static constexpr uint32_t RUNS = 5;
+static constexpr uint16_t SLOTS = E131_DMX_LENGTH;
+static constexpr uint8_t SOURCE_CID[E131_CID_LENGTH] = {0x5e, 0x3a, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01};
+
+static uint32_t s_nFailures;
+
+static void Check(bool bCondition, const char *pText) {
+	printf("%s : %s\n", bCondition ? "PASS" : "FAIL", pText);
+
+	if (!bCondition) {
+		s_nFailures++;
+	}
+}
+
+static uint8_t Slot(uint16_t nUniverse, uint32_t nFrame, uint32_t nSlot) {
+	return static_cast<uint8_t>((nUniverse * 7) + nFrame + nSlot);
+}
+
+/*
+ * One source, a packet per universe. Only the sequence number and the slots change per frame.
+ */
+class Source {
+public:
+	Source(void) {
+		for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+			struct TE131DataPacket *p = &m_aPacket[i];
+
+			memset(p, 0, sizeof(struct TE131DataPacket));
+			// Root Layer (See Section 5)
+			p->RootLayer.PreAmbleSize = __builtin_bswap16(0x0010);
+			p->RootLayer.PostAmbleSize = __builtin_bswap16(0x0000);
+			memcpy(p->RootLayer.ACNPacketIdentifier, E117Const::ACN_PACKET_IDENTIFIER, E117_PACKET_IDENTIFIER_LENGTH);
+			p->RootLayer.FlagsLength = __builtin_bswap16((0x07 << 12) | (DATA_ROOT_LAYER_LENGTH(1U + SLOTS)));
+			p->RootLayer.Vector = __builtin_bswap32(E131_VECTOR_ROOT_DATA);
+			memcpy(p->RootLayer.Cid, SOURCE_CID, E131_CID_LENGTH);
+			// E1.31 Framing Layer (See Section 6)
+			p->FrameLayer.FLagsLength = __builtin_bswap16((0x07 << 12) | (DATA_FRAME_LAYER_LENGTH(1U + SLOTS)));
+			p->FrameLayer.Vector = __builtin_bswap32(E131_VECTOR_DATA_PACKET);
+			strcpy(reinterpret_cast<char *>(p->FrameLayer.SourceName), "forwardbench");
+			p->FrameLayer.Priority = E131_PRIORITY_DEFAULT;
+			p->FrameLayer.Universe = __builtin_bswap16(static_cast<uint16_t>(i + 1));
+			// Data Layer
+			p->DMPLayer.FlagsLength = __builtin_bswap16((0x07 << 12) | (DATA_LAYER_LENGTH(1U + SLOTS)));
+			p->DMPLayer.Vector = E131_VECTOR_DMP_SET_PROPERTY;
+			p->DMPLayer.Type = 0xa1;
+			p->DMPLayer.FirstAddressProperty = __builtin_bswap16(0x0000);
+			p->DMPLayer.AddressIncrement = __builtin_bswap16(0x0001);
+			p->DMPLayer.PropertyValueCount = __builtin_bswap16(1U + SLOTS);
+		}
+	}
+
+	const struct TE131DataPacket *Fill(uint16_t nUniverse, uint32_t nFrame) {
+		struct TE131DataPacket *p = &m_aPacket[nUniverse - 1];
+
+		p->FrameLayer.SequenceNumber = static_cast<uint8_t>(nFrame);
+
+		for (uint32_t i = 0; i < SLOTS; i++) {
+			p->DMPLayer.PropertyValues[1 + i] = Slot(nUniverse, nFrame, i);
+		}
+
+		return p;
+	}
+
+	static constexpr uint16_t PACKET_SIZE = DATA_PACKET_SIZE(1U + SLOTS);
+
+private:
+	struct TE131DataPacket m_aPacket[E131_MAX_PORTS];
+};
+
+/*
+ * Counts the packets which are forwarded, per port
+ */
+class CountingOutput final: public ArtNetOutput {
+public:
+	using ArtNetOutput::Handler;
+
+	void Handler(uint8_t nPortIndex, uint8_t *pData, uint16_t nLength) override {
+		m_nForwarded[nPortIndex]++;
+		ArtNetOutput::Handler(nPortIndex, pData, nLength);
+	}
+
+	uint32_t m_nForwarded[E131_MAX_PORTS]{};
+};
+
+/*
+ * The ArtDmx packets sent by the controller are copied, as the emac does into the transmit buffer,
+ * and the last one of each port is kept.
+ */
+class ControllerNetwork final: public SimNetwork {
+public:
+	ControllerNetwork(void) {
+		Clear();
+	}
+
+	void Clear(void) {
+		memset(m_aArtDmx, 0, sizeof(m_aArtDmx));
+		memset(m_nArtDmxSent, 0, sizeof(m_nArtDmxSent));
+	}
+
+	uint32_t GetArtDmxSent(uint8_t nPortIndex) const {
+		return m_nArtDmxSent[nPortIndex];
+	}
+
+	const struct TArtDmx *GetArtDmx(uint8_t nPortIndex) const {
+		return &m_aArtDmx[nPortIndex];
+	}
+
+protected:
+	void Sent(const uint8_t *pBuffer, uint16_t nLength, __attribute__((unused)) uint32_t nToIp, __attribute__((unused)) uint16_t nRemotePort) override {
+		const struct TArtDmx *pArtDmx = reinterpret_cast<const struct TArtDmx*>(pBuffer);
+
+		if ((nLength > sizeof(struct TArtDmx)) || (pArtDmx->OpCode != OP_DMX) || (pArtDmx->Physical >= E131_MAX_PORTS)) {
+			return;
+		}
+
+		memcpy(&m_aArtDmx[pArtDmx->Physical], pBuffer, nLength);
+		m_nArtDmxSent[pArtDmx->Physical]++;
+	}
+
+private:
+	struct TArtDmx m_aArtDmx[E131_MAX_PORTS];
+	uint32_t m_nArtDmxSent[E131_MAX_PORTS];
+};
+
+static void SendFrame(E131Bridge &bridge, ControllerNetwork &network, Source &source, uint32_t nUniverses, uint32_t nFrame) {
+	for (uint32_t nUniverse = 1; nUniverse <= nUniverses; nUniverse++) {
+		network.Push(source.Fill(static_cast<uint16_t>(nUniverse), nFrame), Source::PACKET_SIZE, E131_DEFAULT_PORT);
+		bridge.Run();
+	}
+}
+
+/*
+ * The port has sent the ArtDmx of the universe with the slots of the frame
+ */
+static bool IsSent(const ControllerNetwork &network, uint8_t nPortIndex, uint16_t nUniverse, uint32_t nFrame) {
+	const struct TArtDmx *pArtDmx = network.GetArtDmx(nPortIndex);
+
+	if ((pArtDmx->PortAddress != nUniverse) || (((pArtDmx->LengthHi << 8) | pArtDmx->Length) != SLOTS)) {
+		return false;
+	}
+
+	for (uint32_t i = 0; i < SLOTS; i++) {
+		if (pArtDmx->Data[i] != Slot(nUniverse, nFrame, i)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void TestSharedUniverse(ControllerNetwork &network) {
+	puts("Ports 0 and 1 output universe 1, port 2 outputs universe 2");
+
+	network.Clear();
+
+	ArtNetController controller;
+	controller.SetUnicast(false);
+	controller.Start();
+
+	E131Bridge bridge;
+	CountingOutput output;
+
+	bridge.SetOutput(&output);
+	bridge.SetE131Forward(&output);
+	bridge.SetUniverse(0, E131_OUTPUT_PORT, 1);
+	bridge.SetUniverse(1, E131_OUTPUT_PORT, 1);
+	bridge.SetUniverse(2, E131_OUTPUT_PORT, 2);
+	bridge.Start();
+
+	Source source;
+	uint32_t nFrame;
+
+	for (nFrame = 0; nFrame < 3; nFrame++) {
+		SendFrame(bridge, network, source, 2, nFrame);
+	}
+
+	Check(IsSent(network, 0, 1, nFrame - 1) && IsSent(network, 1, 1, nFrame - 1), "universe 1 is output on port 0 and on port 1");
+	Check(IsSent(network, 2, 2, nFrame - 1), "universe 2 is output on port 2");
+	Check((output.m_nForwarded[0] == 0) && (output.m_nForwarded[1] == 0), "universe 1 takes the copy path");
+	Check(output.m_nForwarded[2] == nFrame, "universe 2 is forwarded");
+
+	bridge.SetUniverse(1, E131_DISABLE_PORT, 1);
+
+	SendFrame(bridge, network, source, 2, nFrame);
+
+	Check((output.m_nForwarded[0] == 1) && IsSent(network, 0, 1, nFrame), "universe 1 is forwarded after port 1 is disabled");
+
+	bridge.Stop();
+}
+
+struct BenchResult {
+	double fMicrosPerPacket;
+	double fFrameMicrosMax;
+	bool bIsComplete;
+};
+
+/*
+ * Port i outputs universe (i % nUniverses) + 1, the best of RUNS is reported
+ */
+static BenchResult Bench(ControllerNetwork &network, bool bForward, uint32_t nUniverses) {
+	BenchResult result = { 1e9, 0, true };
+
+	for (uint32_t nRun = 0; nRun < RUNS; nRun++) {
+		network.Clear();
+
+		ArtNetController controller;
+		controller.SetUnicast(false);
+		controller.Start();
+
+		E131Bridge bridge;
+		ArtNetOutput output;
+
+		bridge.SetOutput(&output);
+
+		if (bForward) {
+			bridge.SetE131Forward(&output);
+		}
+
+		for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+			bridge.SetUniverse(static_cast<uint8_t>(i), E131_OUTPUT_PORT, static_cast<uint16_t>((i % nUniverses) + 1));
+		}
+
+		bridge.Start();
+
+		Source source;
+		const uint32_t nFrames = REFRESH_HZ * SECONDS;
+		double fTotalMicros = 0;
+		double fFrameMicrosMax = 0;
+
+		for (uint32_t nFrame = 0; nFrame < nFrames; nFrame++) {
+			const struct TE131DataPacket *aPacket[E131_MAX_PORTS];
+
+			for (uint32_t nUniverse = 1; nUniverse <= nUniverses; nUniverse++) {
+				aPacket[nUniverse - 1] = source.Fill(static_cast<uint16_t>(nUniverse), nFrame);
+			}
+
+			struct timespec start, end;
+			clock_gettime(CLOCK_MONOTONIC, &start);
+
+			for (uint32_t i = 0; i < nUniverses; i++) {
+				network.Push(aPacket[i], Source::PACKET_SIZE, E131_DEFAULT_PORT);
+				bridge.Run();
+			}
+
+			clock_gettime(CLOCK_MONOTONIC, &end);
+
+			const double fFrameMicros = static_cast<double>(end.tv_sec - start.tv_sec) * 1e6 + static_cast<double>(end.tv_nsec - start.tv_nsec) / 1e3;
+
+			fTotalMicros += fFrameMicros;
+
+			if (fFrameMicros > fFrameMicrosMax) {
+				fFrameMicrosMax = fFrameMicros;
+			}
+		}
+
+		for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+			result.bIsComplete &= IsSent(network, static_cast<uint8_t>(i), static_cast<uint16_t>((i % nUniverses) + 1), nFrames - 1);
+		}
+
+		bridge.Stop();
+
+		const double fMicrosPerPacket = fTotalMicros / (nFrames * nUniverses);
+
+		if (fMicrosPerPacket < result.fMicrosPerPacket) {
+			result.fMicrosPerPacket = fMicrosPerPacket;
+			result.fFrameMicrosMax = fFrameMicrosMax;
+		}
+	}
+
+	return result;
+}
+
+static void Print(const char *pText, uint32_t nUniverses, const BenchResult &result) {
+	printf("%-13s %2u universes : %.3f us per packet, %.1f us frame max, %.3f %% of a core at %u Hz\n", pText, nUniverses, result.fMicrosPerPacket,
+			result.fFrameMicrosMax, result.fMicrosPerPacket * nUniverses * REFRESH_HZ / 1e4, REFRESH_HZ);
+}
+
+int main(void) {
+	Hardware hw;
+	LedBlink lb;
+	ControllerNetwork network;
+
+	TestSharedUniverse(network);
+
+	printf("%u universes on %u ports at %u Hz, %u s, best of %u\n", E131_MAX_PORTS, E131_MAX_PORTS, REFRESH_HZ, SECONDS, RUNS);
+
+	const BenchResult copy = Bench(network, false, E131_MAX_PORTS);
+	Print("Copy path", E131_MAX_PORTS, copy);
+	Check(copy.bIsComplete, "copy path, every port has sent the last frame");
+
+	const BenchResult forward = Bench(network, true, E131_MAX_PORTS);
+	Print("Forward path", E131_MAX_PORTS, forward);
+	Check(forward.bIsComplete, "forward path, every port has sent the last frame");
+
+	printf("Forward path is %.2f times the speed of the copy path\n", copy.fMicrosPerPacket / forward.fMicrosPerPacket);
+
+	const BenchResult shared = Bench(network, true, E131_MAX_PORTS / 2);
+	Print("Shared", E131_MAX_PORTS / 2, shared);
+	Check(shared.bIsComplete, "each universe on two ports, every port has sent the last frame");
+
+	printf("%s\n", s_nFailures == 0 ? "All tests passed" : "Tests failed");
+
+	return s_nFailures == 0 ? 0 : 1;
+}
@@ -37,6 +37,7 @@
 // Handlers
 #include "e131dmx.h"
 #include "e131sync.h"
+#include "e131forward.h"
 
 enum {
 	E131_MAX_UARTS = 4
@@ -78,6 +79,8 @@ struct TE131OutputPort {
 	uint16_t nUniverse;
 	E131Merge mergeMode;
 	bool IsDataPending;
+	bool IsForwarded;
+	bool IsUniqueUniverse;
 	bool bIsEnabled;
 	bool IsTransmitting;
 	bool IsMerging;
@@ -166,6 +169,10 @@ public:
 		m_pE131Sync = pE131Sync;
 	}
 
+	void SetE131Forward(E131Forward *pE131Forward) {
+		m_pE131Forward = pE131Forward;
+	}
+
 	const uint8_t *GetCid(void) {
 		return m_Cid;
 	}
@@ -199,6 +206,8 @@ private:
 	bool IsValidRoot(void);
 	bool IsValidDataPacket(void);
 
+	void Trace(uint16_t nForeignPort, uint16_t nBytesReceived);
+
 	void SetNetworkDataLossCondition(bool bSourceA = true, bool bSourceB = true);
 
 	void SetSynchronizationAddress(bool bSourceA, bool bSourceB, uint16_t nSynchronizationAddress);
@@ -214,6 +223,7 @@ private:
 
 	uint32_t UniverseToMulticastIp(uint16_t nUniverse) const;
 	void LeaveUniverse(uint8_t nPortIndex, uint16_t nUniverse);
+	void UpdateUniqueUniverse(void);
 
 	// Input
 	void HandleDmxIn(void);
@@ -248,6 +258,9 @@ private:
 	// Synchronization handler
 	E131Sync *m_pE131Sync;
 
+	// Forwarding handler
+	E131Forward *m_pE131Forward;
+
 public:
 	static E131Bridge* Get(void) {
 		return s_pThis;
@@ -39,6 +39,14 @@ enum {
 #define DMX_MAX_VALUE 255
 #endif
 
+struct TE131ControllerPort {
+	struct TE131DataPacket *pDataPacket;	///< Prebuilt, only the slots, the lengths and the sequence number change
+	uint32_t nIpAddress;
+	uint16_t nUniverse;						///< 0 is not in use
+	uint16_t nLength;						///< The lengths in the packet are filled for this number of slots
+	uint8_t nPriority;
+};
+
 struct TE131ControllerState {
 	bool bIsRunning;
 	uint16_t nActiveUniverses;
@@ -63,6 +71,7 @@ public:
 	void Print(void);
 
 	void HandleDmxOut(uint16_t nUniverse, const uint8_t *pDmxData, uint16_t nLength);
+	void HandlePortDmxOut(uint8_t nPortIndex, const uint8_t *pDmxData, uint16_t nLength, bool bSynchronize = false);
 	void HandleSync(void);
 	void HandleBlackout(void);
 
@@ -90,11 +99,23 @@ public:
 	void SetSourceName(const char *pSourceName);
 	void SetPriority(uint8_t nPriority);
 
+	void SetPort(uint8_t nPortIndex, uint16_t nUniverse, uint8_t nPriority = E131_PRIORITY_DEFAULT);
+	bool GetPort(uint8_t nPortIndex, uint16_t &nUniverse) const {
+		if ((nPortIndex < E131_MAX_PORTS) && (m_aPort[nPortIndex].nUniverse != 0)) {
+			nUniverse = m_aPort[nPortIndex].nUniverse;
+			return true;
+		}
+
+		return false;
+	}
+
 private:
 	uint32_t UniverseToMulticastIp(uint16_t nUniverse) const;
 	void FillDataPacket(void);
 	void FillDiscoveryPacket(void);
 	void FillSynchronizationPacket(void);
+	void FillPortDataPacket(uint8_t nPortIndex);
+	void SetPortLength(struct TE131ControllerPort *pPort, uint16_t nLength);
 	void SendDiscoveryPacket(void);
 	uint8_t GetSequenceNumber(uint16_t nUniverse, uint32_t &nMulticastIpAddress);
 
@@ -109,6 +130,7 @@ private:
 	uint8_t m_Cid[E131_CID_LENGTH];
 	char m_SourceName[E131_SOURCE_NAME_LENGTH];
 	uint32_t m_nMaster;
+	struct TE131ControllerPort m_aPort[E131_MAX_PORTS];
 
 public:
 	static E131Controller* Get(void) {
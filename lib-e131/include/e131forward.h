@@ -0,0 +1,28 @@
+/**
+ * @file e131forward.h
+ *
+ */
+
+#ifndef E131FORWARD_H_
+#define E131FORWARD_H_
+
+#include <stdint.h>
+
+#include "e131packets.h"
+
+struct E131ForwardConst {
+	static constexpr uint32_t HEADROOM = __builtin_offsetof(struct TE131DataPacket, DMPLayer.PropertyValues) + 1;	///< Bytes in front of the slots
+};
+
+/**
+ * The received slots are handed over in the receive buffer, without copying.
+ * The HEADROOM bytes in front of pData and the byte following the slots may be overwritten.
+ */
+class E131Forward {
+public:
+	virtual ~E131Forward(void) {}
+
+	virtual void Handler(uint8_t nPortIndex, uint8_t *pData, uint16_t nLength)=0;
+};
+
+#endif /* E131FORWARD_H_ */
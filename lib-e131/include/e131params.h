@@ -49,6 +49,7 @@ struct TE131Params {
 	bool bEnableNoChangeUpdate;
 	uint8_t nDirection;
 	uint8_t nPriority;
+	uint8_t nPriorityPort[E131_PARAMS::MAX_PORTS];
 };
 //} __attribute__((packed));
 
@@ -70,6 +71,10 @@ struct E131ParamsMask {
 	static constexpr auto ENABLE_NO_CHANGE_OUTPUT = (1U << 14);
 	static constexpr auto DIRECTION = (1U << 15);
 	static constexpr auto PRIORITY = (1U << 16);
+	static constexpr auto PRIORITY_A = (1U << 17);
+	static constexpr auto PRIORITY_B = (1U << 18);
+	static constexpr auto PRIORITY_C = (1U << 19);
+	static constexpr auto PRIORITY_D = (1U << 20);
 };
 
 class E131ParamsStore {
@@ -108,6 +113,7 @@ public:
 	}
 
 	uint16_t GetUniverse(uint8_t nPort, bool &IsSet);
+	uint8_t GetPriority(uint8_t nPort);
 
 	bool IsEnableNoChangeUpdate() {
 		return m_tE131Params.bEnableNoChangeUpdate;
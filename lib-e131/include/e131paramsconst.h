@@ -37,6 +37,7 @@ public:
 	static const char DISABLE_MERGE_TIMEOUT[];
 	static const char DIRECTION[];
 	static const char PRIORITY[];
+	static const char PRIORITY_PORT[4][16];
 };
 
 #endif /* E131PARAMSCONST_H_ */
@@ -41,6 +41,7 @@
 #include "hardware.h"
 #include "network.h"
 #include "ledblink.h"
+#include "packettrace.h"
 
 #include "debug.h"
 
@@ -59,7 +60,8 @@ E131Bridge::E131Bridge(void) :
 	m_pE131DataPacket(0),
 	m_pE131DiscoveryPacket(0),
 	m_DiscoveryIpAddress(0),
-	m_pE131Sync(0)
+	m_pE131Sync(0),
+	m_pE131Forward(0)
 {
 	assert(Hardware::Get() != 0);
 	assert(Network::Get() != 0);
@@ -131,6 +133,7 @@ void E131Bridge::Stop(void) {
 			m_pLightSet->Stop(i);
 			m_OutputPort[i].length = 0;
 			m_OutputPort[i].IsDataPending = false;
+			m_OutputPort[i].IsForwarded = false;
 		}
 	}
 
@@ -259,6 +262,7 @@ void E131Bridge::SetUniverse(uint8_t nPortIndex, TE131PortDir dir, uint16_t nUni
 				m_OutputPort[nPortIndex].bIsEnabled = false;
 				m_State.nActiveOutputPorts = m_State.nActiveOutputPorts - 1;
 				LeaveUniverse(nPortIndex, nUniverse);
+				UpdateUniqueUniverse();
 			}
 		}
 
@@ -289,6 +293,28 @@ void E131Bridge::SetUniverse(uint8_t nPortIndex, TE131PortDir dir, uint16_t nUni
 	Network::Get()->JoinGroup(m_nHandle, UniverseToMulticastIp(nUniverse));
 
 	m_OutputPort[nPortIndex].nUniverse = nUniverse;
+
+	UpdateUniqueUniverse();
+}
+
+/**
+ * Only a universe which is output on a single port can be forwarded, the forward handler overwrites the packet.
+ */
+void E131Bridge::UpdateUniqueUniverse(void) {
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		m_OutputPort[i].IsUniqueUniverse = m_OutputPort[i].bIsEnabled;
+
+		if (!m_OutputPort[i].bIsEnabled) {
+			continue;
+		}
+
+		for (uint32_t j = 0; j < E131_MAX_PORTS; j++) {
+			if ((j != i) && m_OutputPort[j].bIsEnabled && (m_OutputPort[j].nUniverse == m_OutputPort[i].nUniverse)) {
+				m_OutputPort[i].IsUniqueUniverse = false;
+				break;
+			}
+		}
+	}
 }
 
 bool E131Bridge::GetUniverse(uint8_t nPortIndex, uint16_t &nUniverse, TE131PortDir tDir) const {
@@ -493,12 +519,18 @@ void E131Bridge::HandleDmx(void) {
 			const int8_t diff = (m_E131.E131Packet.Data.FrameLayer.SequenceNumber - pSourceA->sequenceNumberData);
 			pSourceA->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
 			if ((diff <= 0) && (diff > -20)) {
+				if (PacketTrace::Get() != 0) {
+					PacketTrace::Get()->SetResult(PacketTraceResult::DISCARDED);
+				}
 				continue;
 			}
 		} else if (isSourceB) {
 			const int8_t diff = (m_E131.E131Packet.Data.FrameLayer.SequenceNumber - pSourceB->sequenceNumberData);
 			pSourceB->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
 			if ((diff <= 0) && (diff > -20)) {
+				if (PacketTrace::Get() != 0) {
+					PacketTrace::Get()->SetResult(PacketTraceResult::DISCARDED);
+				}
 				continue;
 			}
 		}
@@ -526,6 +558,9 @@ void E131Bridge::HandleDmx(void) {
 
 		if (m_E131.E131Packet.Data.FrameLayer.Priority < m_State.nPriority ){
 			if (!IsPriorityTimeOut(i)) {
+				if (PacketTrace::Get() != 0) {
+					PacketTrace::Get()->SetResult(PacketTraceResult::DISCARDED);
+				}
 				continue;
 			}
 			m_State.nPriority = m_E131.E131Packet.Data.FrameLayer.Priority;
@@ -536,7 +571,21 @@ void E131Bridge::HandleDmx(void) {
 			m_State.nPriority = m_E131.E131Packet.Data.FrameLayer.Priority;
 		}
 
-		if ((ipA == 0) && (ipB == 0)) {
+		// A single source is forwarded as is, there is nothing to merge.
+		// A universe output on more than one port takes the copy path, each port needs the original slots.
+		const bool bIsForward = (m_pE131Forward != 0) && m_OutputPort[i].IsUniqueUniverse && !m_State.IsMergeMode && (ipB == 0) && ((ipA == 0) || isSourceA);
+
+		if (bIsForward) {
+			if (ipA == 0) {
+				pSourceA->ip = m_E131.IPAddressFrom;
+				memcpy(pSourceA->cid, m_E131.E131Packet.Data.RootLayer.Cid, 16);
+			}
+			pSourceA->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
+			pSourceA->time = m_nCurrentPacketMillis;
+			m_OutputPort[i].length = slots;
+			m_OutputPort[i].IsForwarded = true;
+
+		} else if ((ipA == 0) && (ipB == 0)) {
 			//printf("1. First package from Source\n");
 			pSourceA->ip = m_E131.IPAddressFrom;
 			pSourceA->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
@@ -544,6 +593,7 @@ void E131Bridge::HandleDmx(void) {
 			pSourceA->time = m_nCurrentPacketMillis;
 			memcpy(pSourceA->data, p, slots);
 			sendNewData = IsDmxDataChanged(i, p, slots);
+			m_OutputPort[i].IsForwarded = false;
 
 		} else if (isSourceA && (ipB == 0)) {
 			//printf("2. Continue package from SourceA\n");
@@ -551,6 +601,7 @@ void E131Bridge::HandleDmx(void) {
 			pSourceA->time = m_nCurrentPacketMillis;
 			memcpy(pSourceA->data, p, slots);
 			sendNewData = IsDmxDataChanged(i, p, slots);
+			m_OutputPort[i].IsForwarded = false;
 
 		} else if ((ipA == 0) && isSourceB) {
 			//printf("3. Continue package from SourceB\n");
@@ -566,6 +617,14 @@ void E131Bridge::HandleDmx(void) {
 			memcpy(pSourceB->cid, m_E131.E131Packet.Data.RootLayer.Cid, 16);
 			pSourceB->time = m_nCurrentPacketMillis;
 			memcpy(pSourceB->data, p, slots);
+
+			if (m_OutputPort[i].IsForwarded) {
+				// The data of source A has not been kept, the merge starts with its next packet
+				m_OutputPort[i].IsForwarded = false;
+				m_State.bIsReceivingDmx = true;
+				continue;
+			}
+
 			sendNewData = IsMergedDmxDataChanged(i, pSourceB->data, slots);
 
 		} else if ((ipA == 0) && !isSourceB) {
@@ -592,16 +651,25 @@ void E131Bridge::HandleDmx(void) {
 			sendNewData = IsMergedDmxDataChanged(i, pSourceB->data, slots);
 
 		} else if (isSourceA && isSourceB) {
+			if (PacketTrace::Get() != 0) {
+				PacketTrace::Get()->SetResult(PacketTraceResult::DISCARDED);
+			}
 			printf("8. Source matches both buffers, this shouldn't be happening!\n");
 			assert(0);
 			return;
 
 		} else if (!isSourceA && !isSourceB) {
+			if (PacketTrace::Get() != 0) {
+				PacketTrace::Get()->SetResult(PacketTraceResult::DISCARDED);
+			}
 			printf("9. More than two sources, discarding data\n");
 			assert(0);
 			return;
 
 		} else {
+			if (PacketTrace::Get() != 0) {
+				PacketTrace::Get()->SetResult(PacketTraceResult::DISCARDED);
+			}
 			printf("0. No cases matched, this shouldn't happen!\n");
 			assert(0);
 			return;
@@ -633,6 +701,21 @@ void E131Bridge::HandleDmx(void) {
 			m_State.IsForcedSynchronized = false;
 		}
 
+		if (bIsForward) {
+			if (!m_OutputPort[i].IsTransmitting) {
+				m_pLightSet->Start(i);
+				m_State.IsChanged |= (!m_OutputPort[i].IsTransmitting);
+				m_OutputPort[i].IsTransmitting = true;
+			}
+
+			m_State.bIsReceivingDmx = true;
+
+			// The handler overwrites the layers in front of the slots.
+			// The universe is unique, there is no other port which needs this packet.
+			m_pE131Forward->Handler(i, const_cast<uint8_t *>(p), slots);
+			return;
+		}
+
 		if (sendNewData || m_bDirectUpdate) {
 			if ((!m_State.IsSynchronized) || (m_State.bDisableSynchronize)) {
 
@@ -672,6 +755,11 @@ void E131Bridge::HandleSynchronization(void) {
 	m_State.SynchronizationTime = m_nCurrentPacketMillis;
 
 	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		// The forwarded data has already been sent, the handlers below take care of the synchronization
+		if (m_OutputPort[i].IsForwarded) {
+			continue;
+		}
+
 		if ((m_OutputPort[i].IsDataPending) || (m_OutputPort[i].bIsEnabled && m_bDirectUpdate)){
 
 			m_pLightSet->SetData(i, m_OutputPort[i].data, m_OutputPort[i].length);
@@ -685,6 +773,8 @@ void E131Bridge::HandleSynchronization(void) {
 		}
 	}
 
+	m_pLightSet->Sync();
+
 	if (m_pE131Sync != 0) {
 		m_pE131Sync->Handler();
 	}
@@ -712,6 +802,7 @@ void E131Bridge::SetNetworkDataLossCondition(bool bSourceA, bool bSourceB) {
 				memset(m_OutputPort[i].sourceB.cid, 0, E131_CID_LENGTH);
 				m_OutputPort[i].length = 0;
 				m_OutputPort[i].IsDataPending = false;
+				m_OutputPort[i].IsForwarded = false;
 				m_OutputPort[i].IsTransmitting = false;
 				m_OutputPort[i].IsMerging = false;
 			}
@@ -737,6 +828,7 @@ void E131Bridge::SetNetworkDataLossCondition(bool bSourceA, bool bSourceB) {
 					m_pLightSet->Stop(i);
 					m_OutputPort[i].length = 0;
 					m_OutputPort[i].IsDataPending = false;
+					m_OutputPort[i].IsForwarded = false;
 					m_OutputPort[i].IsTransmitting = false;
 				}
 			}
@@ -834,6 +926,17 @@ bool E131Bridge::IsValidDataPacket(void) {
 	return true;
 }
 
+void E131Bridge::Trace(uint16_t nForeignPort, uint16_t nBytesReceived) {
+	const uint32_t nRootVector = __builtin_bswap32(m_E131.E131Packet.Raw.RootLayer.Vector);
+	const bool bIsData = (nRootVector == E131_VECTOR_ROOT_DATA);
+	const uint16_t nVector = static_cast<uint16_t>(bIsData ? nRootVector : __builtin_bswap32(m_E131.E131Packet.Raw.FrameLayer.Vector));
+	const uint16_t nUniverse = bIsData ? __builtin_bswap16(m_E131.E131Packet.Data.FrameLayer.Universe) : 0;
+	const uint8_t nSequence = bIsData ? m_E131.E131Packet.Data.FrameLayer.SequenceNumber : 0;
+
+	PacketTrace::Get()->Record(m_E131.IPAddressFrom, nForeignPort, E131_DEFAULT_PORT, nVector, nUniverse, nSequence, nBytesReceived, &m_E131.E131Packet,
+			IsValidRoot() ? PacketTraceResult::ACCEPTED : PacketTraceResult::INVALID);
+}
+
 void E131Bridge::Run(void) {
 	uint16_t nForeignPort;
 
@@ -876,6 +979,10 @@ void E131Bridge::Run(void) {
 		return;
 	}
 
+	if (__builtin_expect((PacketTrace::Get() != 0), 0)) {
+		Trace(nForeignPort, nBytesReceived);
+	}
+
 	if (__builtin_expect((!IsValidRoot()), 0)) {
 		return;
 	}
@@ -894,6 +1001,8 @@ void E131Bridge::Run(void) {
 	if (nRootVector == E131_VECTOR_ROOT_DATA) {
 		if (IsValidDataPacket()) {
 			HandleDmx();
+		} else if (PacketTrace::Get() != 0) {
+			PacketTrace::Get()->SetResult(PacketTraceResult::INVALID);
 		}
 	} else if (nRootVector == E131_VECTOR_ROOT_EXTENDED) {
 		const uint32_t nFramingVector = __builtin_bswap32(m_E131.E131Packet.Raw.FrameLayer.Vector);
@@ -902,6 +1011,9 @@ void E131Bridge::Run(void) {
 		}
 	} else {
 		DEBUG_PRINTF("Not supported Root Vector : 0x%x", nRootVector);
+		if (PacketTrace::Get() != 0) {
+			PacketTrace::Get()->SetResult(PacketTraceResult::IGNORED);
+		}
 	}
 
 	if (m_pE131DmxIn != 0) {
@@ -70,6 +70,7 @@ E131Controller::E131Controller(void):
 	s_pThis = this;
 
 	memset(&m_State, 0, sizeof(struct TE131ControllerState));
+	memset(m_aPort, 0, sizeof(m_aPort));
 	m_State.nPriority = 100;
 
 	char aSourceName[E131_SOURCE_NAME_LENGTH];
@@ -113,6 +114,12 @@ E131Controller::~E131Controller(void) {
 
 	Network::Get()->End(E131_DEFAULT_PORT);
 
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		if (m_aPort[i].pDataPacket != 0) {
+			delete m_aPort[i].pDataPacket;
+		}
+	}
+
 	if (m_pE131SynchronizationPacket != 0) {
 		delete m_pE131SynchronizationPacket;
 	}
@@ -135,6 +142,13 @@ void E131Controller::Start(void) {
 	FillDiscoveryPacket();
 	FillSynchronizationPacket();
 
+	// The source name and the synchronization address could have been changed after SetPort
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		if (m_aPort[i].nUniverse != 0) {
+			FillPortDataPacket(i);
+		}
+	}
+
 	m_State.bIsRunning = true;
 
 	DEBUG_EXIT
@@ -236,6 +250,42 @@ void E131Controller::HandleDmxOut(uint16_t nUniverse, const uint8_t *pDmxData, u
 	Network::Get()->SendTo(m_nHandle, m_pE131DataPacket, DATA_PACKET_SIZE(1U + nLength), nIp, E131_DEFAULT_PORT);
 }
 
+/**
+ * The packet for the port is prebuilt, only the slots and the sequence number are updated per frame.
+ * The lengths are updated when the number of slots changes.
+ */
+void E131Controller::HandlePortDmxOut(uint8_t nPortIndex, const uint8_t *pDmxData, uint16_t nLength, bool bSynchronize) {
+	assert(nPortIndex < E131_MAX_PORTS);
+	assert(nLength <= E131_DMX_LENGTH);
+
+	struct TE131ControllerPort *pPort = &m_aPort[nPortIndex];
+
+	if (pPort->nUniverse == 0) {
+		return;
+	}
+
+	struct TE131DataPacket *pDataPacket = pPort->pDataPacket;
+
+	if (__builtin_expect((pPort->nLength != nLength), 0)) {
+		SetPortLength(pPort, nLength);
+	}
+
+	pDataPacket->FrameLayer.SequenceNumber++;
+	pDataPacket->FrameLayer.SynchronizationAddress = bSynchronize ? __builtin_bswap16(m_State.SynchronizationPacket.nUniverseNumber) : 0;
+
+	if (__builtin_expect((m_nMaster == DMX_MAX_VALUE), 1)) {
+		memcpy(&pDataPacket->DMPLayer.PropertyValues[1], pDmxData, nLength);
+	} else if (m_nMaster == 0) {
+		memset(&pDataPacket->DMPLayer.PropertyValues[1], 0, nLength);
+	} else {
+		for (uint32_t i = 0; i < nLength; i++) {
+			pDataPacket->DMPLayer.PropertyValues[1 + i] = (m_nMaster * static_cast<uint32_t>(pDmxData[i])) / DMX_MAX_VALUE;
+		}
+	}
+
+	Network::Get()->SendTo(m_nHandle, pDataPacket, DATA_PACKET_SIZE(1U + nLength), pPort->nIpAddress, E131_DEFAULT_PORT);
+}
+
 void E131Controller::HandleSync(void) {
 	if (m_State.SynchronizationPacket.nUniverseNumber != 0) {
 		m_pE131SynchronizationPacket->FrameLayer.SequenceNumber = m_State.SynchronizationPacket.nSequenceNumber++;
@@ -279,6 +329,87 @@ uint32_t E131Controller::UniverseToMulticastIp(uint16_t nUniverse) const {
 	return nMulticastIp;
 }
 
+/**
+ * The port has its own data packet, with the universe and the priority filled in once.
+ * The universe is added to the universe discovery list.
+ */
+void E131Controller::SetPort(uint8_t nPortIndex, uint16_t nUniverse, uint8_t nPriority) {
+	DEBUG_ENTRY
+	DEBUG_PRINTF("nPortIndex=%d, nUniverse=%d, nPriority=%d", static_cast<int>(nPortIndex), static_cast<int>(nUniverse), static_cast<int>(nPriority));
+
+	assert(nPortIndex < E131_MAX_PORTS);
+
+	struct TE131ControllerPort *pPort = &m_aPort[nPortIndex];
+
+	if ((nUniverse == 0) || (nUniverse > E131_UNIVERSE_MAX)) {
+		pPort->nUniverse = 0;
+		DEBUG_EXIT
+		return;
+	}
+
+	if (pPort->pDataPacket == 0) {
+		pPort->pDataPacket = new struct TE131DataPacket;
+		assert(pPort->pDataPacket != 0);
+	}
+
+	pPort->nUniverse = nUniverse;
+	if ((nPriority >= E131_PRIORITY_LOWEST) && (nPriority <= E131_PRIORITY_HIGHEST)) {
+		pPort->nPriority = nPriority;
+	} else {
+		pPort->nPriority = E131_PRIORITY_DEFAULT;
+	}
+
+	uint32_t nIp;
+	GetSequenceNumber(nUniverse, nIp);
+
+	FillPortDataPacket(nPortIndex);
+
+	DEBUG_EXIT
+}
+
+void E131Controller::FillPortDataPacket(uint8_t nPortIndex) {
+	struct TE131ControllerPort *pPort = &m_aPort[nPortIndex];
+	struct TE131DataPacket *pDataPacket = pPort->pDataPacket;
+
+	// Root Layer (See Section 5)
+	pDataPacket->RootLayer.PreAmbleSize = __builtin_bswap16(0x0010);
+	pDataPacket->RootLayer.PostAmbleSize = __builtin_bswap16(0x0000);
+	memcpy(pDataPacket->RootLayer.ACNPacketIdentifier, E117Const::ACN_PACKET_IDENTIFIER, E117_PACKET_IDENTIFIER_LENGTH);
+	pDataPacket->RootLayer.Vector = __builtin_bswap32(E131_VECTOR_ROOT_DATA);
+	memcpy(pDataPacket->RootLayer.Cid, m_Cid, E131_CID_LENGTH);
+
+	// E1.31 Framing Layer (See Section 6)
+	pDataPacket->FrameLayer.Vector = __builtin_bswap32(E131_VECTOR_DATA_PACKET);
+	memcpy(pDataPacket->FrameLayer.SourceName, m_SourceName, E131_SOURCE_NAME_LENGTH);
+	pDataPacket->FrameLayer.Priority = pPort->nPriority;
+	pDataPacket->FrameLayer.SynchronizationAddress = 0;
+	pDataPacket->FrameLayer.SequenceNumber = 0;
+	pDataPacket->FrameLayer.Options = 0;
+	pDataPacket->FrameLayer.Universe = __builtin_bswap16(pPort->nUniverse);
+
+	// Data Layer
+	pDataPacket->DMPLayer.Vector = E131_VECTOR_DMP_SET_PROPERTY;
+	pDataPacket->DMPLayer.Type = 0xa1;
+	pDataPacket->DMPLayer.FirstAddressProperty = __builtin_bswap16(0x0000);
+	pDataPacket->DMPLayer.AddressIncrement = __builtin_bswap16(0x0001);
+	pDataPacket->DMPLayer.PropertyValues[0] = 0;
+
+	pPort->nIpAddress = UniverseToMulticastIp(pPort->nUniverse);
+
+	SetPortLength(pPort, E131_DMX_LENGTH);
+}
+
+void E131Controller::SetPortLength(struct TE131ControllerPort *pPort, uint16_t nLength) {
+	struct TE131DataPacket *pDataPacket = pPort->pDataPacket;
+
+	pDataPacket->RootLayer.FlagsLength = __builtin_bswap16((0x07 << 12) | (DATA_ROOT_LAYER_LENGTH(1U + nLength)));
+	pDataPacket->FrameLayer.FLagsLength = __builtin_bswap16((0x07 << 12) | (DATA_FRAME_LAYER_LENGTH(1U + nLength)));
+	pDataPacket->DMPLayer.FlagsLength = __builtin_bswap16((0x07 << 12) | (DATA_LAYER_LENGTH(1U + nLength)));
+	pDataPacket->DMPLayer.PropertyValueCount = __builtin_bswap16(1 + nLength);
+
+	pPort->nLength = nLength;
+}
+
 const uint8_t *E131Controller::GetSoftwareVersion(void) {
 	return DEVICE_SOFTWARE_VERSION;
 }
@@ -380,6 +511,13 @@ uint8_t E131Controller::GetSequenceNumber(uint16_t nUniverse, uint32_t &nMultica
 void E131Controller::Print(void) {
 	printf("sACN E1.31 Controller\n");
 	printf(" Max Universes : %d\n", static_cast<int>(sizeof(s_SequenceNumbers) / sizeof(s_SequenceNumbers[0])));
+
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		if (m_aPort[i].nUniverse != 0) {
+			printf(" Port %2d -> Universe %d, Priority %d\n", static_cast<int>(i), static_cast<int>(m_aPort[i].nUniverse), static_cast<int>(m_aPort[i].nPriority));
+		}
+	}
+
 	if (m_State.SynchronizationPacket.nUniverseNumber != 0) {
 		printf(" Synchronization Universe : %u\n", m_State.SynchronizationPacket.nUniverseNumber);
 	} else {
@@ -53,6 +53,10 @@ E131Params::E131Params(E131ParamsStore *pE131ParamsStore):m_pE131ParamsStore(pE1
 	m_tE131Params.nNetworkTimeout = E131_NETWORK_DATA_LOSS_TIMEOUT_SECONDS;
 	m_tE131Params.nDirection = E131_OUTPUT_PORT;
 	m_tE131Params.nPriority = E131_PRIORITY_DEFAULT;
+
+	for (uint32_t i = 0; i < E131_PARAMS::MAX_PORTS; i++) {
+		m_tE131Params.nPriorityPort[i] = E131_PRIORITY_DEFAULT;
+	}
 }
 
 bool E131Params::Load() {
@@ -195,6 +199,19 @@ void E131Params::callbackFunction(const char *pLine) {
 		return;
 	}
 
+	for (uint32_t i = 0; i < E131_PARAMS::MAX_PORTS; i++) {
+		if (Sscan::Uint8(pLine, E131ParamsConst::PRIORITY_PORT[i], value8) == Sscan::OK) {
+			if ((value8 >= E131_PRIORITY_LOWEST) && (value8 <= E131_PRIORITY_HIGHEST)) {
+				m_tE131Params.nPriorityPort[i] = value8;
+				m_tE131Params.nSetList |= (E131ParamsMask::PRIORITY_A << i);
+			} else {
+				m_tE131Params.nPriorityPort[i] = E131_PRIORITY_DEFAULT;
+				m_tE131Params.nSetList &= ~(E131ParamsMask::PRIORITY_A << i);
+			}
+			return;
+		}
+	}
+
 }
 
 void E131Params::Dump() {
@@ -240,6 +257,12 @@ void E131Params::Dump() {
 	if (isMaskSet(E131ParamsMask::PRIORITY)) {
 		printf(" %s=%d\n", E131ParamsConst::PRIORITY, m_tE131Params.nPriority);
 	}
+
+	for (unsigned i = 0; i < E131_PARAMS::MAX_PORTS; i++) {
+		if (isMaskSet(E131ParamsMask::PRIORITY_A << i)) {
+			printf(" %s=%d\n", E131ParamsConst::PRIORITY_PORT[i], m_tE131Params.nPriorityPort[i]);
+		}
+	}
 #endif
 }
 
@@ -251,6 +274,19 @@ uint16_t E131Params::GetUniverse(uint8_t nPort, bool &IsSet) {
 	return m_tE131Params.nUniversePort[nPort];
 }
 
+/**
+ * @return the priority for the port, when not set the priority for all ports
+ */
+uint8_t E131Params::GetPriority(uint8_t nPort) {
+	assert(nPort < E131_PARAMS::MAX_PORTS);
+
+	if (isMaskSet(E131ParamsMask::PRIORITY_A << nPort)) {
+		return m_tE131Params.nPriorityPort[nPort];
+	}
+
+	return m_tE131Params.nPriority;
+}
+
 void E131Params::staticCallbackFunction(void *p, const char *s) {
 	assert(p != nullptr);
 	assert(s != nullptr);
@@ -34,3 +34,4 @@ const char E131ParamsConst::NETWORK_DATA_LOSS_TIMEOUT[] = "network_data_loss_tim
 const char E131ParamsConst::DISABLE_MERGE_TIMEOUT[] = "disable_merge_timeout";
 const char E131ParamsConst::DIRECTION[] = "direction";
 const char E131ParamsConst::PRIORITY[] = "priority";
+const char E131ParamsConst::PRIORITY_PORT[4][16] = { "priority_port_a", "priority_port_b", "priority_port_c", "priority_port_d" };
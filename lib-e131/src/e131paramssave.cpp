@@ -76,6 +76,10 @@ void E131Params::Builder(const struct TE131Params *ptE131Params, char *pBuffer,
 	builder.AddComment("DMX Input");
 	builder.Add(E131ParamsConst::PRIORITY, m_tE131Params.nPriority, isMaskSet(E131ParamsMask::PRIORITY));
 
+	for (uint32_t i = 0; i < E131_PARAMS::MAX_PORTS; i++) {
+		builder.Add(E131ParamsConst::PRIORITY_PORT[i], m_tE131Params.nPriorityPort[i], isMaskSet(E131ParamsMask::PRIORITY_A << i));
+	}
+
 	nSize = builder.GetSize();
 
 	DEBUG_PRINTF("nSize=%d", nSize);
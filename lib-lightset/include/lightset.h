@@ -61,6 +61,9 @@ public:
 
 	virtual void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLength)= 0;
 
+	// Optional, called after the pending data is sent on ArtSync / E1.31 Synchronization
+	virtual void Sync(void);
+
 	virtual void Print(void);
 
 	void SetLightSetDisplay(LightSetDisplay *pLightSetDisplay) {
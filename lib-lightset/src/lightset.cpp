@@ -37,6 +37,10 @@ LightSet::LightSet(void) : m_pLightSetDisplay(0) {
 LightSet::~LightSet(void) {
 }
 
+void LightSet::Sync(void) {
+	// override
+}
+
 void LightSet::Print(void) {
 	// override
 }
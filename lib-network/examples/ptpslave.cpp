@@ -0,0 +1,96 @@
+/**
+ * @file ptpslave.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Runs the PTP slave on a Linux interface and prints one line per second.
+ * The master is for example ptp4l on another host of the same subnet:
+ *
+ *   ptp4l -S -E -4 -i eth0 -m
+ *
+ * The PTP ports 319 and 320 are privileged, so run as root.
+ * The system clock of the Linux host is not changed.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "hardware.h"
+#include "networklinux.h"
+
+#include "ptpclient.h"
+
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		printf("Usage: %s ip_address|interface_name [domain] [seconds]\n", argv[0]);
+		return -1;
+	}
+
+	Hardware hw;
+	NetworkLinux nw;
+
+	if (nw.Init(argv[1]) < 0) {
+		fprintf(stderr, "Not able to start the network\n");
+		return -1;
+	}
+
+	nw.Print();
+
+	const uint8_t nDomain = (argc > 2) ? static_cast<uint8_t>(atoi(argv[2])) : 0;
+	const uint32_t nSeconds = (argc > 3) ? static_cast<uint32_t>(atoi(argv[3])) : 0;
+
+	PtpClient ptpClient(nDomain);
+	ptpClient.Start();
+
+	const char *aStatus[] = { "Stopped", "Listening", "Uncalibrated", "Locked" };
+	const uint32_t nMillisStart = hw.Millis();
+	uint32_t nMillisPrint = nMillisStart;
+
+	for (;;) {
+		ptpClient.Run();
+
+		const uint32_t nMillis = hw.Millis();
+
+		if ((nMillis - nMillisPrint) < 1000) {
+			continue;
+		}
+
+		nMillisPrint = nMillis;
+
+		printf("%-12s offset %9lld ns  path delay %7lld ns  frequency %7d ppb\n",
+				aStatus[static_cast<int>(ptpClient.GetStatus())],
+				static_cast<long long>(ptpClient.GetOffset()),
+				static_cast<long long>(ptpClient.GetMeanPathDelay()),
+				ptpClient.GetFrequency());
+
+		if ((nSeconds != 0) && ((nMillis - nMillisStart) >= (nSeconds * 1000))) {
+			break;
+		}
+	}
+
+	ptpClient.Print();
+
+	return ptpClient.IsLocked() ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file simnetwork.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SIMNETWORK_H_
+#define SIMNETWORK_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "network.h"
+
+/**
+ * In-process network for the host tests and benchmarks.
+ * The packets are pushed by the test, one at a time, and received with the next Run() of the node.
+ * The packets sent by the node are counted, a test inspects them by overriding Sent().
+ */
+class SimNetwork: public Network {
+public:
+	SimNetwork(void) {
+		memset(m_aNetMacaddr, 0, sizeof(m_aNetMacaddr));
+		m_nLocalIp = LOCAL_IP;
+		m_nGatewayIp = 0;
+		m_nNetmask = 0x000000FF;
+		m_IsDhcpCapable = false;
+		m_IsDhcpUsed = false;
+		m_IsZeroconfCapable = false;
+		m_IsZeroconfUsed = false;
+		strcpy(m_aHostName, "sim");
+		m_aDomainName[0] = '\0';
+		strcpy(m_aIfName, "sim0");
+		m_nIfIndex = 1;
+		m_nNtpServerIp = 0;
+		m_fNtpUtcOffset = 0;
+	}
+
+	int32_t Begin(__attribute__((unused)) uint16_t nPort) override {
+		return 0;
+	}
+	int32_t End(__attribute__((unused)) uint16_t nPort) override {
+		return 0;
+	}
+
+	void MacAddressCopyTo(uint8_t *pMacAddress) override {
+		memcpy(pMacAddress, m_aNetMacaddr, NETWORK_MAC_SIZE);
+	}
+
+	void JoinGroup(__attribute__((unused)) int32_t nHandle, __attribute__((unused)) uint32_t nIp) override {
+	}
+	void LeaveGroup(__attribute__((unused)) int32_t nHandle, __attribute__((unused)) uint32_t nIp) override {
+	}
+
+	uint16_t RecvFrom(__attribute__((unused)) int32_t nHandle, void *pBuffer, uint16_t nLength, uint32_t *pFromIp, uint16_t *pFromPort) override {
+		if (m_nPacketLength == 0) {
+			return 0;
+		}
+
+		const uint16_t nBytes = (m_nPacketLength < nLength) ? m_nPacketLength : nLength;
+
+		memcpy(pBuffer, m_aPacket, nBytes);
+		*pFromIp = REMOTE_IP;
+		*pFromPort = m_nFromPort;
+
+		m_nPacketLength = 0;
+		return nBytes;
+	}
+
+	void SendTo(__attribute__((unused)) int32_t nHandle, const void *pBuffer, uint16_t nLength, uint32_t nToIp, uint16_t nRemotePort) override {
+		m_nSent++;
+		Sent(reinterpret_cast<const uint8_t*>(pBuffer), nLength, nToIp, nRemotePort);
+	}
+
+	void SetIp(__attribute__((unused)) uint32_t nIp) override {
+	}
+	void SetNetmask(__attribute__((unused)) uint32_t nNetmask) override {
+	}
+	bool SetZeroconf(void) override {
+		return false;
+	}
+	bool EnableDhcp(void) override {
+		return false;
+	}
+
+	/**
+	 * One packet at a time, it is received from REMOTE_IP:nFromPort with the next Run() of the node
+	 */
+	void Push(const void *pPacket, uint16_t nLength, uint16_t nFromPort) {
+		if (nLength > sizeof(m_aPacket)) {
+			nLength = sizeof(m_aPacket);
+		}
+
+		memcpy(m_aPacket, pPacket, nLength);
+		m_nPacketLength = nLength;
+		m_nFromPort = nFromPort;
+	}
+
+	uint32_t GetSent(void) const {
+		return m_nSent;
+	}
+
+	static constexpr uint32_t LOCAL_IP = 0x0100000A;	// 10.0.0.1
+	static constexpr uint32_t REMOTE_IP = 0x0200000A;	// 10.0.0.2
+
+protected:
+	/**
+	 * The packet is only valid during the call, as the transmit buffer of the emac
+	 */
+	virtual void Sent(__attribute__((unused)) const uint8_t *pBuffer, __attribute__((unused)) uint16_t nLength,
+			__attribute__((unused)) uint32_t nToIp, __attribute__((unused)) uint16_t nRemotePort) {
+	}
+
+private:
+	uint8_t m_aPacket[1500];
+	uint16_t m_nPacketLength{0};
+	uint16_t m_nFromPort{0};
+	uint32_t m_nSent{0};
+};
+
+#endif /* SIMNETWORK_H_ */
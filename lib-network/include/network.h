@@ -99,6 +99,18 @@ public:
 	virtual uint16_t RecvFrom(int32_t nHandle, void *pBuffer, uint16_t nLength, uint32_t *pFromIp, uint16_t *pFromPort)=0;
 	virtual void SendTo(int32_t nHandle, const void *pBuffer, uint16_t nLength, uint32_t nToIp, uint16_t nRemotePort)=0;
 
+	/*
+	 * TCP client, non-blocking. Not every platform has a TCP stack, the defaults fail.
+	 * TcpRead returns 0 when no data is available and -1 when the connection is closed.
+	 * TcpWrite returns the number of bytes accepted, this can be less than nLength or 0
+	 * when the socket buffer is full, and -1 on an error.
+	 */
+	virtual int32_t TcpBegin(uint32_t nRemoteIp, uint16_t nRemotePort);
+	virtual void TcpEnd(int32_t nHandle);
+	virtual bool TcpIsConnected(int32_t nHandle);
+	virtual int32_t TcpRead(int32_t nHandle, void *pBuffer, uint16_t nLength);
+	virtual int32_t TcpWrite(int32_t nHandle, const void *pBuffer, uint16_t nLength);
+
 	virtual void SetIp(uint32_t nIp)=0;
 	virtual void SetNetmask(uint32_t nNetmask)=0;
 	virtual bool SetZeroconf(void)=0;
@@ -60,6 +60,12 @@ public:
 	uint16_t RecvFrom(int32_t nHandle, void *pBuffer, uint16_t nLength, uint32_t *pFromIp, uint16_t *pFromPort);
 	void SendTo(int32_t nHandle, const void *pBuffer, uint16_t nLength, uint32_t nToIp, uint16_t nRemotePort);
 
+	int32_t TcpBegin(uint32_t nRemoteIp, uint16_t nRemotePort);
+	void TcpEnd(int32_t nHandle);
+	bool TcpIsConnected(int32_t nHandle);
+	int32_t TcpRead(int32_t nHandle, void *pBuffer, uint16_t nLength);
+	int32_t TcpWrite(int32_t nHandle, const void *pBuffer, uint16_t nLength);
+
 private:
 	uint32_t GetDefaultGateway(void);
 	bool IsDhclient(const char *pIfName);
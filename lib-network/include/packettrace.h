@@ -0,0 +1,154 @@
+/**
+ * @file packettrace.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PACKETTRACE_H_
+#define PACKETTRACE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "hardware.h"
+
+struct PacketTraceConst {
+	static constexpr uint32_t RECORDS_MAX = 4096;
+	static constexpr uint32_t PAYLOAD_MAX = 256;
+};
+
+enum class PacketTraceResult: uint8_t {
+	ACCEPTED,
+	IGNORED,	///< Not supported, or not for this node
+	DISCARDED,	///< Valid, but dropped (merge limit, sequence, priority)
+	INVALID
+};
+
+struct TPacketTraceRecord {
+	uint32_t nMicros;
+	uint32_t nFromIp;
+	uint16_t nFromPort;
+	uint16_t nPort;
+	uint16_t nOpCode;	///< Art-Net OpCode or E1.31 vector
+	uint16_t nUniverse;
+	uint16_t nLength;
+	uint8_t nSequence;
+	PacketTraceResult tResult;
+};
+
+/**
+ * Fixed size ring buffer with the meta data (and optionally the first bytes) of the received packets.
+ * The ring is exported as a pcapng file with LINKTYPE_IPV4, so it can be opened with Wireshark.
+ */
+class PacketTrace {
+public:
+	PacketTrace(uint32_t nRecords, uint32_t nPayloadBytes = 0);
+	~PacketTrace(void);
+
+	/**
+	 * Called for each received packet, the handling result can be updated with SetResult
+	 */
+	void Record(uint32_t nFromIp, uint16_t nFromPort, uint16_t nPort, uint16_t nOpCode, uint16_t nUniverse, uint8_t nSequence, uint16_t nLength, const void *pPayload, PacketTraceResult tResult = PacketTraceResult::ACCEPTED) {
+		if (__builtin_expect(m_bFrozen, 0)) {
+			m_pLast = &m_Dummy;
+			return;
+		}
+
+		uint8_t *pRecord = &m_pRing[m_nHead * m_nStride];
+		m_pLast = reinterpret_cast<TPacketTraceRecord*>(pRecord);
+
+		m_pLast->nMicros = Hardware::Get()->Micros();
+		m_pLast->nFromIp = nFromIp;
+		m_pLast->nFromPort = nFromPort;
+		m_pLast->nPort = nPort;
+		m_pLast->nOpCode = nOpCode;
+		m_pLast->nUniverse = nUniverse;
+		m_pLast->nLength = nLength;
+		m_pLast->nSequence = nSequence;
+		m_pLast->tResult = tResult;
+
+		if (m_nPayloadBytes != 0) {
+			memcpy(&pRecord[sizeof(struct TPacketTraceRecord)], pPayload, nLength < m_nPayloadBytes ? nLength : m_nPayloadBytes);
+		}
+
+		if (++m_nHead == m_nRecords) {
+			m_nHead = 0;
+		}
+
+		if (m_nCount < m_nRecords) {
+			m_nCount++;
+		}
+	}
+
+	void SetResult(PacketTraceResult tResult) {
+		m_pLast->tResult = tResult;
+	}
+
+	/**
+	 * Export
+	 */
+	void Freeze(void);
+	void Resume(void);
+	uint32_t GetFileSize(void);
+	uint32_t Read(uint32_t nOffset, void *pBuffer, uint32_t nCount);
+
+	uint32_t GetCount(void) {
+		return m_nCount;
+	}
+
+	void Clear(void) {
+		m_nHead = 0;
+		m_nCount = 0;
+	}
+
+	void Print(void);
+
+	static PacketTrace *Get(void) {
+		return s_pThis;
+	}
+
+private:
+	const uint8_t *GetRecord(uint32_t nIndex);
+	uint32_t GetBlockSize(int32_t nBlock);
+	uint32_t Serialize(int32_t nBlock, uint8_t *pBuffer);
+
+private:
+	uint32_t m_nRecords;
+	uint32_t m_nPayloadBytes;
+	uint32_t m_nStride;
+	uint8_t *m_pRing;
+	uint8_t *m_pBlock;
+	uint32_t m_nHead{0};
+	uint32_t m_nCount{0};
+	bool m_bFrozen{false};
+	TPacketTraceRecord *m_pLast;
+	TPacketTraceRecord m_Dummy;
+	// Export
+	uint64_t m_nFreezeMicros{0};	///< Time since the epoch
+	uint32_t m_nFreezeCounter{0};	///< Hardware::Micros() when frozen
+	int32_t m_nCursorBlock{-1};
+	uint32_t m_nCursorOffset{0};
+
+	static PacketTrace *s_pThis;
+};
+
+#endif /* PACKETTRACE_H_ */
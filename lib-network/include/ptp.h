@@ -0,0 +1,144 @@
+/**
+ * @file ptp.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PTP_H_
+#define PTP_H_
+
+#include <stdint.h>
+
+/**
+ * IEEE 1588-2008 (PTPv2) Annex D - Transport of PTP over UDP over IPv4
+ */
+
+#define PTP_MULTICAST_ADDRESS	"224.0.1.129"
+
+enum TPtpUdpPort {
+	PTP_UDP_PORT_EVENT = 319,
+	PTP_UDP_PORT_GENERAL = 320
+};
+
+enum TPtpVersion {
+	PTP_VERSION = 2
+};
+
+enum TPtpMessageType {
+	PTP_MESSAGE_SYNC = 0x0,
+	PTP_MESSAGE_DELAY_REQ = 0x1,
+	PTP_MESSAGE_FOLLOW_UP = 0x8,
+	PTP_MESSAGE_DELAY_RESP = 0x9,
+	PTP_MESSAGE_ANNOUNCE = 0xB
+};
+
+enum TPtpControl {
+	PTP_CONTROL_SYNC = 0x00,
+	PTP_CONTROL_DELAY_REQ = 0x01,
+	PTP_CONTROL_FOLLOW_UP = 0x02,
+	PTP_CONTROL_DELAY_RESP = 0x03,
+	PTP_CONTROL_OTHER = 0x05
+};
+
+/**
+ * flagField in host byte order
+ */
+enum TPtpFlags {
+	PTP_FLAG_TWO_STEP = (1U << 9),
+	PTP_FLAG_UTC_OFFSET_VALID = (1U << 2)
+};
+
+enum TPtpLogInterval {
+	PTP_LOG_INTERVAL_UNICAST = 0x7F
+};
+
+enum TPtpIdentity {
+	PTP_CLOCK_IDENTITY_SIZE = 8
+};
+
+struct TPtpPortIdentity {
+	uint8_t ClockIdentity[PTP_CLOCK_IDENTITY_SIZE];
+	uint16_t PortNumber;
+}__attribute__((packed));
+
+struct TPtpTimestamp {
+	uint16_t SecondsHigh;
+	uint32_t SecondsLow;
+	uint32_t NanoSeconds;
+}__attribute__((packed));
+
+struct TPtpHeader {
+	uint8_t MessageType;		///< transportSpecific (4 bits) | messageType (4 bits)
+	uint8_t Version;			///< reserved (4 bits) | versionPTP (4 bits)
+	uint16_t MessageLength;
+	uint8_t DomainNumber;
+	uint8_t Reserved1;
+	uint16_t FlagField;
+	uint64_t CorrectionField;	///< Nanoseconds multiplied by 2^16
+	uint32_t Reserved2;
+	struct TPtpPortIdentity SourcePortIdentity;
+	uint16_t SequenceId;
+	uint8_t ControlField;
+	int8_t LogMessageInterval;
+}__attribute__((packed));
+
+struct TPtpSync {	///< Also used for Delay_Req
+	struct TPtpHeader Header;
+	struct TPtpTimestamp OriginTimestamp;
+}__attribute__((packed));
+
+struct TPtpFollowUp {
+	struct TPtpHeader Header;
+	struct TPtpTimestamp PreciseOriginTimestamp;
+}__attribute__((packed));
+
+struct TPtpDelayResp {
+	struct TPtpHeader Header;
+	struct TPtpTimestamp ReceiveTimestamp;
+	struct TPtpPortIdentity RequestingPortIdentity;
+}__attribute__((packed));
+
+struct TPtpAnnounce {
+	struct TPtpHeader Header;
+	struct TPtpTimestamp OriginTimestamp;
+	int16_t CurrentUtcOffset;
+	uint8_t Reserved;
+	uint8_t GrandmasterPriority1;
+	uint8_t GrandmasterClockClass;
+	uint8_t GrandmasterClockAccuracy;
+	uint16_t GrandmasterOffsetScaledLogVariance;
+	uint8_t GrandmasterPriority2;
+	uint8_t GrandmasterIdentity[PTP_CLOCK_IDENTITY_SIZE];
+	uint16_t StepsRemoved;
+	uint8_t TimeSource;
+}__attribute__((packed));
+
+union UPtpPacket {
+	struct TPtpHeader Header;
+	struct TPtpSync Sync;
+	struct TPtpFollowUp FollowUp;
+	struct TPtpDelayResp DelayResp;
+	struct TPtpAnnounce Announce;
+	uint8_t Buffer[128];
+};
+
+#endif /* PTP_H_ */
@@ -0,0 +1,164 @@
+/**
+ * @file ptpclient.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PTPCLIENT_H_
+#define PTPCLIENT_H_
+
+#include <stdint.h>
+
+#include "ptp.h"
+
+enum class PtpClientStatus {
+	STOPPED,
+	LISTENING,		///< No master selected
+	UNCALIBRATED,	///< Master selected, servo not yet converged
+	LOCKED
+};
+
+struct PtpClientHistogram {
+	static constexpr uint32_t BUCKETS = 16;	///< [0] < 1us, [n] < 2^n us, [15] >= 16.384 ms
+};
+
+/**
+ * End-to-end, two-step, ordinary clock slave (UDP/IPv4 multicast).
+ * The time stamps are taken in software at the moment the packet is
+ * read from the network, so the accuracy is limited by the polling latency of Run().
+ */
+class PtpClient {
+public:
+	PtpClient(uint8_t nDomain = 0);
+	~PtpClient(void);
+
+	void Start(void);
+	void Stop(void);
+
+	void Run(void);
+
+	void Print(void);
+
+	PtpClientStatus GetStatus(void) {
+		return m_tStatus;
+	}
+
+	bool IsLocked(void) {
+		return m_tStatus == PtpClientStatus::LOCKED;
+	}
+
+	/**
+	 * PTP timescale (TAI)
+	 */
+	void GetTime(uint32_t &nSeconds, uint32_t &nNanoSeconds);
+	uint64_t GetTime(void);
+
+	int64_t GetOffset(void) {
+		return m_nOffset;
+	}
+
+	int64_t GetMeanPathDelay(void) {
+		return m_nMeanPathDelay;
+	}
+
+	int32_t GetFrequency(void) {
+		return m_nFrequency;
+	}
+
+	uint32_t GetHistogram(uint32_t nBucket) {
+		return nBucket < PtpClientHistogram::BUCKETS ? m_aHistogram[nBucket] : 0;
+	}
+
+	void ResetHistogram(void);
+
+	static PtpClient *Get(void) {
+		return s_pThis;
+	}
+
+private:
+	void HandleEvent(void);
+	void HandleGeneral(void);
+	void HandleAnnounce(uint32_t nFromIp);
+	void HandleFollowUp(void);
+	void HandleDelayResp(void);
+
+	void SendDelayReq(void);
+	void Sample(void);
+	void Servo(int64_t nOffset);
+	void Step(int64_t nOffset);
+
+	void UpdateClock(void);
+	bool IsFromMaster(void);
+
+	static uint32_t LogIntervalToMillis(int8_t nLogInterval);
+	static int64_t ToNanoSeconds(const struct TPtpTimestamp &Timestamp);
+	static int64_t CorrectionToNanoSeconds(uint64_t nCorrectionField);
+
+private:
+	uint8_t m_nDomain;
+	uint32_t m_nMulticastIp;
+	int32_t m_nHandleEvent;
+	int32_t m_nHandleGeneral;
+	PtpClientStatus m_tStatus;
+	UPtpPacket m_Packet;
+	struct TPtpSync m_DelayReq;
+	struct TPtpPortIdentity m_PortIdentity;
+	// Selected master
+	struct TPtpPortIdentity m_MasterIdentity;
+	uint8_t m_aMasterDataset[6 + PTP_CLOCK_IDENTITY_SIZE];	///< Ordered as compared by the BMC algorithm
+	uint32_t m_nMasterIp;
+	uint32_t m_nMillisAnnounce;
+	uint32_t m_nAnnounceTimeoutMillis;
+	int16_t m_nUtcOffset;
+	bool m_bUtcOffsetValid;
+	// Sync / Follow_Up
+	uint16_t m_nSyncSequenceId;
+	bool m_bSyncPending;
+	int64_t m_nT1;
+	int64_t m_nT2;
+	int64_t m_nMasterToSlave;
+	bool m_bMasterToSlaveValid;
+	int8_t m_nLogSyncInterval;
+	// Delay_Req / Delay_Resp
+	uint16_t m_nDelayReqSequenceId;
+	bool m_bDelayReqPending;
+	int64_t m_nT3;
+	uint32_t m_nMillisDelayReq;
+	uint32_t m_nDelayReqIntervalMillis;
+	int64_t m_nMeanPathDelay;
+	bool m_bMeanPathDelayValid;
+	// Local clock, disciplined by the servo
+	uint32_t m_nClockMicros;
+	int64_t m_nClockNanoSeconds;
+	int64_t m_nClockFraction;
+	int32_t m_nTimeZoneOffset;
+	int32_t m_nFrequency;	///< ppb
+	float m_fDrift;			///< ppb
+	int64_t m_nOffset;
+	uint32_t m_nLockCount;
+	uint32_t m_nSteps;
+	uint32_t m_aHistogram[PtpClientHistogram::BUCKETS];
+
+	static PtpClient *s_pThis;
+};
+
+#endif /* PTPCLIENT_H_ */
@@ -33,6 +33,9 @@
 #include <net/if.h>
 #include <ifaddrs.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
 #include <cassert>
 
 #include "networklinux.h"
@@ -121,7 +124,7 @@ int NetworkLinux::Init(const char *s) {
 
 	i = 0;
 
-	while(i < NETWORK_HOSTNAME_SIZE && m_aHostName[i] != '.') {
+	while(i < (NETWORK_HOSTNAME_SIZE - 1) && m_aHostName[i] != '.') {
 		i++;
 	}
 
@@ -129,7 +132,7 @@ int NetworkLinux::Init(const char *s) {
 
 	uint32_t j = 0;
 
-	while (j < NETWORK_DOMAINNAME_SIZE && i < NETWORK_HOSTNAME_SIZE && m_aHostName[i] != '\0') {
+	while (j < (NETWORK_DOMAINNAME_SIZE - 1) && i < NETWORK_HOSTNAME_SIZE && m_aHostName[i] != '\0') {
 		m_aDomainName[j++] = m_aHostName[i++];
 	}
 
@@ -378,6 +381,113 @@ void NetworkLinux::SendTo(int32_t nHandle, const void *pPacket, uint16_t nSize,
 	}
 }
 
+#if !defined (MSG_NOSIGNAL)
+# define MSG_NOSIGNAL	0
+#endif
+
+int32_t NetworkLinux::TcpBegin(uint32_t nRemoteIp, uint16_t nRemotePort) {
+	DEBUG_ENTRY
+
+	int nHandle;
+
+	if ((nHandle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP)) == -1) {
+		perror("socket");
+		DEBUG_EXIT
+		return -1;
+	}
+
+	if (fcntl(nHandle, F_SETFL, fcntl(nHandle, F_GETFL, 0) | O_NONBLOCK) == -1) {
+		perror("fcntl");
+		close(nHandle);
+		DEBUG_EXIT
+		return -1;
+	}
+
+	struct sockaddr_in si_other;
+
+	memset(&si_other, 0, sizeof(si_other));
+	si_other.sin_family = AF_INET;
+	si_other.sin_addr.s_addr = nRemoteIp;
+	si_other.sin_port = htons(nRemotePort);
+
+	if ((connect(nHandle, reinterpret_cast<struct sockaddr*>(&si_other), sizeof(si_other)) == -1) && (errno != EINPROGRESS)) {
+		perror("connect");
+		close(nHandle);
+		DEBUG_EXIT
+		return -1;
+	}
+
+	DEBUG_PRINTF("nHandle=%d", nHandle);
+	DEBUG_EXIT
+	return nHandle;
+}
+
+void NetworkLinux::TcpEnd(int32_t nHandle) {
+	DEBUG_PRINTF("nHandle=%d", nHandle);
+
+	if (nHandle >= 0) {
+		close(nHandle);
+	}
+}
+
+bool NetworkLinux::TcpIsConnected(int32_t nHandle) {
+	struct pollfd pfd;
+
+	pfd.fd = nHandle;
+	pfd.events = POLLOUT;
+	pfd.revents = 0;
+
+	if (poll(&pfd, 1, 0) != 1) {
+		return false;
+	}
+
+	int nError = 0;
+	socklen_t nLength = sizeof(nError);
+
+	if ((getsockopt(nHandle, SOL_SOCKET, SO_ERROR, &nError, &nLength) == -1) || (nError != 0)) {
+		return false;
+	}
+
+	return (pfd.revents & POLLOUT) == POLLOUT;
+}
+
+int32_t NetworkLinux::TcpRead(int32_t nHandle, void *pBuffer, uint16_t nLength) {
+	assert(pBuffer != NULL);
+
+	const ssize_t nBytes = recv(nHandle, pBuffer, nLength, 0);
+
+	if (nBytes == 0) {
+		return -1;	// Closed by the peer
+	}
+
+	if (nBytes == -1) {
+		if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+			return 0;
+		}
+		perror("recv");
+		return -1;
+	}
+
+	return static_cast<int32_t>(nBytes);
+}
+
+int32_t NetworkLinux::TcpWrite(int32_t nHandle, const void *pBuffer, uint16_t nLength) {
+	assert(pBuffer != NULL);
+
+	// Never waits for a full socket buffer, the caller keeps the bytes not sent
+	const ssize_t nBytes = send(nHandle, pBuffer, nLength, MSG_NOSIGNAL);
+
+	if (nBytes == -1) {
+		if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+			return 0;
+		}
+		perror("send");
+		return -1;
+	}
+
+	return static_cast<int32_t>(nBytes);
+}
+
 #if defined(__linux__)
 bool NetworkLinux::IsDhclient(const char* if_name) {
 	char cmd[255];
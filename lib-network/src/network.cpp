@@ -66,6 +66,25 @@ void Network::Shutdown(void) {
 	DEBUG_EXIT
 }
 
+int32_t Network::TcpBegin(__attribute__((unused)) uint32_t nRemoteIp, __attribute__((unused)) uint16_t nRemotePort) {
+	return -1;
+}
+
+void Network::TcpEnd(__attribute__((unused)) int32_t nHandle) {
+}
+
+bool Network::TcpIsConnected(__attribute__((unused)) int32_t nHandle) {
+	return false;
+}
+
+int32_t Network::TcpRead(__attribute__((unused)) int32_t nHandle, __attribute__((unused)) void *pBuffer, __attribute__((unused)) uint16_t nLength) {
+	return -1;
+}
+
+int32_t Network::TcpWrite(__attribute__((unused)) int32_t nHandle, __attribute__((unused)) const void *pBuffer, __attribute__((unused)) uint16_t nLength) {
+	return -1;
+}
+
 void Network::SetQueuedStaticIp(uint32_t nLocalIp, uint32_t nNetmask) {
 	DEBUG_ENTRY
 	DEBUG_PRINTF(IPSTR ", nNetmask=" IPSTR, IP2STR(nLocalIp), IP2STR(nNetmask));
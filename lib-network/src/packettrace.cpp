@@ -0,0 +1,300 @@
+/**
+ * @file packettrace.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cassert>
+
+#include "packettrace.h"
+
+#include "network.h"
+#include "hardware.h"
+
+#include "debug.h"
+
+namespace pcapng {
+static constexpr uint32_t BLOCK_TYPE_SHB = 0x0A0D0D0A;
+static constexpr uint32_t BLOCK_TYPE_IDB = 0x00000001;
+static constexpr uint32_t BLOCK_TYPE_EPB = 0x00000006;
+static constexpr uint32_t BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+static constexpr uint16_t LINKTYPE_IPV4 = 228;
+static constexpr uint16_t OPTION_COMMENT = 1;
+static constexpr uint32_t SHB_SIZE = 28;
+static constexpr uint32_t IDB_SIZE = 20;
+static constexpr uint32_t COMMENT_LENGTH = 36;	///< Fixed width, multiple of 4
+static constexpr uint32_t EPB_FIXED_SIZE = 28 + 4 + COMMENT_LENGTH + 4 + 4;
+static constexpr uint32_t IP_UDP_HEADER_SIZE = 28;
+}  // namespace pcapng
+
+static const char *s_aResult[] = { "accepted", "ignored", "discarded", "invalid" };
+
+PacketTrace *PacketTrace::s_pThis = 0;
+
+PacketTrace::PacketTrace(uint32_t nRecords, uint32_t nPayloadBytes):
+	m_nRecords(nRecords),
+	m_nPayloadBytes(nPayloadBytes)
+{
+	DEBUG_ENTRY
+
+	assert(s_pThis == 0);
+	s_pThis = this;
+
+	assert(m_nRecords != 0);
+
+	m_nStride = sizeof(struct TPacketTraceRecord) + ((m_nPayloadBytes + 3) & ~3U);
+
+	m_pRing = new uint8_t[m_nRecords * m_nStride];
+	assert(m_pRing != 0);
+
+	m_pBlock = new uint8_t[pcapng::EPB_FIXED_SIZE + pcapng::IP_UDP_HEADER_SIZE + m_nPayloadBytes + 4];
+	assert(m_pBlock != 0);
+
+	memset(&m_Dummy, 0, sizeof(struct TPacketTraceRecord));
+	m_pLast = &m_Dummy;
+
+	DEBUG_PRINTF("m_nRecords=%u, m_nPayloadBytes=%u, m_nStride=%u", m_nRecords, m_nPayloadBytes, m_nStride);
+	DEBUG_EXIT
+}
+
+PacketTrace::~PacketTrace(void) {
+	delete[] m_pBlock;
+	m_pBlock = 0;
+
+	delete[] m_pRing;
+	m_pRing = 0;
+
+	s_pThis = 0;
+}
+
+void PacketTrace::Freeze(void) {
+	m_bFrozen = true;
+
+	m_nFreezeCounter = Hardware::Get()->Micros();
+	m_nFreezeMicros = static_cast<uint64_t>(Hardware::Get()->GetTime()) * 1000000;
+
+	m_nCursorBlock = -1;
+	m_nCursorOffset = 0;
+}
+
+void PacketTrace::Resume(void) {
+	m_bFrozen = false;
+}
+
+const uint8_t *PacketTrace::GetRecord(uint32_t nIndex) {
+	// nIndex 0 is the oldest record
+	uint32_t nPosition = m_nHead + m_nRecords - m_nCount + nIndex;
+
+	if (nPosition >= m_nRecords) {
+		nPosition -= m_nRecords;
+	}
+
+	return &m_pRing[nPosition * m_nStride];
+}
+
+/**
+ * Block -1 is the Section Header Block followed by the Interface Description Block
+ */
+uint32_t PacketTrace::GetBlockSize(int32_t nBlock) {
+	if (nBlock < 0) {
+		return pcapng::SHB_SIZE + pcapng::IDB_SIZE;
+	}
+
+	const auto *pRecord = reinterpret_cast<const TPacketTraceRecord*>(GetRecord(static_cast<uint32_t>(nBlock)));
+	const uint32_t nCaptured = pcapng::IP_UDP_HEADER_SIZE + (pRecord->nLength < m_nPayloadBytes ? pRecord->nLength : m_nPayloadBytes);
+
+	return pcapng::EPB_FIXED_SIZE + ((nCaptured + 3) & ~3U);
+}
+
+uint32_t PacketTrace::GetFileSize(void) {
+	uint32_t nSize = GetBlockSize(-1);
+
+	for (uint32_t i = 0; i < m_nCount; i++) {
+		nSize += GetBlockSize(static_cast<int32_t>(i));
+	}
+
+	return nSize;
+}
+
+static uint8_t *Put32(uint8_t *p, uint32_t n) {
+	memcpy(p, &n, 4);
+	return p + 4;
+}
+
+static uint8_t *Put16(uint8_t *p, uint16_t n) {
+	memcpy(p, &n, 2);
+	return p + 2;
+}
+
+static uint16_t Checksum(const uint8_t *p, uint32_t nLength) {
+	uint32_t nSum = 0;
+
+	for (uint32_t i = 0; i < nLength; i += 2) {
+		nSum += static_cast<uint32_t>((p[i] << 8) | p[i + 1]);
+	}
+
+	while ((nSum >> 16) != 0) {
+		nSum = (nSum & 0xFFFF) + (nSum >> 16);
+	}
+
+	return static_cast<uint16_t>(~nSum);
+}
+
+uint32_t PacketTrace::Serialize(int32_t nBlock, uint8_t *pBuffer) {
+	uint8_t *p = pBuffer;
+
+	if (nBlock < 0) {
+		p = Put32(p, pcapng::BLOCK_TYPE_SHB);
+		p = Put32(p, pcapng::SHB_SIZE);
+		p = Put32(p, pcapng::BYTE_ORDER_MAGIC);
+		p = Put16(p, 1);	// Major version
+		p = Put16(p, 0);	// Minor version
+		p = Put32(p, 0xFFFFFFFF);	// Section length not specified
+		p = Put32(p, 0xFFFFFFFF);
+		p = Put32(p, pcapng::SHB_SIZE);
+
+		p = Put32(p, pcapng::BLOCK_TYPE_IDB);
+		p = Put32(p, pcapng::IDB_SIZE);
+		p = Put16(p, pcapng::LINKTYPE_IPV4);
+		p = Put16(p, 0);
+		p = Put32(p, pcapng::IP_UDP_HEADER_SIZE + m_nPayloadBytes);	// Snap length
+		p = Put32(p, pcapng::IDB_SIZE);
+
+		return static_cast<uint32_t>(p - pBuffer);
+	}
+
+	const uint8_t *pRecordData = GetRecord(static_cast<uint32_t>(nBlock));
+	const auto *pRecord = reinterpret_cast<const TPacketTraceRecord*>(pRecordData);
+
+	const uint32_t nPayload = pRecord->nLength < m_nPayloadBytes ? pRecord->nLength : m_nPayloadBytes;
+	const uint32_t nCaptured = pcapng::IP_UDP_HEADER_SIZE + nPayload;
+	const uint32_t nBlockSize = pcapng::EPB_FIXED_SIZE + ((nCaptured + 3) & ~3U);
+	const uint64_t nTimestamp = m_nFreezeMicros - (m_nFreezeCounter - pRecord->nMicros);
+
+	p = Put32(p, pcapng::BLOCK_TYPE_EPB);
+	p = Put32(p, nBlockSize);
+	p = Put32(p, 0);	// Interface ID
+	p = Put32(p, static_cast<uint32_t>(nTimestamp >> 32));
+	p = Put32(p, static_cast<uint32_t>(nTimestamp));
+	p = Put32(p, nCaptured);
+	p = Put32(p, pcapng::IP_UDP_HEADER_SIZE + pRecord->nLength);
+
+	// Synthesized IPv4 header, the destination is the node itself
+	const uint16_t nTotalLength = static_cast<uint16_t>(pcapng::IP_UDP_HEADER_SIZE + pRecord->nLength);
+	const uint32_t nLocalIp = Network::Get()->GetIp();
+	uint8_t *pIp = p;
+
+	*p++ = 0x45;
+	*p++ = 0x00;
+	p = Put16(p, __builtin_bswap16(nTotalLength));
+	p = Put16(p, 0);
+	p = Put16(p, __builtin_bswap16(0x4000));	// Don't fragment
+	*p++ = 64;	// TTL
+	*p++ = 17;	// UDP
+	p = Put16(p, 0);
+	p = Put32(p, pRecord->nFromIp);
+	p = Put32(p, nLocalIp);
+
+	const uint16_t nChecksum = Checksum(pIp, 20);
+	pIp[10] = static_cast<uint8_t>(nChecksum >> 8);
+	pIp[11] = static_cast<uint8_t>(nChecksum);
+
+	// UDP header, no checksum
+	p = Put16(p, __builtin_bswap16(pRecord->nFromPort));
+	p = Put16(p, __builtin_bswap16(pRecord->nPort));
+	p = Put16(p, __builtin_bswap16(static_cast<uint16_t>(8 + pRecord->nLength)));
+	p = Put16(p, 0);
+
+	memcpy(p, &pRecordData[sizeof(struct TPacketTraceRecord)], nPayload);
+	p += nPayload;
+
+	while (((p - pBuffer) & 3) != 0) {
+		*p++ = 0;
+	}
+
+	// Option comment with the handling result, fixed width
+	p = Put16(p, pcapng::OPTION_COMMENT);
+	p = Put16(p, pcapng::COMMENT_LENGTH);
+
+	char aComment[pcapng::COMMENT_LENGTH + 1];
+	memset(aComment, ' ', sizeof aComment);
+	snprintf(aComment, sizeof aComment, "%-9s u=%5u s=%3u op=0x%04x", s_aResult[static_cast<uint32_t>(pRecord->tResult) & 0x3], pRecord->nUniverse, pRecord->nSequence, pRecord->nOpCode);
+
+	for (uint32_t i = 0; i < pcapng::COMMENT_LENGTH; i++) {
+		*p++ = aComment[i] == '\0' ? ' ' : static_cast<uint8_t>(aComment[i]);
+	}
+
+	p = Put32(p, 0);	// opt_endofopt
+	p = Put32(p, nBlockSize);
+
+	assert(static_cast<uint32_t>(p - pBuffer) == nBlockSize);
+
+	return nBlockSize;
+}
+
+/**
+ * Random access into the pcapng file. The (TFTP) reads are sequential,
+ * so a cursor is kept to avoid walking the ring from the start for each read.
+ */
+uint32_t PacketTrace::Read(uint32_t nOffset, void *pBuffer, uint32_t nCount) {
+	auto *pDestination = reinterpret_cast<uint8_t*>(pBuffer);
+	uint32_t nCopied = 0;
+
+	if (nOffset < m_nCursorOffset) {
+		m_nCursorBlock = -1;
+		m_nCursorOffset = 0;
+	}
+
+	while ((nCopied < nCount) && (m_nCursorBlock < static_cast<int32_t>(m_nCount))) {
+		const uint32_t nBlockSize = GetBlockSize(m_nCursorBlock);
+		const uint32_t nPosition = nOffset + nCopied;
+
+		if (nPosition >= (m_nCursorOffset + nBlockSize)) {
+			m_nCursorOffset += nBlockSize;
+			m_nCursorBlock++;
+			continue;
+		}
+
+		Serialize(m_nCursorBlock, m_pBlock);
+
+		const uint32_t nStart = nPosition - m_nCursorOffset;
+		uint32_t nChunk = nBlockSize - nStart;
+
+		if (nChunk > (nCount - nCopied)) {
+			nChunk = nCount - nCopied;
+		}
+
+		memcpy(&pDestination[nCopied], &m_pBlock[nStart], nChunk);
+		nCopied += nChunk;
+	}
+
+	return nCopied;
+}
+
+void PacketTrace::Print(void) {
+	printf("Packet trace\n");
+	printf(" Records : %u/%u\n", m_nCount, m_nRecords);
+	printf(" Payload : %u bytes\n", m_nPayloadBytes);
+}
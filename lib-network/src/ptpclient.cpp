@@ -0,0 +1,585 @@
+/**
+ * @file ptpclient.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <cassert>
+
+#include "ptpclient.h"
+#include "ptp.h"
+
+#include "utc.h"
+
+#include "network.h"
+#include "hardware.h"
+
+#include "debug.h"
+
+#define NANOS_PER_SECOND			1000000000LL
+#define STEP_THRESHOLD_NANOS		1000000		// 1 ms
+#define LOCK_THRESHOLD_NANOS		50000		// 50 us
+#define LOCK_COUNT					4			// Consecutive samples within the lock threshold
+#define FREQUENCY_MAX_PPB			500000		// 500 ppm
+#define SERVO_KP					0.7f		// Sync interval of 1 second and longer: SERVO_KP / interval
+#define SERVO_KI					0.3f		// Sync interval of 1 second and longer: SERVO_KI / interval
+#define ANNOUNCE_RECEIPT_TIMEOUT	3
+#define PATH_DELAY_FILTER_SHIFT		3			// Exponential average over 8 samples
+
+PtpClient *PtpClient::s_pThis = 0;
+
+PtpClient::PtpClient(uint8_t nDomain):
+	m_nDomain(nDomain),
+	m_nHandleEvent(-1),
+	m_nHandleGeneral(-1),
+	m_tStatus(PtpClientStatus::STOPPED),
+	m_nMasterIp(0),
+	m_nMillisAnnounce(0),
+	m_nAnnounceTimeoutMillis(0),
+	m_nUtcOffset(0),
+	m_bUtcOffsetValid(false),
+	m_nSyncSequenceId(0),
+	m_bSyncPending(false),
+	m_nT1(0),
+	m_nT2(0),
+	m_nMasterToSlave(0),
+	m_bMasterToSlaveValid(false),
+	m_nLogSyncInterval(0),
+	m_nDelayReqSequenceId(0),
+	m_bDelayReqPending(false),
+	m_nT3(0),
+	m_nMillisDelayReq(0),
+	m_nDelayReqIntervalMillis(1000),
+	m_nMeanPathDelay(0),
+	m_bMeanPathDelayValid(false),
+	m_nClockMicros(0),
+	m_nClockNanoSeconds(0),
+	m_nClockFraction(0),
+	m_nFrequency(0),
+	m_fDrift(0),
+	m_nOffset(0),
+	m_nLockCount(0),
+	m_nSteps(0)
+{
+	DEBUG_ENTRY
+
+	assert(s_pThis == 0);
+	s_pThis = this;
+
+	struct in_addr group_ip;
+	static_cast<void>(inet_aton(PTP_MULTICAST_ADDRESS, &group_ip));
+	m_nMulticastIp = group_ip.s_addr;
+
+	m_nTimeZoneOffset = Utc::Validate(Network::Get()->GetNtpUtcOffset());
+
+	// EUI-64 clock identity derived from the EUI-48 MAC address
+	uint8_t aMacAddress[NETWORK_MAC_SIZE];
+	Network::Get()->MacAddressCopyTo(aMacAddress);
+
+	m_PortIdentity.ClockIdentity[0] = aMacAddress[0];
+	m_PortIdentity.ClockIdentity[1] = aMacAddress[1];
+	m_PortIdentity.ClockIdentity[2] = aMacAddress[2];
+	m_PortIdentity.ClockIdentity[3] = 0xFF;
+	m_PortIdentity.ClockIdentity[4] = 0xFE;
+	m_PortIdentity.ClockIdentity[5] = aMacAddress[3];
+	m_PortIdentity.ClockIdentity[6] = aMacAddress[4];
+	m_PortIdentity.ClockIdentity[7] = aMacAddress[5];
+	m_PortIdentity.PortNumber = __builtin_bswap16(1);
+
+	memset(&m_MasterIdentity, 0, sizeof m_MasterIdentity);
+	memset(m_aMasterDataset, 0xFF, sizeof m_aMasterDataset);
+
+	memset(&m_DelayReq, 0, sizeof m_DelayReq);
+
+	m_DelayReq.Header.MessageType = PTP_MESSAGE_DELAY_REQ;
+	m_DelayReq.Header.Version = PTP_VERSION;
+	m_DelayReq.Header.MessageLength = __builtin_bswap16(sizeof m_DelayReq);
+	m_DelayReq.Header.DomainNumber = m_nDomain;
+	memcpy(&m_DelayReq.Header.SourcePortIdentity, &m_PortIdentity, sizeof m_PortIdentity);
+	m_DelayReq.Header.ControlField = PTP_CONTROL_DELAY_REQ;
+	m_DelayReq.Header.LogMessageInterval = PTP_LOG_INTERVAL_UNICAST;
+
+	ResetHistogram();
+
+	DEBUG_EXIT
+}
+
+PtpClient::~PtpClient(void) {
+	Stop();
+	s_pThis = 0;
+}
+
+void PtpClient::Start(void) {
+	DEBUG_ENTRY
+
+	if (m_tStatus != PtpClientStatus::STOPPED) {
+		DEBUG_EXIT
+		return;
+	}
+
+	m_nHandleEvent = Network::Get()->Begin(PTP_UDP_PORT_EVENT);
+	assert(m_nHandleEvent != -1);
+	Network::Get()->JoinGroup(m_nHandleEvent, m_nMulticastIp);
+
+	m_nHandleGeneral = Network::Get()->Begin(PTP_UDP_PORT_GENERAL);
+	assert(m_nHandleGeneral != -1);
+	Network::Get()->JoinGroup(m_nHandleGeneral, m_nMulticastIp);
+
+	m_nClockMicros = Hardware::Get()->Micros();
+	m_tStatus = PtpClientStatus::LISTENING;
+
+	DEBUG_EXIT
+}
+
+void PtpClient::Stop(void) {
+	DEBUG_ENTRY
+
+	if (m_tStatus == PtpClientStatus::STOPPED) {
+		DEBUG_EXIT
+		return;
+	}
+
+	Network::Get()->LeaveGroup(m_nHandleGeneral, m_nMulticastIp);
+	Network::Get()->End(PTP_UDP_PORT_GENERAL);
+	m_nHandleGeneral = -1;
+
+	Network::Get()->LeaveGroup(m_nHandleEvent, m_nMulticastIp);
+	Network::Get()->End(PTP_UDP_PORT_EVENT);
+	m_nHandleEvent = -1;
+
+	m_tStatus = PtpClientStatus::STOPPED;
+
+	DEBUG_EXIT
+}
+
+void PtpClient::ResetHistogram(void) {
+	for (uint32_t i = 0; i < PtpClientHistogram::BUCKETS; i++) {
+		m_aHistogram[i] = 0;
+	}
+}
+
+uint32_t PtpClient::LogIntervalToMillis(int8_t nLogInterval) {
+	if (nLogInterval > 6) {
+		nLogInterval = 6;
+	} else if (nLogInterval < -7) {
+		nLogInterval = -7;
+	}
+
+	if (nLogInterval >= 0) {
+		return 1000U << nLogInterval;
+	}
+
+	return 1000U >> (-nLogInterval);
+}
+
+int64_t PtpClient::ToNanoSeconds(const struct TPtpTimestamp &Timestamp) {
+	const uint64_t nSeconds = (static_cast<uint64_t>(__builtin_bswap16(Timestamp.SecondsHigh)) << 32) | __builtin_bswap32(Timestamp.SecondsLow);
+	return static_cast<int64_t>(nSeconds) * NANOS_PER_SECOND + __builtin_bswap32(Timestamp.NanoSeconds);
+}
+
+int64_t PtpClient::CorrectionToNanoSeconds(uint64_t nCorrectionField) {
+	return static_cast<int64_t>(__builtin_bswap64(nCorrectionField)) / 65536;
+}
+
+/**
+ * The local clock is free running on Hardware::Micros() and corrected with the servo frequency.
+ * Run() must be called at least once per 71 minutes (32-bit micro seconds wrap around).
+ */
+void PtpClient::UpdateClock(void) {
+	const uint32_t nMicros = Hardware::Get()->Micros();
+	const int64_t nElapsed = static_cast<int64_t>(nMicros - m_nClockMicros) * 1000;
+	m_nClockMicros = nMicros;
+
+	m_nClockFraction += nElapsed * m_nFrequency;
+	const int64_t nAdjust = m_nClockFraction / NANOS_PER_SECOND;
+	m_nClockFraction -= nAdjust * NANOS_PER_SECOND;
+
+	m_nClockNanoSeconds += nElapsed + nAdjust;
+}
+
+uint64_t PtpClient::GetTime(void) {
+	UpdateClock();
+	return static_cast<uint64_t>(m_nClockNanoSeconds);
+}
+
+void PtpClient::GetTime(uint32_t &nSeconds, uint32_t &nNanoSeconds) {
+	const uint64_t nTime = GetTime();
+	nSeconds = static_cast<uint32_t>(nTime / NANOS_PER_SECOND);
+	nNanoSeconds = static_cast<uint32_t>(nTime % NANOS_PER_SECOND);
+}
+
+bool PtpClient::IsFromMaster(void) {
+	return memcmp(&m_Packet.Header.SourcePortIdentity, &m_MasterIdentity, sizeof m_MasterIdentity) == 0;
+}
+
+void PtpClient::Step(int64_t nOffset) {
+	DEBUG_PRINTF("nOffset=%lld", static_cast<long long>(nOffset));
+
+	m_nClockNanoSeconds -= nOffset;
+	m_nSteps++;
+	m_nLockCount = 0;
+	m_tStatus = PtpClientStatus::UNCALIBRATED;
+
+	// The Delay_Req time stamp belongs to the previous time scale
+	m_bDelayReqPending = false;
+	m_bMasterToSlaveValid = false;
+
+	time_t nTime = static_cast<time_t>(m_nClockNanoSeconds / NANOS_PER_SECOND) + m_nTimeZoneOffset;
+
+	if (m_bUtcOffsetValid) {
+		nTime -= m_nUtcOffset;
+	}
+
+	Hardware::Get()->SetSysTime(nTime);
+}
+
+namespace servo {
+/*
+ * Gains for a sync interval of 2^-7 .. 2^0 seconds: kp = 0.7 * interval^-0.3, ki = 0.3 * interval^0.4
+ * A higher sync rate gives more samples to average, so the gain per sample is lower
+ * and the jitter of the software time stamps is filtered.
+ */
+static constexpr float KP[] = { 3.001f, 2.4375f, 1.9799f, 1.6082f, 1.3062f, 1.061f, 0.8618f, SERVO_KP };
+static constexpr float KI[] = { 0.0431f, 0.0568f, 0.075f, 0.099f, 0.1306f, 0.1723f, 0.2274f, SERVO_KI };
+}  // namespace servo
+
+/**
+ * PI servo, the offset is in nanoseconds and the frequency in ppb
+ */
+void PtpClient::Servo(int64_t nOffset) {
+	if ((nOffset > STEP_THRESHOLD_NANOS) || (nOffset < -STEP_THRESHOLD_NANOS)) {
+		Step(nOffset);
+		return;
+	}
+
+	float fKp, fKi;
+
+	if (m_nLogSyncInterval > 0) {
+		const float fInterval = static_cast<float>(1U << (m_nLogSyncInterval & 0x7));
+		fKp = SERVO_KP / fInterval;
+		fKi = SERVO_KI / fInterval;
+	} else {
+		const uint32_t nIndex = static_cast<uint32_t>(m_nLogSyncInterval < -7 ? 0 : m_nLogSyncInterval + 7);
+		fKp = servo::KP[nIndex];
+		fKi = servo::KI[nIndex];
+	}
+
+	const float fOffset = static_cast<float>(nOffset);
+
+	m_fDrift -= fKi * fOffset;
+
+	if (m_fDrift > FREQUENCY_MAX_PPB) {
+		m_fDrift = FREQUENCY_MAX_PPB;
+	} else if (m_fDrift < -FREQUENCY_MAX_PPB) {
+		m_fDrift = -FREQUENCY_MAX_PPB;
+	}
+
+	float fFrequency = m_fDrift - fKp * fOffset;
+
+	if (fFrequency > FREQUENCY_MAX_PPB) {
+		fFrequency = FREQUENCY_MAX_PPB;
+	} else if (fFrequency < -FREQUENCY_MAX_PPB) {
+		fFrequency = -FREQUENCY_MAX_PPB;
+	}
+
+	UpdateClock();
+	m_nFrequency = static_cast<int32_t>(fFrequency);
+
+	if ((nOffset < LOCK_THRESHOLD_NANOS) && (nOffset > -LOCK_THRESHOLD_NANOS)) {
+		if (m_nLockCount < LOCK_COUNT) {
+			m_nLockCount++;
+		}
+
+		if (m_nLockCount == LOCK_COUNT) {
+			if (m_tStatus != PtpClientStatus::LOCKED) {
+				DEBUG_PUTS("PtpClientStatus::LOCKED");
+			}
+			m_tStatus = PtpClientStatus::LOCKED;
+		}
+	} else {
+		m_nLockCount = 0;
+		m_tStatus = PtpClientStatus::UNCALIBRATED;
+	}
+}
+
+void PtpClient::Sample(void) {
+	m_nMasterToSlave = m_nT2 - m_nT1;
+	m_bMasterToSlaveValid = true;
+
+	m_nOffset = m_nMasterToSlave - (m_bMeanPathDelayValid ? m_nMeanPathDelay : 0);
+
+	const uint64_t nAbsOffset = static_cast<uint64_t>(m_nOffset < 0 ? -m_nOffset : m_nOffset);
+	const uint64_t nMicros = nAbsOffset / 1000;
+	uint32_t nBucket = PtpClientHistogram::BUCKETS - 1;
+
+	if (nMicros < (1U << (PtpClientHistogram::BUCKETS - 2))) {
+		nBucket = nMicros == 0 ? 0 : 32U - static_cast<uint32_t>(__builtin_clz(static_cast<uint32_t>(nMicros)));
+	}
+
+	m_aHistogram[nBucket]++;
+
+	Servo(m_nOffset);
+}
+
+void PtpClient::SendDelayReq(void) {
+	m_DelayReq.Header.SequenceId = __builtin_bswap16(++m_nDelayReqSequenceId);
+
+	UpdateClock();
+	m_nT3 = m_nClockNanoSeconds;
+
+	Network::Get()->SendTo(m_nHandleEvent, &m_DelayReq, sizeof m_DelayReq, m_nMulticastIp, PTP_UDP_PORT_EVENT);
+
+	m_bDelayReqPending = true;
+	m_nMillisDelayReq = Hardware::Get()->Millis();
+}
+
+void PtpClient::HandleEvent(void) {
+	uint32_t nFromIp;
+	uint16_t nFromPort;
+
+	const uint16_t nBytesReceived = Network::Get()->RecvFrom(m_nHandleEvent, &m_Packet, sizeof m_Packet, &nFromIp, &nFromPort);
+
+	if (__builtin_expect((nBytesReceived < sizeof(struct TPtpSync)), 1)) {
+		return;
+	}
+
+	// Time stamp as close as possible to the reception
+	UpdateClock();
+	const int64_t nReceive = m_nClockNanoSeconds;
+
+	if (((m_Packet.Header.Version & 0x0F) != PTP_VERSION) || (m_Packet.Header.DomainNumber != m_nDomain)) {
+		return;
+	}
+
+	if (((m_Packet.Header.MessageType & 0x0F) != PTP_MESSAGE_SYNC) || (m_tStatus == PtpClientStatus::LISTENING) || !IsFromMaster()) {
+		return;
+	}
+
+	m_nSyncSequenceId = __builtin_bswap16(m_Packet.Header.SequenceId);
+	m_nLogSyncInterval = m_Packet.Header.LogMessageInterval;
+	m_nT2 = nReceive - CorrectionToNanoSeconds(m_Packet.Header.CorrectionField);
+
+	if ((__builtin_bswap16(m_Packet.Header.FlagField) & PTP_FLAG_TWO_STEP) == PTP_FLAG_TWO_STEP) {
+		m_bSyncPending = true;
+		return;
+	}
+
+	m_bSyncPending = false;
+	m_nT1 = ToNanoSeconds(m_Packet.Sync.OriginTimestamp);
+
+	Sample();
+}
+
+void PtpClient::HandleFollowUp(void) {
+	if (!m_bSyncPending || !IsFromMaster()) {
+		return;
+	}
+
+	if (__builtin_bswap16(m_Packet.Header.SequenceId) != m_nSyncSequenceId) {
+		DEBUG_PUTS("Follow_Up sequenceId mismatch");
+		return;
+	}
+
+	m_bSyncPending = false;
+	m_nT1 = ToNanoSeconds(m_Packet.FollowUp.PreciseOriginTimestamp) + CorrectionToNanoSeconds(m_Packet.Header.CorrectionField);
+
+	Sample();
+}
+
+void PtpClient::HandleDelayResp(void) {
+	if (!m_bDelayReqPending || !IsFromMaster()) {
+		return;
+	}
+
+	if (memcmp(&m_Packet.DelayResp.RequestingPortIdentity, &m_PortIdentity, sizeof m_PortIdentity) != 0) {
+		return;
+	}
+
+	if (__builtin_bswap16(m_Packet.Header.SequenceId) != m_nDelayReqSequenceId) {
+		return;
+	}
+
+	m_bDelayReqPending = false;
+	m_nDelayReqIntervalMillis = LogIntervalToMillis(m_Packet.Header.LogMessageInterval);
+
+	if (!m_bMasterToSlaveValid) {
+		return;
+	}
+
+	const int64_t nT4 = ToNanoSeconds(m_Packet.DelayResp.ReceiveTimestamp) - CorrectionToNanoSeconds(m_Packet.Header.CorrectionField);
+	const int64_t nPathDelay = (m_nMasterToSlave + (nT4 - m_nT3)) / 2;
+
+	if (nPathDelay < 0) {
+		DEBUG_PRINTF("nPathDelay=%lld", static_cast<long long>(nPathDelay));
+		return;
+	}
+
+	if (m_bMeanPathDelayValid) {
+		m_nMeanPathDelay += (nPathDelay - m_nMeanPathDelay) / (1 << PATH_DELAY_FILTER_SHIFT);
+	} else {
+		m_nMeanPathDelay = nPathDelay;
+		m_bMeanPathDelayValid = true;
+	}
+}
+
+void PtpClient::HandleAnnounce(uint32_t nFromIp) {
+	const struct TPtpAnnounce *pAnnounce = &m_Packet.Announce;
+
+	uint8_t aDataset[sizeof m_aMasterDataset];
+
+	aDataset[0] = pAnnounce->GrandmasterPriority1;
+	aDataset[1] = pAnnounce->GrandmasterClockClass;
+	aDataset[2] = pAnnounce->GrandmasterClockAccuracy;
+	memcpy(&aDataset[3], &pAnnounce->GrandmasterOffsetScaledLogVariance, 2); // Network byte order compares as big endian
+	aDataset[5] = pAnnounce->GrandmasterPriority2;
+	memcpy(&aDataset[6], pAnnounce->GrandmasterIdentity, PTP_CLOCK_IDENTITY_SIZE);
+
+	const bool bIsFromMaster = IsFromMaster();
+
+	if ((m_tStatus != PtpClientStatus::LISTENING) && !bIsFromMaster && (memcmp(aDataset, m_aMasterDataset, sizeof aDataset) >= 0)) {
+		return;
+	}
+
+	if (!bIsFromMaster) {
+		DEBUG_PRINTF("New master " IPSTR, IP2STR(nFromIp));
+
+		memcpy(&m_MasterIdentity, &m_Packet.Header.SourcePortIdentity, sizeof m_MasterIdentity);
+
+		m_bSyncPending = false;
+		m_bMasterToSlaveValid = false;
+		m_bDelayReqPending = false;
+		m_bMeanPathDelayValid = false;
+		m_nLockCount = 0;
+		m_tStatus = PtpClientStatus::UNCALIBRATED;
+	}
+
+	memcpy(m_aMasterDataset, aDataset, sizeof m_aMasterDataset);
+
+	m_nMasterIp = nFromIp;
+	m_nUtcOffset = static_cast<int16_t>(__builtin_bswap16(static_cast<uint16_t>(pAnnounce->CurrentUtcOffset)));
+	m_bUtcOffsetValid = ((__builtin_bswap16(m_Packet.Header.FlagField) & PTP_FLAG_UTC_OFFSET_VALID) == PTP_FLAG_UTC_OFFSET_VALID);
+	m_nAnnounceTimeoutMillis = ANNOUNCE_RECEIPT_TIMEOUT * LogIntervalToMillis(m_Packet.Header.LogMessageInterval);
+	m_nMillisAnnounce = Hardware::Get()->Millis();
+}
+
+void PtpClient::HandleGeneral(void) {
+	uint32_t nFromIp;
+	uint16_t nFromPort;
+
+	const uint16_t nBytesReceived = Network::Get()->RecvFrom(m_nHandleGeneral, &m_Packet, sizeof m_Packet, &nFromIp, &nFromPort);
+
+	if (__builtin_expect((nBytesReceived < sizeof(struct TPtpHeader)), 1)) {
+		return;
+	}
+
+	if (((m_Packet.Header.Version & 0x0F) != PTP_VERSION) || (m_Packet.Header.DomainNumber != m_nDomain)) {
+		return;
+	}
+
+	switch (m_Packet.Header.MessageType & 0x0F) {
+	case PTP_MESSAGE_ANNOUNCE:
+		if (nBytesReceived >= sizeof(struct TPtpAnnounce)) {
+			HandleAnnounce(nFromIp);
+		}
+		break;
+	case PTP_MESSAGE_FOLLOW_UP:
+		if (nBytesReceived >= sizeof(struct TPtpFollowUp)) {
+			HandleFollowUp();
+		}
+		break;
+	case PTP_MESSAGE_DELAY_RESP:
+		if (nBytesReceived >= sizeof(struct TPtpDelayResp)) {
+			HandleDelayResp();
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void PtpClient::Run(void) {
+	if (__builtin_expect((m_tStatus == PtpClientStatus::STOPPED), 0)) {
+		return;
+	}
+
+	UpdateClock();
+
+	HandleEvent();
+	HandleGeneral();
+
+	if (m_tStatus == PtpClientStatus::LISTENING) {
+		return;
+	}
+
+	const uint32_t nMillis = Hardware::Get()->Millis();
+
+	if (__builtin_expect(((nMillis - m_nMillisAnnounce) > m_nAnnounceTimeoutMillis), 0)) {
+		DEBUG_PUTS("Announce receipt timeout");
+
+		memset(&m_MasterIdentity, 0, sizeof m_MasterIdentity);
+		memset(m_aMasterDataset, 0xFF, sizeof m_aMasterDataset);
+
+		m_nMasterIp = 0;
+		m_bSyncPending = false;
+		m_bMasterToSlaveValid = false;
+		m_bDelayReqPending = false;
+		m_bMeanPathDelayValid = false;
+		m_nLockCount = 0;
+		m_tStatus = PtpClientStatus::LISTENING;
+		return;
+	}
+
+	if (m_bMasterToSlaveValid && ((nMillis - m_nMillisDelayReq) >= m_nDelayReqIntervalMillis)) {
+		SendDelayReq();
+	}
+}
+
+void PtpClient::Print(void) {
+	const char *aStatus[] = { "Stopped", "Listening", "Uncalibrated", "Locked" };
+
+	printf("PTP v%d Client\n", PTP_VERSION);
+	if (m_tStatus == PtpClientStatus::STOPPED) {
+		printf(" Not running\n");
+		return;
+	}
+	printf(" Domain : %d\n", m_nDomain);
+	printf(" Status : %s\n", aStatus[static_cast<int>(m_tStatus)]);
+	if (m_tStatus == PtpClientStatus::LISTENING) {
+		return;
+	}
+	printf(" Master : " IPSTR "\n", IP2STR(m_nMasterIp));
+	printf(" Offset : %lld (ns)\n", static_cast<long long>(m_nOffset));
+	printf(" Path delay : %lld (ns)\n", static_cast<long long>(m_nMeanPathDelay));
+	printf(" Frequency : %d (ppb)\n", m_nFrequency);
+	printf(" Steps : %u\n", m_nSteps);
+	printf(" Histogram (us) :");
+	for (uint32_t i = 0; i < PtpClientHistogram::BUCKETS; i++) {
+		printf(" %u", m_aHistogram[i]);
+	}
+	printf("\n");
+}
@@ -41,9 +41,26 @@ struct DevicesParamsConst {
 	static const char LED_GROUPING[];
 	static const char LED_GROUP_COUNT[];
 
+	static const char LED_GAMMA[];
+	static const char LED_GAMMA_RED[];
+	static const char LED_GAMMA_GREEN[];
+	static const char LED_GAMMA_BLUE[];
+	static const char LED_GAMMA_WHITE[];
+	static const char LED_16BIT[];
+	static const char LED_DITHERING[];
+
+	static const char LED_MAX_FPS[];
+	static const char LED_FRAME_TIMEOUT[];
+	static const char LED_INTERPOLATION[];
+	static const char LED_RGBW_FROM_RGB[];
+	static const char LED_WHITE_POINT_RED[];
+	static const char LED_WHITE_POINT_GREEN[];
+	static const char LED_WHITE_POINT_BLUE[];
+
 	static const char SPI_SPEED_HZ[];
 
 	static const char GLOBAL_BRIGHTNESS[];
+	static const char APA102_HDR[];
 
 	static const char ACTIVE_OUT[];
 	static const char USE_SI5351A[];
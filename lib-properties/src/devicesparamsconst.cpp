@@ -39,9 +39,26 @@ const char DevicesParamsConst::LED_COUNT[] = "led_count";
 const char DevicesParamsConst::LED_GROUPING[] = "led_grouping";
 const char DevicesParamsConst::LED_GROUP_COUNT[] = "led_group_count";
 
+const char DevicesParamsConst::LED_GAMMA[] = "led_gamma";
+const char DevicesParamsConst::LED_GAMMA_RED[] = "led_gamma_red";
+const char DevicesParamsConst::LED_GAMMA_GREEN[] = "led_gamma_green";
+const char DevicesParamsConst::LED_GAMMA_BLUE[] = "led_gamma_blue";
+const char DevicesParamsConst::LED_GAMMA_WHITE[] = "led_gamma_white";
+const char DevicesParamsConst::LED_16BIT[] = "led_16bit";
+const char DevicesParamsConst::LED_DITHERING[] = "led_dithering";
+
+const char DevicesParamsConst::LED_MAX_FPS[] = "led_max_fps";
+const char DevicesParamsConst::LED_FRAME_TIMEOUT[] = "led_frame_timeout";
+const char DevicesParamsConst::LED_INTERPOLATION[] = "led_interpolation";
+const char DevicesParamsConst::LED_RGBW_FROM_RGB[] = "led_rgbw_from_rgb";
+const char DevicesParamsConst::LED_WHITE_POINT_RED[] = "led_white_point_red";
+const char DevicesParamsConst::LED_WHITE_POINT_GREEN[] = "led_white_point_green";
+const char DevicesParamsConst::LED_WHITE_POINT_BLUE[] = "led_white_point_blue";
+
 const char DevicesParamsConst::SPI_SPEED_HZ[] = "clock_speed_hz";
 
 const char DevicesParamsConst::GLOBAL_BRIGHTNESS[] = "global_brightness";
+const char DevicesParamsConst::APA102_HDR[] = "apa102_hdr";
 
 const char DevicesParamsConst::ACTIVE_OUT[] = "active_out";
 const char DevicesParamsConst::USE_SI5351A[] = "use_si5351A";
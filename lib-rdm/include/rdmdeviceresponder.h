@@ -93,6 +93,11 @@ public:
 		m_pRDMFactoryDefaults = pRDMFactoryDefaults;
 	}
 
+	// Changes when the root device information or labels change
+	uint32_t GetConfigurationCounter(void) const {
+		return m_nConfigurationCounter;
+	}
+
 	static RDMDeviceResponder* Get(void) {
 		return s_pThis;
 	}
@@ -117,6 +122,7 @@ private:
 	uint8_t m_nCurrentPersonalityFactoryDefault;
 	//
 	RDMFactoryDefaults *m_pRDMFactoryDefaults;
+	uint32_t m_nConfigurationCounter;
 
 	static RDMDeviceResponder *s_pThis;
 };
@@ -31,6 +31,11 @@
 #include "rdmmessage.h"
 #include "rdmqueuedmessage.h"
 
+enum {
+	RDM_HANDLER_CACHE_ENTRIES = 5,
+	RDM_HANDLER_CACHE_PARAM_DATA_MAX = 64
+};
+
 class RDMHandler {
 public:
 	RDMHandler(bool bRDM = true);
@@ -53,6 +58,15 @@ private:
 	static const TPidDefinition PID_DEFINITIONS[];
 	static const TPidDefinition PID_DEFINITIONS_SUB_DEVICES[];
 
+	static const TPidDefinition *FindPid(uint16_t nPid);
+	void HandleCachedGet(uint32_t nIndex, const TPidDefinition *pPidDefinition);
+
+	struct TCachedResponse {
+		uint8_t aParamData[RDM_HANDLER_CACHE_PARAM_DATA_MAX];
+		uint8_t nLength;
+		bool bIsValid;
+	};
+
 	// Get
 	void GetQueuedMessage(uint16_t nSubDevice);
 	void GetSupportedParameters(uint16_t nSubDevice);
@@ -132,6 +146,8 @@ private:
 	bool m_IsMuted;
 	uint8_t *m_pRdmDataIn;
 	uint8_t *m_pRdmDataOut;
+	TCachedResponse m_aCache[RDM_HANDLER_CACHE_ENTRIES];
+	uint32_t m_nCacheConfigurationCounter;
 };
 
 #endif /* RDMHANDLER_H_ */
@@ -71,7 +71,8 @@ RDMDeviceResponder::RDMDeviceResponder(RDMPersonality *pRDMPersonality, LightSet
 		m_nCheckSum(0),
 		m_nDmxStartAddressFactoryDefault(DMX_START_ADDRESS_DEFAULT),
 		m_nCurrentPersonalityFactoryDefault(RDM_DEFAULT_CURRENT_PERSONALITY),
-		m_pRDMFactoryDefaults(0)
+		m_pRDMFactoryDefaults(0),
+		m_nConfigurationCounter(0)
 {
 	DEBUG_ENTRY
 
@@ -132,6 +133,8 @@ void RDMDeviceResponder::Init(void) {
 
 	m_nCheckSum = CalculateChecksum();
 
+	m_nConfigurationCounter++;
+
 	DEBUG_EXIT
 }
 
@@ -163,6 +166,7 @@ void RDMDeviceResponder::SetDmxStartAddress(uint16_t nSubDevice, uint16_t nDmxSt
 	if (m_pLightSet->SetDmxStartAddress(nDmxStartAddress)) {
 		m_tRDMDeviceInfo.dmx_start_address[0] = (nDmxStartAddress >> 8);
 		m_tRDMDeviceInfo.dmx_start_address[1] = nDmxStartAddress;
+		m_nConfigurationCounter++;
 	}
 }
 
@@ -189,6 +193,7 @@ void RDMDeviceResponder::SetPersonalityCurrent(uint16_t nSubDevice, uint8_t nPer
 	}
 
 	m_tRDMDeviceInfo.current_personality = nPersonality;
+	m_nConfigurationCounter++;
 }
 
 RDMPersonality* RDMDeviceResponder::GetPersonality(uint16_t nSubDevice,  uint8_t nPersonality) {
@@ -243,6 +248,7 @@ void RDMDeviceResponder::SetLabel(uint16_t nSubDevice, const char *pLabel, uint8
 	info.length = nLabelLength;
 
 	RDMDevice::SetLabel(&info);
+	m_nConfigurationCounter++;
 }
 
 void RDMDeviceResponder::GetLabel(uint16_t nSubDevice, struct TRDMDeviceInfoData* pInfo) {
@@ -258,6 +264,7 @@ void RDMDeviceResponder::GetLabel(uint16_t nSubDevice, struct TRDMDeviceInfoData
 void RDMDeviceResponder::SetLanguage(const char aLanguage[2]) {
 	m_aLanguage[0] = aLanguage[0];
 	m_aLanguage[1] = aLanguage[1];
+	m_nConfigurationCounter++;
 }
 
 uint16_t RDMDeviceResponder::CalculateChecksum(void) {
@@ -301,6 +308,7 @@ void RDMDeviceResponder::SetFactoryDefaults(void) {
 	m_RDMSubDevices.SetFactoryDefaults();
 
 	m_IsFactoryDefaults = true;
+	m_nConfigurationCounter++;
 
 	if (m_pRDMFactoryDefaults != 0) {
 		DEBUG_PUTS("");
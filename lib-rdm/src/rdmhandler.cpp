@@ -54,14 +54,6 @@ enum TPowerState {
 	POWER_STATE_NORMAL = 0xFF,		///< Normal Operating Mode.
 };
 
-RDMHandler::RDMHandler(bool bIsRdm):
-	m_bIsRDM(bIsRdm),
-	m_IsMuted(false),
-	m_pRdmDataIn(0),
-	m_pRdmDataOut(0)
-{
-}
-
 void RDMHandler::HandleString(const char *pString, uint32_t nLength) {
 	struct TRdmMessage *RdmMessage = reinterpret_cast<struct TRdmMessage*>(m_pRdmDataOut);
 
@@ -141,6 +133,10 @@ void RDMHandler::RespondMessageNack(uint16_t nReason) {
 	CreateRespondMessage(E120_RESPONSE_TYPE_NACK_REASON, nReason);
 }
 
+/*
+ * The tables must be sorted by PID, the handler is found with a binary search.
+ */
+
 const RDMHandler::TPidDefinition RDMHandler::PID_DEFINITIONS[] {
 //  {E120_QUEUED_MESSAGE,              	&RDMHandler::GetQueuedMessage,           	0,                   				1, true , false},
 	{E120_SUPPORTED_PARAMETERS,        	&RDMHandler::GetSupportedParameters,      	0,             						0, false, true , false},
@@ -165,23 +161,23 @@ const RDMHandler::TPidDefinition RDMHandler::PID_DEFINITIONS[] {
 	{E120_RECORD_SENSORS,			   	0,											&RDMHandler::SetRecordSensors,	 	0, true , true , false},
 	{E120_DEVICE_HOURS,                	&RDMHandler::GetDeviceHours,    	      	&RDMHandler::SetDeviceHours,       	0, true , true , false},
 	{E120_REAL_TIME_CLOCK,		       	&RDMHandler::GetRealTimeClock,  			&RDMHandler::SetRealTimeClock,    	0, true , true , false},
-	{E120_IDENTIFY_DEVICE,		       	&RDMHandler::GetIdentifyDevice,		    	&RDMHandler::SetIdentifyDevice,    	0, false, true , true },
-	{E120_RESET_DEVICE,			    	0,                                			&RDMHandler::SetResetDevice,       	0, true , true , true },
-	{E120_POWER_STATE,					&RDMHandler::GetPowerState,					&RDMHandler::SetPowerState,			0, true , true , false},
-	{E137_1_IDENTIFY_MODE,			   	&RDMHandler::GetIdentifyMode,				&RDMHandler::SetIdentifyMode,		0, true , true , false},
 	{E137_2_LIST_INTERFACES,			&RDMHandler::GetInterfaceList,				0,									0, false, false, true },
 	{E137_2_INTERFACE_LABEL,			&RDMHandler::GetInterfaceName,				0,									4, false, false, true },
 	{E137_2_INTERFACE_HARDWARE_ADDRESS_TYPE1,&RDMHandler::GetHardwareAddress,		0,									4, false, false, true },
 	{E137_2_IPV4_DHCP_MODE,				&RDMHandler::GetDHCPMode,					&RDMHandler::SetDHCPMode,			4, false, false, true },
 	{E137_2_IPV4_ZEROCONF_MODE,			&RDMHandler::GetZeroconf,					&RDMHandler::SetZeroconf,			4, false, false, true },
 	{E137_2_IPV4_CURRENT_ADDRESS,		&RDMHandler::GetAddressNetmask,				0,									4, false, false, true },
-	{E137_2_INTERFACE_RENEW_DHCP, 		0,											&RDMHandler::RenewDhcp,				4, false, false, true },
 	{E137_2_IPV4_STATIC_ADDRESS,		&RDMHandler::GetStaticAddress,				&RDMHandler::SetStaticAddress,		4, false, false, true },
+	{E137_2_INTERFACE_RENEW_DHCP, 		0,											&RDMHandler::RenewDhcp,				4, false, false, true },
 	{E137_2_INTERFACE_APPLY_CONFIGURATION,0,										&RDMHandler::ApplyConfiguration,	4, false, false, true },
-	{E137_2_DNS_IPV4_NAME_SERVER,		&RDMHandler::GetNameServers,				0,									1, false, false, true },
 	{E137_2_IPV4_DEFAULT_ROUTE,			&RDMHandler::GetDefaultRoute,				&RDMHandler::SetDefaultRoute,		4, false, false, true },
+	{E137_2_DNS_IPV4_NAME_SERVER,		&RDMHandler::GetNameServers,				0,									1, false, false, true },
 	{E137_2_DNS_HOSTNAME,               &RDMHandler::GetHostName,                   &RDMHandler::SetHostName,           0, false, false, true },
-	{E137_2_DNS_DOMAIN_NAME,			&RDMHandler::GetDomainName,					&RDMHandler::SetDomainName,			0, false, false, true }
+	{E137_2_DNS_DOMAIN_NAME,			&RDMHandler::GetDomainName,					&RDMHandler::SetDomainName,			0, false, false, true },
+	{E120_IDENTIFY_DEVICE,		       	&RDMHandler::GetIdentifyDevice,		    	&RDMHandler::SetIdentifyDevice,    	0, false, true , true },
+	{E120_RESET_DEVICE,			    	0,                                			&RDMHandler::SetResetDevice,       	0, true , true , true },
+	{E120_POWER_STATE,					&RDMHandler::GetPowerState,					&RDMHandler::SetPowerState,			0, true , true , false},
+	{E137_1_IDENTIFY_MODE,			   	&RDMHandler::GetIdentifyMode,				&RDMHandler::SetIdentifyMode,		0, true , true , false}
 };
 
 const RDMHandler::TPidDefinition RDMHandler::PID_DEFINITIONS_SUB_DEVICES[] {
@@ -195,6 +191,87 @@ const RDMHandler::TPidDefinition RDMHandler::PID_DEFINITIONS_SUB_DEVICES[] {
 	{E120_IDENTIFY_DEVICE,		       &RDMHandler::GetIdentifyDevice,		    	&RDMHandler::SetIdentifyDevice,		0, true, true ,  false}
 };
 
+/*
+ * The root device responses of these PIDs only change with the configuration.
+ */
+static constexpr uint16_t CACHED_PIDS[RDM_HANDLER_CACHE_ENTRIES] = {
+	E120_SUPPORTED_PARAMETERS,
+	E120_DEVICE_INFO,
+	E120_DEVICE_MODEL_DESCRIPTION,
+	E120_MANUFACTURER_LABEL,
+	E120_SOFTWARE_VERSION_LABEL
+};
+
+RDMHandler::RDMHandler(bool bIsRdm):
+	m_bIsRDM(bIsRdm),
+	m_IsMuted(false),
+	m_pRdmDataIn(0),
+	m_pRdmDataOut(0),
+	m_nCacheConfigurationCounter(0)
+{
+#ifndef NDEBUG
+	for (uint32_t i = 1; i < sizeof(PID_DEFINITIONS) / sizeof(PID_DEFINITIONS[0]); i++) {
+		assert(PID_DEFINITIONS[i - 1].nPid < PID_DEFINITIONS[i].nPid);
+	}
+#endif
+
+	for (uint32_t i = 0; i < RDM_HANDLER_CACHE_ENTRIES; i++) {
+		m_aCache[i].bIsValid = false;
+	}
+}
+
+const RDMHandler::TPidDefinition *RDMHandler::FindPid(uint16_t nPid) {
+	uint32_t nLow = 0;
+	uint32_t nHigh = sizeof(PID_DEFINITIONS) / sizeof(PID_DEFINITIONS[0]);
+
+	while (nLow < nHigh) {
+		const uint32_t nMiddle = (nLow + nHigh) / 2;
+		const uint16_t nMiddlePid = PID_DEFINITIONS[nMiddle].nPid;
+
+		if (nMiddlePid == nPid) {
+			return &PID_DEFINITIONS[nMiddle];
+		}
+
+		if (nMiddlePid < nPid) {
+			nLow = nMiddle + 1;
+		} else {
+			nHigh = nMiddle;
+		}
+	}
+
+	return 0;
+}
+
+void RDMHandler::HandleCachedGet(uint32_t nIndex, const TPidDefinition *pPidDefinition) {
+	const uint32_t nConfigurationCounter = RDMDeviceResponder::Get()->GetConfigurationCounter();
+
+	if (m_nCacheConfigurationCounter != nConfigurationCounter) {
+		m_nCacheConfigurationCounter = nConfigurationCounter;
+
+		for (uint32_t i = 0; i < RDM_HANDLER_CACHE_ENTRIES; i++) {
+			m_aCache[i].bIsValid = false;
+		}
+	}
+
+	struct TRdmMessage *pRdmDataOut = reinterpret_cast<struct TRdmMessage*>(m_pRdmDataOut);
+	TCachedResponse &Cache = m_aCache[nIndex];
+
+	if (Cache.bIsValid) {
+		pRdmDataOut->param_data_length = Cache.nLength;
+		memcpy(pRdmDataOut->param_data, Cache.aParamData, Cache.nLength);
+		RespondMessageAck();
+		return;
+	}
+
+	(this->*(pPidDefinition->pGetHandler))(RDM_ROOT_DEVICE);
+
+	if ((pRdmDataOut->start_code == E120_SC_RDM) && (pRdmDataOut->slot16.response_type == E120_RESPONSE_TYPE_ACK) && (pRdmDataOut->param_data_length <= sizeof(Cache.aParamData))) {
+		Cache.nLength = pRdmDataOut->param_data_length;
+		memcpy(Cache.aParamData, pRdmDataOut->param_data, Cache.nLength);
+		Cache.bIsValid = true;
+	}
+}
+
 /**
  * @param pRdmDataIn RDM with no Start Code
  * @param pRdmDataOut RDM with the Start Code or it is Discover Message
@@ -334,10 +411,6 @@ void RDMHandler::HandleData(const uint8_t *pRdmDataIn, uint8_t *pRdmDataOut) {
 void RDMHandler::Handlers(bool bIsBroadcast, uint8_t nCommandClass, uint16_t nParamId, uint8_t nParamDataLength, uint16_t nSubDevice) {
 	DEBUG1_ENTRY
 
-	TPidDefinition const *pid_handler = 0;
-	bool bRDM;
-	bool bRDMNet;
-
 	if (nCommandClass != E120_GET_COMMAND && nCommandClass != E120_SET_COMMAND) {
 		RespondMessageNack(E120_NR_UNSUPPORTED_COMMAND_CLASS);
 		return;
@@ -350,13 +423,7 @@ void RDMHandler::Handlers(bool bIsBroadcast, uint8_t nCommandClass, uint16_t nPa
 		return;
 	}
 
-	for (uint32_t i = 0; i < sizeof(PID_DEFINITIONS) / sizeof(PID_DEFINITIONS[0]); ++i) {
-		if (PID_DEFINITIONS[i].nPid == nParamId) {
-			pid_handler = &PID_DEFINITIONS[i];
-			bRDM = PID_DEFINITIONS[i].bRDM;
-			bRDMNet = PID_DEFINITIONS[i].bRDMNet;
-		}
-	}
+	const TPidDefinition *pid_handler = FindPid(nParamId);
 
 	if (!pid_handler) {
 		RespondMessageNack(E120_NR_UNKNOWN_PID);
@@ -365,13 +432,13 @@ void RDMHandler::Handlers(bool bIsBroadcast, uint8_t nCommandClass, uint16_t nPa
 	}
 
 	if (m_bIsRDM) {
-		if (!bRDM) {
+		if (!pid_handler->bRDM) {
 			RespondMessageNack(E120_NR_UNKNOWN_PID);
 			DEBUG1_EXIT
 			return;
 		}
 	} else {
-		if (!bRDMNet) {
+		if (!pid_handler->bRDMNet) {
 			RespondMessageNack(E120_NR_UNKNOWN_PID);
 			DEBUG1_EXIT
 			return;
@@ -402,6 +469,16 @@ void RDMHandler::Handlers(bool bIsBroadcast, uint8_t nCommandClass, uint16_t nPa
 			return;
 		}
 
+		if (nSubDevice == RDM_ROOT_DEVICE) {
+			for (uint32_t i = 0; i < RDM_HANDLER_CACHE_ENTRIES; i++) {
+				if (CACHED_PIDS[i] == nParamId) {
+					HandleCachedGet(i, pid_handler);
+					DEBUG1_EXIT
+					return;
+				}
+			}
+		}
+
 		(this->*(pid_handler->pGetHandler))(nSubDevice);
 	} else {
 
@@ -0,0 +1,718 @@
+/**
+ * @file discovery.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Host test of the RDM discovery of the Art-Net node with a full TOD of simulated responders.
+ * The clock is virtual, the node runs every CLOCK_STEP_MICROS and the DMX input is 44 Hz.
+ * - A full discovery (AtcFlush) finds all responders, the DMX output is never stopped for longer than one discovery slot.
+ * - The periodic incremental discovery removes the lost responders and adds the new ones.
+ * - An ArtRdm request is handled in the gaps of a running discovery.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+
+#include "hardware.h"
+#include "ledblink.h"
+
+#include "artnetnode.h"
+#include "artnetrdm.h"
+#include "artnetrdmqueue.h"
+#include "lightset.h"
+
+#include "rdmdiscovery.h"
+#include "rdm.h"
+#include "rdm_e120.h"
+
+#include "simnetwork.h"
+
+static constexpr uint8_t UNIVERSE = 1;
+static constexpr uint32_t RESPONDERS = TOD_TABLE_SIZE;
+static constexpr uint32_t CHANGED_RESPONDERS = 8;
+static constexpr uint32_t CLOCK_STEP_MICROS = 100;
+static constexpr uint32_t DMX_INPUT_MICROS = 1000000 / 44;
+static constexpr uint32_t DISCOVERY_RESPONSE_MICROS = 2000;
+static constexpr uint32_t RESPONSE_MICROS = 2500;
+static constexpr uint32_t RESPONSE_WINDOW_MICROS = 2800;
+static constexpr uint32_t DMX_GAP_MAX_MILLIS = ArtNetRdmConst::DISCOVERY_SLOT_MILLIS + (RDMDiscoveryConst::RECEIVE_TIMEOUT_MICROS / 1000) + 1;
+static constexpr uint8_t CONTROLLER_UID[6] = {0x7F, 0xF0, 0x00, 0x00, 0x00, 0xFF};
+
+static uint64_t s_nMicros;
+static uint32_t s_nFailures;
+
+static void Check(bool bCondition, const char *pText) {
+	printf("%s : %s\n", bCondition ? "PASS" : "FAIL", pText);
+
+	if (!bCondition) {
+		s_nFailures++;
+	}
+}
+
+/*
+ * Virtual clock, replaces lib-hal/src/linux/hardware.cpp
+ */
+Hardware *Hardware::s_pThis = 0;
+
+Hardware::Hardware(void): m_tBoardType(BOARD_TYPE_LINUX), m_nBoardId(0) {
+	s_pThis = this;
+	m_aCpuName[0] = '\0';
+	m_aSocName[0] = '\0';
+	strcpy(m_aBoardName, "sim");
+}
+
+uint32_t Hardware::Micros(void) {
+	return static_cast<uint32_t>(s_nMicros);
+}
+
+uint32_t Hardware::Millis(void) {
+	return static_cast<uint32_t>(s_nMicros / 1000);
+}
+
+const char *Hardware::GetSysName(uint8_t &nLength) {
+	nLength = 3;
+	return "sim";
+}
+
+const char *Hardware::GetBoardName(uint8_t &nLength) {
+	nLength = static_cast<uint8_t>(strlen(m_aBoardName));
+	return m_aBoardName;
+}
+
+uint32_t Hardware::GetReleaseId(void) {
+	return 0;
+}
+
+uint32_t Hardware::GetUpTime(void) {
+	return static_cast<uint32_t>(s_nMicros / 1000000);
+}
+
+void Hardware::SetLed(__attribute__((unused)) THardwareLedStatus tLedStatus) {
+}
+
+bool Hardware::PowerOff(void) {
+	return false;
+}
+
+/*
+ * The RDM line with the responders, replaces lib-dmx/src/rdm.cpp.
+ * The line is busy from a request until its response is read, or until the end of the response window when there is no response.
+ */
+class SimLine {
+public:
+	void Populate(uint32_t nCount) {
+		while (m_nCount < nCount) {
+			Add();
+		}
+	}
+
+	void Add(void) {
+		static const uint16_t aManufacturer[] = {0x7FF0, 0x4150, 0x0001};
+		uint64_t nUid;
+
+		do {
+			m_nRandom = (m_nRandom * 6364136223846793005ULL) + 1442695040888963407ULL;
+			nUid = (static_cast<uint64_t>(aManufacturer[(m_nRandom >> 60) % 3]) << 32) | (m_nRandom >> 16 & 0xFFFFFFFF);
+		} while (std::binary_search(m_aUid, &m_aUid[m_nCount], nUid));
+
+		uint64_t *p = std::lower_bound(m_aUid, &m_aUid[m_nCount], nUid);
+		const uint32_t nIndex = static_cast<uint32_t>(p - m_aUid);
+
+		memmove(&m_aUid[nIndex + 1], &m_aUid[nIndex], (m_nCount - nIndex) * sizeof(m_aUid[0]));
+		memmove(&m_bIsMuted[nIndex + 1], &m_bIsMuted[nIndex], (m_nCount - nIndex) * sizeof(m_bIsMuted[0]));
+		m_aUid[nIndex] = nUid;
+		m_bIsMuted[nIndex] = false;
+		m_nCount++;
+	}
+
+	void Remove(uint32_t nIndex) {
+		m_nCount--;
+		memmove(&m_aUid[nIndex], &m_aUid[nIndex + 1], (m_nCount - nIndex) * sizeof(m_aUid[0]));
+		memmove(&m_bIsMuted[nIndex], &m_bIsMuted[nIndex + 1], (m_nCount - nIndex) * sizeof(m_bIsMuted[0]));
+	}
+
+	uint32_t GetCount(void) const {
+		return m_nCount;
+	}
+
+	uint64_t GetUid(uint32_t nIndex) const {
+		return m_aUid[nIndex];
+	}
+
+	void Send(const uint8_t *pRdmCommand) {
+		if (m_bIsDmxRunning) {
+			m_nViolations++;	// DMX was not stopped
+		}
+
+		if (IsBusy()) {
+			m_nViolations++;	// Previous response not finished
+		}
+
+		m_nRequests++;
+		m_nSendMicros = s_nMicros;
+		m_nResponseLength = 0;
+		m_bIsAnswered = false;
+
+		const struct TRdmMessage *pRequest = reinterpret_cast<const struct TRdmMessage*>(pRdmCommand);
+		const uint64_t nDestination = ToUint(pRequest->destination_uid);
+		const uint16_t nPid = static_cast<uint16_t>((pRequest->param_id[0] << 8) | pRequest->param_id[1]);
+
+		if (pRequest->command_class == E120_DISCOVERY_COMMAND) {
+			if (nPid == E120_DISC_UN_MUTE) {
+				memset(m_bIsMuted, 0, sizeof(m_bIsMuted));
+				return;
+			}
+
+			if (nPid == E120_DISC_UNIQUE_BRANCH) {
+				UniqueBranch(ToUint(&pRequest->param_data[0]), ToUint(&pRequest->param_data[RDM_UID_SIZE]));
+				return;
+			}
+
+			uint32_t nIndex;
+
+			if ((nPid == E120_DISC_MUTE) && Find(nDestination, nIndex)) {
+				m_bIsMuted[nIndex] = true;
+				Response(pRequest, E120_DISCOVERY_COMMAND_RESPONSE, RESPONSE_MICROS);
+			}
+
+			return;
+		}
+
+		uint32_t nIndex;
+
+		if ((pRequest->command_class == E120_GET_COMMAND) && Find(nDestination, nIndex)) {
+			Response(pRequest, E120_GET_COMMAND_RESPONSE, RESPONSE_MICROS);
+		}
+	}
+
+	const uint8_t *Receive(void) {
+		if ((m_nResponseLength == 0) || ((s_nMicros - m_nSendMicros) < m_nResponseMicros)) {
+			return 0;
+		}
+
+		m_nResponseLength = 0;
+		return m_aResponse;
+	}
+
+	bool IsBusy(void) const {
+		if (m_nResponseLength != 0) {
+			return true;
+		}
+
+		return (m_nRequests != 0) && !m_bIsAnswered && ((s_nMicros - m_nSendMicros) < RESPONSE_WINDOW_MICROS);
+	}
+
+	void SetDmxRunning(bool bIsRunning) {
+		if (bIsRunning && IsBusy()) {
+			m_nViolations++;	// RDM was not finished
+		}
+
+		m_bIsDmxRunning = bIsRunning;
+	}
+
+	uint32_t m_nRequests{0};
+	uint32_t m_nCollisions{0};
+	uint32_t m_nViolations{0};
+
+private:
+	bool Find(uint64_t nUid, uint32_t &nIndex) const {
+		const uint64_t *p = std::lower_bound(m_aUid, &m_aUid[m_nCount], nUid);
+		nIndex = static_cast<uint32_t>(p - m_aUid);
+		return (nIndex < m_nCount) && (*p == nUid);
+	}
+
+	/*
+	 * The unmuted responders within the bounds answer, two or more answers are a collision (wired OR)
+	 */
+	void UniqueBranch(uint64_t nLowerBound, uint64_t nUpperBound) {
+		uint32_t nIndex;
+		Find(nLowerBound, nIndex);
+
+		uint32_t nAnswers = 0;
+
+		for (; (nIndex < m_nCount) && (m_aUid[nIndex] <= nUpperBound); nIndex++) {
+			if (m_bIsMuted[nIndex]) {
+				continue;
+			}
+
+			uint8_t aResponse[24];
+			Encode(m_aUid[nIndex], aResponse);
+
+			for (uint32_t i = 0; i < sizeof(aResponse); i++) {
+				m_aResponse[i] = static_cast<uint8_t>((nAnswers == 0) ? aResponse[i] : (m_aResponse[i] | aResponse[i]));
+			}
+
+			nAnswers++;
+		}
+
+		if (nAnswers == 0) {
+			return;
+		}
+
+		if (nAnswers > 1) {
+			m_nCollisions++;
+		}
+
+		m_nResponseLength = 24;
+		m_nResponseMicros = DISCOVERY_RESPONSE_MICROS;
+		m_bIsAnswered = true;
+	}
+
+	void Encode(uint64_t nUid, uint8_t *pResponse) {
+		uint8_t aUid[RDM_UID_SIZE];
+		ToUid(nUid, aUid);
+
+		memset(pResponse, 0xFE, 7);
+		pResponse[7] = 0xAA;
+
+		uint16_t nChecksum = 0;
+
+		for (uint32_t i = 0; i < RDM_UID_SIZE; i++) {
+			pResponse[8 + (2 * i)] = static_cast<uint8_t>(aUid[i] | 0xAA);
+			pResponse[9 + (2 * i)] = static_cast<uint8_t>(aUid[i] | 0x55);
+			nChecksum = static_cast<uint16_t>(nChecksum + pResponse[8 + (2 * i)] + pResponse[9 + (2 * i)]);
+		}
+
+		pResponse[20] = static_cast<uint8_t>((nChecksum >> 8) | 0xAA);
+		pResponse[21] = static_cast<uint8_t>((nChecksum >> 8) | 0x55);
+		pResponse[22] = static_cast<uint8_t>((nChecksum & 0xFF) | 0xAA);
+		pResponse[23] = static_cast<uint8_t>((nChecksum & 0xFF) | 0x55);
+	}
+
+	void Response(const struct TRdmMessage *pRequest, uint8_t nCommandClass, uint32_t nMicros) {
+		struct TRdmMessage *pResponse = reinterpret_cast<struct TRdmMessage*>(m_aResponse);
+
+		memset(pResponse, 0, sizeof(struct TRdmMessage));
+		pResponse->start_code = E120_SC_RDM;
+		pResponse->sub_start_code = E120_SC_SUB_MESSAGE;
+		pResponse->message_length = RDM_MESSAGE_MINIMUM_SIZE;
+		memcpy(pResponse->destination_uid, pRequest->source_uid, RDM_UID_SIZE);
+		memcpy(pResponse->source_uid, pRequest->destination_uid, RDM_UID_SIZE);
+		pResponse->transaction_number = pRequest->transaction_number;
+		pResponse->command_class = nCommandClass;
+		pResponse->param_id[0] = pRequest->param_id[0];
+		pResponse->param_id[1] = pRequest->param_id[1];
+
+		uint16_t nChecksum = 0;
+
+		for (uint32_t i = 0; i < RDM_MESSAGE_MINIMUM_SIZE; i++) {
+			nChecksum = static_cast<uint16_t>(nChecksum + m_aResponse[i]);
+		}
+
+		m_aResponse[RDM_MESSAGE_MINIMUM_SIZE] = static_cast<uint8_t>(nChecksum >> 8);
+		m_aResponse[RDM_MESSAGE_MINIMUM_SIZE + 1] = static_cast<uint8_t>(nChecksum);
+
+		m_nResponseLength = RDM_MESSAGE_MINIMUM_SIZE + RDM_MESSAGE_CHECKSUM_SIZE;
+		m_nResponseMicros = nMicros;
+		m_bIsAnswered = true;
+	}
+
+	static uint64_t ToUint(const uint8_t *pUid) {
+		uint64_t nUid = 0;
+
+		for (uint32_t i = 0; i < RDM_UID_SIZE; i++) {
+			nUid = (nUid << 8) | pUid[i];
+		}
+
+		return nUid;
+	}
+
+	static void ToUid(uint64_t nUid, uint8_t *pUid) {
+		for (uint32_t i = RDM_UID_SIZE; i-- > 0;) {
+			pUid[i] = static_cast<uint8_t>(nUid);
+			nUid >>= 8;
+		}
+	}
+
+	uint64_t m_aUid[RESPONDERS];
+	bool m_bIsMuted[RESPONDERS];
+	uint32_t m_nCount{0};
+	uint64_t m_nRandom{1};
+
+	bool m_bIsDmxRunning{false};
+	bool m_bIsAnswered{false};
+	uint64_t m_nSendMicros{0};
+	uint32_t m_nResponseMicros{0};
+	uint32_t m_nResponseLength{0};
+	uint8_t m_aResponse[sizeof(struct TRdmMessage)];
+};
+
+static SimLine s_Line;
+
+Rdm::Rdm(void) {
+}
+
+void Rdm::Send(__attribute__((unused)) uint8_t nPort, struct TRdmMessage *pRdmCommand) {
+	s_Line.Send(reinterpret_cast<const uint8_t*>(pRdmCommand));
+}
+
+void Rdm::SendRaw(__attribute__((unused)) uint8_t nPort, const uint8_t *pRdmData, __attribute__((unused)) uint16_t nLength) {
+	s_Line.Send(pRdmData);
+}
+
+const uint8_t *Rdm::Receive(__attribute__((unused)) uint8_t nPort) {
+	return s_Line.Receive();
+}
+
+/*
+ * The DMX output of port 0, it measures the longest stop and the fraction of time the output is running
+ */
+class SimLightSet final: public LightSet {
+public:
+	void Start(__attribute__((unused)) uint8_t nPort) override {
+		if (!m_bIsRunning && m_bIsStarted) {
+			const uint32_t nGapMillis = static_cast<uint32_t>((s_nMicros - m_nStopMicros) / 1000);
+			m_nGapMillisMax = std::max(m_nGapMillisMax, nGapMillis);
+			m_nStoppedMicros += s_nMicros - m_nStopMicros;
+		}
+
+		m_bIsRunning = true;
+		m_bIsStarted = true;
+		s_Line.SetDmxRunning(true);
+	}
+	void Stop(__attribute__((unused)) uint8_t nPort) override {
+		if (m_bIsRunning) {
+			m_nStopMicros = s_nMicros;
+		}
+
+		m_bIsRunning = false;
+		s_Line.SetDmxRunning(false);
+	}
+	void SetData(__attribute__((unused)) uint8_t nPort, __attribute__((unused)) const uint8_t *pData, __attribute__((unused)) uint16_t nLength) override {
+	}
+
+	void ResetStatistics(void) {
+		m_nGapMillisMax = 0;
+		m_nStoppedMicros = 0;
+	}
+
+	uint32_t m_nGapMillisMax{0};
+	uint64_t m_nStoppedMicros{0};
+
+private:
+	bool m_bIsRunning{false};
+	bool m_bIsStarted{false};
+	uint64_t m_nStopMicros{0};
+};
+
+/*
+ * The RDM controller of port 0 with the discovery under test, there are no polled responders
+ */
+class SimRdmController final: public ArtNetRdm {
+public:
+	SimRdmController(void) {
+		m_Discovery.SetUid(CONTROLLER_UID);
+	}
+
+	void Full(__attribute__((unused)) uint8_t nPort) override {
+		m_Discovery.Full();
+	}
+	uint32_t GetUidCount(__attribute__((unused)) uint8_t nPort) override {
+		return m_Discovery.GetUidCount();
+	}
+	void Copy(__attribute__((unused)) uint8_t nPort, uint8_t *pTod, uint32_t nIndex, uint32_t nCount) override {
+		m_Discovery.Copy(pTod, nIndex, nCount);
+	}
+
+	void StartDiscovery(__attribute__((unused)) uint8_t nPort, bool bIncremental) override {
+		m_nDiscoveries++;
+		m_Discovery.Start(bIncremental);
+	}
+	bool RunDiscovery(__attribute__((unused)) uint8_t nPort) override {
+		return m_Discovery.Run();
+	}
+	bool IsDiscoveryRunning(__attribute__((unused)) uint8_t nPort) override {
+		return m_Discovery.IsRunning();
+	}
+	bool IsDiscoveryWaiting(__attribute__((unused)) uint8_t nPort) override {
+		return m_Discovery.IsWaiting();
+	}
+	bool IsTodChanged(__attribute__((unused)) uint8_t nPort) override {
+		return m_Discovery.IsTodChanged();
+	}
+
+	bool StartPoll(__attribute__((unused)) uint8_t nPort) override {
+		return false;
+	}
+	bool RunPoll(__attribute__((unused)) uint8_t nPort) override {
+		return false;
+	}
+	bool IsPollRunning(__attribute__((unused)) uint8_t nPort) override {
+		return false;
+	}
+	uint32_t GetPollCount(__attribute__((unused)) uint8_t nPort) override {
+		return 0;
+	}
+	uint32_t CopyPoll(__attribute__((unused)) uint8_t nPort, __attribute__((unused)) struct TArtNetRdmPollEntry *pEntries, __attribute__((unused)) uint32_t nIndex, __attribute__((unused)) uint32_t nCount) override {
+		return 0;
+	}
+
+	const uint8_t *Handler(__attribute__((unused)) uint8_t nPort, __attribute__((unused)) const uint8_t *pRdmData) override {
+		return 0;
+	}
+
+	void SendRequest(uint8_t nPort, const uint8_t *pRdmData) override {
+		m_aRequest[0] = E120_SC_RDM;
+		memcpy(&m_aRequest[1], pRdmData, static_cast<size_t>(pRdmData[1] + 2));
+		Rdm::SendRaw(nPort, m_aRequest, static_cast<uint16_t>(pRdmData[1] + 2));
+	}
+	const uint8_t *ReceiveResponse(uint8_t nPort) override {
+		return Rdm::Receive(nPort);
+	}
+
+	bool IsTodEqual(void) {
+		if (m_Discovery.GetUidCount() != s_Line.GetCount()) {
+			return false;
+		}
+
+		for (uint32_t i = 0; i < s_Line.GetCount(); i++) {
+			uint8_t aUid[RDM_UID_SIZE];
+			m_Discovery.Copy(aUid, i, 1);
+
+			uint64_t nUid = 0;
+
+			for (uint32_t j = 0; j < RDM_UID_SIZE; j++) {
+				nUid = (nUid << 8) | aUid[j];
+			}
+
+			if (nUid != s_Line.GetUid(i)) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void Print(void) {
+		m_Discovery.Print();
+	}
+
+	uint32_t m_nDiscoveries{0};
+
+private:
+	RDMDiscovery m_Discovery;
+	uint8_t m_aRequest[sizeof(struct TRdmMessage)];
+};
+
+static SimRdmController s_Rdm;
+
+static void PushArtDmx(SimNetwork &network) {
+	static uint8_t nSequence;
+	struct TArtDmx artDmx;
+
+	memset(&artDmx, 0, sizeof(struct TArtDmx));
+	memcpy(artDmx.Id, "Art-Net", 8);
+	artDmx.OpCode = OP_DMX;
+	artDmx.ProtVerLo = artnet::PROTOCOL_REVISION;
+	artDmx.Sequence = ++nSequence;
+	artDmx.PortAddress = UNIVERSE;
+	artDmx.LengthHi = 0x02;
+	artDmx.Length = 0x00;
+	artDmx.Data[0] = nSequence;
+
+	network.Push(&artDmx, sizeof(struct TArtDmx));
+}
+
+static void PushArtTodControl(SimNetwork &network) {
+	struct TArtTodControl artTodControl;
+
+	memset(&artTodControl, 0, sizeof(struct TArtTodControl));
+	memcpy(artTodControl.Id, "Art-Net", 8);
+	artTodControl.OpCode = OP_TODCONTROL;
+	artTodControl.ProtVerLo = artnet::PROTOCOL_REVISION;
+	artTodControl.Command = 0x01;	// AtcFlush
+	artTodControl.Address = UNIVERSE;
+
+	network.Push(&artTodControl, sizeof(struct TArtTodControl));
+}
+
+static void PushArtRdmGet(SimNetwork &network, uint64_t nUid) {
+	struct TArtRdm artRdm;
+
+	memset(&artRdm, 0, sizeof(struct TArtRdm));
+	memcpy(artRdm.Id, "Art-Net", 8);
+	artRdm.OpCode = OP_RDM;
+	artRdm.ProtVerLo = artnet::PROTOCOL_REVISION;
+	artRdm.RdmVer = 0x01;
+	artRdm.Address = UNIVERSE;
+
+	uint8_t *p = artRdm.RdmPacket;
+	p[0] = E120_SC_SUB_MESSAGE;
+	p[1] = RDM_MESSAGE_MINIMUM_SIZE;
+
+	for (uint32_t i = RDM_UID_SIZE; i-- > 0;) {
+		p[2 + i] = static_cast<uint8_t>(nUid);
+		nUid >>= 8;
+	}
+
+	memcpy(&p[8], CONTROLLER_UID, RDM_UID_SIZE);
+	p[14] = 1;								// Transaction number
+	p[15] = 1;								// Port id
+	p[19] = E120_GET_COMMAND;
+	p[20] = 0x00;							// DEVICE_INFO
+	p[21] = 0x60;
+
+	network.Push(&artRdm, sizeof(struct TArtRdm));
+}
+
+/*
+ * One main loop iteration, the ArtDmx input has priority over the other packets
+ */
+static void Step(ArtNetNode &node, SimNetwork &network, bool &bIsPending, void (*pPush)(SimNetwork&)) {
+	static uint64_t nDmxMicros;
+
+	if ((s_nMicros - nDmxMicros) >= DMX_INPUT_MICROS) {
+		nDmxMicros = s_nMicros;
+		PushArtDmx(network);
+	} else if (bIsPending) {
+		bIsPending = false;
+		pPush(network);
+	}
+
+	node.Run();
+	s_nMicros += CLOCK_STEP_MICROS;
+}
+
+static uint64_t RunDiscovery(ArtNetNode &node, SimNetwork &network, bool bIsPending, void (*pPush)(SimNetwork&), uint32_t nTimeoutSeconds) {
+	const uint32_t nDiscoveries = s_Rdm.m_nDiscoveries;
+	const uint64_t nTimeOut = s_nMicros + (nTimeoutSeconds * 1000000ULL);
+
+	while ((s_Rdm.m_nDiscoveries == nDiscoveries) && (s_nMicros < nTimeOut)) {
+		Step(node, network, bIsPending, pPush);
+	}
+
+	const uint64_t nStart = s_nMicros;
+
+	while (s_Rdm.IsDiscoveryRunning(0) && (s_nMicros < nTimeOut)) {
+		Step(node, network, bIsPending, pPush);
+	}
+
+	return s_nMicros - nStart;
+}
+
+static void Report(const char *pText, uint64_t nMicros, uint32_t nRequests, SimLightSet &lightSet) {
+	const uint32_t nMillis = static_cast<uint32_t>(nMicros / 1000);
+	const uint32_t nAvailable = (nMicros == 0) ? 0 : static_cast<uint32_t>(100 - ((lightSet.m_nStoppedMicros * 100) / nMicros));
+
+	printf("%s: %u ms, %u requests, DMX stopped for %u ms max, DMX output %u%% of the time\n", pText, nMillis, nRequests, lightSet.m_nGapMillisMax, nAvailable);
+}
+
+int main(void) {
+	Hardware hw;
+	LedBlink lb;
+	SimNetwork network;
+	SimLightSet lightSet;
+
+	s_Line.Populate(RESPONDERS);
+
+	ArtNetNode node;
+
+	node.SetOutput(&lightSet);
+	node.SetUniverseSwitch(0, ARTNET_OUTPUT_PORT, UNIVERSE);
+	node.SetRdmHandler(&s_Rdm);
+	node.SetRdmDiscoveryInterval(0);
+	node.Start();
+
+	bool bIsPending = false;
+
+	for (uint32_t i = 0; i < 10; i++) {
+		Step(node, network, bIsPending, PushArtTodControl);
+	}
+
+	printf("Full discovery of %u responders\n", RESPONDERS);
+
+	lightSet.ResetStatistics();
+	uint32_t nRequests = s_Line.m_nRequests;
+	const uint32_t nTodData = network.GetTodDataSent();
+
+	uint64_t nMicros = RunDiscovery(node, network, true, PushArtTodControl, 600);
+
+	Report("Full", nMicros, s_Line.m_nRequests - nRequests, lightSet);
+	Check(!s_Rdm.IsDiscoveryRunning(0), "the discovery has finished");
+	Check(s_Rdm.IsTodEqual(), "all responders are found");
+	Check(network.GetTodDataSent() > nTodData, "ArtTodData is sent");
+	Check(lightSet.m_nGapMillisMax <= DMX_GAP_MAX_MILLIS, "the DMX output is stopped for one discovery slot at most");
+
+	printf("Incremental discovery, %u responders lost and %u new\n", CHANGED_RESPONDERS, CHANGED_RESPONDERS);
+
+	for (uint32_t i = 0; i < CHANGED_RESPONDERS; i++) {
+		s_Line.Remove((i * 127) % s_Line.GetCount());
+	}
+
+	for (uint32_t i = 0; i < CHANGED_RESPONDERS; i++) {
+		s_Line.Add();
+	}
+
+	node.SetRdmDiscoveryInterval(1);
+
+	lightSet.ResetStatistics();
+	nRequests = s_Line.m_nRequests;
+
+	nMicros = RunDiscovery(node, network, false, PushArtTodControl, 600);
+
+	node.SetRdmDiscoveryInterval(0);
+
+	Report("Incremental", nMicros, s_Line.m_nRequests - nRequests, lightSet);
+	Check(!s_Rdm.IsDiscoveryRunning(0), "the discovery has finished");
+	Check(s_Rdm.IsTodEqual(), "the TOD is updated");
+	Check(lightSet.m_nGapMillisMax <= DMX_GAP_MAX_MILLIS, "the DMX output is stopped for one discovery slot at most");
+
+	puts("ArtRdm request during a discovery");
+
+	PushArtTodControl(network);
+	node.Run();
+	Check(s_Rdm.IsDiscoveryRunning(0), "the discovery is started");
+
+	const uint32_t nRdmSent = network.GetRdmSent();
+	const uint64_t nStart = s_nMicros;
+
+	bIsPending = true;
+
+	while (s_Rdm.IsDiscoveryRunning(0) && (network.GetRdmSent() == nRdmSent)) {
+		Step(node, network, bIsPending, [](SimNetwork &network) { PushArtRdmGet(network, s_Line.GetUid(0)); });
+	}
+
+	printf("Response after %u ms\n", static_cast<uint32_t>((s_nMicros - nStart) / 1000));
+	Check(network.GetRdmSent() == (nRdmSent + 1), "the response is sent while the discovery is running");
+
+	while (s_Rdm.IsDiscoveryRunning(0)) {
+		Step(node, network, bIsPending, PushArtTodControl);
+	}
+
+	Check(s_Rdm.IsTodEqual(), "all responders are found");
+	Check(s_Line.m_nViolations == 0, "DMX and RDM never share the line");
+
+	s_Rdm.Print();
+	printf("%u requests, %u collisions\n", s_Line.m_nRequests, s_Line.m_nCollisions);
+
+	if (s_nFailures != 0) {
+		printf("%u failures\n", s_nFailures);
+		return 1;
+	}
+
+	puts("All tests passed");
+	return 0;
+}
@@ -0,0 +1,199 @@
+/**
+ * @file todbench.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Micro-benchmark of the TOD with 4096 UIDs, the per UID calls against the batch calls.
+ * The batch results are checked against the per UID results.
+ *
+ * Usage: todbench
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "rdmtod.h"
+
+static constexpr uint32_t UIDS = 4096;
+static constexpr uint32_t BATCH = 64;
+static constexpr uint32_t RUNS = 20;
+
+static uint8_t s_aUids[UIDS * RDM_UID_SIZE];
+static uint8_t s_aBatch[UIDS * RDM_UID_SIZE];
+static uint8_t s_aTable[2][UIDS * RDM_UID_SIZE];
+static uint32_t s_nFailures;
+
+static uint64_t Nanos() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/*
+ * Random order, the manufacturer IDs of a mixed rig
+ */
+static void MakeUids(void) {
+	static const uint16_t aManufacturer[] = {0x7FF0, 0x4150, 0x0001, 0x414C};
+	uint64_t nRandom = 1;
+
+	for (uint32_t i = 0; i < UIDS; i++) {
+		nRandom = (nRandom * 6364136223846793005ULL) + 1442695040888963407ULL;
+
+		uint8_t *pUid = &s_aUids[i * RDM_UID_SIZE];
+		const uint16_t nManufacturer = aManufacturer[(nRandom >> 62) & 3];
+
+		pUid[0] = static_cast<uint8_t>(nManufacturer >> 8);
+		pUid[1] = static_cast<uint8_t>(nManufacturer);
+		pUid[2] = static_cast<uint8_t>(nRandom >> 40);
+		pUid[3] = static_cast<uint8_t>(nRandom >> 32);
+		pUid[4] = static_cast<uint8_t>(nRandom >> 24);
+		pUid[5] = static_cast<uint8_t>(i);	// Unique
+	}
+}
+
+static void Check(bool bCondition, const char *pText) {
+	if (!bCondition) {
+		printf("FAIL : %s\n", pText);
+		s_nFailures++;
+	}
+}
+
+static bool IsEqual(RDMTod &a, RDMTod &b) {
+	if (a.GetUidCount() != b.GetUidCount()) {
+		return false;
+	}
+
+	a.Copy(s_aTable[0]);
+	b.Copy(s_aTable[1]);
+
+	return memcmp(s_aTable[0], s_aTable[1], a.GetUidCount() * RDM_UID_SIZE) == 0;
+}
+
+static void Report(const char *pText, uint64_t nNanos, uint32_t nCount) {
+	printf("%-40s %10.1f us %8.1f ns/UID\n", pText, static_cast<double>(nNanos) / 1000.0, static_cast<double>(nNanos) / nCount);
+}
+
+int main(void) {
+	MakeUids();
+
+	uint64_t nSingle[5] = {0, 0, 0, 0, 0};
+	uint64_t nBatch[4] = {0, 0, 0, 0};
+
+	for (uint32_t nRun = 0; nRun < RUNS; nRun++) {
+		RDMTod single(UIDS);
+		RDMTod batch(UIDS);
+
+		// Fill an empty TOD
+		uint64_t nStart = Nanos();
+		for (uint32_t i = 0; i < UIDS; i++) {
+			single.AddUid(&s_aUids[i * RDM_UID_SIZE]);
+		}
+		nSingle[0] += Nanos() - nStart;
+
+		memcpy(s_aBatch, s_aUids, sizeof(s_aUids));
+		nStart = Nanos();
+		const uint32_t nAdded = batch.AddUids(s_aBatch, UIDS);
+		nBatch[0] += Nanos() - nStart;
+
+		Check((nAdded == UIDS) && IsEqual(single, batch), "fill");
+
+		// Lookup
+		uint32_t nFound = 0;
+		nStart = Nanos();
+		for (uint32_t i = 0; i < UIDS; i++) {
+			nFound += single.Exist(&s_aUids[i * RDM_UID_SIZE]) ? 1 : 0;
+		}
+		nSingle[4] += Nanos() - nStart;
+
+		Check(nFound == UIDS, "lookup");
+
+		// Remove a few from a full TOD
+		nStart = Nanos();
+		for (uint32_t i = 0; i < BATCH; i++) {
+			single.Delete(&s_aUids[i * 61 * RDM_UID_SIZE]);
+		}
+		nSingle[1] += Nanos() - nStart;
+
+		for (uint32_t i = 0; i < BATCH; i++) {
+			memcpy(&s_aBatch[i * RDM_UID_SIZE], &s_aUids[i * 61 * RDM_UID_SIZE], RDM_UID_SIZE);
+		}
+		nStart = Nanos();
+		const uint32_t nDeleted = batch.DeleteUids(s_aBatch, BATCH);
+		nBatch[1] += Nanos() - nStart;
+
+		Check((nDeleted == BATCH) && IsEqual(single, batch), "delete a few");
+
+		// Add a few to an almost full TOD, with duplicates and known UIDs
+		nStart = Nanos();
+		for (uint32_t i = 0; i < BATCH; i++) {
+			single.AddUid(&s_aUids[i * 61 * RDM_UID_SIZE]);
+			single.AddUid(&s_aUids[(i * 61 + 1) * RDM_UID_SIZE]);
+		}
+		nSingle[2] += Nanos() - nStart;
+
+		for (uint32_t i = 0; i < BATCH; i++) {
+			memcpy(&s_aBatch[2 * i * RDM_UID_SIZE], &s_aUids[i * 61 * RDM_UID_SIZE], RDM_UID_SIZE);
+			memcpy(&s_aBatch[(2 * i + 1) * RDM_UID_SIZE], &s_aUids[(i * 61 + 1) * RDM_UID_SIZE], RDM_UID_SIZE);
+		}
+		nStart = Nanos();
+		const uint32_t nReAdded = batch.AddUids(s_aBatch, 2 * BATCH);
+		nBatch[2] += Nanos() - nStart;
+
+		Check((nReAdded == BATCH) && IsEqual(single, batch), "add a few");
+
+		// Empty the TOD
+		nStart = Nanos();
+		for (uint32_t i = 0; i < UIDS; i++) {
+			single.Delete(&s_aUids[i * RDM_UID_SIZE]);
+		}
+		nSingle[3] += Nanos() - nStart;
+
+		memcpy(s_aBatch, s_aUids, sizeof(s_aUids));
+		nStart = Nanos();
+		const uint32_t nEmptied = batch.DeleteUids(s_aBatch, UIDS);
+		nBatch[3] += Nanos() - nStart;
+
+		Check((nEmptied == UIDS) && (batch.GetUidCount() == 0) && IsEqual(single, batch), "empty");
+	}
+
+	printf("TOD of %u UIDs, batch of %u, average of %u runs\n", UIDS, BATCH, RUNS);
+	Report("Fill         AddUid", nSingle[0] / RUNS, UIDS);
+	Report("Fill         AddUids", nBatch[0] / RUNS, UIDS);
+	Report("Delete a few Delete", nSingle[1] / RUNS, BATCH);
+	Report("Delete a few DeleteUids", nBatch[1] / RUNS, BATCH);
+	Report("Add a few    AddUid", nSingle[2] / RUNS, 2 * BATCH);
+	Report("Add a few    AddUids", nBatch[2] / RUNS, 2 * BATCH);
+	Report("Empty        Delete", nSingle[3] / RUNS, UIDS);
+	Report("Empty        DeleteUids", nBatch[3] / RUNS, UIDS);
+	Report("Lookup       Exist", nSingle[4] / RUNS, UIDS);
+
+	if (s_nFailures != 0) {
+		printf("%u failures\n", s_nFailures);
+		return 1;
+	}
+
+	return 0;
+}
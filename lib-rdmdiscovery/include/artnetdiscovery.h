@@ -7,6 +7,7 @@
 #include "artnetrdm.h"
 
 #include "rdmdiscovery.h"
+#include "rdmpoller.h"
 #include "rdmdevicecontroller.h"
 
 #include "dmx_uarts.h"
@@ -20,14 +21,31 @@ public:
 	void Print(void);
 
 	void Full(uint8_t nPort = 0);
-	uint8_t GetUidCount(uint8_t nPort = 0);
-	void Copy(uint8_t nPort, uint8_t *pTod);
+	uint32_t GetUidCount(uint8_t nPort = 0);
+	void Copy(uint8_t nPort, uint8_t *pTod, uint32_t nIndex, uint32_t nCount);
+
+	void StartDiscovery(uint8_t nPort, bool bIncremental);
+	bool RunDiscovery(uint8_t nPort);
+	bool IsDiscoveryRunning(uint8_t nPort);
+	bool IsDiscoveryWaiting(uint8_t nPort);
+	bool IsTodChanged(uint8_t nPort);
+
+	bool StartPoll(uint8_t nPort);
+	bool RunPoll(uint8_t nPort);
+	bool IsPollRunning(uint8_t nPort);
+	uint32_t GetPollCount(uint8_t nPort);
+	uint32_t CopyPoll(uint8_t nPort, struct TArtNetRdmPollEntry *pEntries, uint32_t nIndex, uint32_t nCount);
 	const uint8_t *Handler(uint8_t nPort, const uint8_t *pRdmData);
 
+	void SendRequest(uint8_t nPort, const uint8_t *pRdmData);
+	const uint8_t *ReceiveResponse(uint8_t nPort);
+
 	void DumpTod(uint8_t nPort = 0);
+	void PrintPoll(uint8_t nPort = 0);
 
 private:
 	RDMDiscovery *m_Discovery[DMX_MAX_UARTS];
+	RDMPoller *m_Poller[DMX_MAX_UARTS];
 	struct TRdmMessage *m_pRdmCommand;
 };
 
@@ -2,7 +2,7 @@
  * @file rdmddiscovery.h
  *
  */
-/* Copyright (C) 2017-2018 by Arjan van Vught mailto:info@orangepi-dmx.nl
+/* Copyright (C) 2017-2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -33,6 +33,28 @@
 #include "rdmmessage.h"
 #include "rdmtod.h"
 
+struct RDMDiscoveryConst {
+	static constexpr uint32_t RECEIVE_TIMEOUT_MICROS = 5800;	///< 2.8 ms response start + discovery response
+	static constexpr uint32_t UNMUTE_INTERVAL_MILLIS = 100;
+	static constexpr uint32_t UNMUTE_COUNT = 3;
+	static constexpr uint32_t BRANCH_STACK_SIZE = 64;			///< Depth first, one pending branch per UID bit
+};
+
+enum class RDMDiscoveryState {
+	IDLE,
+	UNMUTE,
+	VERIFY,
+	UNIQUE_BRANCH,
+	MUTE
+};
+
+/**
+ * Binary search discovery (ANSI E1.20 7.5) as a state machine.
+ * Run does at most one request/response exchange and never waits for the response.
+ * A full discovery unmutes all responders and starts with an empty TOD.
+ * An incremental discovery mutes the known responders first, the ones not responding are removed,
+ * after that only the new responders take part in the unique branch search.
+ */
 class RDMDiscovery: public RDMTod {
 public:
 	RDMDiscovery(uint8_t nPort = 0);
@@ -42,9 +64,30 @@ public:
 
 	void Full(void);
 
+	void Start(bool bIncremental);
+	bool Run(void);
+
+	bool IsRunning(void) const {
+		return m_tState != RDMDiscoveryState::IDLE;
+	}
+
+	bool IsWaiting(void) const {
+		return m_bIsWaiting;
+	}
+
+	bool IsTodChanged(void) const {
+		return IsChanged();
+	}
+
+	void Print(void);
+
 private:
-	bool FindDevices(uint64_t, uint64_t);
-	bool QuickFind(const uint8_t *);
+	void SendUniqueBranch(void);
+	void SendMute(const uint8_t *pUid);
+	void Receive(const uint8_t *pResponse);
+	bool IsMuteResponse(const uint8_t *pResponse, const uint8_t *pUid);
+	void PushBranch(uint64_t nLowerBound, uint64_t nUpperBound);
+	void SplitBranch(void);
 
 	bool IsValidDiscoveryResponse(const uint8_t *, uint8_t *);
 
@@ -59,6 +102,29 @@ private:
 	RDMMessage m_UnMute;
 	RDMMessage m_Mute;
 	RDMMessage m_DiscUniqueBranch;
+
+	struct TBranch {
+		uint64_t nLowerBound;
+		uint64_t nUpperBound;
+	};
+
+	TBranch m_aBranch[RDMDiscoveryConst::BRANCH_STACK_SIZE];
+	uint32_t m_nBranches;
+
+	RDMDiscoveryState m_tState;
+	bool m_bIsWaiting;
+	bool m_bIsBranchMute;
+	uint32_t m_nSendMicros;
+	uint32_t m_nUnMuteMillis;
+	uint32_t m_nUnMuteCount;
+	uint32_t m_nVerifyIndex;
+	uint8_t m_MuteUid[RDM_UID_SIZE];
+
+	uint32_t m_nFull;
+	uint32_t m_nIncremental;
+	uint32_t m_nAdded;
+	uint32_t m_nLost;
+	uint32_t m_nCollisions;
 };
 
 #endif /* RDMDISCOVERY_H_ */
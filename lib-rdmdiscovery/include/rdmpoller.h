@@ -0,0 +1,124 @@
+/**
+ * @file rdmpoller.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef RDMPOLLER_H_
+#define RDMPOLLER_H_
+
+#include <stdint.h>
+
+#include "rdm.h"
+
+#include "rdmmessage.h"
+#include "rdmtod.h"
+
+struct RDMPollerConst {
+	static constexpr uint32_t RECEIVE_TIMEOUT_MICROS = 15000;	///< 2.8 ms response start + the largest response
+	static constexpr uint32_t SENSORS = 4;						///< Sensors cached per responder
+	static constexpr uint32_t STATUS_MESSAGE_SIZE = 9;			///< ANSI E1.20 Table A-4 STATUS_MESSAGES entry
+	static constexpr uint8_t SENSOR_COUNT_UNKNOWN = 0xFF;
+};
+
+enum class RDMPollerStep {
+	DEVICE_INFO,
+	SENSOR_VALUE,
+	QUEUED_MESSAGE
+};
+
+struct TRdmPollerEntry {
+	uint8_t aUid[RDM_UID_SIZE];
+	uint8_t nSensorCount;
+	uint8_t nMessageCount;
+	int16_t aSensorValue[RDMPollerConst::SENSORS];
+	uint32_t nSensorMillis;
+	uint8_t nStatusMessages;
+	uint8_t aStatusMessage[RDMPollerConst::STATUS_MESSAGE_SIZE];	///< The last one received
+	uint32_t nStatusMillis;
+	bool bHasSensorValue;
+	bool bHasStatus;
+};
+
+/**
+ * Background polling of SENSOR_VALUE and QUEUED_MESSAGE for the responders in the TOD.
+ * Start sends one GET request, Run polls for the response and never waits.
+ * The responders are polled round robin, the latest values are cached per UID (sorted).
+ * The cache follows the changes of the TOD, Start is not called while a discovery is running.
+ */
+class RDMPoller {
+public:
+	RDMPoller(uint8_t nPort, RDMTod *pRDMTod);
+	~RDMPoller(void);
+
+	void SetUid(const uint8_t *pUid);
+
+	bool Start(void);
+	bool Run(void);
+
+	bool IsRunning(void) const {
+		return m_bIsRunning;
+	}
+
+	uint32_t GetCount(void) const {
+		return m_nEntries;
+	}
+
+	const struct TRdmPollerEntry *GetEntry(uint32_t nIndex) const {
+		return &m_pEntries[nIndex];
+	}
+
+	void Print(void);
+
+private:
+	bool Find(const uint8_t *pUid, uint32_t &nIndex) const;
+	struct TRdmPollerEntry *Insert(const uint8_t *pUid);
+	void Remove(const uint8_t *pUid);
+	void Purge(void);
+	void Update(void);
+	void Send(uint16_t nPid, const uint8_t *pParamData, uint8_t nLength);
+	void HandleResponse(const uint8_t *pResponse);
+	void NextUid(void);
+
+private:
+	uint8_t m_nPort;
+	RDMTod *m_pRDMTod;
+	RDMMessage m_Request;
+
+	struct TRdmPollerEntry *m_pEntries;
+	uint32_t m_nEntries;
+	uint32_t m_nGeneration;
+
+	uint32_t m_nTodIndex;
+	uint8_t m_aUid[RDM_UID_SIZE];
+	RDMPollerStep m_tStep;
+	uint8_t m_nSensor;
+	uint16_t m_nPid;
+	uint32_t m_nSendMicros;
+	bool m_bIsRunning;
+
+	uint32_t m_nRequests;
+	uint32_t m_nTimeOuts;
+	uint32_t m_nCycles;
+};
+
+#endif /* RDMPOLLER_H_ */
@@ -2,7 +2,7 @@
  * @file rdmtod.h
  *
  */
-/* Copyright (C) 2017-2018 by Arjan van Vught mailto:info@orangepi-dmx.nl
+/* Copyright (C) 2017-2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -30,30 +30,67 @@
 
 #include "rdm.h"
 
-#define TOD_TABLE_SIZE	200
+#define TOD_TABLE_SIZE	1024
+#define TOD_CHANGES_SIZE	64
 
 struct TRdmTod {
 	uint8_t uid[RDM_UID_SIZE];
 };
 
+struct TRdmTodChange {
+	uint8_t uid[RDM_UID_SIZE];
+	bool bAdded;
+};
+
+/**
+ * The UIDs are kept sorted (big-endian, which is the numeric order), lookup is a binary search.
+ * A batch of UIDs is sorted in place and merged with the table in one pass, every entry is moved at most once.
+ * The changes since the start of the current generation are logged,
+ * when the log overflows or after a Reset the changes are unknown and the full TOD is to be used.
+ */
 class RDMTod {
 public:
-	 RDMTod(void);
+	 RDMTod(uint32_t nTableSize = TOD_TABLE_SIZE);
 	 ~RDMTod(void);
 
 	 void Reset(void);
 	 bool AddUid(const uint8_t *pUid);
-	 uint8_t GetUidCount(void) const;
+	 uint32_t AddUids(uint8_t *pUids, uint32_t nCount);
+	 uint32_t GetUidCount(void) const;
 	 void Copy(uint8_t *pTable);
+	 void Copy(uint8_t *pTable, uint32_t nIndex, uint32_t nCount);
 
 	 bool Delete(const uint8_t *pUid);
+	 uint32_t DeleteUids(uint8_t *pUids, uint32_t nCount);
 	 bool Exist(const uint8_t *pUid);
 
+	 void NextGeneration(void);
+	 uint32_t GetGeneration(void) const {
+		 return m_nGeneration;
+	 }
+	 bool IsChanged(void) const {
+		 return m_bIsChangesOverflow || (m_nChanges != 0);
+	 }
+	 bool IsChangesOverflow(void) const {
+		 return m_bIsChangesOverflow;
+	 }
+	 uint32_t CopyRemoved(uint8_t *pTable) const;
+
 	 void Dump(void);
-	 void Dump(uint8_t nCount);
+	 void Dump(uint32_t nCount);
+
+private:
+	 bool Find(const uint8_t *pUid, uint32_t& nIndex, uint32_t nHigh) const;
+	 void Log(const uint8_t *pUid, bool bAdded);
+
 private:
-	 uint8_t m_nEntries;
+	 uint32_t m_nTableSize;
+	 uint32_t m_nEntries;
 	 TRdmTod *m_pTable;
+	 uint32_t m_nGeneration;
+	 uint32_t m_nChanges;
+	 bool m_bIsChangesOverflow;
+	 TRdmTodChange m_aChanges[TOD_CHANGES_SIZE];
 };
 
 #endif /* RDMTOD_H_ */
@@ -47,6 +47,10 @@ ArtNetRdmController::ArtNetRdmController(void) : m_pRdmCommand(0){
 		m_Discovery[i] = new RDMDiscovery(i);
 		assert(m_Discovery[i] != 0);
 		m_Discovery[i]->SetUid(GetUID());
+
+		m_Poller[i] = new RDMPoller(i, m_Discovery[i]);
+		assert(m_Poller[i] != 0);
+		m_Poller[i]->SetUid(GetUID());
 	}
 
 	m_pRdmCommand = new struct TRdmMessage;
@@ -57,6 +61,11 @@ ArtNetRdmController::ArtNetRdmController(void) : m_pRdmCommand(0){
 
 ArtNetRdmController::~ArtNetRdmController(void) {
 	for (unsigned i = 0; i < DMX_MAX_UARTS; i++) {
+		if (m_Poller[i] != 0) {
+			delete m_Poller[i];
+			m_Poller[i] = 0;
+		}
+
 		if (m_Discovery[i] != 0) {
 			delete m_Discovery[i];
 			m_Discovery[i] = 0;
@@ -68,6 +77,12 @@ void ArtNetRdmController::Print(void) {
 	RDMDeviceController::Print();
 }
 
+void ArtNetRdmController::PrintPoll(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	m_Poller[nPort]->Print();
+}
+
 void ArtNetRdmController::Full(uint8_t nPort) {
 	assert(nPort < DMX_MAX_UARTS);
 
@@ -76,7 +91,7 @@ void ArtNetRdmController::Full(uint8_t nPort) {
 	m_Discovery[nPort]->Full();
 }
 
-uint8_t ArtNetRdmController::GetUidCount(uint8_t nPort) {
+uint32_t ArtNetRdmController::GetUidCount(uint8_t nPort) {
 	assert(nPort < DMX_MAX_UARTS);
 
 	DEBUG_PRINTF("nPort=%d", nPort);
@@ -84,30 +99,107 @@ uint8_t ArtNetRdmController::GetUidCount(uint8_t nPort) {
 	return m_Discovery[nPort]->GetUidCount();
 }
 
-void ArtNetRdmController::Copy(uint8_t nPort, uint8_t *pTod) {
+void ArtNetRdmController::Copy(uint8_t nPort, uint8_t *pTod, uint32_t nIndex, uint32_t nCount) {
 	assert(nPort < DMX_MAX_UARTS);
 
-	DEBUG_PRINTF("nPort=%d", nPort);
+	DEBUG_PRINTF("nPort=%d, nIndex=%d, nCount=%d", nPort, nIndex, nCount);
 
-	m_Discovery[nPort]->Copy(pTod);
+	m_Discovery[nPort]->Copy(pTod, nIndex, nCount);
 }
 
-void ArtNetRdmController::DumpTod(uint8_t nPort) {
+void ArtNetRdmController::StartDiscovery(uint8_t nPort, bool bIncremental) {
 	assert(nPort < DMX_MAX_UARTS);
 
-	DEBUG_PRINTF("nPort=%d", nPort);
+	DEBUG_PRINTF("nPort=%d, bIncremental=%d", nPort, bIncremental);
 
-	m_Discovery[nPort]->Dump();
+	m_Discovery[nPort]->Start(bIncremental);
 }
 
-const uint8_t *ArtNetRdmController::Handler(uint8_t nPort, const uint8_t *pRdmData) {
+bool ArtNetRdmController::RunDiscovery(uint8_t nPort) {
 	assert(nPort < DMX_MAX_UARTS);
 
-	if (pRdmData == 0) {
-		return 0;
+	return m_Discovery[nPort]->Run();
+}
+
+bool ArtNetRdmController::IsDiscoveryRunning(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	return m_Discovery[nPort]->IsRunning();
+}
+
+bool ArtNetRdmController::IsDiscoveryWaiting(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	return m_Discovery[nPort]->IsWaiting();
+}
+
+bool ArtNetRdmController::IsTodChanged(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	return m_Discovery[nPort]->IsTodChanged();
+}
+
+bool ArtNetRdmController::StartPoll(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	return m_Poller[nPort]->Start();
+}
+
+bool ArtNetRdmController::RunPoll(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	return m_Poller[nPort]->Run();
+}
+
+bool ArtNetRdmController::IsPollRunning(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	return m_Poller[nPort]->IsRunning();
+}
+
+uint32_t ArtNetRdmController::GetPollCount(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	return m_Poller[nPort]->GetCount();
+}
+
+uint32_t ArtNetRdmController::CopyPoll(uint8_t nPort, struct TArtNetRdmPollEntry *pEntries, uint32_t nIndex, uint32_t nCount) {
+	assert(nPort < DMX_MAX_UARTS);
+	assert(pEntries != 0);
+
+	static_assert(ArtNetRdmConst::POLL_SENSORS == RDMPollerConst::SENSORS, "");
+
+	const uint32_t nMillis = Hardware::Get()->Millis();
+	uint32_t i;
+
+	for (i = 0; (i < nCount) && ((nIndex + i) < m_Poller[nPort]->GetCount()); i++) {
+		const struct TRdmPollerEntry *pEntry = m_Poller[nPort]->GetEntry(nIndex + i);
+		struct TArtNetRdmPollEntry *pPollEntry = &pEntries[i];
+
+		memcpy(pPollEntry->aUid, pEntry->aUid, RDM_UID_SIZE);
+		pPollEntry->nMessageCount = pEntry->nMessageCount;
+		pPollEntry->nSensorCount = pEntry->nSensorCount;
+		pPollEntry->nSensorAge = pEntry->bHasSensorValue ? (nMillis - pEntry->nSensorMillis) : ArtNetRdmConst::POLL_AGE_UNKNOWN;
+		memcpy(pPollEntry->aSensorValue, pEntry->aSensorValue, sizeof(pPollEntry->aSensorValue));
+		pPollEntry->nStatusAge = pEntry->bHasStatus ? (nMillis - pEntry->nStatusMillis) : ArtNetRdmConst::POLL_AGE_UNKNOWN;
+		pPollEntry->nStatusMessages = pEntry->nStatusMessages;
+		memcpy(pPollEntry->aStatusMessage, pEntry->aStatusMessage, sizeof(pPollEntry->aStatusMessage));
 	}
 
-	Hardware::Get()->WatchdogFeed();
+	return i;
+}
+
+void ArtNetRdmController::DumpTod(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	DEBUG_PRINTF("nPort=%d", nPort);
+
+	m_Discovery[nPort]->Dump();
+}
+
+void ArtNetRdmController::SendRequest(uint8_t nPort, const uint8_t *pRdmData) {
+	assert(nPort < DMX_MAX_UARTS);
+	assert(pRdmData != 0);
 
 	while (0 != RDMMessage::Receive(nPort)) {
 		// Discard late responses
@@ -123,6 +215,31 @@ const uint8_t *ArtNetRdmController::Handler(uint8_t nPort, const uint8_t *pRdmDa
 #endif
 
 	RDMMessage::SendRaw(nPort, pRdmCommand, pRdmMessageNoSc->message_length + 2);
+}
+
+const uint8_t *ArtNetRdmController::ReceiveResponse(uint8_t nPort) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	const uint8_t *pResponse = RDMMessage::Receive(nPort);
+
+#ifndef NDEBUG
+	if (pResponse != 0) {
+		RDMMessage::Print(pResponse);
+	}
+#endif
+	return pResponse;
+}
+
+const uint8_t *ArtNetRdmController::Handler(uint8_t nPort, const uint8_t *pRdmData) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	if (pRdmData == 0) {
+		return 0;
+	}
+
+	Hardware::Get()->WatchdogFeed();
+
+	SendRequest(nPort, pRdmData);
 
 	const uint8_t *pResponse = RDMMessage::ReceiveTimeOut(nPort, 20000);
 
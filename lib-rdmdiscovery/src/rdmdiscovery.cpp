@@ -25,9 +25,8 @@
 
 #include <stdint.h>
 #include <string.h>
-#ifndef NDEBUG
 #include <stdio.h>
-#endif
+#include <cassert>
 
 #include "rdm.h"
 #include "rdm_e120.h"
@@ -35,10 +34,6 @@
 
 #include "hardware.h"
 
-extern "C" {
- void udelay(uint32_t us);
-}
-
 static uint8_t pdl[2][RDM_UID_SIZE];
 
 typedef union cast {
@@ -48,9 +43,24 @@ typedef union cast {
 
 static _cast uuid_cast;
 
-#define RECEIVE_TIME_OUT (2800*100) //TODO #define
-
-RDMDiscovery::RDMDiscovery(uint8_t nPort) : m_nPort(nPort) {
+static constexpr uint64_t UID_UPPER_BOUND = 0xfffffffffffe;
+
+RDMDiscovery::RDMDiscovery(uint8_t nPort) :
+	m_nPort(nPort),
+	m_nBranches(0),
+	m_tState(RDMDiscoveryState::IDLE),
+	m_bIsWaiting(false),
+	m_bIsBranchMute(false),
+	m_nSendMicros(0),
+	m_nUnMuteMillis(0),
+	m_nUnMuteCount(0),
+	m_nVerifyIndex(0),
+	m_nFull(0),
+	m_nIncremental(0),
+	m_nAdded(0),
+	m_nLost(0),
+	m_nCollisions(0)
+{
 	m_UnMute.SetDstUid(UID_ALL);
 	m_UnMute.SetCc(E120_DISCOVERY_COMMAND);
 	m_UnMute.SetPid(E120_DISC_UN_MUTE);
@@ -76,96 +86,239 @@ const uint8_t *RDMDiscovery::GetUid(void) {
 }
 
 void RDMDiscovery::Full(void) {
+	Start(false);
+
+	while (Run()) {
+		Hardware::Get()->WatchdogFeed();
+	}
+}
+
+void RDMDiscovery::Start(bool bIncremental) {
+	m_nBranches = 0;
+	m_bIsWaiting = false;
+
+	NextGeneration();
+
+	if (bIncremental) {
+		m_nIncremental++;
+		m_nVerifyIndex = 0;
+		m_tState = RDMDiscoveryState::VERIFY;
+		return;
+	}
+
+	m_nFull++;
 	Reset();
+	m_nUnMuteCount = 0;
+	m_nUnMuteMillis = Hardware::Get()->Millis() - RDMDiscoveryConst::UNMUTE_INTERVAL_MILLIS;
+	m_tState = RDMDiscoveryState::UNMUTE;
+}
 
-	m_UnMute.Send(m_nPort);
-	m_UnMute.ReceiveTimeOut(m_nPort, 2800);
+/**
+ * @return false when the discovery has finished
+ */
+bool RDMDiscovery::Run(void) {
+	if (m_tState == RDMDiscoveryState::IDLE) {
+		return false;
+	}
 
-	Hardware::Get()->WatchdogFeed();
-	udelay(100000);
+	if (m_bIsWaiting) {
+		const uint8_t *pResponse = RDMMessage::Receive(m_nPort);
 
-	m_UnMute.Send(m_nPort);
-	m_UnMute.ReceiveTimeOut(m_nPort, 2800);
+		if ((pResponse == 0) && ((Hardware::Get()->Micros() - m_nSendMicros) < RDMDiscoveryConst::RECEIVE_TIMEOUT_MICROS)) {
+			return true;
+		}
 
-	Hardware::Get()->WatchdogFeed();
-	udelay(100000);
+		m_bIsWaiting = false;
+		Receive(pResponse);
+		return true;
+	}
 
-	m_UnMute.Send(m_nPort);
+	switch (m_tState) {
+	case RDMDiscoveryState::UNMUTE:
+		if ((Hardware::Get()->Millis() - m_nUnMuteMillis) < RDMDiscoveryConst::UNMUTE_INTERVAL_MILLIS) {
+			break;
+		}
 
-	const struct TRdmMessage *pResponse = reinterpret_cast<const struct TRdmMessage*>(m_Mute.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT));
+		if (m_nUnMuteCount == RDMDiscoveryConst::UNMUTE_COUNT) {
+			PushBranch(0, UID_UPPER_BOUND);
+			m_tState = RDMDiscoveryState::UNIQUE_BRANCH;
+			break;
+		}
 
-	if (pResponse != 0) {
-		FindDevices(ConvertUid(pResponse->source_uid), ConvertUid(pResponse->source_uid));
+		m_UnMute.Send(m_nPort);
+		m_nUnMuteMillis = Hardware::Get()->Millis();
+		m_nUnMuteCount++;
+		break;
+	case RDMDiscoveryState::VERIFY:
+		if (m_nVerifyIndex < GetUidCount()) {
+			Copy(m_MuteUid, m_nVerifyIndex, 1);
+			SendMute(m_MuteUid);
+			break;
+		}
+
+		PushBranch(0, UID_UPPER_BOUND);
+		m_tState = RDMDiscoveryState::UNIQUE_BRANCH;
+		break;
+	case RDMDiscoveryState::UNIQUE_BRANCH:
+		if (m_nBranches == 0) {
+			m_tState = RDMDiscoveryState::IDLE;
+			Dump();
+			return false;
+		}
+
+		if (m_aBranch[m_nBranches - 1].nLowerBound == m_aBranch[m_nBranches - 1].nUpperBound) {
+			// A single UID is muted directly
+			m_nBranches--;
+			memcpy(m_MuteUid, ConvertUid(m_aBranch[m_nBranches].nLowerBound), RDM_UID_SIZE);
+			m_bIsBranchMute = false;
+			m_tState = RDMDiscoveryState::MUTE;
+			SendMute(m_MuteUid);
+			break;
+		}
+
+		SendUniqueBranch();
+		break;
+	default:
+		m_tState = RDMDiscoveryState::UNIQUE_BRANCH;
+		break;
 	}
 
-	FindDevices(0x000000000000, 0xfffffffffffe);
+	return true;
+}
+
+void RDMDiscovery::Receive(const uint8_t *pResponse) {
+	switch (m_tState) {
+	case RDMDiscoveryState::VERIFY:
+		if (IsMuteResponse(pResponse, m_MuteUid)) {
+			m_nVerifyIndex++;
+		} else {
+			Delete(m_MuteUid);
+			m_nLost++;
+		}
+		break;
+	case RDMDiscoveryState::UNIQUE_BRANCH: {
+		if (pResponse == 0) {
+			// No (unmuted) responders in this branch
+			m_nBranches--;
+			break;
+		}
+
+		uint8_t uid[RDM_UID_SIZE];
 
-	Dump();
+		if (IsValidDiscoveryResponse(pResponse, uid)) {
+			// A single responder, the branch is searched again after it is muted
+			memcpy(m_MuteUid, uid, RDM_UID_SIZE);
+			m_bIsBranchMute = true;
+			m_tState = RDMDiscoveryState::MUTE;
+			SendMute(m_MuteUid);
+		} else {
+			m_nCollisions++;
+			SplitBranch();
+		}
+		break;
+	}
+	case RDMDiscoveryState::MUTE:
+		m_tState = RDMDiscoveryState::UNIQUE_BRANCH;
+
+		if (IsMuteResponse(pResponse, m_MuteUid)) {
+			if (AddUid(m_MuteUid)) {
+				m_nAdded++;
+				break;
+			}
+		}
+
+		if (m_bIsBranchMute) {
+			// The responder is not muted or it is already known, continue with the halves of the branch
+			SplitBranch();
+		}
+		break;
+	default:
+		break;
+	}
 }
 
-bool RDMDiscovery::FindDevices(uint64_t LowerBound, uint64_t UpperBound) {
-	struct TRdmMessage *pRdmMessage;
-	uint8_t uid[RDM_UID_SIZE];
-	bool bDeviceFound = false;
-	uint64_t MidPosition;
+bool RDMDiscovery::IsMuteResponse(const uint8_t *pResponse, const uint8_t *pUid) {
+	if (pResponse == 0) {
+		return false;
+	}
+
+	const struct TRdmMessage *pRdmMessage = reinterpret_cast<const struct TRdmMessage*>(pResponse);
 
-	Hardware::Get()->WatchdogFeed();
+	return (pRdmMessage->command_class == E120_DISCOVERY_COMMAND_RESPONSE) && (memcmp(pUid, pRdmMessage->source_uid, RDM_UID_SIZE) == 0);
+}
+
+void RDMDiscovery::SendUniqueBranch(void) {
+	const TBranch &Branch = m_aBranch[m_nBranches - 1];
 
 #ifndef NDEBUG
-	printf("FindDevices : ");
-	PrintUid(LowerBound);
+	printf("UniqueBranch : ");
+	PrintUid(Branch.nLowerBound);
 	printf(" - ");
-	PrintUid(UpperBound);
+	PrintUid(Branch.nUpperBound);
 	printf("\n");
 #endif
 
-	if (LowerBound == UpperBound) {
-		memcpy(uid, ConvertUid(LowerBound), RDM_UID_SIZE);
+	while (0 != RDMMessage::Receive(m_nPort)) {
+		// Discard late responses
+	}
 
-		m_Mute.SetDstUid(uid);
-		m_Mute.Send(m_nPort);
+	memcpy(pdl[0], ConvertUid(Branch.nLowerBound), RDM_UID_SIZE);
+	memcpy(pdl[1], ConvertUid(Branch.nUpperBound), RDM_UID_SIZE);
 
-		pRdmMessage = reinterpret_cast<struct TRdmMessage*>(const_cast<uint8_t*>(m_Mute.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT)));
+	m_DiscUniqueBranch.SetPd(reinterpret_cast<const uint8_t*>(pdl), 2 * RDM_UID_SIZE);
+	m_DiscUniqueBranch.Send(m_nPort);
 
-		if (pRdmMessage != 0) {
-			if ((pRdmMessage->command_class == E120_DISCOVERY_COMMAND_RESPONSE) && (memcmp(uid, pRdmMessage->source_uid, RDM_UID_SIZE) == 0)) {
-				AddUid(uid);
-			}
-		} else {
-			return true;
-		}
-	} else {
-		memcpy(pdl[0], ConvertUid(LowerBound), RDM_UID_SIZE);
-		memcpy(pdl[1], ConvertUid(UpperBound), RDM_UID_SIZE);
+	m_nSendMicros = Hardware::Get()->Micros();
+	m_bIsWaiting = true;
+}
+
+void RDMDiscovery::SendMute(const uint8_t *pUid) {
+	while (0 != RDMMessage::Receive(m_nPort)) {
+		// Discard late responses
+	}
 
-		m_DiscUniqueBranch.SetPd(reinterpret_cast<const uint8_t*>(pdl), 2 * RDM_UID_SIZE);
-		m_DiscUniqueBranch.Send(m_nPort);
+	m_Mute.SetDstUid(pUid);
+	m_Mute.Send(m_nPort);
 
-		pRdmMessage = reinterpret_cast<struct TRdmMessage*>(const_cast<uint8_t*>(m_DiscUniqueBranch.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT)));
+	m_nSendMicros = Hardware::Get()->Micros();
+	m_bIsWaiting = true;
+}
 
-		if (pRdmMessage != 0) {
-			bDeviceFound = true;
+void RDMDiscovery::PushBranch(uint64_t nLowerBound, uint64_t nUpperBound) {
+	assert(m_nBranches < RDMDiscoveryConst::BRANCH_STACK_SIZE);
 
-			if (IsValidDiscoveryResponse(reinterpret_cast<const uint8_t*>(pRdmMessage), uid)) {
-				bDeviceFound = QuickFind(uid);
-			}
+	if (m_nBranches < RDMDiscoveryConst::BRANCH_STACK_SIZE) {
+		m_aBranch[m_nBranches].nLowerBound = nLowerBound;
+		m_aBranch[m_nBranches].nUpperBound = nUpperBound;
+		m_nBranches++;
+	}
+}
+
+/*
+ * The lower half is searched first, the stack never holds more than one pending branch per UID bit.
+ */
+void RDMDiscovery::SplitBranch(void) {
+	assert(m_nBranches != 0);
 
-			if (bDeviceFound) {
-				MidPosition = ((LowerBound & (0x0000800000000000 - 1)) + (UpperBound & (0x0000800000000000 - 1))) / 2
-						+ (UpperBound & (0x0000800000000000) ? 0x0000400000000000 : 0 )
-						+ (LowerBound & (0x0000800000000000) ? 0x0000400000000000 : 0 );
+	m_nBranches--;
 
-				bDeviceFound = FindDevices(LowerBound, MidPosition);
-				bDeviceFound |= FindDevices(MidPosition + 1, UpperBound);
+	const uint64_t nLowerBound = m_aBranch[m_nBranches].nLowerBound;
+	const uint64_t nUpperBound = m_aBranch[m_nBranches].nUpperBound;
 
-				if (bDeviceFound) {
-					return true;
-				}
-			}
-		}
+	if (nLowerBound == nUpperBound) {
+		return;
 	}
 
-	return false;
+	const uint64_t nMiddle = nLowerBound + ((nUpperBound - nLowerBound) / 2);
+
+	PushBranch(nMiddle + 1, nUpperBound);
+	PushBranch(nLowerBound, nMiddle);
+}
+
+void RDMDiscovery::Print(void) {
+	printf(" Discovery port %d\n", static_cast<int>(m_nPort));
+	printf("  UIDs     : %d found, %d added, %d lost\n", static_cast<int>(GetUidCount()), static_cast<int>(m_nAdded), static_cast<int>(m_nLost));
+	printf("  Runs     : %d full, %d incremental, %d collisions\n", static_cast<int>(m_nFull), static_cast<int>(m_nIncremental), static_cast<int>(m_nCollisions));
 }
 
 const uint8_t *RDMDiscovery::ConvertUid(uint64_t uid) {
@@ -228,42 +381,3 @@ bool RDMDiscovery::IsValidDiscoveryResponse(const uint8_t *response, uint8_t *ui
 
 	return bIsValid;
 }
-
-bool RDMDiscovery::QuickFind(const uint8_t *uid) {
-	uint8_t r_uid[RDM_UID_SIZE];
-
-	Hardware::Get()->WatchdogFeed();
-
-#ifndef NDEBUG
-	printf("QuickFind : ");
-	PrintUid(uid);
-	printf("\n");
-#endif
-
-	m_Mute.SetDstUid(uid);
-	m_Mute.Send(m_nPort);
-
-	uint8_t *pResponse = const_cast<uint8_t*>(m_Mute.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT));
-
-	if (pResponse != 0) {
-		struct TRdmMessage *pRdmMessage = reinterpret_cast<struct TRdmMessage*>(pResponse);
-
-		if ((pRdmMessage->command_class == E120_DISCOVERY_COMMAND_RESPONSE) && (memcmp(uid, pRdmMessage->source_uid, RDM_UID_SIZE) == 0)) {
-			AddUid(uid);
-		}
-	}
-
-	Hardware::Get()->WatchdogFeed();
-
-	m_DiscUniqueBranch.Send(m_nPort);
-
-	pResponse = const_cast<uint8_t *>(m_DiscUniqueBranch.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT));
-
-	if ((pResponse != 0) && (IsValidDiscoveryResponse(pResponse, r_uid))) {
-		QuickFind(r_uid);
-	} else {
-		return true;
-	}
-
-	return false;
-}
@@ -0,0 +1,346 @@
+/**
+ * @file rdmpoller.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cassert>
+
+#include "rdmpoller.h"
+
+#include "rdm.h"
+#include "rdm_e120.h"
+#include "rdmdevice.h"
+
+#include "hardware.h"
+
+#include "debug.h"
+
+RDMPoller::RDMPoller(uint8_t nPort, RDMTod *pRDMTod) :
+	m_nPort(nPort),
+	m_pRDMTod(pRDMTod),
+	m_pEntries(0),
+	m_nEntries(0),
+	m_nGeneration(0),
+	m_nTodIndex(0),
+	m_tStep(RDMPollerStep::DEVICE_INFO),
+	m_nSensor(0),
+	m_nPid(0),
+	m_nSendMicros(0),
+	m_bIsRunning(false),
+	m_nRequests(0),
+	m_nTimeOuts(0),
+	m_nCycles(0)
+{
+	assert(m_pRDMTod != 0);
+
+	m_pEntries = new struct TRdmPollerEntry[TOD_TABLE_SIZE];
+	assert(m_pEntries != 0);
+
+	m_Request.SetCc(E120_GET_COMMAND);
+}
+
+RDMPoller::~RDMPoller(void) {
+	delete[] m_pEntries;
+	m_pEntries = 0;
+}
+
+void RDMPoller::SetUid(const uint8_t *pUid) {
+	m_Request.SetSrcUid(pUid);
+}
+
+/**
+ * @return false when there are no responders to poll
+ */
+bool RDMPoller::Start(void) {
+	assert(!m_bIsRunning);
+
+	const uint32_t nUidCount = m_pRDMTod->GetUidCount();
+
+	if (nUidCount == 0) {
+		return false;
+	}
+
+	if (m_pRDMTod->GetGeneration() != m_nGeneration) {
+		Update();
+	}
+
+	if (m_nTodIndex >= nUidCount) {
+		m_nTodIndex = 0;
+		m_tStep = RDMPollerStep::DEVICE_INFO;
+		m_nCycles++;
+	}
+
+	m_pRDMTod->Copy(m_aUid, m_nTodIndex, 1);
+
+	const struct TRdmPollerEntry *pEntry = Insert(m_aUid);
+
+	if (pEntry == 0) {
+		Purge();
+		pEntry = Insert(m_aUid);
+		assert(pEntry != 0);
+	}
+
+	if ((m_tStep == RDMPollerStep::DEVICE_INFO) && (pEntry->nSensorCount != RDMPollerConst::SENSOR_COUNT_UNKNOWN)) {
+		m_tStep = RDMPollerStep::SENSOR_VALUE;
+		m_nSensor = 0;
+	}
+
+	if ((m_tStep == RDMPollerStep::SENSOR_VALUE) && ((m_nSensor >= pEntry->nSensorCount) || (m_nSensor >= RDMPollerConst::SENSORS))) {
+		m_tStep = RDMPollerStep::QUEUED_MESSAGE;
+	}
+
+	switch (m_tStep) {
+	case RDMPollerStep::DEVICE_INFO:
+		Send(E120_DEVICE_INFO, &m_nSensor, 0);
+		break;
+	case RDMPollerStep::SENSOR_VALUE:
+		Send(E120_SENSOR_VALUE, &m_nSensor, 1);
+		break;
+	case RDMPollerStep::QUEUED_MESSAGE: {
+		const uint8_t nStatusType = E120_STATUS_ADVISORY;
+		Send(E120_QUEUED_MESSAGE, &nStatusType, 1);
+		break;
+	}
+	default:
+		break;
+	}
+
+	return true;
+}
+
+/**
+ * @return false when the transaction has finished
+ */
+bool RDMPoller::Run(void) {
+	if (!m_bIsRunning) {
+		return false;
+	}
+
+	const uint8_t *pResponse = RDMMessage::Receive(m_nPort);
+
+	if (pResponse == 0) {
+		if ((Hardware::Get()->Micros() - m_nSendMicros) < RDMPollerConst::RECEIVE_TIMEOUT_MICROS) {
+			return true;
+		}
+
+		// No bus time is spent on the remaining requests for this responder
+		m_nTimeOuts++;
+		m_bIsRunning = false;
+		NextUid();
+		return false;
+	}
+
+	m_bIsRunning = false;
+	HandleResponse(pResponse);
+	return false;
+}
+
+void RDMPoller::Send(uint16_t nPid, const uint8_t *pParamData, uint8_t nLength) {
+	while (0 != RDMMessage::Receive(m_nPort)) {
+		// Discard late responses
+	}
+
+	m_Request.SetDstUid(m_aUid);
+	m_Request.SetPid(nPid);
+	m_Request.SetPd(pParamData, nLength);
+	m_Request.Send(m_nPort);
+
+	m_nPid = nPid;
+	m_nSendMicros = Hardware::Get()->Micros();
+	m_bIsRunning = true;
+	m_nRequests++;
+}
+
+void RDMPoller::HandleResponse(const uint8_t *pResponse) {
+	const struct TRdmMessage *pRdmMessage = reinterpret_cast<const struct TRdmMessage*>(pResponse);
+
+	if ((pRdmMessage->command_class != E120_GET_COMMAND_RESPONSE) || (memcmp(pRdmMessage->source_uid, m_aUid, RDM_UID_SIZE) != 0)) {
+		NextUid();
+		return;
+	}
+
+	struct TRdmPollerEntry *pEntry = Insert(m_aUid);
+	assert(pEntry != 0);
+
+	pEntry->nMessageCount = pRdmMessage->message_count;
+
+	const uint16_t nPid = static_cast<uint16_t>((pRdmMessage->param_id[0] << 8) | pRdmMessage->param_id[1]);
+	const bool bIsAck = (pRdmMessage->slot16.response_type == E120_RESPONSE_TYPE_ACK);
+	const uint8_t *pParamData = pRdmMessage->param_data;
+	const uint8_t nLength = pRdmMessage->param_data_length;
+
+	switch (m_tStep) {
+	case RDMPollerStep::DEVICE_INFO:
+		if (bIsAck && (nPid == m_nPid) && (nLength >= sizeof(struct TRDMDeviceInfo))) {
+			pEntry->nSensorCount = reinterpret_cast<const struct TRDMDeviceInfo*>(pParamData)->sensor_count;
+			m_tStep = RDMPollerStep::SENSOR_VALUE;
+			m_nSensor = 0;
+		} else {
+			NextUid();
+		}
+		break;
+	case RDMPollerStep::SENSOR_VALUE:
+		// Sensor number, present, lowest, highest and recorded value
+		if (bIsAck && (nPid == m_nPid) && (nLength >= 9) && (pParamData[0] == m_nSensor)) {
+			pEntry->aSensorValue[m_nSensor] = static_cast<int16_t>((pParamData[1] << 8) | pParamData[2]);
+			pEntry->nSensorMillis = Hardware::Get()->Millis();
+			pEntry->bHasSensorValue = true;
+		}
+		m_nSensor++;
+		break;
+	case RDMPollerStep::QUEUED_MESSAGE:
+		// Any other PID is a queued parameter change, only the message count is of interest
+		if (bIsAck && (nPid == E120_STATUS_MESSAGES)) {
+			pEntry->nStatusMessages = static_cast<uint8_t>(nLength / RDMPollerConst::STATUS_MESSAGE_SIZE);
+
+			if (pEntry->nStatusMessages != 0) {
+				memcpy(pEntry->aStatusMessage, &pParamData[(pEntry->nStatusMessages - 1) * RDMPollerConst::STATUS_MESSAGE_SIZE], RDMPollerConst::STATUS_MESSAGE_SIZE);
+			}
+
+			pEntry->nStatusMillis = Hardware::Get()->Millis();
+			pEntry->bHasStatus = true;
+		}
+		NextUid();
+		break;
+	default:
+		break;
+	}
+}
+
+void RDMPoller::NextUid(void) {
+	m_nTodIndex++;
+	m_tStep = RDMPollerStep::DEVICE_INFO;
+	m_nSensor = 0;
+}
+
+bool RDMPoller::Find(const uint8_t *pUid, uint32_t &nIndex) const {
+	uint32_t nLow = 0;
+	uint32_t nHigh = m_nEntries;
+
+	while (nLow < nHigh) {
+		const uint32_t nMiddle = nLow + ((nHigh - nLow) / 2);
+		const int nCompare = memcmp(m_pEntries[nMiddle].aUid, pUid, RDM_UID_SIZE);
+
+		if (nCompare == 0) {
+			nIndex = nMiddle;
+			return true;
+		}
+
+		if (nCompare < 0) {
+			nLow = nMiddle + 1;
+		} else {
+			nHigh = nMiddle;
+		}
+	}
+
+	nIndex = nLow;
+	return false;
+}
+
+/*
+ * The entries are kept sorted in the same order as the TOD
+ */
+struct TRdmPollerEntry *RDMPoller::Insert(const uint8_t *pUid) {
+	uint32_t nIndex;
+
+	if (Find(pUid, nIndex)) {
+		return &m_pEntries[nIndex];
+	}
+
+	if (m_nEntries == TOD_TABLE_SIZE) {
+		return 0;
+	}
+
+	memmove(&m_pEntries[nIndex + 1], &m_pEntries[nIndex], (m_nEntries - nIndex) * sizeof(struct TRdmPollerEntry));
+	m_nEntries++;
+
+	struct TRdmPollerEntry *pEntry = &m_pEntries[nIndex];
+
+	memset(pEntry, 0, sizeof(struct TRdmPollerEntry));
+	memcpy(pEntry->aUid, pUid, RDM_UID_SIZE);
+	pEntry->nSensorCount = RDMPollerConst::SENSOR_COUNT_UNKNOWN;
+
+	return pEntry;
+}
+
+void RDMPoller::Remove(const uint8_t *pUid) {
+	uint32_t nIndex;
+
+	if (Find(pUid, nIndex)) {
+		m_nEntries--;
+		memmove(&m_pEntries[nIndex], &m_pEntries[nIndex + 1], (m_nEntries - nIndex) * sizeof(struct TRdmPollerEntry));
+	}
+}
+
+/*
+ * Removes the responders which are no longer in the TOD
+ */
+void RDMPoller::Purge(void) {
+	uint32_t nEntries = 0;
+
+	for (uint32_t i = 0; i < m_nEntries; i++) {
+		if (m_pRDMTod->Exist(m_pEntries[i].aUid)) {
+			if (nEntries != i) {
+				memcpy(&m_pEntries[nEntries], &m_pEntries[i], sizeof(struct TRdmPollerEntry));
+			}
+			nEntries++;
+		}
+	}
+
+	DEBUG_PRINTF("m_nEntries=%d, nEntries=%d", m_nEntries, nEntries);
+
+	m_nEntries = nEntries;
+}
+
+/*
+ * After one discovery only the removed responders are dropped.
+ * When the changes are not known, the full cache is checked against the TOD.
+ */
+void RDMPoller::Update(void) {
+	static uint8_t s_Removed[TOD_CHANGES_SIZE * RDM_UID_SIZE];
+
+	const uint32_t nGeneration = m_pRDMTod->GetGeneration();
+
+	if ((nGeneration != (m_nGeneration + 1)) || m_pRDMTod->IsChangesOverflow()) {
+		Purge();
+	} else {
+		const uint32_t nRemoved = m_pRDMTod->CopyRemoved(s_Removed);
+
+		for (uint32_t i = 0; i < nRemoved; i++) {
+			Remove(&s_Removed[i * RDM_UID_SIZE]);
+		}
+
+		DEBUG_PRINTF("nRemoved=%d, m_nEntries=%d", nRemoved, m_nEntries);
+	}
+
+	m_nGeneration = nGeneration;
+}
+
+void RDMPoller::Print(void) {
+	printf(" Poller port %d\n", static_cast<int>(m_nPort));
+	printf("  Responders : %d cached\n", static_cast<int>(m_nEntries));
+	printf("  Requests   : %d sent, %d timed out, %d cycles\n", static_cast<int>(m_nRequests), static_cast<int>(m_nTimeOuts), static_cast<int>(m_nCycles));
+}
@@ -25,20 +25,31 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <algorithm>
 #ifndef NDEBUG
  #include <stdio.h>
 #endif
 
 #include "rdmtod.h"
 
-#ifndef ALIGNED
- #define ALIGNED __attribute__ ((aligned (4)))
-#endif
+/*
+ * The 48-bit UID as a number, the comparison is cheaper than a memcmp
+ */
+static uint64_t Key(const uint8_t *pUid) {
+	return (static_cast<uint64_t>(pUid[0]) << 40) | (static_cast<uint64_t>(pUid[1]) << 32) | (static_cast<uint64_t>(pUid[2]) << 24)
+			| (static_cast<uint64_t>(pUid[3]) << 16) | (static_cast<uint64_t>(pUid[4]) << 8) | pUid[5];
+}
 
-RDMTod::RDMTod(void) : m_nEntries(0) {
-	m_pTable = new TRdmTod[TOD_TABLE_SIZE];
+RDMTod::RDMTod(uint32_t nTableSize) :
+	m_nTableSize(nTableSize),
+	m_nEntries(0),
+	m_nGeneration(0),
+	m_nChanges(0),
+	m_bIsChangesOverflow(false)
+{
+	m_pTable = new TRdmTod[m_nTableSize];
 
-	for (uint32_t i = 0 ; i < TOD_TABLE_SIZE; i++) {
+	for (uint32_t i = 0 ; i < m_nTableSize; i++) {
 		memcpy(&m_pTable[i], UID_ALL, RDM_UID_SIZE);
 	}
 }
@@ -48,24 +59,47 @@ RDMTod::~RDMTod(void) {
 	delete[] m_pTable;
 }
 
-uint8_t RDMTod::GetUidCount(void) const {
+uint32_t RDMTod::GetUidCount(void) const {
 	return m_nEntries;
 }
 
-bool RDMTod::Exist(const uint8_t *pUid) {
-	for (uint32_t i = 0 ; i < m_nEntries; i++) {
-		if (memcmp(&m_pTable[i], pUid, RDM_UID_SIZE) == 0) {
+/**
+ * Searches the first nHigh entries
+ * @return true when found, otherwise nIndex is the insert position
+ */
+bool RDMTod::Find(const uint8_t *pUid, uint32_t& nIndex, uint32_t nHigh) const {
+	const uint64_t nKey = Key(pUid);
+	uint32_t nLow = 0;
+
+	while (nLow < nHigh) {
+		const uint32_t nMiddle = nLow + ((nHigh - nLow) / 2);
+		const uint64_t nMiddleKey = Key(m_pTable[nMiddle].uid);
+
+		if (nMiddleKey == nKey) {
+			nIndex = nMiddle;
 			return true;
 		}
+
+		if (nMiddleKey < nKey) {
+			nLow = nMiddle + 1;
+		} else {
+			nHigh = nMiddle;
+		}
 	}
 
+	nIndex = nLow;
 	return false;
 }
 
-void RDMTod::Dump(__attribute__((unused)) uint8_t nCount) {
+bool RDMTod::Exist(const uint8_t *pUid) {
+	uint32_t nIndex;
+	return Find(pUid, nIndex, m_nEntries);
+}
+
+void RDMTod::Dump(__attribute__((unused)) uint32_t nCount) {
 #ifndef NDEBUG
-	if (nCount > TOD_TABLE_SIZE) {
-		nCount = TOD_TABLE_SIZE;
+	if (nCount > m_nTableSize) {
+		nCount = m_nTableSize;
 	}
 
 	for (uint32_t i = 0 ; i < nCount; i++) {
@@ -81,54 +115,155 @@ void RDMTod::Dump(void) {
 }
 
 bool RDMTod::AddUid(const uint8_t *pUid) {
-	if (m_nEntries == TOD_TABLE_SIZE) {
+	if (m_nEntries == m_nTableSize) {
 		return false;
 	}
 
-	if (Exist(pUid)) {
+	uint32_t nIndex;
+
+	if (Find(pUid, nIndex, m_nEntries)) {
 		return false;
 	}
 
-	memcpy(&m_pTable[m_nEntries++], pUid, RDM_UID_SIZE);
+	memmove(&m_pTable[nIndex + 1], &m_pTable[nIndex], (m_nEntries - nIndex) * sizeof(struct TRdmTod));
+	memcpy(&m_pTable[nIndex], pUid, RDM_UID_SIZE);
+	m_nEntries++;
+
+	Log(pUid, true);
 
 	return true;
 }
 
-bool RDMTod::Delete(const uint8_t *pUid) {
-	bool found = false;
-	uint32_t i;
+static bool IsDuplicate(const TRdmTod *pBatch, uint32_t nIndex) {
+	return (nIndex != 0) && (Key(pBatch[nIndex - 1].uid) == Key(pBatch[nIndex].uid));
+}
+
+static const TRdmTod *Sort(uint8_t *pUids, uint32_t nCount) {
+	TRdmTod *pBatch = reinterpret_cast<TRdmTod*>(pUids);
+
+	std::sort(pBatch, &pBatch[nCount], [](const TRdmTod &a, const TRdmTod &b) {
+		return Key(a.uid) < Key(b.uid);
+	});
+
+	return pBatch;
+}
 
-	for (i = 0 ; i < m_nEntries; i++) {
-		if (memcmp(&m_pTable[i], pUid, RDM_UID_SIZE) == 0) {
-			found = true;
+/**
+ * The table is merged from the end, the entries between two insert positions are moved as one block.
+ * Every entry is moved at most once, the insert positions are found with a binary search.
+ * Duplicates and UIDs already in the TOD are skipped, the batch is truncated when the table is full.
+ * @return the number of UIDs added
+ */
+uint32_t RDMTod::AddUids(uint8_t *pUids, uint32_t nCount) {
+	const TRdmTod *pBatch = Sort(pUids, nCount);
+
+	uint32_t nAdded = 0;
+	uint32_t nBatch = 0;
+	uint32_t nIndex;
+
+	for (; nBatch < nCount; nBatch++) {
+		if (IsDuplicate(pBatch, nBatch) || Find(pBatch[nBatch].uid, nIndex, m_nEntries)) {
+			continue;
+		}
+
+		if ((m_nEntries + nAdded) == m_nTableSize) {
 			break;
 		}
-	}
 
-	if (!found) {
-		return false;
+		nAdded++;
 	}
 
-	if (i == TOD_TABLE_SIZE - 1) {
-		memcpy(&m_pTable[i], UID_ALL, RDM_UID_SIZE);
-	} else {
-		for (; i < m_nEntries; i++) {
-			memcpy(&m_pTable[i], &m_pTable[i + 1], RDM_UID_SIZE);
+	uint32_t nRead = m_nEntries;
+	uint32_t nShift = nAdded;
+
+	while (nShift != 0) {
+		nBatch--;
+
+		if (IsDuplicate(pBatch, nBatch) || Find(pBatch[nBatch].uid, nIndex, nRead)) {
+			continue;
 		}
+
+		memmove(&m_pTable[nIndex + nShift], &m_pTable[nIndex], (nRead - nIndex) * sizeof(struct TRdmTod));
+		nShift--;
+		m_pTable[nIndex + nShift] = pBatch[nBatch];
+		nRead = nIndex;
+
+		Log(pBatch[nBatch].uid, true);
+	}
+
+	m_nEntries += nAdded;
+
+	return nAdded;
+}
+
+bool RDMTod::Delete(const uint8_t *pUid) {
+	uint32_t nIndex;
+
+	if (!Find(pUid, nIndex, m_nEntries)) {
+		return false;
 	}
 
 	m_nEntries--;
+	memmove(&m_pTable[nIndex], &m_pTable[nIndex + 1], (m_nEntries - nIndex) * sizeof(struct TRdmTod));
+	memcpy(&m_pTable[m_nEntries], UID_ALL, RDM_UID_SIZE);
+
+	Log(pUid, false);
 
 	return true;
 }
 
+/**
+ * The table is compacted from the start, the entries between two deleted UIDs are moved as one block
+ * @return the number of UIDs deleted
+ */
+uint32_t RDMTod::DeleteUids(uint8_t *pUids, uint32_t nCount) {
+	const TRdmTod *pBatch = Sort(pUids, nCount);
+
+	uint32_t nWrite = 0;
+	uint32_t nRead = 0;
+
+	for (uint32_t nBatch = 0; nBatch < nCount; nBatch++) {
+		uint32_t nIndex;
+
+		if (IsDuplicate(pBatch, nBatch) || !Find(pBatch[nBatch].uid, nIndex, m_nEntries) || (nIndex < nRead)) {
+			continue;
+		}
+
+		memmove(&m_pTable[nWrite], &m_pTable[nRead], (nIndex - nRead) * sizeof(struct TRdmTod));
+		nWrite += nIndex - nRead;
+		nRead = nIndex + 1;
+
+		Log(pBatch[nBatch].uid, false);
+	}
+
+	memmove(&m_pTable[nWrite], &m_pTable[nRead], (m_nEntries - nRead) * sizeof(struct TRdmTod));
+	nWrite += m_nEntries - nRead;
+
+	const uint32_t nDeleted = m_nEntries - nWrite;
+
+	for (uint32_t i = nWrite; i < m_nEntries; i++) {
+		memcpy(&m_pTable[i], UID_ALL, RDM_UID_SIZE);
+	}
+
+	m_nEntries = nWrite;
+
+	return nDeleted;
+}
+
 void RDMTod::Copy(uint8_t *pTable) {
-	const uint8_t *pSrc = reinterpret_cast<const uint8_t*>(m_pTable);
-	uint8_t *pDst = pTable;
+	memcpy(pTable, m_pTable, m_nEntries * RDM_UID_SIZE);
+}
+
+void RDMTod::Copy(uint8_t *pTable, uint32_t nIndex, uint32_t nCount) {
+	if (nIndex >= m_nEntries) {
+		return;
+	}
 
-	for (uint32_t i = 0; i < (m_nEntries * RDM_UID_SIZE); i++) {
-		*pDst++ = *pSrc++;
+	if (nCount > (m_nEntries - nIndex)) {
+		nCount = m_nEntries - nIndex;
 	}
+
+	memcpy(pTable, &m_pTable[nIndex], nCount * RDM_UID_SIZE);
 }
 
 void RDMTod::Reset(void) {
@@ -137,4 +272,53 @@ void RDMTod::Reset(void) {
 	}
 
 	m_nEntries = 0;
+	m_bIsChangesOverflow = true;
+}
+
+void RDMTod::NextGeneration(void) {
+	m_nGeneration++;
+	m_nChanges = 0;
+	m_bIsChangesOverflow = false;
+}
+
+/*
+ * A UID added and removed again within the same generation is not a change.
+ * After an overflow the changes are unknown until the next generation.
+ */
+void RDMTod::Log(const uint8_t *pUid, bool bAdded) {
+	if (m_bIsChangesOverflow) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < m_nChanges; i++) {
+		if (memcmp(m_aChanges[i].uid, pUid, RDM_UID_SIZE) == 0) {
+			m_aChanges[i] = m_aChanges[--m_nChanges];
+			return;
+		}
+	}
+
+	if (m_nChanges == TOD_CHANGES_SIZE) {
+		m_bIsChangesOverflow = true;
+		return;
+	}
+
+	memcpy(m_aChanges[m_nChanges].uid, pUid, RDM_UID_SIZE);
+	m_aChanges[m_nChanges].bAdded = bAdded;
+	m_nChanges++;
+}
+
+/**
+ * @return the number of UIDs removed in the current generation, pTable holds TOD_CHANGES_SIZE UIDs
+ */
+uint32_t RDMTod::CopyRemoved(uint8_t *pTable) const {
+	uint32_t nCount = 0;
+
+	for (uint32_t i = 0; i < m_nChanges; i++) {
+		if (!m_aChanges[i].bAdded) {
+			memcpy(&pTable[nCount * RDM_UID_SIZE], m_aChanges[i].uid, RDM_UID_SIZE);
+			nCount++;
+		}
+	}
+
+	return nCount;
 }
@@ -2,7 +2,7 @@
  * @file dummy_device.cpp
  *
  */
-/* Copyright (C) 2019 by Arjan van Vught mailto:info@orangepi-dmx.nl
+/* Copyright (C) 2019-2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -27,6 +27,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include <arpa/inet.h>
 
 #include "hardware.h"
 #include "networklinux.h"
@@ -50,7 +51,7 @@ int main(int argc, char **argv) {
 	FirmwareVersion fw(SOFTWARE_VERSION, __DATE__, __TIME__);
 
 	if (argc < 2) {
-		printf("Usage: %s ip_address|interface_name\n", argv[0]);
+		printf("Usage: %s ip_address|interface_name [broker_ip_address broker_port]\n", argv[0]);
 		return -1;
 	}
 
@@ -79,6 +80,14 @@ int main(int argc, char **argv) {
 		rdmDeviceParams.Dump();
 	}
 
+	if (argc == 4) {
+		struct in_addr broker;
+
+		if (inet_aton(argv[2], &broker) != 0) {
+			device.SetBroker(broker.s_addr, static_cast<uint16_t>(atoi(argv[3])));
+		}
+	}
+
 	device.Init();
 	device.Print();
 	device.Start();
@@ -0,0 +1,529 @@
+/**
+ * @file rptbench.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * RPT throughput of the RDMnet device with a Broker stand-in on the loopback interface.
+ * The Broker and the device run in one loop, the Broker pipelines the RPT Requests.
+ * Only the RPT part of the device is run: on Linux the LLRP UDP socket has a receive timeout.
+ * - GET DEVICE_INFO and SET IDENTIFY_DEVICE are answered with a Notification each.
+ * - While the Broker does not read, Run keeps returning at once and no request is lost.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "hardware.h"
+#include "networklinux.h"
+#include "ledblink.h"
+
+#include "rdmnetdevice.h"
+#include "rptpacket.h"
+#include "e133.h"
+#include "lightsetdebug.h"
+#include "rdmpersonality.h"
+
+#include "rdm.h"
+#include "rdm_e120.h"
+
+#include "identify.h"
+
+static constexpr uint32_t REQUESTS = 20000;
+static constexpr uint32_t WINDOW = 16;
+static constexpr uint32_t BACK_PRESSURE_MILLIS = 2000;
+static constexpr uint32_t BACK_PRESSURE_PENDING = 64 * 1024;
+static constexpr uint32_t RUN_MAX_MICROS = 20000;	///< The old TcpWrite waited 100 ms for a full socket buffer
+static constexpr int BROKER_RECEIVE_BUFFER = 4096;
+static constexpr uint8_t ACN_PACKET_IDENTIFIER[12] = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0 };
+static constexpr uint8_t BROKER_UID[6] = {0x7F, 0xF0, 0x00, 0x00, 0x00, 0x01};
+static constexpr uint8_t CONTROLLER_UID[6] = {0x7F, 0xF0, 0x00, 0x00, 0x00, 0x02};
+
+static uint32_t s_nFailures;
+
+static void Check(bool bCondition, const char *pText) {
+	printf("%s : %s\n", bCondition ? "PASS" : "FAIL", pText);
+
+	if (!bCondition) {
+		s_nFailures++;
+	}
+}
+
+static uint64_t Micros(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (static_cast<uint64_t>(ts.tv_sec) * 1000000) + static_cast<uint64_t>(ts.tv_nsec / 1000);
+}
+
+static void SetFlagsLength(uint8_t *pFlagsLength, uint32_t nLength) {
+	pFlagsLength[0] = static_cast<uint8_t>(0xF0 | ((nLength >> 16) & 0x0F));
+	pFlagsLength[1] = static_cast<uint8_t>(nLength >> 8);
+	pFlagsLength[2] = static_cast<uint8_t>(nLength);
+}
+
+/*
+ * A Broker with one client. The requests are queued when the socket does not accept them.
+ */
+class Broker {
+public:
+	~Broker(void) {
+		if (m_nClient >= 0) {
+			close(m_nClient);
+		}
+		if (m_nListen >= 0) {
+			close(m_nListen);
+		}
+	}
+
+	bool Listen(void) {
+		if ((m_nListen = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
+			perror("socket");
+			return false;
+		}
+
+		int nValue = 1;
+		setsockopt(m_nListen, SOL_SOCKET, SO_REUSEADDR, &nValue, sizeof(nValue));
+
+		// A small receive window, the device's socket fills up soon when the Broker does not read
+		nValue = BROKER_RECEIVE_BUFFER;
+		setsockopt(m_nListen, SOL_SOCKET, SO_RCVBUF, &nValue, sizeof(nValue));
+
+		struct sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		socklen_t nLength = sizeof(addr);
+
+		if ((bind(m_nListen, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0)
+				|| (listen(m_nListen, 1) < 0)
+				|| (getsockname(m_nListen, reinterpret_cast<struct sockaddr*>(&addr), &nLength) < 0)) {
+			perror("listen");
+			return false;
+		}
+
+		fcntl(m_nListen, F_SETFL, fcntl(m_nListen, F_GETFL, 0) | O_NONBLOCK);
+		m_nPort = ntohs(addr.sin_port);
+
+		return true;
+	}
+
+	void Run(void) {
+		if (m_nClient < 0) {
+			if ((m_nClient = accept(m_nListen, 0, 0)) >= 0) {
+				fcntl(m_nClient, F_SETFL, fcntl(m_nClient, F_GETFL, 0) | O_NONBLOCK);
+			}
+			return;
+		}
+
+		Flush();
+
+		while (m_bIsReading) {
+			const ssize_t nBytes = recv(m_nClient, &m_aReceive[m_nReceiveLength], sizeof(m_aReceive) - m_nReceiveLength, 0);
+
+			if (nBytes <= 0) {
+				break;
+			}
+
+			m_nReceiveLength += static_cast<uint32_t>(nBytes);
+			HandleReceive();
+		}
+	}
+
+	void SendRequest(const uint8_t *pDeviceUid, uint16_t nParamId, uint8_t nCommandClass, const uint8_t *pParamData, uint8_t nParamDataLength) {
+		uint8_t aPacket[sizeof(struct TRptCommonPacket) + sizeof(struct TRptRequestPDU) + RDM_COMMAND_PDU_HEADER_SIZE + 256];
+
+		// The RDM Command without SC, the message length includes the SC but not the checksum
+		uint8_t *pRdm = &aPacket[sizeof(struct TRptCommonPacket) + sizeof(struct TRptRequestPDU) + RDM_COMMAND_PDU_HEADER_SIZE];
+		const uint8_t nMessageLength = static_cast<uint8_t>(RDM_MESSAGE_MINIMUM_SIZE + nParamDataLength);
+
+		pRdm[0] = E120_SC_SUB_MESSAGE;
+		pRdm[1] = nMessageLength;
+		memcpy(&pRdm[2], pDeviceUid, 6);
+		memcpy(&pRdm[8], CONTROLLER_UID, 6);
+		pRdm[14] = static_cast<uint8_t>(m_nSequence);
+		pRdm[15] = 1;
+		pRdm[16] = 0;
+		pRdm[17] = 0;
+		pRdm[18] = 0;
+		pRdm[19] = nCommandClass;
+		pRdm[20] = static_cast<uint8_t>(nParamId >> 8);
+		pRdm[21] = static_cast<uint8_t>(nParamId);
+		pRdm[22] = nParamDataLength;
+		memcpy(&pRdm[23], pParamData, nParamDataLength);
+
+		uint16_t nChecksum = E120_SC_RDM;
+
+		for (uint32_t i = 0; i < (nMessageLength - 1U); i++) {
+			nChecksum = static_cast<uint16_t>(nChecksum + pRdm[i]);
+		}
+
+		pRdm[nMessageLength - 1] = static_cast<uint8_t>(nChecksum >> 8);
+		pRdm[nMessageLength] = static_cast<uint8_t>(nChecksum);
+
+		const uint32_t nRdmLength = nMessageLength + 1U;
+
+		uint8_t *pCommandPDU = pRdm - RDM_COMMAND_PDU_HEADER_SIZE;
+		SetFlagsLength(pCommandPDU, RDM_COMMAND_PDU_HEADER_SIZE + nRdmLength);
+		pCommandPDU[3] = VECTOR_RDM_CMD_RDM_DATA;
+
+		const uint32_t nRequestLength = sizeof(struct TRptRequestPDU) + RDM_COMMAND_PDU_HEADER_SIZE + nRdmLength;
+		auto *pRequestPDU = reinterpret_cast<struct TRptRequestPDU*>(&aPacket[sizeof(struct TRptCommonPacket)]);
+		SetFlagsLength(pRequestPDU->FlagsLength, nRequestLength);
+		pRequestPDU->Vector = __builtin_bswap32(VECTOR_REQUEST_RDM_CMD);
+
+		auto *pRptPDU = &reinterpret_cast<struct TRptCommonPacket*>(aPacket)->RptPDU;
+		const uint32_t nRptLength = sizeof(struct TRptPDU) + nRequestLength;
+		SetFlagsLength(pRptPDU->FlagsLength, nRptLength);
+		pRptPDU->Vector = __builtin_bswap32(VECTOR_RPT_REQUEST);
+		memcpy(pRptPDU->SourceUid, CONTROLLER_UID, 6);
+		pRptPDU->SourceEndpoint = 0;
+		memcpy(pRptPDU->DestinationUid, pDeviceUid, 6);
+		pRptPDU->DestinationEndpoint = __builtin_bswap16(E133_NULL_ENDPOINT);
+		pRptPDU->SequenceNumber = __builtin_bswap32(m_nSequence);
+		pRptPDU->Reserved = 0;
+
+		m_aSendMicros[m_nSequence % (sizeof(m_aSendMicros) / sizeof(m_aSendMicros[0]))] = Micros();
+		m_nSequence++;
+
+		Queue(aPacket, FillRootLayer(aPacket, VECTOR_ROOT_RPT, nRptLength));
+	}
+
+	void SetReading(bool bIsReading) {
+		m_bIsReading = bIsReading;
+	}
+
+	void ResetStatistics(void) {
+		m_nNotifications = 0;
+		m_nStatus = 0;
+		m_nOutOfOrder = 0;
+		m_nLatencyMicros = 0;
+		m_nLatencyMaxMicros = 0;
+	}
+
+	uint32_t GetInFlight(void) const {
+		return m_nSequence - m_nAnswered;
+	}
+
+	uint16_t m_nPort = 0;
+	uint8_t m_aDeviceUid[6] {};
+	bool m_bIsDeviceConnected = false;
+	uint32_t m_nSendLength = 0;
+	uint32_t m_nSequence = 0;
+	uint32_t m_nAnswered = 0;
+	uint32_t m_nNotifications = 0;
+	uint32_t m_nStatus = 0;
+	uint32_t m_nOutOfOrder = 0;
+	uint64_t m_nLatencyMicros = 0;
+	uint32_t m_nLatencyMaxMicros = 0;
+
+private:
+	uint32_t FillRootLayer(uint8_t *pPacket, uint32_t nVector, uint32_t nDataLength) {
+		auto *pPreAmble = reinterpret_cast<struct TTcpPreAmble*>(pPacket);
+		auto *pRootLayerPDU = reinterpret_cast<struct TRootLayerPDU*>(&pPacket[sizeof(struct TTcpPreAmble)]);
+		const uint32_t nRootLayerLength = sizeof(struct TRootLayerPDU) + nDataLength;
+
+		memcpy(pPreAmble->ACNPacketIdentifier, ACN_PACKET_IDENTIFIER, sizeof(ACN_PACKET_IDENTIFIER));
+		pPreAmble->RlpBlockLength = __builtin_bswap32(nRootLayerLength);
+		SetFlagsLength(pRootLayerPDU->FlagsLength, nRootLayerLength);
+		pRootLayerPDU->Vector = __builtin_bswap32(nVector);
+		memset(pRootLayerPDU->SenderCid, 0xBB, sizeof(pRootLayerPDU->SenderCid));
+
+		return sizeof(struct TTcpPreAmble) + nRootLayerLength;
+	}
+
+	void SendConnectReply(void) {
+		uint8_t aPacket[sizeof(struct TBrokerCommonPacket) + sizeof(struct TConnectReply)];
+		auto *pBrokerPDU = &reinterpret_cast<struct TBrokerCommonPacket*>(aPacket)->BrokerPDU;
+		auto *pConnectReply = reinterpret_cast<struct TConnectReply*>(&aPacket[sizeof(struct TBrokerCommonPacket)]);
+
+		SetFlagsLength(pBrokerPDU->FlagsLength, sizeof(struct TBrokerPDU) + sizeof(struct TConnectReply));
+		pBrokerPDU->Vector = __builtin_bswap16(VECTOR_BROKER_CONNECT_REPLY);
+		pConnectReply->ConnectionCode = __builtin_bswap16(E133_CONNECT_OK);
+		pConnectReply->E133Version = __builtin_bswap16(E133_VERSION);
+		memcpy(pConnectReply->BrokerUid, BROKER_UID, 6);
+		memcpy(pConnectReply->ClientUid, m_aDeviceUid, 6);
+
+		Queue(aPacket, FillRootLayer(aPacket, VECTOR_ROOT_BROKER, sizeof(struct TBrokerPDU) + sizeof(struct TConnectReply)));
+	}
+
+	void Queue(const uint8_t *pData, uint32_t nLength) {
+		if ((m_nSendLength + nLength) > sizeof(m_aSend)) {
+			puts("Broker send queue overflow");
+			s_nFailures++;
+			return;
+		}
+
+		memcpy(&m_aSend[m_nSendLength], pData, nLength);
+		m_nSendLength += nLength;
+
+		Flush();
+	}
+
+	void Flush(void) {
+		if (m_nSendLength == 0) {
+			return;
+		}
+
+		const ssize_t nBytes = send(m_nClient, m_aSend, m_nSendLength, MSG_NOSIGNAL);
+
+		if (nBytes > 0) {
+			m_nSendLength -= static_cast<uint32_t>(nBytes);
+			memmove(m_aSend, &m_aSend[nBytes], m_nSendLength);
+		}
+	}
+
+	void HandleReceive(void) {
+		uint32_t nOffset = 0;
+
+		while ((m_nReceiveLength - nOffset) >= sizeof(struct TTcpPreAmble)) {
+			const auto *pPreAmble = reinterpret_cast<const struct TTcpPreAmble*>(&m_aReceive[nOffset]);
+			const uint32_t nPacketLength = sizeof(struct TTcpPreAmble) + __builtin_bswap32(pPreAmble->RlpBlockLength);
+
+			if ((m_nReceiveLength - nOffset) < nPacketLength) {
+				break;
+			}
+
+			HandlePacket(&m_aReceive[nOffset]);
+			nOffset += nPacketLength;
+		}
+
+		m_nReceiveLength -= nOffset;
+		memmove(m_aReceive, &m_aReceive[nOffset], m_nReceiveLength);
+	}
+
+	void HandlePacket(const uint8_t *pPacket) {
+		const auto *pRootLayerPDU = reinterpret_cast<const struct TRootLayerPDU*>(&pPacket[sizeof(struct TTcpPreAmble)]);
+
+		if (__builtin_bswap32(pRootLayerPDU->Vector) == VECTOR_ROOT_BROKER) {
+			const auto *pBrokerPDU = &reinterpret_cast<const struct TBrokerCommonPacket*>(pPacket)->BrokerPDU;
+
+			if (__builtin_bswap16(pBrokerPDU->Vector) == VECTOR_BROKER_CONNECT) {
+				const auto *pConnect = reinterpret_cast<const struct TBrokerClientConnectPacket*>(pPacket);
+				memcpy(m_aDeviceUid, pConnect->RptClientEntry.ClientUid, 6);
+				m_bIsDeviceConnected = true;
+				SendConnectReply();
+			}
+			return;
+		}
+
+		if (__builtin_bswap32(pRootLayerPDU->Vector) != VECTOR_ROOT_RPT) {
+			return;
+		}
+
+		const auto *pRptPDU = &reinterpret_cast<const struct TRptCommonPacket*>(pPacket)->RptPDU;
+		const uint32_t nSequence = __builtin_bswap32(pRptPDU->SequenceNumber);
+
+		if (__builtin_bswap32(pRptPDU->Vector) == VECTOR_RPT_NOTIFICATION) {
+			m_nNotifications++;
+		} else {
+			m_nStatus++;
+		}
+
+		if (nSequence != m_nAnswered) {
+			m_nOutOfOrder++;
+		}
+
+		const uint32_t nLatency = static_cast<uint32_t>(Micros() - m_aSendMicros[nSequence % (sizeof(m_aSendMicros) / sizeof(m_aSendMicros[0]))]);
+
+		m_nLatencyMicros += nLatency;
+
+		if (nLatency > m_nLatencyMaxMicros) {
+			m_nLatencyMaxMicros = nLatency;
+		}
+
+		m_nAnswered = nSequence + 1;
+	}
+
+	int m_nListen = -1;
+	int m_nClient = -1;
+	bool m_bIsReading = true;
+	uint8_t m_aReceive[8192];
+	uint32_t m_nReceiveLength = 0;
+	uint8_t m_aSend[256 * 1024];
+	uint64_t m_aSendMicros[65536];
+};
+
+static Broker s_Broker;
+
+struct Statistics {
+	uint32_t nRunMaxMicros;
+	uint64_t nElapsedMicros;
+};
+
+static void RunBoth(RDMNetDevice &device, Statistics &statistics) {
+	const uint64_t nStart = Micros();
+
+	device.RPTDevice::Run();
+
+	const uint32_t nRunMicros = static_cast<uint32_t>(Micros() - nStart);
+
+	if (nRunMicros > statistics.nRunMaxMicros) {
+		statistics.nRunMaxMicros = nRunMicros;
+	}
+
+	s_Broker.Run();
+}
+
+static void SendRequest(uint32_t nIndex, bool bIsSet) {
+	if (bIsSet) {
+		const uint8_t nIdentify = static_cast<uint8_t>(nIndex & 0x1);
+		s_Broker.SendRequest(s_Broker.m_aDeviceUid, E120_IDENTIFY_DEVICE, E120_SET_COMMAND, &nIdentify, 1);
+	} else {
+		s_Broker.SendRequest(s_Broker.m_aDeviceUid, E120_DEVICE_INFO, E120_GET_COMMAND, 0, 0);
+	}
+}
+
+/*
+ * WINDOW requests in flight, a new request is sent for each answer
+ */
+static void Throughput(RDMNetDevice &device, bool bIsSet) {
+	const char *pText = bIsSet ? "SET IDENTIFY_DEVICE" : "GET DEVICE_INFO";
+	Statistics statistics {};
+
+	s_Broker.ResetStatistics();
+
+	const uint64_t nStart = Micros();
+	uint32_t nSent = 0;
+
+	while (s_Broker.m_nNotifications + s_Broker.m_nStatus < REQUESTS) {
+		while ((nSent < REQUESTS) && (s_Broker.GetInFlight() < WINDOW)) {
+			SendRequest(nSent++, bIsSet);
+		}
+
+		RunBoth(device, statistics);
+
+		if ((Micros() - nStart) > 30000000) {
+			break;
+		}
+	}
+
+	statistics.nElapsedMicros = Micros() - nStart;
+
+	const uint32_t nAnswered = s_Broker.m_nNotifications + s_Broker.m_nStatus;
+	const uint32_t nRate = static_cast<uint32_t>((static_cast<uint64_t>(nAnswered) * 1000000) / statistics.nElapsedMicros);
+	const uint32_t nLatency = (nAnswered == 0) ? 0 : static_cast<uint32_t>(s_Broker.m_nLatencyMicros / nAnswered);
+
+	printf("%s: %u requests in %u ms, %u requests/s, latency %u us mean %u us max, Run %u us max\n", pText, nAnswered,
+			static_cast<uint32_t>(statistics.nElapsedMicros / 1000), nRate, nLatency, s_Broker.m_nLatencyMaxMicros, statistics.nRunMaxMicros);
+
+	Check((s_Broker.m_nNotifications == REQUESTS) && (s_Broker.m_nStatus == 0), "each request is answered with a Notification");
+	Check(s_Broker.m_nOutOfOrder == 0, "the Notifications are in the order of the requests");
+}
+
+/*
+ * The Broker stops reading: the device's socket fills up, the device queues and then stops reading requests
+ */
+static void BackPressure(RDMNetDevice &device) {
+	Statistics statistics {};
+
+	s_Broker.ResetStatistics();
+	s_Broker.SetReading(false);
+
+	const uint32_t nFirst = s_Broker.m_nSequence;
+	uint64_t nStart = Micros();
+	uint32_t nRuns = 0;
+
+	while ((Micros() - nStart) < (BACK_PRESSURE_MILLIS * 1000)) {
+		if (s_Broker.m_nSendLength < BACK_PRESSURE_PENDING) {
+			SendRequest(s_Broker.m_nSequence, false);
+		}
+
+		RunBoth(device, statistics);
+		nRuns++;
+	}
+
+	const uint32_t nSent = s_Broker.m_nSequence - nFirst;
+
+	printf("Broker not reading for %u ms: %u requests sent, %u runs, Run %u us max\n", BACK_PRESSURE_MILLIS, nSent, nRuns, statistics.nRunMaxMicros);
+
+	Check(statistics.nRunMaxMicros < RUN_MAX_MICROS, "Run does not wait for the socket");
+	Check(device.IsConnected(), "the device stays connected");
+
+	s_Broker.SetReading(true);
+	nStart = Micros();
+
+	while ((s_Broker.GetInFlight() != 0) && ((Micros() - nStart) < 10000000)) {
+		RunBoth(device, statistics);
+	}
+
+	printf("Broker reading again: %u answered in %u ms\n", s_Broker.m_nNotifications + s_Broker.m_nStatus, static_cast<uint32_t>((Micros() - nStart) / 1000));
+
+	Check((s_Broker.m_nNotifications == nSent) && (s_Broker.m_nStatus == 0), "all requests are answered, none is dropped");
+	Check(s_Broker.m_nOutOfOrder == 0, "the Notifications are in the order of the requests");
+}
+
+int main(int argc, char **argv) {
+	Hardware hw;
+	NetworkLinux nw;
+	LedBlink lb;
+
+	if (nw.Init(argc < 2 ? "lo" : argv[1]) < 0) {
+		fprintf(stderr, "Not able to start the network\n");
+		return -1;
+	}
+
+	if (!s_Broker.Listen()) {
+		return -1;
+	}
+
+	Identify identify;
+	LightSetDebug lighSetDebug;
+	RDMPersonality personality("RPT bench device", lighSetDebug.GetDmxFootprint());
+	RDMNetDevice device(&personality);
+
+	device.SetBroker(htonl(INADDR_LOOPBACK), s_Broker.m_nPort);
+	device.Init();
+	device.Start();
+
+	printf("Broker on 127.0.0.1:%u, %u requests, %u in flight\n", s_Broker.m_nPort, REQUESTS, WINDOW);
+
+	Statistics statistics {};
+	const uint64_t nStart = Micros();
+
+	while (!device.IsConnected() && ((Micros() - nStart) < 5000000)) {
+		RunBoth(device, statistics);
+	}
+
+	Check(device.IsConnected() && s_Broker.m_bIsDeviceConnected, "the device is connected to the Broker");
+
+	if (device.IsConnected()) {
+		Throughput(device, false);
+		Throughput(device, true);
+		BackPressure(device);
+	}
+
+	device.RPTDevice::Print();
+
+	printf("%s\n", s_nFailures == 0 ? "All tests passed" : "Tests failed");
+
+	return s_nFailures == 0 ? 0 : 1;
+}
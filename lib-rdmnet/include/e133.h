@@ -2,7 +2,7 @@
  * @file e133.h
  *
  */
-/* Copyright (C) 2019 by Arjan van Vught mailto:info@orangepi-dmx.nl
+/* Copyright (C) 2019-2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -26,10 +26,23 @@
 #ifndef E133_H_
 #define E133_H_
 
+/**
+ * Table A-1: Broker Protocol Constants
+ */
+#define E133_VERSION                        0x0001
+#define E133_DEFAULT_SCOPE                  "default"
+#define E133_DEFAULT_DOMAIN                 "local."
+#define E133_SCOPE_STRING_PADDED_LENGTH     63
+#define E133_DOMAIN_STRING_PADDED_LENGTH    231
+#define E133_TCP_HEARTBEAT_INTERVAL         15	/* seconds */
+#define E133_HEARTBEAT_TIMEOUT              45	/* seconds */
+
 /**
  * A.3 Root Layer PDU Vector
  */
 
+#define VECTOR_ROOT_RPT				0x00000005	/* Section 6 */
+#define VECTOR_ROOT_BROKER			0x00000009	/* Section 7 */
 #define VECTOR_ROOT_LLRP 			0x0000000A	/* Section 5.4 */
 
 /**
@@ -49,6 +62,52 @@
  */
 #define VECTOR_PROBE_REPLY_DATA 0x01
 
+/**
+ * Table A-7: Vector Defines for Broker PDU
+ */
+#define VECTOR_BROKER_CONNECT               0x0001
+#define VECTOR_BROKER_CONNECT_REPLY         0x0002
+#define VECTOR_BROKER_CLIENT_ENTRY_UPDATE   0x0003
+#define VECTOR_BROKER_REDIRECT_V4           0x0004
+#define VECTOR_BROKER_REDIRECT_V6           0x0005
+#define VECTOR_BROKER_FETCH_CLIENT_LIST     0x0006
+#define VECTOR_BROKER_CONNECTED_CLIENT_LIST 0x0007
+#define VECTOR_BROKER_CLIENT_ADD            0x0008
+#define VECTOR_BROKER_CLIENT_REMOVE         0x0009
+#define VECTOR_BROKER_CLIENT_ENTRY_CHANGE   0x000A
+#define VECTOR_BROKER_DISCONNECT            0x000E
+#define VECTOR_BROKER_NULL                  0x000F
+
+/**
+ * Table A-8: Vector Defines for RPT PDU
+ */
+#define VECTOR_RPT_REQUEST      0x00000001
+#define VECTOR_RPT_STATUS       0x00000002
+#define VECTOR_RPT_NOTIFICATION 0x00000003
+
+/**
+ * Table A-9: Vector Defines for Request PDU
+ */
+#define VECTOR_REQUEST_RDM_CMD 0x00000001
+
+/**
+ * Table A-10: Vector Defines for RPT Status PDU
+ */
+#define VECTOR_RPT_STATUS_UNKNOWN_RPT_UID       0x0001
+#define VECTOR_RPT_STATUS_RDM_TIMEOUT           0x0002
+#define VECTOR_RPT_STATUS_RDM_INVALID_RESPONSE  0x0003
+#define VECTOR_RPT_STATUS_UNKNOWN_RDM_UID       0x0004
+#define VECTOR_RPT_STATUS_UNKNOWN_ENDPOINT      0x0005
+#define VECTOR_RPT_STATUS_BROADCAST_COMPLETE    0x0006
+#define VECTOR_RPT_STATUS_UNKNOWN_VECTOR        0x0007
+#define VECTOR_RPT_STATUS_INVALID_MESSAGE       0x0008
+#define VECTOR_RPT_STATUS_INVALID_COMMAND_CLASS 0x0009
+
+/**
+ * Table A-11: Vector Defines for Notification PDU
+ */
+#define VECTOR_NOTIFICATION_RDM_CMD 0x00000001
+
 /**
  * Table A.12 RDM Command PDU Vector
  */
@@ -62,4 +121,38 @@
 #define LLRP_COMPONENT_TYPE_BROKER         0x02	///< The LLRP Target is a Broker
 #define LLRP_COMPONENT_TYPE_NON_RDMNET     0xFF	///< The LLRP Target does not implement any RDMnet protocol other than LLRP
 
+/**
+ * Table A-19: Connection Status Codes for Broker Connect
+ */
+#define E133_CONNECT_OK                   0x0000
+#define E133_CONNECT_SCOPE_MISMATCH       0x0001
+#define E133_CONNECT_CAPACITY_EXCEEDED    0x0002
+#define E133_CONNECT_DUPLICATE_UID        0x0003
+#define E133_CONNECT_INVALID_CLIENT_ENTRY 0x0004
+#define E133_CONNECT_INVALID_UID          0x0005
+
+/**
+ * Table A-20: Status Codes for Broker Disconnect
+ */
+#define E133_DISCONNECT_SHUTDOWN          0x0000
+
+/**
+ * Table A-21: Client Protocol Codes
+ */
+#define CLIENT_PROTOCOL_RPT 0x00000005
+
+/**
+ * Table A-22: RPT Client Type Codes
+ */
+#define RPT_CLIENT_TYPE_DEVICE     0x00
+#define RPT_CLIENT_TYPE_CONTROLLER 0x01
+
+/**
+ * Section 6.2.3 Endpoints, Section 6.2.4 RPT broadcast UIDs (0xFFFCmmmmFFFF and 0xFFFDmmmmFFFF)
+ */
+#define E133_NULL_ENDPOINT            0x0000
+#define E133_BROADCAST_ENDPOINT       0xFFFF
+#define E133_RPT_ALL_CONTROLLERS_MSB  0xFFFC
+#define E133_RPT_ALL_DEVICES_MSB      0xFFFD
+
 #endif /* E133_H_ */
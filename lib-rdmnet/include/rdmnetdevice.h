@@ -2,7 +2,7 @@
  * @file rdmnetdevice.h
  *
  */
-/* Copyright (C) 2019 by Arjan van Vught mailto:info@orangepi-dmx.nl
+/* Copyright (C) 2019-2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -30,13 +30,14 @@
 
 #include "rdmdeviceresponder.h"
 #include "llrpdevice.h"
+#include "rptdevice.h"
 
 #include "rdmhandler.h"
 
 #include "e131.h"
 #include "e131uuid.h"
 
-class RDMNetDevice: public RDMDeviceResponder, public LLRPDevice {
+class RDMNetDevice: public RDMDeviceResponder, public LLRPDevice, public RPTDevice {
 public:
 	RDMNetDevice(RDMPersonality *pRDMPersonality);
 	~RDMNetDevice(void);
@@ -51,6 +52,7 @@ public:
 	void CopyCID(uint8_t *pCID) override;
 
 	uint8_t *LLRPHandleRdmCommand(const uint8_t *pRdmDataNoSC) override;
+	uint8_t *RPTHandleRdmCommand(const uint8_t *pRdmDataNoSC) override;
 
 private:
 	RDMHandler *m_RDMHandler;
@@ -0,0 +1,142 @@
+/**
+ * @file rptdevice.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef RPTDEVICE_H_
+#define RPTDEVICE_H_
+
+#include <stdint.h>
+
+#include "rptpacket.h"
+#include "e133.h"
+
+struct RPTDeviceConst {
+	static constexpr uint32_t CONNECT_TIMEOUT_MILLIS = 5000;
+	static constexpr uint32_t RECONNECT_MIN_MILLIS = 1000;
+	static constexpr uint32_t RECONNECT_MAX_MILLIS = 32000;
+	static constexpr uint32_t RECEIVE_BUFFER_SIZE = 1024;	///< Larger messages (client lists) are skipped
+	static constexpr uint32_t TRANSMIT_BUFFER_SIZE = sizeof(struct TRptCommonPacket) + sizeof(struct TRptRequestPDU) + (2 * (RDM_COMMAND_PDU_HEADER_SIZE + 256));
+	static constexpr uint32_t SEND_QUEUE_SIZE = 4 * TRANSMIT_BUFFER_SIZE;	///< The bytes the socket did not accept yet
+};
+
+enum class RPTDeviceState {
+	IDLE,
+	WAIT_RECONNECT,
+	CONNECTING,
+	CONNECT_SENT,
+	CONNECTED
+};
+
+/**
+ * RDMnet RPT Device, the TCP connection with a Broker (E1.33 Section 6 and 7).
+ * The Broker is configured statically, there is no DNS-SD discovery.
+ * Run never waits: the connection is set up in steps, the heartbeat is kept and
+ * after a lost connection it reconnects with an exponential backoff.
+ * What the socket does not accept is queued and flushed by Run. While the queue
+ * has no room for a response, no more requests are read: the Broker is slowed down
+ * by TCP flow control instead of the device waiting.
+ * An RPT Request for the default responder is answered with a Notification holding
+ * the command and the response, or with an RPT Status.
+ */
+class RPTDevice {
+public:
+	RPTDevice(void);
+	virtual ~RPTDevice(void);
+
+	void SetBroker(uint32_t nIp, uint16_t nPort);
+	void SetScope(const char *pScope);
+
+	void Start(void);
+	void Stop(void);
+	void Run(void);
+
+	bool IsConnected(void) const {
+		return m_tState == RPTDeviceState::CONNECTED;
+	}
+
+	void Print(void);
+
+protected:
+	virtual void CopyUID(uint8_t *pUID);
+	virtual void CopyCID(uint8_t *pCID);
+	virtual uint8_t *RPTHandleRdmCommand(const uint8_t *pRdmDataNoSC);
+
+private:
+	void Connect(void);
+	void Disconnect(bool bSendDisconnect);
+	void Receive(void);
+	void Flush(void);
+	bool IsSendQueueAvailable(void) const {
+		return (RPTDeviceConst::SEND_QUEUE_SIZE - m_nSendQueueLength) >= RPTDeviceConst::TRANSMIT_BUFFER_SIZE;
+	}
+	bool HandleReceiveBuffer(void);
+	void HandleRootLayer(const uint8_t *pData, uint32_t nLength);
+	void HandleBroker(const uint8_t *pData, uint32_t nLength);
+	void HandleRpt(const uint8_t *pData, uint32_t nLength);
+	void HandleRequest(const struct TRptPDU *pRptPDU, const uint8_t *pData, uint32_t nLength);
+	bool IsForThisDevice(const uint8_t *pUid, bool &bIsBroadcast);
+
+	uint32_t FillRootLayer(uint32_t nVector, uint32_t nDataLength);
+	uint32_t FillBroker(uint16_t nVector, uint32_t nDataLength);
+	uint32_t FillRpt(uint32_t nVector, const struct TRptPDU *pRequestPDU, const uint8_t *pDestinationUid, uint32_t nDataLength);
+
+	void SendClientConnect(void);
+	void SendNull(void);
+	void SendStatus(const struct TRptPDU *pRequestPDU, uint16_t nStatus);
+	void SendNotification(const struct TRptPDU *pRequestPDU, const uint8_t *pCommand, uint32_t nCommandLength, const uint8_t *pResponse);
+	void Send(uint32_t nLength);
+
+private:
+	uint32_t m_nBrokerIp = 0;
+	uint16_t m_nBrokerPort = 0;
+	char m_aScope[E133_SCOPE_STRING_PADDED_LENGTH];
+	uint8_t m_aUid[6];
+	uint8_t m_aBrokerUid[6];
+
+	int32_t m_nHandle = -1;
+	RPTDeviceState m_tState = RPTDeviceState::IDLE;
+	uint32_t m_nStateMillis = 0;
+	uint32_t m_nReceiveMillis = 0;
+	uint32_t m_nSendMillis = 0;
+	uint32_t m_nWaitMillis = 0;
+	uint32_t m_nReconnectMillis = RPTDeviceConst::RECONNECT_MIN_MILLIS;
+	uint16_t m_nConnectCode = E133_CONNECT_OK;
+
+	uint8_t m_aReceiveBuffer[RPTDeviceConst::RECEIVE_BUFFER_SIZE];
+	uint32_t m_nReceiveLength = 0;
+	uint32_t m_nSkipLength = 0;
+	uint8_t m_aTransmitBuffer[RPTDeviceConst::TRANSMIT_BUFFER_SIZE];
+	uint8_t m_aSendQueue[RPTDeviceConst::SEND_QUEUE_SIZE];
+	uint32_t m_nSendQueueLength = 0;
+
+	uint32_t m_nConnects = 0;
+	uint32_t m_nHeartbeatTimeOuts = 0;
+	uint32_t m_nRequests = 0;
+	uint32_t m_nNotifications = 0;
+	uint32_t m_nStatus = 0;
+	uint32_t m_nSkipped = 0;
+	uint32_t m_nDropped = 0;
+};
+
+#endif /* RPTDEVICE_H_ */
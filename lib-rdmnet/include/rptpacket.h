@@ -0,0 +1,147 @@
+/**
+ * @file rptpacket.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef RPTPACKET_H_
+#define RPTPACKET_H_
+
+#include <stdint.h>
+
+#include "llrppacket.h"
+#include "e133.h"
+
+#if  ! defined (PACKED)
+#define PACKED __attribute__((packed))
+#endif
+
+/**
+ * E1.17 TCP preamble, Section 5.2 E1.33
+ */
+struct TTcpPreAmble {
+	uint8_t ACNPacketIdentifier[12];  	///< ACN Packet Identifier
+	uint32_t RlpBlockLength;			///< Length of the Root Layer PDU block that follows
+}PACKED;
+
+/**
+ * 7.1 Broker PDU
+ */
+struct TBrokerPDU {
+	uint8_t FlagsLength[3]; 			///< Protocol flags and length. Low 20 bits = PDU length High 4 bits = 0xF
+	uint16_t Vector;					///< Identifies data format
+}PACKED;
+
+/**
+ * 7.2.1 Client Connect
+ */
+struct TClientConnect {
+	uint8_t ClientScope[E133_SCOPE_STRING_PADDED_LENGTH];	///< Null padded UTF-8 scope
+	uint16_t E133Version;
+	uint8_t SearchDomain[E133_DOMAIN_STRING_PADDED_LENGTH];	///< Null padded UTF-8 search domain
+	uint8_t ConnectionFlags;
+}PACKED;
+
+struct TClientEntryPDU {
+	uint8_t FlagsLength[3]; 			///< Protocol flags and length. Low 20 bits = PDU length High 4 bits = 0xF
+	uint32_t Vector;					///< Client protocol -> CLIENT_PROTOCOL_RPT
+	uint8_t ClientCid[16];
+}PACKED;
+
+struct TRptClientEntry {
+	uint8_t ClientUid[6];
+	uint8_t ClientType;					///< RPT_CLIENT_TYPE_DEVICE
+	uint8_t BindingCid[16];
+}PACKED;
+
+/**
+ * 7.2.2 Connect Reply
+ */
+struct TConnectReply {
+	uint16_t ConnectionCode;
+	uint16_t E133Version;
+	uint8_t BrokerUid[6];
+	uint8_t ClientUid[6];
+}PACKED;
+
+/**
+ * 6.2 RPT PDU
+ */
+struct TRptPDU {
+	uint8_t FlagsLength[3]; 			///< Protocol flags and length. Low 20 bits = PDU length High 4 bits = 0xF
+	uint32_t Vector;					///< Identifies data format
+	uint8_t SourceUid[6];
+	uint16_t SourceEndpoint;
+	uint8_t DestinationUid[6];
+	uint16_t DestinationEndpoint;
+	uint32_t SequenceNumber;			///< Used to match request / notification messages.
+	uint8_t Reserved;
+}PACKED;
+
+/**
+ * 6.3 Request PDU and 6.5 Notification PDU, followed by RDM Command PDU's
+ */
+struct TRptRequestPDU {
+	uint8_t FlagsLength[3]; 			///< Protocol flags and length. Low 20 bits = PDU length High 4 bits = 0xF
+	uint32_t Vector;					///< VECTOR_REQUEST_RDM_CMD or VECTOR_NOTIFICATION_RDM_CMD
+}PACKED;
+
+/**
+ * 6.4 RPT Status PDU, the optional status string is not used
+ */
+struct TRptStatusPDU {
+	uint8_t FlagsLength[3]; 			///< Protocol flags and length. Low 20 bits = PDU length High 4 bits = 0xF
+	uint16_t Vector;					///< Table A-10
+}PACKED;
+
+struct TBrokerCommonPacket {
+	struct TTcpPreAmble TcpPreAmble;
+	struct TRootLayerPDU RootLayerPDU;
+	struct TBrokerPDU BrokerPDU;
+}PACKED;
+
+struct TBrokerClientConnectPacket {
+	struct TBrokerCommonPacket Common;
+	struct TClientConnect ClientConnect;
+	struct TClientEntryPDU ClientEntryPDU;
+	struct TRptClientEntry RptClientEntry;
+}PACKED;
+
+struct TBrokerDisconnectPacket {
+	struct TBrokerCommonPacket Common;
+	uint16_t DisconnectReason;
+}PACKED;
+
+struct TRptCommonPacket {
+	struct TTcpPreAmble TcpPreAmble;
+	struct TRootLayerPDU RootLayerPDU;
+	struct TRptPDU RptPDU;
+}PACKED;
+
+struct TRptStatusPacket {
+	struct TRptCommonPacket Common;
+	struct TRptStatusPDU StatusPDU;
+}PACKED;
+
+#define RDM_COMMAND_PDU_HEADER_SIZE		RDM_COMMAND_PDU_LENGTH(0)
+
+#endif /* RPTPACKET_H_ */
@@ -2,7 +2,7 @@
  * @file rdmnetdevice.cpp
  *
  */
-/* Copyright (C) 2019 by Arjan van Vught mailto:info@orangepi-dmx.nl
+/* Copyright (C) 2019-2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -32,6 +32,7 @@
 #include "rdmnetdevice.h"
 
 #include "llrpdevice.h"
+#include "rptdevice.h"
 #include "rdmpersonality.h"
 #include "lightset.h"
 #include "rdmdeviceresponder.h"
@@ -76,6 +77,7 @@ void RDMNetDevice::Start(void) {
 	DEBUG_ENTRY
 
 	LLRPDevice::Start();
+	RPTDevice::Start();
 
 	DEBUG_EXIT
 }
@@ -83,6 +85,7 @@ void RDMNetDevice::Start(void) {
 void RDMNetDevice::Stop(void) {
 	DEBUG_ENTRY
 
+	RPTDevice::Stop();
 	LLRPDevice::Stop();
 
 	DEBUG_EXIT
@@ -90,6 +93,7 @@ void RDMNetDevice::Stop(void) {
 
 void RDMNetDevice::Run(void) {
 	LLRPDevice::Run();
+	RPTDevice::Run();
 }
 
 void RDMNetDevice::Print(void) {
@@ -101,6 +105,7 @@ void RDMNetDevice::Print(void) {
 	printf(" CID : %s\n", uuid_str);
 
 	LLRPDevice::Print();
+	RPTDevice::Print();
 	RDMDeviceResponder::Print();
 }
 
@@ -119,3 +124,9 @@ uint8_t *RDMNetDevice::LLRPHandleRdmCommand(const uint8_t *pRdmDataNoSC) {
 
 	return reinterpret_cast<uint8_t*>(m_pRdmCommand);
 }
+
+uint8_t *RDMNetDevice::RPTHandleRdmCommand(const uint8_t *pRdmDataNoSC) {
+	m_RDMHandler->HandleData(pRdmDataNoSC, reinterpret_cast<uint8_t*>(m_pRdmCommand));
+
+	return reinterpret_cast<uint8_t*>(m_pRdmCommand);
+}
@@ -0,0 +1,679 @@
+/**
+ * @file rptdevice.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <cassert>
+
+#include "rptdevice.h"
+#include "rptpacket.h"
+
+#include "e133.h"
+#include "rdm.h"
+#include "rdm_e120.h"
+
+#include "hardware.h"
+#include "network.h"
+
+#include "debug.h"
+
+static constexpr uint8_t ACN_PACKET_IDENTIFIER[12] = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0 };
+
+static void SetFlagsLength(uint8_t *pFlagsLength, uint32_t nLength) {
+	pFlagsLength[0] = static_cast<uint8_t>(0xF0 | ((nLength >> 16) & 0x0F));
+	pFlagsLength[1] = static_cast<uint8_t>(nLength >> 8);
+	pFlagsLength[2] = static_cast<uint8_t>(nLength);
+}
+
+static uint32_t GetLength(const uint8_t *pFlagsLength) {
+	return (static_cast<uint32_t>(pFlagsLength[0] & 0x0F) << 16) | static_cast<uint32_t>(pFlagsLength[1] << 8) | pFlagsLength[2];
+}
+
+RPTDevice::RPTDevice(void) {
+	DEBUG_ENTRY
+
+	SetScope(E133_DEFAULT_SCOPE);
+
+	memset(m_aUid, 0, sizeof(m_aUid));
+	memset(m_aBrokerUid, 0, sizeof(m_aBrokerUid));
+
+	DEBUG_EXIT
+}
+
+RPTDevice::~RPTDevice(void) {
+	DEBUG_ENTRY
+
+	DEBUG_EXIT
+}
+
+void RPTDevice::SetBroker(uint32_t nIp, uint16_t nPort) {
+	m_nBrokerIp = nIp;
+	m_nBrokerPort = nPort;
+}
+
+void RPTDevice::SetScope(const char *pScope) {
+	assert(pScope != 0);
+
+	strncpy(m_aScope, pScope, sizeof(m_aScope) - 1);
+	m_aScope[sizeof(m_aScope) - 1] = '\0';
+}
+
+void RPTDevice::Start(void) {
+	DEBUG_ENTRY
+
+	if ((m_nBrokerIp == 0) || (m_nBrokerPort == 0)) {
+		DEBUG_PUTS("No Broker");
+		DEBUG_EXIT
+		return;
+	}
+
+	CopyUID(m_aUid);
+
+	m_nReconnectMillis = RPTDeviceConst::RECONNECT_MIN_MILLIS;
+	Connect();
+
+	DEBUG_EXIT
+}
+
+void RPTDevice::Stop(void) {
+	DEBUG_ENTRY
+
+	Disconnect(true);
+	m_tState = RPTDeviceState::IDLE;
+
+	DEBUG_EXIT
+}
+
+void RPTDevice::Connect(void) {
+	m_nHandle = Network::Get()->TcpBegin(m_nBrokerIp, m_nBrokerPort);
+	m_nStateMillis = Hardware::Get()->Millis();
+
+	if (m_nHandle < 0) {
+		m_nWaitMillis = m_nReconnectMillis;
+		m_tState = RPTDeviceState::WAIT_RECONNECT;
+		return;
+	}
+
+	m_tState = RPTDeviceState::CONNECTING;
+}
+
+void RPTDevice::Disconnect(bool bSendDisconnect) {
+	if (m_nHandle < 0) {
+		return;
+	}
+
+	DEBUG_PRINTF("m_tState=%d", static_cast<int>(m_tState));
+
+	// Not in the middle of a queued message
+	if (bSendDisconnect && (m_tState == RPTDeviceState::CONNECTED) && (m_nSendQueueLength == 0)) {
+		auto *pDisconnect = reinterpret_cast<struct TBrokerDisconnectPacket*>(m_aTransmitBuffer);
+		const uint32_t nLength = FillBroker(VECTOR_BROKER_DISCONNECT, sizeof(pDisconnect->DisconnectReason));
+
+		pDisconnect->DisconnectReason = __builtin_bswap16(E133_DISCONNECT_SHUTDOWN);
+
+		static_cast<void>(Network::Get()->TcpWrite(m_nHandle, m_aTransmitBuffer, static_cast<uint16_t>(nLength)));
+	}
+
+	Network::Get()->TcpEnd(m_nHandle);
+
+	m_nHandle = -1;
+	m_nReceiveLength = 0;
+	m_nSkipLength = 0;
+	m_nSendQueueLength = 0;
+
+	// Exponential backoff, the wait is reset when the Broker accepts the connection
+	m_nWaitMillis = m_nReconnectMillis;
+	m_nReconnectMillis *= 2;
+
+	if (m_nReconnectMillis > RPTDeviceConst::RECONNECT_MAX_MILLIS) {
+		m_nReconnectMillis = RPTDeviceConst::RECONNECT_MAX_MILLIS;
+	}
+
+	m_nStateMillis = Hardware::Get()->Millis();
+	m_tState = RPTDeviceState::WAIT_RECONNECT;
+}
+
+void RPTDevice::Run(void) {
+	switch (m_tState) {
+	case RPTDeviceState::IDLE:
+		return;
+	case RPTDeviceState::WAIT_RECONNECT:
+		if ((Hardware::Get()->Millis() - m_nStateMillis) >= m_nWaitMillis) {
+			Connect();
+		}
+		return;
+	case RPTDeviceState::CONNECTING:
+		if (Network::Get()->TcpIsConnected(m_nHandle)) {
+			m_nConnects++;
+			m_nReceiveMillis = Hardware::Get()->Millis();
+			m_nStateMillis = m_nReceiveMillis;
+			m_tState = RPTDeviceState::CONNECT_SENT;
+			SendClientConnect();
+		} else if ((Hardware::Get()->Millis() - m_nStateMillis) >= RPTDeviceConst::CONNECT_TIMEOUT_MILLIS) {
+			Disconnect(false);
+		}
+		return;
+	default:
+		break;
+	}
+
+	Flush();
+
+	if (m_nHandle < 0) {
+		return;
+	}
+
+	Receive();
+
+	if (m_nHandle < 0) {
+		return;
+	}
+
+	const uint32_t nMillis = Hardware::Get()->Millis();
+
+	if ((m_tState == RPTDeviceState::CONNECT_SENT) && ((nMillis - m_nStateMillis) >= RPTDeviceConst::CONNECT_TIMEOUT_MILLIS)) {
+		Disconnect(false);
+		return;
+	}
+
+	if ((nMillis - m_nReceiveMillis) >= (E133_HEARTBEAT_TIMEOUT * 1000)) {
+		m_nHeartbeatTimeOuts++;
+		Disconnect(false);
+		return;
+	}
+
+	if ((m_tState == RPTDeviceState::CONNECTED) && ((nMillis - m_nSendMillis) >= (E133_TCP_HEARTBEAT_INTERVAL * 1000))) {
+		SendNull();
+	}
+}
+
+void RPTDevice::Receive(void) {
+	for (;;) {
+		// Also the requests left in the buffer while the send queue was full
+		if (!HandleReceiveBuffer()) {
+			DEBUG_PUTS("Stream out of sync");
+			Disconnect(false);
+			return;
+		}
+
+		if ((m_nHandle < 0) || !IsSendQueueAvailable()) {
+			return;
+		}
+
+		assert(m_nReceiveLength < sizeof(m_aReceiveBuffer));
+
+		const int32_t nBytes = Network::Get()->TcpRead(m_nHandle, &m_aReceiveBuffer[m_nReceiveLength], static_cast<uint16_t>(sizeof(m_aReceiveBuffer) - m_nReceiveLength));
+
+		if (nBytes == 0) {
+			return;
+		}
+
+		if (nBytes < 0) {
+			Disconnect(false);
+			return;
+		}
+
+		m_nReceiveMillis = Hardware::Get()->Millis();
+		m_nReceiveLength += static_cast<uint32_t>(nBytes);
+	}
+}
+
+void RPTDevice::Flush(void) {
+	if (m_nSendQueueLength == 0) {
+		return;
+	}
+
+	const int32_t nBytes = Network::Get()->TcpWrite(m_nHandle, m_aSendQueue, static_cast<uint16_t>(m_nSendQueueLength));
+
+	if (nBytes < 0) {
+		Disconnect(false);
+		return;
+	}
+
+	m_nSendQueueLength -= static_cast<uint32_t>(nBytes);
+	memmove(m_aSendQueue, &m_aSendQueue[nBytes], m_nSendQueueLength);
+}
+
+/**
+ * The TCP stream is split into the E1.17 packets, a packet can be received in parts.
+ * @return false when the stream is not in sync with the preamble
+ */
+bool RPTDevice::HandleReceiveBuffer(void) {
+	uint32_t nOffset = 0;
+
+	for (;;) {
+		const uint32_t nAvailable = m_nReceiveLength - nOffset;
+
+		if (m_nSkipLength != 0) {
+			const uint32_t nSkip = (m_nSkipLength < nAvailable) ? m_nSkipLength : nAvailable;
+
+			nOffset += nSkip;
+			m_nSkipLength -= nSkip;
+
+			if (m_nSkipLength != 0) {
+				break;
+			}
+
+			continue;
+		}
+
+		if ((nAvailable < sizeof(struct TTcpPreAmble)) || !IsSendQueueAvailable()) {
+			break;
+		}
+
+		const auto *pPreAmble = reinterpret_cast<const struct TTcpPreAmble*>(&m_aReceiveBuffer[nOffset]);
+
+		if (memcmp(pPreAmble->ACNPacketIdentifier, ACN_PACKET_IDENTIFIER, sizeof(ACN_PACKET_IDENTIFIER)) != 0) {
+			return false;
+		}
+
+		const uint32_t nBlockLength = __builtin_bswap32(pPreAmble->RlpBlockLength);
+		const uint32_t nPacketLength = sizeof(struct TTcpPreAmble) + nBlockLength;
+
+		if (nPacketLength > sizeof(m_aReceiveBuffer)) {
+			DEBUG_PRINTF("Skip %d", nPacketLength);
+			m_nSkipped++;
+			m_nSkipLength = nPacketLength;
+			continue;
+		}
+
+		if (nAvailable < nPacketLength) {
+			break;
+		}
+
+		HandleRootLayer(&m_aReceiveBuffer[nOffset + sizeof(struct TTcpPreAmble)], nBlockLength);
+
+		if (m_nHandle < 0) {
+			return true;
+		}
+
+		nOffset += nPacketLength;
+	}
+
+	m_nReceiveLength -= nOffset;
+	memmove(m_aReceiveBuffer, &m_aReceiveBuffer[nOffset], m_nReceiveLength);
+
+	return true;
+}
+
+void RPTDevice::HandleRootLayer(const uint8_t *pData, uint32_t nLength) {
+	const auto *pRootLayerPDU = reinterpret_cast<const struct TRootLayerPDU*>(pData);
+
+	if (nLength < sizeof(struct TRootLayerPDU)) {
+		return;
+	}
+
+	const uint32_t nPduLength = GetLength(pRootLayerPDU->FlagsLength);
+
+	if ((nPduLength < sizeof(struct TRootLayerPDU)) || (nPduLength > nLength)) {
+		return;
+	}
+
+	switch (__builtin_bswap32(pRootLayerPDU->Vector)) {
+	case VECTOR_ROOT_BROKER:
+		HandleBroker(&pData[sizeof(struct TRootLayerPDU)], nPduLength - sizeof(struct TRootLayerPDU));
+		break;
+	case VECTOR_ROOT_RPT:
+		HandleRpt(&pData[sizeof(struct TRootLayerPDU)], nPduLength - sizeof(struct TRootLayerPDU));
+		break;
+	default:
+		break;
+	}
+}
+
+void RPTDevice::HandleBroker(const uint8_t *pData, uint32_t nLength) {
+	const auto *pBrokerPDU = reinterpret_cast<const struct TBrokerPDU*>(pData);
+
+	if ((nLength < sizeof(struct TBrokerPDU)) || (GetLength(pBrokerPDU->FlagsLength) > nLength)) {
+		return;
+	}
+
+	switch (__builtin_bswap16(pBrokerPDU->Vector)) {
+	case VECTOR_BROKER_CONNECT_REPLY: {
+		if ((m_tState != RPTDeviceState::CONNECT_SENT) || (nLength < (sizeof(struct TBrokerPDU) + sizeof(struct TConnectReply)))) {
+			break;
+		}
+
+		const auto *pConnectReply = reinterpret_cast<const struct TConnectReply*>(&pData[sizeof(struct TBrokerPDU)]);
+
+		m_nConnectCode = __builtin_bswap16(pConnectReply->ConnectionCode);
+
+		if (m_nConnectCode != E133_CONNECT_OK) {
+			DEBUG_PRINTF("m_nConnectCode=%d", m_nConnectCode);
+			Disconnect(false);
+			break;
+		}
+
+		memcpy(m_aBrokerUid, pConnectReply->BrokerUid, sizeof(m_aBrokerUid));
+
+		m_nReconnectMillis = RPTDeviceConst::RECONNECT_MIN_MILLIS;
+		m_tState = RPTDeviceState::CONNECTED;
+		DEBUG_PUTS("Connected");
+		break;
+	}
+	case VECTOR_BROKER_DISCONNECT:
+		DEBUG_PUTS("VECTOR_BROKER_DISCONNECT");
+		Disconnect(false);
+		break;
+	case VECTOR_BROKER_NULL:
+		// The heartbeat, the receive time is already updated
+		break;
+	default:
+		DEBUG_PRINTF("Vector=%x", __builtin_bswap16(pBrokerPDU->Vector));
+		break;
+	}
+}
+
+void RPTDevice::HandleRpt(const uint8_t *pData, uint32_t nLength) {
+	const auto *pRptPDU = reinterpret_cast<const struct TRptPDU*>(pData);
+
+	if ((m_tState != RPTDeviceState::CONNECTED) || (nLength < sizeof(struct TRptPDU))) {
+		return;
+	}
+
+	const uint32_t nPduLength = GetLength(pRptPDU->FlagsLength);
+
+	if ((nPduLength < sizeof(struct TRptPDU)) || (nPduLength > nLength)) {
+		return;
+	}
+
+	// A Device receives requests only, a Status or Notification is for a Controller
+	if (__builtin_bswap32(pRptPDU->Vector) == VECTOR_RPT_REQUEST) {
+		HandleRequest(pRptPDU, &pData[sizeof(struct TRptPDU)], nPduLength - sizeof(struct TRptPDU));
+	}
+}
+
+void RPTDevice::HandleRequest(const struct TRptPDU *pRptPDU, const uint8_t *pData, uint32_t nLength) {
+	m_nRequests++;
+
+	bool bIsBroadcast;
+
+	if (!IsForThisDevice(pRptPDU->DestinationUid, bIsBroadcast)) {
+		SendStatus(pRptPDU, VECTOR_RPT_STATUS_UNKNOWN_RPT_UID);
+		return;
+	}
+
+	const uint16_t nEndpoint = __builtin_bswap16(pRptPDU->DestinationEndpoint);
+
+	// Only the default responder, there are no physical endpoints
+	if ((nEndpoint != E133_NULL_ENDPOINT) && (nEndpoint != E133_BROADCAST_ENDPOINT)) {
+		if (!bIsBroadcast) {
+			SendStatus(pRptPDU, VECTOR_RPT_STATUS_UNKNOWN_ENDPOINT);
+		}
+		return;
+	}
+
+	const auto *pRequestPDU = reinterpret_cast<const struct TRptRequestPDU*>(pData);
+
+	if (nLength < (sizeof(struct TRptRequestPDU) + RDM_COMMAND_PDU_HEADER_SIZE)) {
+		SendStatus(pRptPDU, VECTOR_RPT_STATUS_INVALID_MESSAGE);
+		return;
+	}
+
+	if (__builtin_bswap32(pRequestPDU->Vector) != VECTOR_REQUEST_RDM_CMD) {
+		SendStatus(pRptPDU, VECTOR_RPT_STATUS_UNKNOWN_VECTOR);
+		return;
+	}
+
+	const auto *pCommandPDU = reinterpret_cast<const struct TRDMCommandPDU*>(&pData[sizeof(struct TRptRequestPDU)]);
+	const uint32_t nCommandPduLength = GetLength(pCommandPDU->FlagsLength);
+	const uint8_t *pRdmDataNoSC = pCommandPDU->RDMData;
+	const uint32_t nRdmLength = nCommandPduLength - RDM_COMMAND_PDU_HEADER_SIZE;
+
+	// RDM Command length without SC: message length includes the SC, plus the checksum
+	if ((nCommandPduLength > (nLength - sizeof(struct TRptRequestPDU)))
+			|| (pCommandPDU->Vector != VECTOR_RDM_CMD_RDM_DATA)
+			|| (nCommandPduLength < (RDM_COMMAND_PDU_HEADER_SIZE + RDM_MESSAGE_MINIMUM_SIZE + 1))
+			|| (nRdmLength != (pRdmDataNoSC[1] + 1U))) {
+		SendStatus(pRptPDU, VECTOR_RPT_STATUS_INVALID_MESSAGE);
+		return;
+	}
+
+	const uint8_t *pResponse = RPTHandleRdmCommand(pRdmDataNoSC);
+
+	if ((pResponse == 0) || (*pResponse != E120_SC_RDM)) {
+		if (!bIsBroadcast) {
+			const auto *pRdmMessage = reinterpret_cast<const struct TRdmMessageNoSc*>(pRdmDataNoSC);
+			const bool bIsRdmBroadcast = (pRdmMessage->destination_uid[2] == 0xFF) && (pRdmMessage->destination_uid[3] == 0xFF)
+					&& (pRdmMessage->destination_uid[4] == 0xFF) && (pRdmMessage->destination_uid[5] == 0xFF);
+			SendStatus(pRptPDU, bIsRdmBroadcast ? VECTOR_RPT_STATUS_BROADCAST_COMPLETE : VECTOR_RPT_STATUS_UNKNOWN_RDM_UID);
+		}
+		return;
+	}
+
+	SendNotification(pRptPDU, pRdmDataNoSC, nRdmLength, pResponse);
+}
+
+/**
+ * This device or an RPT_ALL_DEVICES broadcast, all manufacturers or ours
+ */
+bool RPTDevice::IsForThisDevice(const uint8_t *pUid, bool &bIsBroadcast) {
+	bIsBroadcast = false;
+
+	if (memcmp(pUid, m_aUid, sizeof(m_aUid)) == 0) {
+		return true;
+	}
+
+	if ((pUid[0] != (E133_RPT_ALL_DEVICES_MSB >> 8)) || (pUid[1] != (E133_RPT_ALL_DEVICES_MSB & 0xFF)) || (pUid[4] != 0xFF) || (pUid[5] != 0xFF)) {
+		return false;
+	}
+
+	if (((pUid[2] == 0xFF) && (pUid[3] == 0xFF)) || ((pUid[2] == m_aUid[0]) && (pUid[3] == m_aUid[1]))) {
+		bIsBroadcast = true;
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t RPTDevice::FillRootLayer(uint32_t nVector, uint32_t nDataLength) {
+	auto *pPreAmble = reinterpret_cast<struct TTcpPreAmble*>(m_aTransmitBuffer);
+	auto *pRootLayerPDU = reinterpret_cast<struct TRootLayerPDU*>(&m_aTransmitBuffer[sizeof(struct TTcpPreAmble)]);
+	const uint32_t nRootLayerLength = sizeof(struct TRootLayerPDU) + nDataLength;
+
+	memcpy(pPreAmble->ACNPacketIdentifier, ACN_PACKET_IDENTIFIER, sizeof(ACN_PACKET_IDENTIFIER));
+	pPreAmble->RlpBlockLength = __builtin_bswap32(nRootLayerLength);
+
+	SetFlagsLength(pRootLayerPDU->FlagsLength, nRootLayerLength);
+	pRootLayerPDU->Vector = __builtin_bswap32(nVector);
+	CopyCID(pRootLayerPDU->SenderCid);
+
+	return sizeof(struct TTcpPreAmble) + nRootLayerLength;
+}
+
+uint32_t RPTDevice::FillBroker(uint16_t nVector, uint32_t nDataLength) {
+	auto *pBrokerPDU = &reinterpret_cast<struct TBrokerCommonPacket*>(m_aTransmitBuffer)->BrokerPDU;
+	const uint32_t nBrokerLength = sizeof(struct TBrokerPDU) + nDataLength;
+
+	SetFlagsLength(pBrokerPDU->FlagsLength, nBrokerLength);
+	pBrokerPDU->Vector = __builtin_bswap16(nVector);
+
+	return FillRootLayer(VECTOR_ROOT_BROKER, nBrokerLength);
+}
+
+/**
+ * The Status or Notification answers the request: the sequence number and the endpoint are echoed
+ */
+uint32_t RPTDevice::FillRpt(uint32_t nVector, const struct TRptPDU *pRequestPDU, const uint8_t *pDestinationUid, uint32_t nDataLength) {
+	auto *pRptPDU = &reinterpret_cast<struct TRptCommonPacket*>(m_aTransmitBuffer)->RptPDU;
+	const uint32_t nRptLength = sizeof(struct TRptPDU) + nDataLength;
+
+	SetFlagsLength(pRptPDU->FlagsLength, nRptLength);
+	pRptPDU->Vector = __builtin_bswap32(nVector);
+	memcpy(pRptPDU->SourceUid, m_aUid, sizeof(m_aUid));
+	pRptPDU->SourceEndpoint = __builtin_bswap16(E133_NULL_ENDPOINT);
+	memcpy(pRptPDU->DestinationUid, pDestinationUid, sizeof(pRptPDU->DestinationUid));
+	pRptPDU->DestinationEndpoint = pRequestPDU->SourceEndpoint;
+	pRptPDU->SequenceNumber = pRequestPDU->SequenceNumber;
+	pRptPDU->Reserved = 0;
+
+	return FillRootLayer(VECTOR_ROOT_RPT, nRptLength);
+}
+
+void RPTDevice::SendClientConnect(void) {
+	DEBUG_ENTRY
+
+	auto *pConnect = reinterpret_cast<struct TBrokerClientConnectPacket*>(m_aTransmitBuffer);
+	const uint32_t nLength = FillBroker(VECTOR_BROKER_CONNECT, sizeof(struct TBrokerClientConnectPacket) - sizeof(struct TBrokerCommonPacket));
+
+	memset(&pConnect->ClientConnect, 0, sizeof(struct TClientConnect));
+	memcpy(pConnect->ClientConnect.ClientScope, m_aScope, sizeof(pConnect->ClientConnect.ClientScope));
+	pConnect->ClientConnect.E133Version = __builtin_bswap16(E133_VERSION);
+	memcpy(pConnect->ClientConnect.SearchDomain, E133_DEFAULT_DOMAIN, sizeof(E133_DEFAULT_DOMAIN));
+
+	SetFlagsLength(pConnect->ClientEntryPDU.FlagsLength, sizeof(struct TClientEntryPDU) + sizeof(struct TRptClientEntry));
+	pConnect->ClientEntryPDU.Vector = __builtin_bswap32(CLIENT_PROTOCOL_RPT);
+	CopyCID(pConnect->ClientEntryPDU.ClientCid);
+
+	memcpy(pConnect->RptClientEntry.ClientUid, m_aUid, sizeof(m_aUid));
+	pConnect->RptClientEntry.ClientType = RPT_CLIENT_TYPE_DEVICE;
+	memset(pConnect->RptClientEntry.BindingCid, 0, sizeof(pConnect->RptClientEntry.BindingCid));
+
+	Send(nLength);
+
+	DEBUG_EXIT
+}
+
+void RPTDevice::SendNull(void) {
+	Send(FillBroker(VECTOR_BROKER_NULL, 0));
+}
+
+void RPTDevice::SendStatus(const struct TRptPDU *pRequestPDU, uint16_t nStatus) {
+	DEBUG_PRINTF("nStatus=%d", nStatus);
+
+	auto *pStatus = reinterpret_cast<struct TRptStatusPacket*>(m_aTransmitBuffer);
+
+	SetFlagsLength(pStatus->StatusPDU.FlagsLength, sizeof(struct TRptStatusPDU));
+	pStatus->StatusPDU.Vector = __builtin_bswap16(nStatus);
+
+	const uint32_t nLength = FillRpt(VECTOR_RPT_STATUS, pRequestPDU, pRequestPDU->SourceUid, sizeof(struct TRptStatusPDU));
+
+	m_nStatus++;
+	Send(nLength);
+}
+
+/**
+ * A GET response goes to the requesting Controller, a SET response to all Controllers
+ */
+void RPTDevice::SendNotification(const struct TRptPDU *pRequestPDU, const uint8_t *pCommand, uint32_t nCommandLength, const uint8_t *pResponse) {
+	const uint32_t nResponseLength = pResponse[2] + 1U;	// RDM Command length without SC
+	const uint32_t nNotificationLength = sizeof(struct TRptRequestPDU) + RDM_COMMAND_PDU_HEADER_SIZE + nCommandLength + RDM_COMMAND_PDU_HEADER_SIZE + nResponseLength;
+
+	assert((sizeof(struct TRptCommonPacket) + nNotificationLength) <= sizeof(m_aTransmitBuffer));
+
+	uint8_t *pData = &m_aTransmitBuffer[sizeof(struct TRptCommonPacket)];
+	auto *pNotificationPDU = reinterpret_cast<struct TRptRequestPDU*>(pData);
+
+	SetFlagsLength(pNotificationPDU->FlagsLength, nNotificationLength);
+	pNotificationPDU->Vector = __builtin_bswap32(VECTOR_NOTIFICATION_RDM_CMD);
+	pData += sizeof(struct TRptRequestPDU);
+
+	// The RDM Command PDU's are variable length, RDMData is not used
+	SetFlagsLength(pData, RDM_COMMAND_PDU_HEADER_SIZE + nCommandLength);
+	pData[3] = VECTOR_RDM_CMD_RDM_DATA;
+	memcpy(&pData[RDM_COMMAND_PDU_HEADER_SIZE], pCommand, nCommandLength);
+	pData += RDM_COMMAND_PDU_HEADER_SIZE + nCommandLength;
+
+	SetFlagsLength(pData, RDM_COMMAND_PDU_HEADER_SIZE + nResponseLength);
+	pData[3] = VECTOR_RDM_CMD_RDM_DATA;
+	memcpy(&pData[RDM_COMMAND_PDU_HEADER_SIZE], &pResponse[1], nResponseLength);
+
+	const auto *pRdmCommand = reinterpret_cast<const struct TRdmMessageNoSc*>(pCommand);
+	uint8_t aDestinationUid[6];
+
+	if (pRdmCommand->command_class == E120_SET_COMMAND) {
+		aDestinationUid[0] = E133_RPT_ALL_CONTROLLERS_MSB >> 8;
+		aDestinationUid[1] = E133_RPT_ALL_CONTROLLERS_MSB & 0xFF;
+		memset(&aDestinationUid[2], 0xFF, 4);
+	} else {
+		memcpy(aDestinationUid, pRequestPDU->SourceUid, sizeof(aDestinationUid));
+	}
+
+	const uint32_t nLength = FillRpt(VECTOR_RPT_NOTIFICATION, pRequestPDU, aDestinationUid, nNotificationLength);
+
+	m_nNotifications++;
+	Send(nLength);
+}
+
+/**
+ * A message is written at once when nothing is queued, the rest is queued.
+ * A message is never sent in part: without room in the queue it is dropped.
+ */
+void RPTDevice::Send(uint32_t nLength) {
+	uint32_t nSent = 0;
+
+	if (m_nSendQueueLength == 0) {
+		const int32_t nBytes = Network::Get()->TcpWrite(m_nHandle, m_aTransmitBuffer, static_cast<uint16_t>(nLength));
+
+		if (nBytes < 0) {
+			Disconnect(false);
+			return;
+		}
+
+		nSent = static_cast<uint32_t>(nBytes);
+	}
+
+	const uint32_t nRemaining = nLength - nSent;
+
+	if (nRemaining > (sizeof(m_aSendQueue) - m_nSendQueueLength)) {
+		assert(nSent == 0);
+		m_nDropped++;
+		return;
+	}
+
+	memcpy(&m_aSendQueue[m_nSendQueueLength], &m_aTransmitBuffer[nSent], nRemaining);
+	m_nSendQueueLength += nRemaining;
+
+	m_nSendMillis = Hardware::Get()->Millis();
+}
+
+void RPTDevice::Print(void) {
+	printf("RPT Device configuration\n");
+
+	if (m_nBrokerIp == 0) {
+		printf(" Broker : not configured\n");
+		return;
+	}
+
+	printf(" Broker     : " IPSTR ":%d\n", IP2STR(m_nBrokerIp), static_cast<int>(m_nBrokerPort));
+	printf(" Scope      : %s\n", m_aScope);
+	printf(" Connected  : %s (%d connects, %d heartbeat timeouts, last code %d)\n", IsConnected() ? "Yes" : "No", static_cast<int>(m_nConnects), static_cast<int>(m_nHeartbeatTimeOuts), static_cast<int>(m_nConnectCode));
+	printf(" Requests   : %d received, %d notifications, %d status, %d skipped messages\n", static_cast<int>(m_nRequests), static_cast<int>(m_nNotifications), static_cast<int>(m_nStatus), static_cast<int>(m_nSkipped));
+	printf(" Send queue : %d bytes, %d dropped messages\n", static_cast<int>(m_nSendQueueLength), static_cast<int>(m_nDropped));
+}
+
+void RPTDevice::CopyUID(__attribute__((unused)) uint8_t *pUID) {
+	// Override
+}
+
+void RPTDevice::CopyCID(__attribute__((unused)) uint8_t *pCID) {
+	// Override
+}
+
+uint8_t *RPTDevice::RPTHandleRdmCommand(__attribute__((unused)) const uint8_t *pRdmDataNoSC) {
+	// Override
+	return 0;
+}
@@ -43,13 +43,29 @@ public:
 	~ArtNetRdmResponder(void);
 
 	void Full(uint8_t nPort);
-	uint8_t GetUidCount(uint8_t nPort);
-	void Copy(uint8_t nPort, uint8_t *);
+	uint32_t GetUidCount(uint8_t nPort);
+	void Copy(uint8_t nPort, uint8_t *pTod, uint32_t nIndex, uint32_t nCount);
+
+	void StartDiscovery(uint8_t nPort, bool bIncremental);
+	bool RunDiscovery(uint8_t nPort);
+	bool IsDiscoveryRunning(uint8_t nPort);
+	bool IsDiscoveryWaiting(uint8_t nPort);
+	bool IsTodChanged(uint8_t nPort);
+
+	bool StartPoll(uint8_t nPort);
+	bool RunPoll(uint8_t nPort);
+	bool IsPollRunning(uint8_t nPort);
+	uint32_t GetPollCount(uint8_t nPort);
+	uint32_t CopyPoll(uint8_t nPort, struct TArtNetRdmPollEntry *pEntries, uint32_t nIndex, uint32_t nCount);
 	const uint8_t *Handler(uint8_t nPort, const uint8_t *);
 
+	void SendRequest(uint8_t nPort, const uint8_t *);
+	const uint8_t *ReceiveResponse(uint8_t nPort);
+
 private:
 	struct TRdmMessage *m_pRdmCommand;
 	RDMHandler *m_RDMHandler;
+	const uint8_t *m_pResponse;
 };
 
 #endif /* ARTNETRDMRESPONDER_H_ */
@@ -42,7 +42,8 @@
 ArtNetRdmResponder::ArtNetRdmResponder(RDMPersonality *pRDMPersonality, LightSet *pLightSet) :
 	RDMDeviceResponder(pRDMPersonality, pLightSet),
 	m_pRdmCommand(0),
-	m_RDMHandler(0)
+	m_RDMHandler(0),
+	m_pResponse(0)
 {
 	DEBUG_ENTRY
 
@@ -71,12 +72,54 @@ void ArtNetRdmResponder::Full(__attribute__((unused)) uint8_t nPort) {
 	// We are a Responder - no code needed
 }
 
-uint8_t ArtNetRdmResponder::GetUidCount(__attribute__((unused)) uint8_t nPort) {
+uint32_t ArtNetRdmResponder::GetUidCount(__attribute__((unused)) uint8_t nPort) {
 	return 1; // We are a Responder
 }
 
-void ArtNetRdmResponder::Copy(__attribute__((unused)) uint8_t nPort, unsigned char *tod) {
-	memcpy(tod, RDMDeviceResponder::GetUID(), RDM_UID_SIZE);
+void ArtNetRdmResponder::Copy(__attribute__((unused)) uint8_t nPort, unsigned char *tod, uint32_t nIndex, uint32_t nCount) {
+	if ((nIndex == 0) && (nCount != 0)) {
+		memcpy(tod, RDMDeviceResponder::GetUID(), RDM_UID_SIZE);
+	}
+}
+
+void ArtNetRdmResponder::StartDiscovery(__attribute__((unused)) uint8_t nPort, __attribute__((unused)) bool bIncremental) {
+	// We are a Responder - no code needed
+}
+
+bool ArtNetRdmResponder::RunDiscovery(__attribute__((unused)) uint8_t nPort) {
+	return false;
+}
+
+bool ArtNetRdmResponder::IsDiscoveryRunning(__attribute__((unused)) uint8_t nPort) {
+	return false;
+}
+
+bool ArtNetRdmResponder::IsDiscoveryWaiting(__attribute__((unused)) uint8_t nPort) {
+	return false;
+}
+
+bool ArtNetRdmResponder::IsTodChanged(__attribute__((unused)) uint8_t nPort) {
+	return false;
+}
+
+bool ArtNetRdmResponder::StartPoll(__attribute__((unused)) uint8_t nPort) {
+	return false; // We are a Responder
+}
+
+bool ArtNetRdmResponder::RunPoll(__attribute__((unused)) uint8_t nPort) {
+	return false;
+}
+
+bool ArtNetRdmResponder::IsPollRunning(__attribute__((unused)) uint8_t nPort) {
+	return false;
+}
+
+uint32_t ArtNetRdmResponder::GetPollCount(__attribute__((unused)) uint8_t nPort) {
+	return 0;
+}
+
+uint32_t ArtNetRdmResponder::CopyPoll(__attribute__((unused)) uint8_t nPort, __attribute__((unused)) struct TArtNetRdmPollEntry *pEntries, __attribute__((unused)) uint32_t nIndex, __attribute__((unused)) uint32_t nCount) {
+	return 0;
 }
 
 const uint8_t *ArtNetRdmResponder::Handler(__attribute__((unused)) uint8_t nPort, const uint8_t *pRdmDataNoSC) {
@@ -105,3 +148,14 @@ const uint8_t *ArtNetRdmResponder::Handler(__attribute__((unused)) uint8_t nPort
 	DEBUG_EXIT
 	return reinterpret_cast<const uint8_t*>(m_pRdmCommand);
 }
+
+void ArtNetRdmResponder::SendRequest(uint8_t nPort, const uint8_t *pRdmDataNoSC) {
+	// The responder is local, the response is available immediately
+	m_pResponse = Handler(nPort, pRdmDataNoSC);
+}
+
+const uint8_t *ArtNetRdmResponder::ReceiveResponse(__attribute__((unused)) uint8_t nPort) {
+	const uint8_t *pResponse = m_pResponse;
+	m_pResponse = 0;
+	return pResponse;
+}
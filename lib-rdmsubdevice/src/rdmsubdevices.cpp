@@ -35,7 +35,7 @@
 
 RDMSubDevices *RDMSubDevices::s_pThis = 0;
 
-RDMSubDevices::RDMSubDevices() : m_nCount(0) {
+RDMSubDevices::RDMSubDevices() : m_pRDMSubDevice(0), m_nCount(0) {
 	assert(s_pThis == 0);
 	s_pThis = this;
 
@@ -47,6 +47,7 @@
 #include "spiflashstore.h"
 
 #include "tftpfileserver.h"
+#include "packettrace.h"
 
 enum TRemoteConfig {
 	REMOTE_CONFIG_ARTNET,
@@ -122,6 +123,16 @@ struct TRemoteConfigListBin {
 	char aDisplayName[REMOTE_CONFIG_DISPLAY_NAME_LENGTH];
 }__attribute__((packed));
 
+/**
+ * ?rdm#<port> reply, each packet is followed by nCount struct TArtNetRdmPollEntry
+ */
+struct TRemoteConfigRdmPollBin {
+	uint8_t nPort;
+	uint8_t nCount;
+	uint16_t nIndex;
+	uint16_t nTotal;
+}__attribute__((packed));
+
 class RemoteConfig {
 public:
 	RemoteConfig(TRemoteConfig tRemoteConfig, TRemoteConfigMode tRemoteConfigMode, uint8_t nOutputs = 0);
@@ -155,6 +166,8 @@ public:
 
 	void SetDisplayName(const char *pDisplayName);
 
+	void SetTraceRecords(uint32_t nRecords, uint32_t nPayloadBytes = 0);
+
 	bool IsReboot() {
 		return m_bIsReboot;
 	}
@@ -275,6 +288,10 @@ private:
 	void HandleDisplaySet();
 	void HandleDisplayGet();
 
+#if defined (ARTNET_NODE)
+	void HandleRdmPollGet();
+#endif
+
 	void HandleStoreSet();
 	void HandleStoreGet();
 
@@ -291,6 +308,7 @@ private:
 	bool m_bEnableUptime{false};
 	bool m_bEnableTFTP{false};
 	TFTPFileServer *m_pTFTPFileServer{nullptr};
+	PacketTrace *m_pPacketTrace{nullptr};
 	uint8_t *m_pTFTPBuffer{nullptr};
 	char m_aId[REMOTE_CONFIG_ID_LENGTH];
 	int32_t m_nIdLength{0};
@@ -38,6 +38,9 @@ struct RemoteConfigConst {
 	static const char PARAMS_DISPLAY_NAME[];
 
 	static const char PARAMS_DISABLE_RDMNET_LLRP_ONLY[];
+
+	static const char PARAMS_TRACE_RECORDS[];
+	static const char PARAMS_TRACE_PAYLOAD[];
 };
 
 #endif /* REMOTECONFIGCONST_H_ */
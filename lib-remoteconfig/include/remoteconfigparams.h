@@ -38,6 +38,8 @@ struct TRemoteConfigParams {
 	bool bEnableUptime;
 	char aDisplayName[REMOTE_CONFIG_DISPLAY_NAME_LENGTH];
 	bool bDisableRdmNetLlrpOnly;
+	uint16_t nTraceRecords;
+	uint16_t nTracePayload;
 } __attribute__((packed));
 
 struct RemoteConfigParamsMask {
@@ -47,6 +49,8 @@ struct RemoteConfigParamsMask {
 	static constexpr auto ENABLE_UPTIME = (1U << 3);
 	static constexpr auto DISPLAY_NAME = (1U << 4);
 	static constexpr auto DISABLE_RDMNET_LLRP_ONLY = (1U << 5);
+	static constexpr auto TRACE_RECORDS = (1U << 6);
+	static constexpr auto TRACE_PAYLOAD = (1U << 7);
 };
 
 class RemoteConfigParamsStore {
@@ -57,6 +57,8 @@ private:
 	uint32_t m_nFileSize;
 	bool m_bIsCompressedSupported;
 	bool m_bDone;
+	bool m_bIsTrace{false};
+	bool m_bIsPixelMap{false};
 };
 
 #endif /* TFTPFILESERVER_H_ */
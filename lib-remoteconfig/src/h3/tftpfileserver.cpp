@@ -29,11 +29,16 @@
 #include <cassert>
 
 #include "tftpfileserver.h"
+#include "packettrace.h"
 #include "ubootheader.h"
 #include "remoteconfig.h"
 
 #include "display.h"
 
+#if defined (PIXEL_MULTI)
+# include "pixelmap.h"
+#endif
+
 // Temporarily class. Only needed for the migration to compressed firmware
 #include "compressed.h"
 
@@ -47,6 +52,11 @@
 
 static constexpr auto FILE_NAME_LENGTH = sizeof(FILE_NAME) - 1;
 
+static constexpr char TRACE_FILE_NAME[] = "trace.pcapng";
+#if defined (PIXEL_MULTI)
+ static constexpr char PIXELMAP_FILE_NAME[] = "pixelmap.txt";
+#endif
+
 TFTPFileServer::TFTPFileServer(uint8_t *pBuffer, uint32_t nSize):
 		m_pBuffer(pBuffer),
 		m_nSize(nSize),
@@ -78,11 +88,21 @@ void TFTPFileServer::Exit() {
 }
 
 
-bool TFTPFileServer::FileOpen(__attribute__((unused)) const char* pFileName, __attribute__((unused)) TFTPMode tMode) {
+bool TFTPFileServer::FileOpen(const char* pFileName, TFTPMode tMode) {
 	DEBUG_ENTRY
 
+	assert(pFileName != nullptr);
+
+	if ((tMode == TFTPMode::BINARY) && (strcmp(pFileName, TRACE_FILE_NAME) == 0) && (PacketTrace::Get() != nullptr)) {
+		PacketTrace::Get()->Freeze();
+		m_bIsTrace = true;
+
+		DEBUG_EXIT
+		return true;
+	}
+
 	DEBUG_EXIT
-	return (false);
+	return false;
 }
 
 bool TFTPFileServer::FileCreate(const char* pFileName, TFTPMode tMode) {
@@ -95,6 +115,16 @@ bool TFTPFileServer::FileCreate(const char* pFileName, TFTPMode tMode) {
 		return false;
 	}
 
+#if defined (PIXEL_MULTI)
+	if ((strcmp(pFileName, PIXELMAP_FILE_NAME) == 0) && (PixelMap::Get() != nullptr)) {
+		m_nFileSize = 0;
+		m_bIsPixelMap = true;
+
+		DEBUG_EXIT
+		return true;
+	}
+#endif
+
 	if (strncmp(FILE_NAME, pFileName, FILE_NAME_LENGTH) != 0) {
 		DEBUG_EXIT
 		return false;
@@ -112,6 +142,28 @@ bool TFTPFileServer::FileCreate(const char* pFileName, TFTPMode tMode) {
 bool TFTPFileServer::FileClose() {
 	DEBUG_ENTRY
 
+	if (m_bIsTrace) {
+		PacketTrace::Get()->Resume();
+		m_bIsTrace = false;
+
+		DEBUG_EXIT
+		return true;
+	}
+
+#if defined (PIXEL_MULTI)
+	if (m_bIsPixelMap) {
+		m_bIsPixelMap = false;
+
+		if (m_nFileSize != 0) {
+			PixelMap::Get()->Load(reinterpret_cast<const char *>(m_pBuffer), m_nFileSize);
+			PixelMap::Get()->Dump();
+		}
+
+		DEBUG_EXIT
+		return true;
+	}
+#endif
+
 	m_bDone = true;
 	Display::Get()->TextStatus("TFTP Ended", Display7SegmentMessage::INFO_TFTP_ENDED);
 
@@ -119,15 +171,20 @@ bool TFTPFileServer::FileClose() {
 	return true;
 }
 
-size_t TFTPFileServer::FileRead(__attribute__((unused)) void* pBuffer, __attribute__((unused)) size_t nCount, __attribute__((unused)) unsigned nBlockNumber) {
-	DEBUG_ENTRY
+size_t TFTPFileServer::FileRead(void* pBuffer, size_t nCount, unsigned nBlockNumber) {
+	DEBUG_PRINTF("pBuffer=%p, nCount=%u, nBlockNumber=%u", pBuffer, static_cast<unsigned>(nCount), nBlockNumber);
 
-	DEBUG_EXIT
-	return 0;
+	if (!m_bIsTrace) {
+		return 0;
+	}
+
+	assert(nBlockNumber != 0);
+
+	return PacketTrace::Get()->Read((nBlockNumber - 1) * 512, pBuffer, nCount);
 }
 
 size_t TFTPFileServer::FileWrite(const void *pBuffer, size_t nCount, unsigned nBlockNumber) {
-	DEBUG_PRINTF("pBuffer=%p, nCount=%d, nBlockNumber=%d (%d)", pBuffer, nCount, nBlockNumber, m_nSize / 512);
+	DEBUG_PRINTF("pBuffer=%p, nCount=%u, nBlockNumber=%u (%u)", pBuffer, static_cast<unsigned>(nCount), nBlockNumber, static_cast<unsigned>(m_nSize / 512));
 
 	if (nBlockNumber > (m_nSize / 512)) {
 		m_nFileSize = 0;
@@ -136,6 +193,15 @@ size_t TFTPFileServer::FileWrite(const void *pBuffer, size_t nCount, unsigned nB
 
 	assert(nBlockNumber != 0);
 
+	if (m_bIsPixelMap) {
+		const uint32_t nOffset = (nBlockNumber - 1) * 512;
+
+		memcpy(&m_pBuffer[nOffset], pBuffer, nCount);
+		m_nFileSize = nOffset + static_cast<uint32_t>(nCount);
+
+		return nCount;
+	}
+
 	if (nBlockNumber == 1) {
 		UBootHeader uImage(reinterpret_cast<uint8_t *>(const_cast<void*>(pBuffer)));
 		if (!uImage.IsValid()) {
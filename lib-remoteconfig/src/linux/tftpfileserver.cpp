@@ -27,10 +27,16 @@
  #pragma GCC diagnostic ignored "-Wunused-private-field"
 #endif
 
+#include <string.h>
+#include <cassert>
+
 #include "tftpfileserver.h"
+#include "packettrace.h"
 
 #include "debug.h"
 
+static constexpr char TRACE_FILE_NAME[] = "trace.pcapng";
+
 TFTPFileServer::TFTPFileServer(uint8_t *pBuffer, uint32_t nSize):
 		m_pBuffer(pBuffer),
 		m_nSize(nSize),
@@ -52,8 +58,19 @@ void TFTPFileServer::Exit(void) {
 }
 
 
-bool TFTPFileServer::FileOpen(__attribute__((unused)) const char* pFileName, __attribute__((unused)) TFTPMode tMode) {
+bool TFTPFileServer::FileOpen(const char* pFileName, TFTPMode tMode) {
 	DEBUG_ENTRY
+
+	assert(pFileName != nullptr);
+
+	if ((tMode == TFTPMode::BINARY) && (strcmp(pFileName, TRACE_FILE_NAME) == 0) && (PacketTrace::Get() != nullptr)) {
+		PacketTrace::Get()->Freeze();
+		m_bIsTrace = true;
+
+		DEBUG_EXIT
+		return true;
+	}
+
 	DEBUG_EXIT
 	return false;
 }
@@ -66,14 +83,29 @@ bool TFTPFileServer::FileCreate(__attribute__((unused)) const char* pFileName, _
 
 bool TFTPFileServer::FileClose(void) {
 	DEBUG_ENTRY
+
+	if (m_bIsTrace) {
+		PacketTrace::Get()->Resume();
+		m_bIsTrace = false;
+
+		DEBUG_EXIT
+		return true;
+	}
+
 	DEBUG_EXIT
 	return false;
 }
 
-size_t TFTPFileServer::FileRead(__attribute__((unused)) void* pBuffer, __attribute__((unused)) size_t nCount, __attribute__((unused)) unsigned nBlockNumber) {
-	DEBUG_ENTRY
-	DEBUG_EXIT
-	return 0;
+size_t TFTPFileServer::FileRead(void* pBuffer, size_t nCount, unsigned nBlockNumber) {
+	DEBUG_PRINTF("pBuffer=%p, nCount=%zu, nBlockNumber=%u", pBuffer, nCount, nBlockNumber);
+
+	if (!m_bIsTrace) {
+		return 0;
+	}
+
+	assert(nBlockNumber != 0);
+
+	return PacketTrace::Get()->Read((nBlockNumber - 1) * 512, pBuffer, nCount);
 }
 
 size_t TFTPFileServer::FileWrite(__attribute__((unused)) const void *pBuffer, __attribute__((unused)) size_t nCount, __attribute__((unused)) unsigned nBlockNumber) {
@@ -48,6 +48,8 @@
 #if defined (ARTNET_NODE)
 /* artnet.txt */
 # include "artnetparams.h"
+# include "artnetnode.h"
+# include "artnetrdm.h"
 # include "storeartnet.h"
 # include "artnet4params.h"
 # include "storeartnet4.h"
@@ -173,6 +175,11 @@ static constexpr auto GET_TFTP_LENGTH = sizeof(sGetTFTP) - 1;
 static constexpr char sSetTFTP[] = "!tftp#";
 static constexpr auto SET_TFTP_LENGTH = sizeof(sSetTFTP) - 1;
 
+#if defined (ARTNET_NODE)
+static constexpr char sGetRdmPoll[] = "?rdm#";
+static constexpr auto GET_RDM_POLL_LENGTH = sizeof(sGetRdmPoll) - 1;
+#endif
+
 namespace udp {
 	static constexpr auto PORT = 0x2905;
 	static constexpr auto BUFFER_SIZE = 1024;
@@ -228,6 +235,9 @@ RemoteConfig::~RemoteConfig() {
 	Network::Get()->End(udp::PORT);
 	m_nHandle = -1;
 
+	delete m_pPacketTrace;
+	m_pPacketTrace = nullptr;
+
 	DEBUG_EXIT
 }
 
@@ -258,6 +268,22 @@ void RemoteConfig::SetDisplayName(const char *pDisplayName) {
 	DEBUG_EXIT
 }
 
+/**
+ * The packet trace is off by default, the ring is allocated once.
+ * With nPayloadBytes the first bytes of each packet are captured as well.
+ */
+void RemoteConfig::SetTraceRecords(uint32_t nRecords, uint32_t nPayloadBytes) {
+	DEBUG_ENTRY
+
+	if ((nRecords != 0) && (PacketTrace::Get() == nullptr)) {
+		m_pPacketTrace = new PacketTrace(nRecords, nPayloadBytes);
+		assert(m_pPacketTrace != nullptr);
+	}
+
+	DEBUG_PRINTF("nRecords=%u, nPayloadBytes=%u", nRecords, nPayloadBytes);
+	DEBUG_EXIT
+}
+
 void RemoteConfig::Run() {
 	uint16_t nForeignPort;
 
@@ -302,6 +328,10 @@ void RemoteConfig::Run() {
 			HandleDisplayGet();
 		} else if ((m_nBytesReceived >= GET_TFTP_LENGTH) && (memcmp(m_pUdpBuffer, sGetTFTP, GET_TFTP_LENGTH) == 0)) {
 			HandleTftpGet();
+#if defined (ARTNET_NODE)
+		} else if ((m_nBytesReceived == GET_RDM_POLL_LENGTH + 1) && (memcmp(m_pUdpBuffer, sGetRdmPoll, GET_RDM_POLL_LENGTH) == 0)) {
+			HandleRdmPollGet();
+#endif
 		} else {
 #ifndef NDEBUG
 			Network::Get()->SendTo(m_nHandle, "?#ERROR#\n", 9, m_nIPAddressFrom, udp::PORT);
@@ -418,6 +448,50 @@ void RemoteConfig::HandleDisplayGet() {
 	DEBUG_EXIT
 }
 
+#if defined (ARTNET_NODE)
+/*
+ * The cached RDM sensor and status values of the responders on an output port, as many packets as needed
+ */
+void RemoteConfig::HandleRdmPollGet() {
+	DEBUG_ENTRY
+
+	const uint32_t nPort = static_cast<uint32_t>(m_pUdpBuffer[GET_RDM_POLL_LENGTH] - '1');
+
+	if ((nPort >= artnet::MAX_PORTS) || (ArtNetNode::Get() == nullptr) || (ArtNetNode::Get()->GetRdmHandler() == nullptr)) {
+		DEBUG_EXIT
+		return;
+	}
+
+	auto *pArtNetRdm = ArtNetNode::Get()->GetRdmHandler();
+	auto *pHeader = reinterpret_cast<struct TRemoteConfigRdmPollBin*>(m_pUdpBuffer);
+	auto *pEntries = reinterpret_cast<struct TArtNetRdmPollEntry*>(&m_pUdpBuffer[sizeof(struct TRemoteConfigRdmPollBin)]);
+
+	constexpr uint32_t nEntriesMax = (udp::BUFFER_SIZE - sizeof(struct TRemoteConfigRdmPollBin)) / sizeof(struct TArtNetRdmPollEntry);
+
+	const uint32_t nTotal = pArtNetRdm->GetPollCount(static_cast<uint8_t>(nPort));
+	uint32_t nIndex = 0;
+
+	do {
+		const uint32_t nCount = pArtNetRdm->CopyPoll(static_cast<uint8_t>(nPort), pEntries, nIndex, nEntriesMax);
+
+		pHeader->nPort = static_cast<uint8_t>(nPort + 1);
+		pHeader->nCount = static_cast<uint8_t>(nCount);
+		pHeader->nIndex = static_cast<uint16_t>(nIndex);
+		pHeader->nTotal = static_cast<uint16_t>(nTotal);
+
+		Network::Get()->SendTo(m_nHandle, m_pUdpBuffer, static_cast<uint16_t>(sizeof(struct TRemoteConfigRdmPollBin) + nCount * sizeof(struct TArtNetRdmPollEntry)), m_nIPAddressFrom, udp::PORT);
+
+		if (nCount == 0) {
+			break;
+		}
+
+		nIndex += nCount;
+	} while (nIndex < nTotal);
+
+	DEBUG_EXIT
+}
+#endif
+
 void RemoteConfig::HandleStoreGet() {
 	DEBUG_ENTRY
 
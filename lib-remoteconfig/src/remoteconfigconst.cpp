@@ -37,3 +37,6 @@ const char RemoteConfigConst::PARAMS_DISPLAY_NAME[] = "display_name";
 
 const char RemoteConfigConst::PARAMS_DISABLE_RDMNET_LLRP_ONLY[] = "disable_rdmnet_llrp_only";
 
+const char RemoteConfigConst::PARAMS_TRACE_RECORDS[] = "trace_records";
+const char RemoteConfigConst::PARAMS_TRACE_PAYLOAD[] = "trace_payload";
+
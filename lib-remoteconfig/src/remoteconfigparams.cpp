@@ -40,6 +40,8 @@
 #include "sscan.h"
 #include "propertiesbuilder.h"
 
+#include "packettrace.h"
+
 #include "debug.h"
 
 RemoteConfigParams::RemoteConfigParams(RemoteConfigParamsStore* pTRemoteConfigParamsStore): m_pRemoteConfigParamsStore(pTRemoteConfigParamsStore) {
@@ -120,6 +122,30 @@ void RemoteConfigParams::callbackFunction(const char *pLine) {
 		m_tRemoteConfigParams.nSetList |= RemoteConfigParamsMask::DISPLAY_NAME;
 		return;
 	}
+
+	uint16_t nValue16;
+
+	if (Sscan::Uint16(pLine, RemoteConfigConst::PARAMS_TRACE_RECORDS, nValue16) == Sscan::OK) {
+		if ((nValue16 != 0) && (nValue16 <= PacketTraceConst::RECORDS_MAX)) {
+			m_tRemoteConfigParams.nTraceRecords = nValue16;
+			m_tRemoteConfigParams.nSetList |= RemoteConfigParamsMask::TRACE_RECORDS;
+		} else {
+			m_tRemoteConfigParams.nTraceRecords = 0;
+			m_tRemoteConfigParams.nSetList &= ~RemoteConfigParamsMask::TRACE_RECORDS;
+		}
+		return;
+	}
+
+	if (Sscan::Uint16(pLine, RemoteConfigConst::PARAMS_TRACE_PAYLOAD, nValue16) == Sscan::OK) {
+		if ((nValue16 != 0) && (nValue16 <= PacketTraceConst::PAYLOAD_MAX)) {
+			m_tRemoteConfigParams.nTracePayload = nValue16;
+			m_tRemoteConfigParams.nSetList |= RemoteConfigParamsMask::TRACE_PAYLOAD;
+		} else {
+			m_tRemoteConfigParams.nTracePayload = 0;
+			m_tRemoteConfigParams.nSetList &= ~RemoteConfigParamsMask::TRACE_PAYLOAD;
+		}
+		return;
+	}
 }
 
 void RemoteConfigParams::Builder(const struct TRemoteConfigParams *pRemoteConfigParams, char *pBuffer, uint32_t nLength, uint32_t &nSize) {
@@ -141,6 +167,10 @@ void RemoteConfigParams::Builder(const struct TRemoteConfigParams *pRemoteConfig
 	builder.Add(RemoteConfigConst::PARAMS_ENABLE_UPTIME, m_tRemoteConfigParams.bEnableUptime, isMaskSet(RemoteConfigParamsMask::ENABLE_UPTIME));
 	builder.Add(RemoteConfigConst::PARAMS_DISPLAY_NAME, m_tRemoteConfigParams.aDisplayName, isMaskSet(RemoteConfigParamsMask::DISPLAY_NAME));
 
+	builder.AddComment("Packet trace, exported as trace.pcapng with TFTP");
+	builder.Add(RemoteConfigConst::PARAMS_TRACE_RECORDS, m_tRemoteConfigParams.nTraceRecords, isMaskSet(RemoteConfigParamsMask::TRACE_RECORDS));
+	builder.Add(RemoteConfigConst::PARAMS_TRACE_PAYLOAD, m_tRemoteConfigParams.nTracePayload, isMaskSet(RemoteConfigParamsMask::TRACE_PAYLOAD));
+
 //	builder.AddComment("RDMNet LLRP Only (not used, yet)");
 //	builder.Add(RemoteConfigConst::PARAMS_DISABLE_RDMNET_LLRP_ONLY, m_tRemoteConfigParams.bDisableRdmNetLlrpOnly, isMaskSet(RemoteConfigParamsMask::DISABLE_RDMNET_LLRP_ONY));
 
@@ -186,6 +216,10 @@ void RemoteConfigParams::Set(RemoteConfig* pRemoteConfig) {
 	if (isMaskSet(RemoteConfigParamsMask::DISPLAY_NAME)) {
 		pRemoteConfig->SetDisplayName(m_tRemoteConfigParams.aDisplayName);
 	}
+
+	if (isMaskSet(RemoteConfigParamsMask::TRACE_RECORDS)) {
+		pRemoteConfig->SetTraceRecords(m_tRemoteConfigParams.nTraceRecords, isMaskSet(RemoteConfigParamsMask::TRACE_PAYLOAD) ? m_tRemoteConfigParams.nTracePayload : 0);
+	}
 }
 
 void RemoteConfigParams::staticCallbackFunction(void *p, const char *s) {
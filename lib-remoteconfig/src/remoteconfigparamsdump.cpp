@@ -58,5 +58,13 @@ void RemoteConfigParams::Dump() {
 	if (isMaskSet(RemoteConfigParamsMask::DISPLAY_NAME)) {
 		printf(" %s=%s\n", RemoteConfigConst::PARAMS_DISPLAY_NAME, m_tRemoteConfigParams.aDisplayName);
 	}
+
+	if (isMaskSet(RemoteConfigParamsMask::TRACE_RECORDS)) {
+		printf(" %s=%d\n", RemoteConfigConst::PARAMS_TRACE_RECORDS, static_cast<int>(m_tRemoteConfigParams.nTraceRecords));
+	}
+
+	if (isMaskSet(RemoteConfigParamsMask::TRACE_PAYLOAD)) {
+		printf(" %s=%d\n", RemoteConfigConst::PARAMS_TRACE_PAYLOAD, static_cast<int>(m_tRemoteConfigParams.nTracePayload));
+	}
 #endif
 }
@@ -0,0 +1,123 @@
+/**
+ * @file encoders.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Benchmarks the encoder selected at construction, for every LED type.
+ * The time of the output sink is not included.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "ws28xx.h"
+#include "linux/ws28xxsink.h"
+
+static constexpr uint32_t FRAMES = 2000;
+static constexpr uint32_t LED_COUNT = LEDCOUNT_RGB_MAX;
+
+static uint64_t Nanos() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+static uint8_t s_aData[LED_COUNT * 4];
+
+static void Print(const char *pName, uint64_t nNanos) {
+	printf(" %-12s: %6.2f us/frame, %5.1f ns/LED\n", pName,
+			static_cast<double>(nNanos) / (FRAMES * 1000),
+			static_cast<double>(nNanos) / (FRAMES * LED_COUNT));
+}
+
+static uint32_t Benchmark(TWS28XXType tType) {
+	WS28xx ws28xx(tType, LED_COUNT);
+	ws28xx.Initialize();
+
+	const uint32_t nChannels = (tType == SK6812W) ? 4 : 3;
+	uint32_t nChecksum = 0;
+
+	printf("%s, %u LEDs, %u frames\n", WS28xx::GetLedTypeString(tType), static_cast<unsigned>(LED_COUNT), FRAMES);
+
+	// SetLED, one LED at a time
+	WS28xxSink::ResetCounters();
+	uint64_t nStart = Nanos();
+
+	for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+		for (uint32_t i = 0; i < LED_COUNT; i++) {
+			ws28xx.SetLED(i, static_cast<uint8_t>(i + nFrame), static_cast<uint8_t>(i * 7), static_cast<uint8_t>(nFrame));
+		}
+		ws28xx.Update();
+		nChecksum += WS28xxSink::GetFrame()[nFrame % WS28xxSink::GetFrameLength()];
+	}
+
+	Print("SetLED", Nanos() - nStart - WS28xxSink::GetWriteNanos());
+
+	if (tType == SK6812W) {
+		WS28xxSink::ResetCounters();
+		nStart = Nanos();
+
+		for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+			for (uint32_t i = 0; i < LED_COUNT; i++) {
+				ws28xx.SetLED(i, static_cast<uint8_t>(i + nFrame), static_cast<uint8_t>(i * 7), static_cast<uint8_t>(nFrame), static_cast<uint8_t>(i));
+			}
+			ws28xx.Update();
+			nChecksum += WS28xxSink::GetFrame()[nFrame % WS28xxSink::GetFrameLength()];
+		}
+
+		Print("SetLED RGBW", Nanos() - nStart - WS28xxSink::GetWriteNanos());
+	}
+
+	// SetLEDs, the DMX data of all the LEDs at once
+	WS28xxSink::ResetCounters();
+	nStart = Nanos();
+
+	for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+		s_aData[nFrame % (LED_COUNT * nChannels)] = static_cast<uint8_t>(nFrame);
+		ws28xx.SetLEDs(0, s_aData, LED_COUNT);
+		ws28xx.Update();
+		nChecksum += WS28xxSink::GetFrame()[nFrame % WS28xxSink::GetFrameLength()];
+	}
+
+	Print("SetLEDs", Nanos() - nStart - WS28xxSink::GetWriteNanos());
+
+	return nChecksum;
+}
+
+int main() {
+	uint32_t nChecksum = 0;
+
+	for (uint32_t i = 0; i < LED_COUNT * 4; i++) {
+		s_aData[i] = static_cast<uint8_t>(i * 13);
+	}
+
+	for (uint32_t i = 0; i < WS28XX_UNDEFINED; i++) {
+		nChecksum += Benchmark(static_cast<TWS28XXType>(i));
+	}
+
+	printf("[%u]\n", nChecksum);
+
+	return 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file framepending.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Checks the frame scheduling of WS28xx with the sink busy for the wire time of each frame, as with the DMA:
+ * an Update while a frame is sent is pending (latest frame wins), a Blackout is deferred and replaces the pending frame.
+ * The calls go through a WS28xx pointer, as from WS28xxDmx.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "ws28xx.h"
+#include "linux/ws28xxsink.h"
+
+static uint32_t s_nFailures;
+
+static void Check(bool bCondition, const char *pText) {
+	printf("%s : %s\n", bCondition ? "PASS" : "FAIL", pText);
+
+	if (!bCondition) {
+		s_nFailures++;
+	}
+}
+
+static void WaitIdle(WS28xx *pWS28xx) {
+	while (pWS28xx->IsUpdating()) {
+	}
+}
+
+/*
+ * WS2812B is GRB, the first SPI byte of a LED is the MSB of green
+ */
+static bool IsGreen(WS28xx *pWS28xx) {
+	return WS28xxSink::GetFrame()[0] == pWS28xx->GetHighCode();
+}
+
+int main() {
+	WS28xxSink::Open(WS28xxSinkType::MEMORY);
+	WS28xxSink::SetWireTime(true);
+
+	WS28xx *pWS28xx = new WS28xx(WS2812B, 170);
+	pWS28xx->Initialize();
+
+	Check(WS28xxSink::GetFrames() == 1, "Initialize sends the blackout");
+	Check(pWS28xx->IsUpdating(), "IsUpdating during the wire time");
+
+	pWS28xx->SetLED(0, 0xFF, 0, 0);
+	pWS28xx->Update();
+	pWS28xx->SetLED(0, 0, 0xFF, 0);
+	pWS28xx->Update();
+
+	Check(WS28xxSink::GetFrames() == 1, "Update is pending while a frame is sent");
+	Check(pWS28xx->GetFramesDropped() == 1, "The first pending frame is dropped");
+
+	WaitIdle(pWS28xx);
+
+	Check(WS28xxSink::GetFrames() == 2, "Run sends the pending frame");
+	Check(IsGreen(pWS28xx), "The latest frame wins");
+
+	pWS28xx->Update();
+	pWS28xx->Blackout();
+
+	Check(WS28xxSink::GetFrames() == 3, "Update is sent when idle");
+	Check(IsGreen(pWS28xx), "Blackout does not interrupt the frame");
+
+	WaitIdle(pWS28xx);
+
+	Check(WS28xxSink::GetFrames() == 4, "Run sends the deferred blackout");
+	Check(!IsGreen(pWS28xx), "The blackout is sent");
+
+	pWS28xx->Update();
+	pWS28xx->Update();
+	pWS28xx->Blackout();
+
+	WaitIdle(pWS28xx);
+
+	Check(WS28xxSink::GetFrames() == 6, "Blackout replaces the pending frame");
+	Check(!IsGreen(pWS28xx), "The last output is the blackout");
+
+	WS28xxSink::SetWireTime(false);
+
+	pWS28xx->Update();
+
+	Check(!pWS28xx->IsUpdating() && (WS28xxSink::GetFrames() == 7), "Update is sent at once without the wire time");
+
+	delete pWS28xx;
+
+	WS28xxSink::Close();
+
+	if (s_nFailures != 0) {
+		printf("%u failures\n", s_nFailures);
+		return 1;
+	}
+
+	puts("All tests passed");
+	return 0;
+}
@@ -0,0 +1,261 @@
+/**
+ * @file rtzencode.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Checks that the lookup table RTZ encoder gives the same SPI bytes as the per bit encoder it replaced,
+ * for every colour value and every RGB mapping, and compares the encoding speed of both.
+ * For SK6812W the RGB SetLED must give the same SPI bytes as the RGBW SetLED with W=0.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "ws28xx.h"
+#include "rgbmapping.h"
+#include "linux/ws28xxsink.h"
+
+static constexpr uint32_t FRAMES = 2000;
+
+static uint64_t Nanos() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/*
+ * The encoder before the lookup table: one SPI byte per bit, MSB first
+ */
+static void SetColorReference(uint8_t *pBuffer, uint32_t nOffset, uint8_t nValue, uint8_t nLowCode, uint8_t nHighCode) {
+	for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
+		if (nValue & mask) {
+			pBuffer[nOffset] = nHighCode;
+		} else {
+			pBuffer[nOffset] = nLowCode;
+		}
+		nOffset++;
+	}
+}
+
+static void SetLEDReference(uint8_t *pBuffer, TRGBMapping tRGBMapping, uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nLowCode, uint8_t nHighCode) {
+	const uint32_t nOffset = nLEDIndex * 3 * 8;
+	uint8_t aColour[3];
+
+	switch (tRGBMapping) {
+	case RGB_MAPPING_RBG:
+		aColour[0] = nRed; aColour[1] = nBlue; aColour[2] = nGreen;
+		break;
+	case RGB_MAPPING_GRB:
+		aColour[0] = nGreen; aColour[1] = nRed; aColour[2] = nBlue;
+		break;
+	case RGB_MAPPING_GBR:
+		aColour[0] = nGreen; aColour[1] = nBlue; aColour[2] = nRed;
+		break;
+	case RGB_MAPPING_BRG:
+		aColour[0] = nBlue; aColour[1] = nRed; aColour[2] = nGreen;
+		break;
+	case RGB_MAPPING_BGR:
+		aColour[0] = nBlue; aColour[1] = nGreen; aColour[2] = nRed;
+		break;
+	default:  // RGB
+		aColour[0] = nRed; aColour[1] = nGreen; aColour[2] = nBlue;
+		break;
+	}
+
+	for (uint32_t i = 0; i < 3; i++) {
+		SetColorReference(pBuffer, nOffset + (i * 8), aColour[i], nLowCode, nHighCode);
+	}
+}
+
+/*
+ * Over LEDCOUNT_RGB_MAX LEDs each channel takes every value from 0 to 255
+ */
+static void GetColour(uint32_t nLEDIndex, uint32_t nFrame, uint8_t &nRed, uint8_t &nGreen, uint8_t &nBlue) {
+	nRed = static_cast<uint8_t>(nLEDIndex + nFrame);
+	nGreen = static_cast<uint8_t>((nLEDIndex * 7) + 3 + nFrame);
+	nBlue = static_cast<uint8_t>(255 - nLEDIndex + nFrame);
+}
+
+static bool CheckRGB(TWS28XXType tType, TRGBMapping tRGBMapping) {
+	WS28xx ws28xx(tType, LEDCOUNT_RGB_MAX, tRGBMapping);
+	ws28xx.Initialize();
+
+	const uint32_t nSize = LEDCOUNT_RGB_MAX * 3 * 8;
+	uint8_t *pReference = new uint8_t[nSize];
+
+	for (uint32_t i = 0; i < LEDCOUNT_RGB_MAX; i++) {
+		uint8_t nRed, nGreen, nBlue;
+		GetColour(i, 0, nRed, nGreen, nBlue);
+		ws28xx.SetLED(i, nRed, nGreen, nBlue);
+		SetLEDReference(pReference, tRGBMapping, i, nRed, nGreen, nBlue, ws28xx.GetLowCode(), ws28xx.GetHighCode());
+	}
+
+	ws28xx.Update();
+
+	const bool bIsIdentical = (WS28xxSink::GetFrameLength() == nSize) && (memcmp(WS28xxSink::GetFrame(), pReference, nSize) == 0);
+
+	printf(" %-8s %s : %s\n", WS28xx::GetLedTypeString(tType), RGBMapping::ToString(tRGBMapping), bIsIdentical ? "identical" : "DIFFERENT");
+
+	delete[] pReference;
+	return bIsIdentical;
+}
+
+static bool CheckRGBW() {
+	WS28xx ws28xx(SK6812W, LEDCOUNT_RGBW_MAX);
+	ws28xx.Initialize();
+
+	const uint32_t nSize = LEDCOUNT_RGBW_MAX * 4 * 8;
+	uint8_t *pReference = new uint8_t[nSize];
+
+	for (uint32_t i = 0; i < LEDCOUNT_RGBW_MAX; i++) {
+		uint8_t nRed, nGreen, nBlue;
+		GetColour(i, 0, nRed, nGreen, nBlue);
+		const auto nWhite = static_cast<uint8_t>(i * 3);
+		ws28xx.SetLED(i, nRed, nGreen, nBlue, nWhite);
+
+		const uint32_t nOffset = i * 4 * 8;
+		SetColorReference(pReference, nOffset, nGreen, ws28xx.GetLowCode(), ws28xx.GetHighCode());
+		SetColorReference(pReference, nOffset + 8, nRed, ws28xx.GetLowCode(), ws28xx.GetHighCode());
+		SetColorReference(pReference, nOffset + 16, nBlue, ws28xx.GetLowCode(), ws28xx.GetHighCode());
+		SetColorReference(pReference, nOffset + 24, nWhite, ws28xx.GetLowCode(), ws28xx.GetHighCode());
+	}
+
+	ws28xx.Update();
+
+	const bool bIsIdentical = (WS28xxSink::GetFrameLength() == nSize) && (memcmp(WS28xxSink::GetFrame(), pReference, nSize) == 0);
+
+	printf(" %-8s GRBW : %s\n", WS28xx::GetLedTypeString(SK6812W), bIsIdentical ? "identical" : "DIFFERENT");
+
+	delete[] pReference;
+	return bIsIdentical;
+}
+
+/*
+ * SK6812W: the RGB SetLED is the RGBW SetLED with the white LED off
+ */
+static bool CheckRGBWFromRGB() {
+	WS28xx ws28xx(SK6812W, LEDCOUNT_RGBW_MAX);
+	ws28xx.Initialize();
+
+	const uint32_t nSize = LEDCOUNT_RGBW_MAX * 4 * 8;
+	uint8_t *pReference = new uint8_t[nSize];
+
+	for (uint32_t i = 0; i < LEDCOUNT_RGBW_MAX; i++) {
+		uint8_t nRed, nGreen, nBlue;
+		GetColour(i, 0, nRed, nGreen, nBlue);
+		ws28xx.SetLED(i, nRed, nGreen, nBlue, 0);
+	}
+
+	ws28xx.Update();
+
+	memcpy(pReference, WS28xxSink::GetFrame(), nSize);
+
+	for (uint32_t i = 0; i < LEDCOUNT_RGBW_MAX; i++) {
+		ws28xx.SetLED(i, 0xFF, 0xFF, 0xFF, 0xFF);
+		uint8_t nRed, nGreen, nBlue;
+		GetColour(i, 0, nRed, nGreen, nBlue);
+		ws28xx.SetLED(i, nRed, nGreen, nBlue);
+	}
+
+	ws28xx.Update();
+
+	const bool bIsIdentical = (WS28xxSink::GetFrameLength() == nSize) && (memcmp(WS28xxSink::GetFrame(), pReference, nSize) == 0);
+
+	printf(" %-8s RGB  : %s\n", WS28xx::GetLedTypeString(SK6812W), bIsIdentical ? "identical" : "DIFFERENT");
+
+	delete[] pReference;
+	return bIsIdentical;
+}
+
+static void Benchmark() {
+	WS28xx ws28xx(WS2812B, LEDCOUNT_RGB_MAX);
+	ws28xx.Initialize();
+
+	const TRGBMapping tRGBMapping = ws28xx.GetRgbMapping();
+	const uint8_t nLowCode = ws28xx.GetLowCode();
+	const uint8_t nHighCode = ws28xx.GetHighCode();
+
+	uint8_t *pReference = new uint8_t[LEDCOUNT_RGB_MAX * 3 * 8];
+	uint32_t nChecksum = 0;
+
+	uint64_t nStart = Nanos();
+
+	for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+		for (uint32_t i = 0; i < LEDCOUNT_RGB_MAX; i++) {
+			uint8_t nRed, nGreen, nBlue;
+			GetColour(i, nFrame, nRed, nGreen, nBlue);
+			SetLEDReference(pReference, tRGBMapping, i, nRed, nGreen, nBlue, nLowCode, nHighCode);
+		}
+		nChecksum += pReference[nFrame % (LEDCOUNT_RGB_MAX * 3 * 8)];
+	}
+
+	const uint64_t nReferenceNanos = Nanos() - nStart;
+
+	nStart = Nanos();
+
+	for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+		for (uint32_t i = 0; i < LEDCOUNT_RGB_MAX; i++) {
+			uint8_t nRed, nGreen, nBlue;
+			GetColour(i, nFrame, nRed, nGreen, nBlue);
+			ws28xx.SetLED(i, nRed, nGreen, nBlue);
+		}
+		ws28xx.Update();
+		nChecksum += WS28xxSink::GetFrame()[nFrame % (LEDCOUNT_RGB_MAX * 3 * 8)];
+	}
+
+	const uint64_t nTableNanos = Nanos() - nStart - WS28xxSink::GetWriteNanos();
+
+	printf("Benchmark %s, %u LEDs, %u frames [%u]\n", WS28xx::GetLedTypeString(WS2812B), static_cast<unsigned>(LEDCOUNT_RGB_MAX), FRAMES, nChecksum);
+	printf(" Per bit      : %llu us/frame\n", static_cast<unsigned long long>(nReferenceNanos / FRAMES / 1000));
+	printf(" Lookup table : %llu us/frame\n", static_cast<unsigned long long>(nTableNanos / FRAMES / 1000));
+
+	if (nTableNanos != 0) {
+		printf(" Speed up     : %.1fx\n", static_cast<double>(nReferenceNanos) / static_cast<double>(nTableNanos));
+	}
+
+	delete[] pReference;
+}
+
+int main() {
+	bool bIsIdentical = true;
+
+	printf("Lookup table against per bit encoder\n");
+
+	for (uint32_t i = 0; i < RGB_MAPPING_UNDEFINED; i++) {
+		bIsIdentical &= CheckRGB(WS2812B, static_cast<TRGBMapping>(i));
+	}
+
+	bIsIdentical &= CheckRGB(WS2811, RGB_MAPPING_RGB);
+	bIsIdentical &= CheckRGB(UCS1903, RGB_MAPPING_BRG);
+	bIsIdentical &= CheckRGBW();
+	bIsIdentical &= CheckRGBWFromRGB();
+
+	WS28xxSink::ResetCounters();
+
+	Benchmark();
+
+	return bIsIdentical ? 0 : 1;
+}
@@ -35,16 +35,52 @@
 class WS28xxDMA: public WS28xx {
 public:
 	WS28xxDMA(TWS28XXType Type, uint16_t nLedCount, TRGBMapping tRGBMapping = RGB_MAPPING_UNDEFINED, uint8_t nT0H = 0, uint8_t nT1H = 0, uint32_t nClockSpeed = spi::speed::ws2801::default_hz);
-	~WS28xxDMA();
+	~WS28xxDMA() override;
 
-	bool Initialize ();
+	bool Initialize () override;
 
-	void Update();
-	void Blackout();
+	void Update() override;
+	void Blackout() override;
 
-	bool IsUpdating () { // returns TRUE while DMA operation is active
-		return h3_spi_dma_tx_is_active();
+	/**
+	 * Starts the pending output as soon as the previous DMA transfer has completed
+	 */
+	void Run() override {
+		if ((m_bFramePending || m_bBlackoutPending) && !h3_spi_dma_tx_is_active()) {
+			StartFrame();
+		}
 	}
+
+	bool IsUpdating () override { // returns TRUE while DMA operation is active, or an output is pending
+		Run();
+		return h3_spi_dma_tx_is_active() || m_bFramePending || m_bBlackoutPending;
+	}
+
+private:
+	void FillStale() override;
+	static void Merge(Range &range, const Range &other);
+	void CopyLEDs(const uint8_t *pSource, uint32_t nFirst, uint32_t nLast);
+	void StartFrame();
+
+private:
+	/*
+	 * m_pBuffer is the back buffer, SetLED never writes into a buffer that is used by the DMA.
+	 * Update moves the frame into m_pReadyBuffer, which is sent from m_pFrontBuffer when the DMA is idle.
+	 *
+	 * The buffers are swapped, not copied. Each buffer has a stale range: the LEDs which differ
+	 * from the last frame. Update fills in the stale LEDs of the back buffer, which are not set
+	 * for the new frame, from the last frame (m_pLastFrame). So there is nothing to copy when
+	 * all the LEDs are set for each frame. m_Written must be exact for this, when the LEDs are
+	 * not set in a contiguous run the stale LEDs are filled in first.
+	 */
+	uint8_t *m_pReadyBuffer{nullptr};
+	uint8_t *m_pFrontBuffer{nullptr};
+	uint8_t *m_pLastFrame{nullptr};
+	Range m_BackStale{0, 0};
+	Range m_ReadyStale{0, 0};
+	Range m_FrontStale{0, 0};
+	uint32_t m_nLedOffset{0};		///< SPI bytes before the first LED
+	uint32_t m_nLedStride{0};		///< SPI bytes for each LED
 };
 
 #endif /* WS28XXDMA_H_ */
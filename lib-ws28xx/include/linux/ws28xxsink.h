@@ -0,0 +1,116 @@
+/**
+ * @file ws28xxsink.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LINUX_WS28XXSINK_H_
+#define LINUX_WS28XXSINK_H_
+
+#include <stdint.h>
+
+enum class WS28xxSinkType {
+	MEMORY,	///< The last frame is kept, nothing is written
+	FILE,	///< Each frame is appended to a file
+	SPIDEV	///< Each frame is written to a spidev device, e.g. /dev/spidev0.0
+};
+
+/**
+ * Linux output backend for WS28xx and WS28xxMulti: the encoded frames are written as is.
+ * The counters give the output throughput without a strip attached.
+ */
+class WS28xxSink {
+public:
+	/**
+	 * MEMORY is the default. With nSpeedHz = 0 the spidev speed is the clock speed of the last WS28xx.
+	 */
+	static bool Open(WS28xxSinkType tType, const char *pPath = nullptr, uint32_t nSpeedHz = 0);
+	static void Close();
+
+	/**
+	 * Called by the WS28xx constructor with the clock speed of the LED type
+	 */
+	static void SetSpeedHz(uint32_t nSpeedHz);
+
+	/**
+	 * nSpeedHz = 0 is the speed set with SetSpeedHz
+	 */
+	static void Write(const void *pData, uint32_t nLength, uint32_t nSpeedHz = 0);
+
+	/**
+	 * With bWireTime the sink is busy after each write for the time the frame takes at the SPI speed,
+	 * as with the DMA on the H3. The outputs hold back the frames meanwhile (IsUpdating, Run).
+	 */
+	static void SetWireTime(bool bWireTime) {
+		s_bWireTime = bWireTime;
+		s_nBusyUntilNanos = 0;
+	}
+
+	static bool IsBusy();
+
+	static WS28xxSinkType GetType() {
+		return s_tType;
+	}
+
+	static const uint8_t *GetFrame() {
+		return s_pFrame;
+	}
+
+	static uint32_t GetFrameLength() {
+		return s_nFrameLength;
+	}
+
+	static uint32_t GetFrames() {
+		return s_nFrames;
+	}
+
+	static uint64_t GetBytes() {
+		return s_nBytes;
+	}
+
+	static uint64_t GetWriteNanos() {
+		return s_nWriteNanos;
+	}
+
+	static void ResetCounters() {
+		s_nFrames = 0;
+		s_nBytes = 0;
+		s_nWriteNanos = 0;
+	}
+
+	static void Print();
+
+private:
+	static WS28xxSinkType s_tType;
+	static int s_nFd;
+	static uint32_t s_nSpeedHz;
+	static uint8_t *s_pFrame;
+	static uint32_t s_nFrameSize;
+	static uint32_t s_nFrameLength;
+	static uint32_t s_nFrames;
+	static uint64_t s_nBytes;
+	static uint64_t s_nWriteNanos;
+	static bool s_bWireTime;
+	static uint64_t s_nBusyUntilNanos;
+};
+
+#endif /* LINUX_WS28XXSINK_H_ */
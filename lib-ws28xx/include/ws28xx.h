@@ -71,9 +71,9 @@ static constexpr uint32_t default_hz = 4000000;	///< 4 MHz
 class WS28xx {
 public:
 	WS28xx(TWS28XXType Type, uint16_t nLedCount, TRGBMapping tRGBMapping = RGB_MAPPING_UNDEFINED, uint8_t nT0H = 0, uint8_t nT1H = 0, uint32_t nClockSpeed = spi::speed::ws2801::default_hz);
-	~WS28xx();
+	virtual ~WS28xx();
 
-	bool Initialize ();
+	virtual bool Initialize ();
 
 	TWS28XXType GetLEDType() {
 		return m_tLEDType;
@@ -105,14 +105,53 @@ public:
 		return m_nGlobalBrightness;
 	}
 
-	void SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
+	/*
+	 * The setters record the LEDs set for the next frame, see SetDirty
+	 */
+	void SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+		SetDirty(nLEDIndex, 1);
+		(this->*m_pSetLED)(nLEDIndex, nRed, nGreen, nBlue);
+	}
 	void SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite);
 
-	void Update();
-	void Blackout();
+	/**
+	 * pData holds nLEDs times RGB, or RGBW for SK6812W
+	 */
+	void SetLEDs(uint32_t nLEDIndex, const uint8_t *pData, uint32_t nLEDs) {
+		SetDirty(nLEDIndex, nLEDs);
+		(this->*m_pSetLEDs)(nLEDIndex, pData, nLEDs);
+	}
 
-	bool IsUpdating() {
-		return false;
+	/**
+	 * The colour is encoded once for the first LED, then the encoded bytes are copied to the other LEDs
+	 */
+	void SetLEDGroup(uint32_t nLEDIndex, uint32_t nLEDCount, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
+	void SetLEDGroup(uint32_t nLEDIndex, uint32_t nLEDCount, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite);
+
+	/**
+	 * APA102 HDR: the colour is 8.8 fixed point (0xFF00 is full scale). It is split with
+	 * lookup tables into the per-pixel 5-bit brightness field and the 8-bit PWM values.
+	 * The global brightness is not used.
+	 */
+	void SetLED16(uint32_t nLEDIndex, uint16_t nRed, uint16_t nGreen, uint16_t nBlue);
+	void SetLEDGroup16(uint32_t nLEDIndex, uint32_t nLEDCount, uint16_t nRed, uint16_t nGreen, uint16_t nBlue);
+
+	/**
+	 * Update sends the frame, or marks it as pending while the previous frame is still sent (latest frame wins).
+	 * Blackout is deferred the same way, Run starts the pending output.
+	 * The SPI transfer is blocking, except on Linux when the sink models the wire time (WS28xxSink::SetWireTime).
+	 */
+	virtual void Update();
+	virtual void Blackout();
+	virtual void Run();
+
+	/**
+	 * True while a frame is sent or pending, there is no need to wait for it before Update or Blackout
+	 */
+	virtual bool IsUpdating();
+
+	uint32_t GetFramesDropped() {
+		return m_nFramesDropped;
 	}
 
 	static const char *GetLedTypeString(TWS28XXType tType);
@@ -123,7 +162,64 @@ public:
 	static uint8_t ConvertTxH(float fTxH);
 
 private:
+	void SetupRTZ();
+	void SetupEncoder();
+	static void SetupHDR();
+	template<void (WS28xx::*pSetLED)(uint32_t, uint8_t, uint8_t, uint8_t)>
+	void SelectEncoder();
+	template<void (WS28xx::*pSetLED)(uint32_t, uint8_t, uint8_t, uint8_t)>
+	void SetLEDsRGB(uint32_t nLEDIndex, const uint8_t *pData, uint32_t nLEDs);
+	void SetLEDsRGBW(uint32_t nLEDIndex, const uint8_t *pData, uint32_t nLEDs);
 	void SetColorWS28xx(uint32_t nOffset, uint8_t nValue);
+	template<uint32_t nRedOffset, uint32_t nGreenOffset, uint32_t nBlueOffset>
+	void SetLEDRTZ(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
+	template<TWS28XXType tLEDType>
+	void SetLEDClocked(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
+	void SetLEDRGBW(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
+	void SetLEDSK6812W(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite);
+	void ReplicateLED(uint32_t nLEDIndex, uint32_t nLEDCount);
+	static bool IsBusy();
+
+protected:
+	struct Range {	///< LED indexes [nFirst, nLast), empty when nFirst >= nLast
+		uint32_t nFirst;
+		uint32_t nLast;
+	};
+
+	void SetDirty(uint32_t nLEDIndex, uint32_t nLEDs) {
+		const uint32_t nLast = nLEDIndex + nLEDs;
+
+		if (nLEDIndex < m_Dirty.nFirst) {
+			m_Dirty.nFirst = nLEDIndex;
+		}
+
+		if (nLast > m_Dirty.nLast) {
+			m_Dirty.nLast = nLast;
+		}
+
+		if (m_Written.nFirst >= m_Written.nLast) {
+			m_Written = {nLEDIndex, nLast};
+		} else if ((nLEDIndex <= m_Written.nLast) && (nLast >= m_Written.nFirst)) {
+			m_Written.nFirst = nLEDIndex < m_Written.nFirst ? nLEDIndex : m_Written.nFirst;
+			m_Written.nLast = nLast > m_Written.nLast ? nLast : m_Written.nLast;
+		} else {
+			// Not contiguous, the stale LEDs are filled in before they can be set
+			FillStale();
+			m_Written = {nLEDIndex, nLast};
+		}
+	}
+
+	void ClearDirty() {
+		m_Dirty = {UINT32_MAX, 0};
+		m_Written = {0, 0};
+	}
+
+	/**
+	 * Fills in the LEDs of the back buffer which are not set for the next frame,
+	 * there is nothing to fill in with a single buffer
+	 */
+	virtual void FillStale() {
+	}
 
 protected:
 	TWS28XXType m_tLEDType;
@@ -138,6 +234,20 @@ protected:
 
 	alignas(uintptr_t) uint8_t *m_pBuffer;
 	alignas(uintptr_t) uint8_t *m_pBlackoutBuffer;
+
+	Range m_Dirty{UINT32_MAX, 0};	///< All the LEDs set since the last Update (superset)
+	Range m_Written{0, 0};			///< The contiguous run of LEDs set since the last Update, or FillStale
+	bool m_bFramePending{false};
+	bool m_bBlackoutPending{false};
+	uint32_t m_nFramesDropped{0};
+
+private:
+	void (WS28xx::*m_pSetLED)(uint32_t, uint8_t, uint8_t, uint8_t);	///< Selected once by SetupEncoder
+	void (WS28xx::*m_pSetLEDs)(uint32_t, const uint8_t *, uint32_t);
+	uint64_t m_aRTZTable[256];		///< RTZ: 8 SPI bytes for each colour value, MSB first
+
+	static uint8_t s_aHDRBrightness[256];	///< APA102 HDR: 5-bit brightness for the high byte of the largest colour
+	static uint16_t s_aHDRScale[32];		///< APA102 HDR: PWM = (colour * scale) >> 16, for each brightness
 };
 
 #endif /* WS28XX_H_ */
@@ -0,0 +1,147 @@
+/**
+ * @file ws28xxcolour.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef WS28XXCOLOUR_H_
+#define WS28XXCOLOUR_H_
+
+#include <stdint.h>
+
+struct WS28xxColourChannel {
+	static constexpr uint32_t RED = 0;
+	static constexpr uint32_t GREEN = 1;
+	static constexpr uint32_t BLUE = 2;
+	static constexpr uint32_t WHITE = 3;
+	static constexpr uint32_t MAX = 4;
+};
+
+/**
+ * Colour stage between the DMX data and the pixel encoder.
+ * - gamma correction with a precomputed table per channel (8.8 fixed point)
+ * - optional 16-bit input (coarse/fine channel pairs)
+ * - optional temporal dithering of the remainder below 8 bits
+ */
+class WS28xxColour {
+public:
+	WS28xxColour();
+
+	void SetGamma(float fGamma);
+	void SetGamma(uint32_t nChannel, float fGamma);
+	float GetGamma(uint32_t nChannel) const {
+		return nChannel < WS28xxColourChannel::MAX ? m_aGamma[nChannel] : 1.0f;
+	}
+
+	void Set16Bit(bool b16Bit) {
+		m_b16Bit = b16Bit;
+		UpdateEnabled();
+	}
+	bool Is16Bit() const {
+		return m_b16Bit;
+	}
+
+	void SetDithering(bool bDithering) {
+		m_bDithering = bDithering;
+		UpdateEnabled();
+	}
+	bool IsDithering() const {
+		return m_bDithering;
+	}
+
+	/**
+	 * False when the output is equal to the (8-bit) input
+	 */
+	bool IsEnabled() const {
+		return m_bIsEnabled;
+	}
+
+	/**
+	 * Advances the dithering phase, called once for each output frame
+	 */
+	void NextFrame() {
+		m_nFrame++;
+	}
+
+	/**
+	 * pIn holds nColours values, or nColours coarse/fine pairs in 16-bit mode.
+	 * nPixel offsets the dithering phase, so that neighbouring pixels do not step together.
+	 */
+	void Convert(const uint8_t *pIn, uint8_t *pOut, uint32_t nColours, uint32_t nPixel) const {
+		const uint32_t nRound = m_bDithering ? s_Dither[(m_nFrame + nPixel) & 7] : 0x80;
+
+		if (m_b16Bit) {
+			for (uint32_t i = 0; i < nColours; i++) {
+				const uint16_t *pTable = m_aTable[i];
+				const uint32_t nCoarse = pIn[0];
+				const uint32_t nStep = static_cast<uint32_t>(pTable[nCoarse + 1] - pTable[nCoarse]);
+				const uint32_t nValue = pTable[nCoarse] + ((nStep * pIn[1]) >> 8);
+				pOut[i] = static_cast<uint8_t>((nValue + nRound) >> 8);
+				pIn += 2;
+			}
+			return;
+		}
+
+		for (uint32_t i = 0; i < nColours; i++) {
+			pOut[i] = static_cast<uint8_t>((m_aTable[i][pIn[i]] + nRound) >> 8);
+		}
+	}
+
+	/**
+	 * As Convert, but without the rounding to 8 bits (no dithering).
+	 * pOut is 8.8 fixed point, 0xFF00 is full scale.
+	 */
+	void Convert16(const uint8_t *pIn, uint16_t *pOut, uint32_t nColours) const {
+		if (m_b16Bit) {
+			for (uint32_t i = 0; i < nColours; i++) {
+				const uint16_t *pTable = m_aTable[i];
+				const uint32_t nCoarse = pIn[0];
+				const uint32_t nStep = static_cast<uint32_t>(pTable[nCoarse + 1] - pTable[nCoarse]);
+				pOut[i] = static_cast<uint16_t>(pTable[nCoarse] + ((nStep * pIn[1]) >> 8));
+				pIn += 2;
+			}
+			return;
+		}
+
+		for (uint32_t i = 0; i < nColours; i++) {
+			pOut[i] = m_aTable[i][pIn[i]];
+		}
+	}
+
+	void Print() const;
+
+private:
+	void UpdateTable(uint32_t nChannel);
+	void UpdateEnabled();
+
+private:
+	uint16_t m_aTable[WS28xxColourChannel::MAX][257];	///< 8.8 fixed point, [256] is a copy of [255] for the interpolation
+	float m_aGamma[WS28xxColourChannel::MAX];
+	uint32_t m_nFrame{0};
+	bool m_b16Bit{false};
+	bool m_bDithering{false};
+	bool m_bIsEnabled{false};
+
+	static const uint8_t s_Dither[8];
+};
+
+#endif /* WS28XXCOLOUR_H_ */
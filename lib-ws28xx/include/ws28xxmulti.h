@@ -93,24 +93,85 @@ public:
 	}
 
 #if defined (H3)
+	/**
+	 * 8x: Starts the pending frame or blackout as soon as the previous DMA transfer has completed
+	 */
+	void Run() {
+		if ((m_bFramePending || m_bBlackoutPending) && !h3_spi_dma_tx_is_active()) {
+			StartFrame();
+		}
+	}
+
 	bool IsUpdating() {
 		if (m_tBoard == WS28XXMULTI_BOARD_8X) {
-			return h3_spi_dma_tx_is_active();  // returns TRUE while DMA operation is active
+			Run();
+			return h3_spi_dma_tx_is_active() || m_bFramePending || m_bBlackoutPending;  // returns TRUE while DMA operation is active, or an output is pending
 		} else {
 			return false;
 		}
 	}
 #else
-	bool IsUpdating(void) {
-		return false;
-	}
+	/**
+	 * 8x: As on the H3, with the sink busy for the wire time of the frame (WS28xxSink::SetWireTime)
+	 */
+	void Run();
+	bool IsUpdating();
 #endif
 
+	uint32_t GetFramesDropped() {
+		return m_nFramesDropped;
+	}
+
+	/**
+	 * Bulk interface: the colour data of each port is staged with SetPortData,
+	 * then Encode builds the output buffer for all the ports at once (8x8 bit transpose).
+	 */
+	void SetPortData(uint8_t nPort, uint32_t nLedIndex, const uint8_t *pData, uint32_t nLeds);
+	/**
+	 * pMap[nLedIndex + i] is the LED for pixel i, 0xFFFF when the pixel is not wired
+	 */
+	void SetPortData(uint8_t nPort, uint32_t nLedIndex, const uint8_t *pData, uint32_t nLeds, const uint16_t *pMap);
+	void Encode();
+
+	/**
+	 * Grouped mode: each group of nLedGroupCount LEDs has one colour, staged with SetPortGroupData.
+	 * Encode encodes the first LED of each group only and copies it to the other LEDs of the group.
+	 */
+	void SetLEDGroupCount(uint32_t nLedGroupCount);
+	uint32_t GetLEDGroupCount() {
+		return m_nLedGroupCount;
+	}
+	void SetPortGroupData(uint8_t nPort, uint32_t nGroupIndex, const uint8_t *pData, uint32_t nGroups);
+
+	/**
+	 * Interpolation: Latch takes the staged data as the target of the next blend,
+	 * Interpolate blends the output towards it, then Encode and Update output the blend.
+	 * Interpolate returns false when there is nothing new to output.
+	 * Bit n of nPortMask enables port n, 0 disables the interpolation.
+	 */
+	void SetInterpolation(uint8_t nPortMask);
+	bool IsInterpolation() {
+		return m_nInterpolateMask != 0;
+	}
+	void Latch(uint32_t nMillis);
+	bool Interpolate(uint32_t nMillis);
+
+	bool IsFramePending() {
+		Run();
+		return m_bFramePending;
+	}
+
+	/**
+	 * 8x: Update and Blackout do not wait for the DMA, the output is pending until it is idle (latest wins)
+	 */
 	void Update();
 	void Blackout();
 
 private:
 	uint8_t ReverseBits(uint8_t nBits);
+	void StartFrame();
+	void SetupPortData();
+	void EncodeGroups();
 
 // 4x
 	bool IsMCP23017();
@@ -139,8 +200,31 @@ private:
 	uint32_t *m_pBuffer4x;
 	uint32_t *m_pBlackoutBuffer4x;
 
+	/*
+	 * 8x: Encode writes into the back buffer (m_pBuffer8x), which is never used by the DMA.
+	 * Update marks the frame as pending, it is swapped with m_pFrontBuffer8x when the DMA is idle.
+	 */
 	alignas(uintptr_t) uint8_t *m_pBuffer8x;
+	alignas(uintptr_t) uint8_t *m_pFrontBuffer8x;
 	alignas(uintptr_t) uint8_t *m_pBlackoutBuffer8x;
+	bool m_bFramePending;
+	bool m_bBlackoutPending;
+	uint32_t m_nFramesDropped;
+
+	uint64_t *m_pPortData;			///< Byte n of each word is the colour byte of port n, in LED order
+	uint32_t m_nPortDataSize;		///< Colour bytes per port
+	uint32_t m_aColourOffset[3];	///< Red, Green, Blue offset within a LED, resolved from m_tRGBMapping
+	uint32_t m_nLedGroupCount;
+
+	uint64_t *m_pEncodeData;		///< m_pPortData, or the blended output when interpolating
+	uint64_t *m_pInterpolateFrom;
+	uint64_t *m_pInterpolateTo;
+	uint64_t *m_pInterpolateOut;
+	uint64_t m_nInterpolateMask;	///< 0xFF in byte n when port n is interpolated
+	uint32_t m_nLatchMillis;
+	uint32_t m_nInterpolateIntervalMillis;
+	uint32_t m_nInterpolatePhase;	///< 0..256
+	bool m_bInterpolateOutput;		///< m_pInterpolateOut holds the phase, and is encoded
 };
 
 #endif /* WS28XXMULTI_H_ */
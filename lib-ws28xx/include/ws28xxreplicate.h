@@ -0,0 +1,48 @@
+/**
+ * @file ws28xxreplicate.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef WS28XXREPLICATE_H_
+#define WS28XXREPLICATE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+namespace ws28xx {
+/**
+ * Copies the encoded LED at pFirst to the next (nCount - 1) LEDs.
+ * The copied block doubles each step, so there are log2(nCount) memcpy calls.
+ */
+inline void replicate(uint8_t *pFirst, uint32_t nStride, uint32_t nCount) {
+	uint32_t nDone = 1;
+
+	while (nDone < nCount) {
+		const uint32_t n = (nDone < (nCount - nDone)) ? nDone : (nCount - nDone);
+		memcpy(&pFirst[nDone * nStride], pFirst, n * nStride);
+		nDone += n;
+	}
+}
+}  // namespace ws28xx
+
+#endif /* WS28XXREPLICATE_H_ */
@@ -0,0 +1,60 @@
+/**
+ * @file ws28xxwhite.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef WS28XXWHITE_H_
+#define WS28XXWHITE_H_
+
+#include <stdint.h>
+
+/**
+ * RGB to RGBW: the white LED takes the largest part of the colour that it can reproduce.
+ * The white point is the colour of the white LED, as RGB at full scale.
+ *  W = min(R * 255 / Wr, G * 255 / Wg, B * 255 / Wb)
+ *  R' = R - W * Wr / 255 (same for G and B)
+ */
+class WS28xxWhite {
+public:
+	WS28xxWhite();
+
+	void SetWhitePoint(uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
+	void GetWhitePoint(uint8_t &nRed, uint8_t &nGreen, uint8_t &nBlue) const {
+		nRed = m_aWhitePoint[0];
+		nGreen = m_aWhitePoint[1];
+		nBlue = m_aWhitePoint[2];
+	}
+
+	/**
+	 * pIn holds nPixels RGB triplets, pOut nPixels RGBW quads
+	 */
+	void Convert(const uint8_t *pIn, uint8_t *pOut, uint32_t nPixels) const;
+
+	void Print() const;
+
+private:
+	uint8_t m_aWhitePoint[3];
+	uint16_t m_aScale[3];	///< 8.8 fixed point, 255 / white point
+};
+
+#endif /* WS28XXWHITE_H_ */
@@ -2,7 +2,7 @@
  * @file ws28xxdma.cpp
  *
  */
-/* Copyright (C) 2019 by Arjan van Vught mailto:info@orangepi-dmx.nl
+/* Copyright (C) 2019-2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy
  * of this software and associated documentation files (the "Software"), to deal
@@ -43,6 +43,9 @@ WS28xxDMA::WS28xxDMA(TWS28XXType Type, uint16_t nLEDCount, TRGBMapping tRGBMappi
 }
 
 WS28xxDMA::~WS28xxDMA() {
+	m_pLastFrame = 0;
+	m_pFrontBuffer = 0;
+	m_pReadyBuffer = 0;
 	m_pBlackoutBuffer = 0;
 	m_pBuffer = 0;
 }
@@ -53,28 +56,51 @@ bool WS28xxDMA::Initialize() {
 	m_pBuffer = const_cast<uint8_t*>(h3_spi_dma_tx_prepare(&nSize));
 	assert(m_pBuffer != 0);
 
-	const uint32_t nSizeHalf = nSize / 2;
-	assert(m_nBufSize <= nSizeHalf);
+	// Back, ready, front and blackout buffer
+	const uint32_t nSizeQuarter = (nSize / 4) & static_cast<uint32_t>(~7);
+	assert(m_nBufSize <= nSizeQuarter);
 
-	if (m_nBufSize > nSizeHalf) {
+	if (m_nBufSize > nSizeQuarter) {
 		return false;
 	}
 
-	m_pBlackoutBuffer = m_pBuffer + (nSizeHalf & static_cast<uint32_t>(~3));
+	m_pReadyBuffer = m_pBuffer + nSizeQuarter;
+	m_pFrontBuffer = m_pBuffer + (2 * nSizeQuarter);
+	m_pBlackoutBuffer = m_pBuffer + (3 * nSizeQuarter);
 
-	if (m_tLEDType == APA102) {
+	if (m_bIsRTZProtocol) {
+		m_nLedStride = (m_tLEDType == SK6812W) ? (4 * 8) : (3 * 8);
+	} else if ((m_tLEDType == APA102) || (m_tLEDType == P9813)) {
+		m_nLedOffset = 4;
+		m_nLedStride = 4;
+	} else {
+		m_nLedStride = 3;
+	}
+
+	if ((m_tLEDType == APA102) || (m_tLEDType == P9813)) {
 		memset(m_pBuffer, 0, 4);
+
 		for (uint32_t i = 0; i < m_nLedCount; i++) {
 			SetLED(i, 0, 0, 0);
 		}
-		memset(&m_pBuffer[m_nBufSize - 4], 0xFF, 4);
+
+		if (m_tLEDType == APA102) {
+			memset(&m_pBuffer[m_nBufSize - 4], 0xFF, 4);
+		} else {
+			memset(&m_pBuffer[m_nBufSize - 4], 0, 4);
+		}
 	} else {
-		memset(m_pBuffer, m_tLEDType == WS2801 ? 0 : 0xC0, m_nBufSize);
+		memset(m_pBuffer, m_tLEDType == WS2801 ? 0 : m_nLowCode, m_nBufSize);
 	}
 
+	memcpy(m_pReadyBuffer, m_pBuffer, m_nBufSize);
+	memcpy(m_pFrontBuffer, m_pBuffer, m_nBufSize);
 	memcpy(m_pBlackoutBuffer, m_pBuffer, m_nBufSize);
 
-	DEBUG_PRINTF("nSize=%x, m_pBuffer=%p, m_pBlackoutBuffer=%p", nSize, m_pBuffer, m_pBlackoutBuffer);
+	m_pLastFrame = m_pReadyBuffer;
+	ClearDirty();
+
+	DEBUG_PRINTF("nSize=%x, m_pBuffer=%p, m_pReadyBuffer=%p, m_pFrontBuffer=%p, m_pBlackoutBuffer=%p", nSize, m_pBuffer, m_pReadyBuffer, m_pFrontBuffer, m_pBlackoutBuffer);
 
 	Blackout();
 
@@ -83,14 +109,106 @@ bool WS28xxDMA::Initialize() {
 
 void WS28xxDMA::Update() {
 	assert(m_pBuffer != nullptr);
-	assert(!IsUpdating());
 
-	h3_spi_dma_tx_start(m_pBuffer, m_nBufSize);
+	FillStale();
+
+	// The other buffers miss the LEDs set for this frame
+	Merge(m_ReadyStale, m_Dirty);
+	Merge(m_FrontStale, m_Dirty);
+
+	ClearDirty();
+
+	m_bBlackoutPending = false;
+
+	if (m_bFramePending) {
+		// Latest frame wins
+		m_nFramesDropped++;
+	}
+
+	uint8_t *pBuffer = m_pReadyBuffer;
+	m_pReadyBuffer = m_pBuffer;
+	m_pBuffer = pBuffer;
+
+	m_BackStale = m_ReadyStale;
+	m_ReadyStale = {0, 0};
+
+	m_pLastFrame = m_pReadyBuffer;
+	m_bFramePending = true;
+
+	Run();
+}
+
+void WS28xxDMA::Merge(Range &range, const Range &other) {
+	if (other.nFirst >= other.nLast) {
+		return;
+	}
+
+	if (range.nFirst >= range.nLast) {
+		range = other;
+		return;
+	}
+
+	range.nFirst = other.nFirst < range.nFirst ? other.nFirst : range.nFirst;
+	range.nLast = other.nLast > range.nLast ? other.nLast : range.nLast;
 }
 
+/*
+ * The stale LEDs which are not set for this frame keep their value from the last frame
+ */
+void WS28xxDMA::FillStale() {
+	if (m_Written.nFirst < m_Written.nLast) {
+		CopyLEDs(m_pLastFrame, m_BackStale.nFirst, m_BackStale.nLast < m_Written.nFirst ? m_BackStale.nLast : m_Written.nFirst);
+		CopyLEDs(m_pLastFrame, m_BackStale.nFirst > m_Written.nLast ? m_BackStale.nFirst : m_Written.nLast, m_BackStale.nLast);
+	} else {
+		CopyLEDs(m_pLastFrame, m_BackStale.nFirst, m_BackStale.nLast);
+	}
+
+	m_BackStale = {0, 0};
+}
+
+void WS28xxDMA::CopyLEDs(const uint8_t *pSource, uint32_t nFirst, uint32_t nLast) {
+	if (nFirst >= nLast) {
+		return;
+	}
+
+	assert(nLast <= m_nLedCount);
+
+	const uint32_t nOffset = m_nLedOffset + (nFirst * m_nLedStride);
+	memcpy(&m_pBuffer[nOffset], &pSource[nOffset], (nLast - nFirst) * m_nLedStride);
+}
+
+void WS28xxDMA::StartFrame() {
+	assert(m_bFramePending || m_bBlackoutPending);
+
+	if (m_bBlackoutPending) {
+		m_bBlackoutPending = false;
+		h3_spi_dma_tx_start(m_pBlackoutBuffer, m_nBufSize);
+		return;
+	}
+
+	uint8_t *pBuffer = m_pFrontBuffer;
+	m_pFrontBuffer = m_pReadyBuffer;
+	m_pReadyBuffer = pBuffer;
+
+	const Range stale = m_FrontStale;
+	m_FrontStale = m_ReadyStale;
+	m_ReadyStale = stale;
+
+	m_pLastFrame = m_pFrontBuffer;
+	m_bFramePending = false;
+
+	h3_spi_dma_tx_start(m_pFrontBuffer, m_nBufSize);
+}
+
+/**
+ * The blackout is sent as soon as the DMA is idle, the previous frame is not interrupted
+ */
 void WS28xxDMA::Blackout() {
 	assert(m_pBlackoutBuffer != nullptr);
-	assert(!IsUpdating());
 
-	h3_spi_dma_tx_start(m_pBlackoutBuffer, m_nBufSize);
+	// A pending frame must not overwrite the blackout
+	m_bFramePending = false;
+	m_bBlackoutPending = true;
+
+	Run();
 }
@@ -42,23 +42,52 @@ uint8_t WS28xxMulti::ReverseBits(uint8_t nBits) {
 void WS28xxMulti::Update() {
 	if (m_tBoard == WS28XXMULTI_BOARD_8X) {
 		assert(m_pBuffer8x != nullptr);
-		assert(!h3_spi_dma_tx_is_active());
 
-		h3_spi_dma_tx_start(m_pBuffer8x, m_nBufSize);
+		m_bBlackoutPending = false;
+
+		if (m_bFramePending) {
+			// Latest frame wins
+			m_nFramesDropped++;
+		}
+
+		m_bFramePending = true;
+
+		Run();
 	} else {
 		assert(m_pBuffer4x != 0);
 		Generate800kHz(m_pBuffer4x);
 	}
 }
 
+void WS28xxMulti::StartFrame() {
+	assert(m_bFramePending || m_bBlackoutPending);
+
+	if (m_bBlackoutPending) {
+		m_bBlackoutPending = false;
+		h3_spi_dma_tx_start(m_pBlackoutBuffer8x, m_nBufSize);
+		return;
+	}
+
+	uint8_t *pBuffer = m_pFrontBuffer8x;
+	m_pFrontBuffer8x = m_pBuffer8x;
+	m_pBuffer8x = pBuffer;
+
+	m_bFramePending = false;
+
+	h3_spi_dma_tx_start(m_pFrontBuffer8x, m_nBufSize);
+}
+
 void WS28xxMulti::Blackout() {
 	DEBUG_ENTRY
 
 	if (m_tBoard == WS28XXMULTI_BOARD_8X) {
 		assert(m_pBlackoutBuffer8x != nullptr);
-		assert(!h3_spi_dma_tx_is_active());
 
-		h3_spi_dma_tx_start(m_pBlackoutBuffer8x, m_nBufSize);
+		// A pending frame must not overwrite the blackout, which is sent as soon as the DMA is idle
+		m_bFramePending = false;
+		m_bBlackoutPending = true;
+
+		Run();
 	} else {
 		Generate800kHz(m_pBlackoutBuffer4x);
 	}
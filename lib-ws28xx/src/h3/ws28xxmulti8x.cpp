@@ -46,19 +46,22 @@ void WS28xxMulti::SetupBuffers8x(void) {
 	m_pBuffer8x = const_cast<uint8_t*>(h3_spi_dma_tx_prepare(&nSize));
 	assert(m_pBuffer8x != 0);
 
-	const uint32_t nSizeHalf = nSize / 2;
-	assert(m_nBufSize <= nSizeHalf);
+	// Back, front and blackout buffer
+	const uint32_t nSizeThird = (nSize / 3) & static_cast<uint32_t>(~7);
+	assert(m_nBufSize <= nSizeThird);
 
-	if (m_nBufSize > nSizeHalf) {
+	if (m_nBufSize > nSizeThird) {
 		// FIXME Handle internal error
 		return;
 	}
 
-	m_pBlackoutBuffer8x = m_pBuffer8x + (nSizeHalf & static_cast<uint32_t>(~3));
+	m_pFrontBuffer8x = m_pBuffer8x + nSizeThird;
+	m_pBlackoutBuffer8x = m_pBuffer8x + (2 * nSizeThird);
 
 	memset(m_pBuffer8x, 0, m_nBufSize);
+	memcpy(m_pFrontBuffer8x, m_pBuffer8x, m_nBufSize);
 	memcpy(m_pBlackoutBuffer8x, m_pBuffer8x, m_nBufSize);
 
-	DEBUG_PRINTF("nSize=%x, m_pBuffer=%p, m_pBlackoutBuffer=%p", nSize, m_pBuffer8x, m_pBlackoutBuffer8x);
+	DEBUG_PRINTF("nSize=%x, m_pBuffer=%p, m_pFrontBuffer=%p, m_pBlackoutBuffer=%p", nSize, m_pBuffer8x, m_pFrontBuffer8x, m_pBlackoutBuffer8x);
 	DEBUG_EXIT
 }
@@ -30,11 +30,14 @@
 #include <cassert>
 
 #include "ws28xxmulti.h"
+#include "linux/ws28xxsink.h"
 
 #include "debug.h"
 
 #define PULSE	6
 
+static constexpr uint32_t SPI_SPEED_HZ = 6400000;	///< 8x, as set by SetupSPI
+
 void WS28xxMulti::SetupGPIO(void) {
 	// Nothing todo
 }
@@ -53,34 +56,71 @@ void WS28xxMulti::SetupBuffers4x(void) {
 	}
 }
 
+/*
+ * 8x: there is a single buffer, a pending frame is sent as encoded when it is started
+ */
 void WS28xxMulti::Update(void) {
+	if (m_tBoard == WS28XXMULTI_BOARD_8X) {
+		m_bBlackoutPending = false;
+
+		if (m_bFramePending) {
+			// Latest frame wins
+			m_nFramesDropped++;
+		}
+
+		m_bFramePending = true;
+
+		Run();
+		return;
+	}
+
 	Generate800kHz(m_pBuffer4x);
 }
 
 void WS28xxMulti::Blackout(void) {
+	if (m_tBoard == WS28XXMULTI_BOARD_8X) {
+		// A pending frame must not overwrite the blackout
+		m_bFramePending = false;
+		m_bBlackoutPending = true;
+
+		Run();
+		return;
+	}
+
 	Generate800kHz(m_pBlackoutBuffer4x);
 }
 
-void WS28xxMulti::Generate800kHz(const uint32_t* pBuffer) {
-	for (uint32_t k = 0; k < m_nBufSize; k = k + SINGLE_RGB) {
-		printf("%.2d ", k / SINGLE_RGB);
+void WS28xxMulti::Run(void) {
+	if ((m_bFramePending || m_bBlackoutPending) && !WS28xxSink::IsBusy()) {
+		StartFrame();
+	}
+}
+
+bool WS28xxMulti::IsUpdating(void) {
+	if (m_tBoard == WS28XXMULTI_BOARD_8X) {
+		Run();
+		return WS28xxSink::IsBusy() || m_bFramePending || m_bBlackoutPending;
+	}
 
-		for (uint32_t j = 0; j < 4; j++) {
+	return false;
+}
 
-			for (uint32_t i = 0; i < 24; i++) {
-				bool b = (pBuffer[k + i] & (1U << j)) == 0;
-				printf("%c", '0' + (b ? 0 : 1));
+void WS28xxMulti::StartFrame(void) {
+	assert(m_bFramePending || m_bBlackoutPending);
 
-				if ((i != 0) && ((i + 1) % 8 == 0)) {
-					printf("|");
-				}
-			}
-			printf(" ");
-		}
-		printf("\n");
-	}
+	const uint8_t *pBuffer = m_bBlackoutPending ? m_pBlackoutBuffer8x : m_pBuffer8x;
 
-	printf("\n");
+	m_bFramePending = false;
+	m_bBlackoutPending = false;
+
+	WS28xxSink::Write(pBuffer, m_nBufSize, SPI_SPEED_HZ);
+}
+
+/**
+ * There is no MCP23017 bit banging, the encoded words are written to the sink
+ */
+void WS28xxMulti::Generate800kHz(const uint32_t* pBuffer) {
+	WS28xxSink::Write(pBuffer, m_nBufSize * static_cast<uint32_t>(sizeof(uint32_t)));
 }
 
 uint8_t WS28xxMulti::ReverseBits(uint8_t nBits) {
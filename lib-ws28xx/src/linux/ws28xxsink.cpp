@@ -0,0 +1,180 @@
+/**
+ * @file ws28xxsink.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined (__linux__)
+ #include <sys/ioctl.h>
+ #include <linux/spi/spidev.h>
+#endif
+#include <cassert>
+
+#include "linux/ws28xxsink.h"
+
+#include "debug.h"
+
+WS28xxSinkType WS28xxSink::s_tType = WS28xxSinkType::MEMORY;
+int WS28xxSink::s_nFd = -1;
+uint32_t WS28xxSink::s_nSpeedHz = 0;
+uint8_t *WS28xxSink::s_pFrame = nullptr;
+uint32_t WS28xxSink::s_nFrameSize = 0;
+uint32_t WS28xxSink::s_nFrameLength = 0;
+uint32_t WS28xxSink::s_nFrames = 0;
+uint64_t WS28xxSink::s_nBytes = 0;
+uint64_t WS28xxSink::s_nWriteNanos = 0;
+bool WS28xxSink::s_bWireTime = false;
+uint64_t WS28xxSink::s_nBusyUntilNanos = 0;
+
+static uint64_t Nanos() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+bool WS28xxSink::Open(WS28xxSinkType tType, const char *pPath, uint32_t nSpeedHz) {
+	DEBUG_ENTRY
+
+	Close();
+
+	s_tType = tType;
+
+	if (tType == WS28xxSinkType::MEMORY) {
+		DEBUG_EXIT
+		return true;
+	}
+
+	assert(pPath != nullptr);
+
+	if (tType == WS28xxSinkType::FILE) {
+		s_nFd = open(pPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	} else {
+		s_nFd = open(pPath, O_WRONLY);
+	}
+
+	if (s_nFd < 0) {
+		perror(pPath);
+		s_tType = WS28xxSinkType::MEMORY;
+		DEBUG_EXIT
+		return false;
+	}
+
+	if (nSpeedHz != 0) {
+		s_nSpeedHz = nSpeedHz;
+	}
+
+	SetSpeedHz(s_nSpeedHz);
+
+	DEBUG_PRINTF("%s [%d]", pPath, s_nFd);
+	DEBUG_EXIT
+	return true;
+}
+
+void WS28xxSink::Close() {
+	if (s_nFd >= 0) {
+		close(s_nFd);
+		s_nFd = -1;
+	}
+
+	s_tType = WS28xxSinkType::MEMORY;
+}
+
+void WS28xxSink::SetSpeedHz(uint32_t nSpeedHz) {
+	s_nSpeedHz = nSpeedHz;
+
+#if defined (__linux__)
+	if ((s_tType == WS28xxSinkType::SPIDEV) && (nSpeedHz != 0)) {
+		if (ioctl(s_nFd, SPI_IOC_WR_MAX_SPEED_HZ, &nSpeedHz) < 0) {
+			perror("SPI_IOC_WR_MAX_SPEED_HZ");
+		}
+	}
+#endif
+}
+
+void WS28xxSink::Write(const void *pData, uint32_t nLength, uint32_t nSpeedHz) {
+	assert(pData != nullptr);
+
+	const uint64_t nStart = Nanos();
+
+	if (nSpeedHz == 0) {
+		nSpeedHz = s_nSpeedHz;
+	}
+
+	if (s_bWireTime && (nSpeedHz != 0)) {
+		s_nBusyUntilNanos = nStart + ((static_cast<uint64_t>(nLength) * 8 * 1000000000ULL) / nSpeedHz);
+	}
+
+	if (s_tType == WS28xxSinkType::MEMORY) {
+		if (nLength > s_nFrameSize) {
+			delete[] s_pFrame;
+			s_pFrame = new uint8_t[nLength];
+			assert(s_pFrame != nullptr);
+			s_nFrameSize = nLength;
+		}
+
+		memcpy(s_pFrame, pData, nLength);
+		s_nFrameLength = nLength;
+	} else {
+		const auto *p = static_cast<const uint8_t *>(pData);
+		uint32_t nRemaining = nLength;
+
+		// spidev: a frame must be a single transfer, so spidev.bufsiz must be at least the frame size
+		while (nRemaining != 0) {
+			const ssize_t nWritten = write(s_nFd, p, nRemaining);
+
+			if (nWritten <= 0) {
+				perror("write");
+				break;
+			}
+
+			p += nWritten;
+			nRemaining -= static_cast<uint32_t>(nWritten);
+		}
+	}
+
+	s_nWriteNanos += Nanos() - nStart;
+	s_nBytes += nLength;
+	s_nFrames++;
+}
+
+bool WS28xxSink::IsBusy() {
+	return s_bWireTime && (Nanos() < s_nBusyUntilNanos);
+}
+
+void WS28xxSink::Print() {
+	static constexpr const char *TYPES[] = { "memory", "file", "spidev" };
+
+	printf("WS28xx sink\n");
+	printf(" Type   : %s\n", TYPES[static_cast<uint32_t>(s_tType)]);
+	printf(" Frames : %u\n", s_nFrames);
+	printf(" Bytes  : %llu\n", static_cast<unsigned long long>(s_nBytes));
+
+	if (s_nFrames != 0) {
+		printf(" Write  : %llu ns/frame\n", static_cast<unsigned long long>(s_nWriteNanos / s_nFrames));
+	}
+}
@@ -32,6 +32,9 @@
 #include "rgbmapping.h"
 
 #include "hal_spi.h"
+#if defined (__linux__) && !defined (RASPPI)
+ #include "linux/ws28xxsink.h"
+#endif
 
 #include "debug.h"
 
@@ -49,7 +52,7 @@ WS28xx::WS28xx(TWS28XXType Type, uint16_t nLedCount, TRGBMapping tRGBMapping, ui
 {
 	assert(m_nLedCount != 0);
 
-	if ((m_tLEDType == SK6812W) || (m_tLEDType == APA102)) {
+	if ((m_tLEDType == SK6812W) || (m_tLEDType == APA102) || (m_tLEDType == P9813)) {
 		m_nBufSize = static_cast<uint32_t>(m_nLedCount * 4);
 	} else {
 		m_nBufSize = static_cast<uint32_t>(m_nLedCount * 3);
@@ -97,10 +100,14 @@ WS28xx::WS28xx(TWS28XXType Type, uint16_t nLedCount, TRGBMapping tRGBMapping, ui
 			m_nHighCode = nHighCode;
 		}
 
+		SetupRTZ();
+
 		DEBUG_PRINTF("m_tWS28xxType=%d (%s), m_nLedCount=%d, m_nBufSize=%d", m_tLEDType, WS28xx::GetLedTypeString(m_tLEDType), m_nLedCount, m_nBufSize);
 		DEBUG_PRINTF("m_tRGBMapping=%d (%s), m_nLowCode=0x%X, m_nHighCode=0x%X", static_cast<int>(m_tRGBMapping), RGBMapping::ToString(m_tRGBMapping), static_cast<int>(m_nLowCode), static_cast<int>(m_nHighCode));
 	}
 
+	SetupEncoder();
+
 	FUNC_PREFIX (spi_begin());
 
 	if (m_bIsRTZProtocol) {
@@ -121,7 +128,11 @@ WS28xx::WS28xx(TWS28XXType Type, uint16_t nLedCount, TRGBMapping tRGBMapping, ui
 		}
 	}
 
+#if defined (__linux__) && !defined (RASPPI)
+	WS28xxSink::SetSpeedHz(m_nClockSpeedHz);
+#else
 	FUNC_PREFIX(spi_set_speed_hz(m_nClockSpeedHz));
+#endif
 
 	DEBUG_PRINTF("m_bIsRTZProtocol=%d, m_nClockSpeedHz=%d", static_cast<int>(m_bIsRTZProtocol), m_nClockSpeedHz);
 }
@@ -165,17 +176,69 @@ bool WS28xx::Initialize() {
 
 	memcpy(m_pBlackoutBuffer, m_pBuffer, m_nBufSize);
 
+	ClearDirty();
+
 	Blackout();
 
 	return true;
 }
 
+/*
+ * There is a single buffer, a pending frame is sent with the LEDs as set when it is started
+ */
 void WS28xx::Update() {
 	assert (m_pBuffer != nullptr);
-	FUNC_PREFIX(spi_writenb(reinterpret_cast<char *>(m_pBuffer), m_nBufSize));
+
+	ClearDirty();
+
+	m_bBlackoutPending = false;
+
+	if (m_bFramePending) {
+		// Latest frame wins
+		m_nFramesDropped++;
+	}
+
+	m_bFramePending = true;
+
+	Run();
 }
 
 void WS28xx::Blackout() {
 	assert (m_pBlackoutBuffer != nullptr);
-	FUNC_PREFIX(spi_writenb(reinterpret_cast<char *>(m_pBlackoutBuffer), m_nBufSize));
+
+	// A pending frame must not overwrite the blackout
+	m_bFramePending = false;
+	m_bBlackoutPending = true;
+
+	Run();
+}
+
+void WS28xx::Run() {
+	if (!(m_bFramePending || m_bBlackoutPending) || IsBusy()) {
+		return;
+	}
+
+	const uint8_t *pBuffer = m_bBlackoutPending ? m_pBlackoutBuffer : m_pBuffer;
+
+	m_bFramePending = false;
+	m_bBlackoutPending = false;
+
+#if defined (__linux__) && !defined (RASPPI)
+	WS28xxSink::Write(pBuffer, m_nBufSize);
+#else
+	FUNC_PREFIX(spi_writenb(reinterpret_cast<const char *>(pBuffer), m_nBufSize));
+#endif
+}
+
+bool WS28xx::IsUpdating() {
+	Run();
+	return IsBusy() || m_bFramePending || m_bBlackoutPending;
+}
+
+bool WS28xx::IsBusy() {
+#if defined (__linux__) && !defined (RASPPI)
+	return WS28xxSink::IsBusy();
+#else
+	return false;
+#endif
 }
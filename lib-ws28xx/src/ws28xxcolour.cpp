@@ -0,0 +1,142 @@
+/**
+ * @file ws28xxcolour.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <cassert>
+
+#include "ws28xxcolour.h"
+
+#include "debug.h"
+
+/**
+ * Ordered (bit reversed) thresholds, each 8 frames the remainder is spread evenly
+ */
+const uint8_t WS28xxColour::s_Dither[8] = { 0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0 };
+
+static constexpr float GAMMA_MIN = 0.1f;
+static constexpr float GAMMA_MAX = 5.0f;
+
+/**
+ * The baremetal C library has no powf, and the table is only
+ * computed on a configuration change, so a plain series is good enough.
+ */
+static float Power(float fBase, float fExponent) {
+	if (fBase <= 0.0f) {
+		return 0.0f;
+	}
+
+	// ln(x) = e * ln(2) + 2 * atanh((m - 1) / (m + 1)), with m in [0.5, 1]
+	int32_t nExponent2 = 0;
+
+	while (fBase < 0.5f) {
+		fBase *= 2.0f;
+		nExponent2--;
+	}
+
+	const float z = (fBase - 1.0f) / (fBase + 1.0f);
+	const float z2 = z * z;
+	float fTerm = z;
+	float fSeries = 0.0f;
+
+	for (uint32_t n = 1; n < 16; n += 2) {
+		fSeries += fTerm / static_cast<float>(n);
+		fTerm *= z2;
+	}
+
+	const float y = fExponent * (static_cast<float>(nExponent2) * 0.69314718f + 2.0f * fSeries);
+
+	// exp(y) = exp(y / 256) ^ 256
+	const float t = y / 256.0f;
+	float fResult = 1.0f + t * (1.0f + t * (0.5f + t * (1.0f / 6.0f + t * (1.0f / 24.0f))));
+
+	for (uint32_t i = 0; i < 8; i++) {
+		fResult *= fResult;
+	}
+
+	return fResult;
+}
+
+WS28xxColour::WS28xxColour() {
+	DEBUG_ENTRY
+
+	SetGamma(1.0f);
+
+	DEBUG_EXIT
+}
+
+void WS28xxColour::SetGamma(float fGamma) {
+	for (uint32_t i = 0; i < WS28xxColourChannel::MAX; i++) {
+		SetGamma(i, fGamma);
+	}
+}
+
+void WS28xxColour::SetGamma(uint32_t nChannel, float fGamma) {
+	assert(nChannel < WS28xxColourChannel::MAX);
+
+	if ((fGamma < GAMMA_MIN) || (fGamma > GAMMA_MAX)) {
+		fGamma = 1.0f;
+	}
+
+	m_aGamma[nChannel] = fGamma;
+
+	UpdateTable(nChannel);
+	UpdateEnabled();
+}
+
+void WS28xxColour::UpdateTable(uint32_t nChannel) {
+	uint16_t *pTable = m_aTable[nChannel];
+	const float fGamma = m_aGamma[nChannel];
+
+	for (uint32_t i = 0; i < 256; i++) {
+		if (fGamma == 1.0f) {
+			pTable[i] = static_cast<uint16_t>(i << 8);
+		} else {
+			const float fValue = Power(static_cast<float>(i) / 255.0f, fGamma) * (255.0f * 256.0f);
+			const auto nValue = static_cast<uint32_t>(fValue + 0.5f);
+			pTable[i] = static_cast<uint16_t>(nValue > (255U << 8) ? (255U << 8) : nValue);
+		}
+	}
+
+	pTable[256] = pTable[255];
+}
+
+void WS28xxColour::UpdateEnabled() {
+	m_bIsEnabled = m_b16Bit || m_bDithering;
+
+	for (uint32_t i = 0; i < WS28xxColourChannel::MAX; i++) {
+		m_bIsEnabled |= (m_aGamma[i] != 1.0f);
+	}
+}
+
+void WS28xxColour::Print() const {
+	if (!m_bIsEnabled) {
+		return;
+	}
+
+	printf(" Gamma : R=%.1f G=%.1f B=%.1f W=%.1f\n", m_aGamma[WS28xxColourChannel::RED], m_aGamma[WS28xxColourChannel::GREEN], m_aGamma[WS28xxColourChannel::BLUE], m_aGamma[WS28xxColourChannel::WHITE]);
+	printf(" Input : %d-bit\n", m_b16Bit ? 16 : 8);
+	printf(" Dither: %c\n", m_bDithering ? 'Y' : 'N');
+}
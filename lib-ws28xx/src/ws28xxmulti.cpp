@@ -47,7 +47,23 @@ WS28xxMulti::WS28xxMulti():
 	m_pBuffer4x(0),
 	m_pBlackoutBuffer4x(0),
 	m_pBuffer8x(0),
-	m_pBlackoutBuffer8x(0)
+	m_pFrontBuffer8x(0),
+	m_pBlackoutBuffer8x(0),
+	m_bFramePending(false),
+	m_bBlackoutPending(false),
+	m_nFramesDropped(0),
+	m_pPortData(0),
+	m_nPortDataSize(0),
+	m_nLedGroupCount(1),
+	m_pEncodeData(0),
+	m_pInterpolateFrom(0),
+	m_pInterpolateTo(0),
+	m_pInterpolateOut(0),
+	m_nInterpolateMask(0),
+	m_nLatchMillis(0),
+	m_nInterpolateIntervalMillis(0),
+	m_nInterpolatePhase(0),
+	m_bInterpolateOutput(false)
 {
 	DEBUG_ENTRY
 
@@ -58,6 +74,11 @@ WS28xxMulti::WS28xxMulti():
 }
 
 WS28xxMulti::~WS28xxMulti() {
+	SetInterpolation(0);
+
+	delete[] m_pPortData;
+	m_pPortData = 0;
+
 	if (m_tBoard == WS28XXMULTI_BOARD_4X) {
 		delete[] m_pBlackoutBuffer4x;
 		m_pBlackoutBuffer4x = 0;
@@ -66,6 +87,7 @@ WS28xxMulti::~WS28xxMulti() {
 		m_pBuffer4x = 0;
 	} else {
 		m_pBlackoutBuffer8x = 0;
+		m_pFrontBuffer8x = 0;
 		m_pBuffer8x = 0;
 	}
 }
@@ -112,6 +134,8 @@ void WS28xxMulti::Initialize(TWS28XXType tWS28xxType, uint16_t nLedCount, __attr
 	DEBUG_PRINTF("m_tWS28xxType=%d (%s), m_nLedCount=%d, m_nBufSize=%d", m_tWS28xxType, WS28xx::GetLedTypeString(m_tWS28xxType), m_nLedCount, m_nBufSize);
 	DEBUG_PRINTF("m_tRGBMapping=%d (%s), m_nLowCode=0x%X, m_nHighCode=0x%X", m_tRGBMapping, RGBMapping::ToString(m_tRGBMapping), m_nLowCode, m_nHighCode);
 
+	SetupPortData();
+
 	if (m_tBoard == WS28XXMULTI_BOARD_4X) {
 		SetupMCP23017(ReverseBits(m_nLowCode), ReverseBits(m_nHighCode));
 		if (bUseSI5351A) {
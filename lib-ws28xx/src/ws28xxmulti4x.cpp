@@ -152,14 +152,14 @@ void WS28xxMulti::SetLED4x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint
 				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
 			}
 			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
+				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
 			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
+				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
 			}
 			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
+				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
 			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
+				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
 			}
 			break;
 		case RGB_MAPPING_BRG:
@@ -186,14 +186,14 @@ void WS28xxMulti::SetLED4x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint
 				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
 			}
 			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
+				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
 			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
+				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
 			}
 			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
+				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
 			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
+				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
 			}
 			break;
 		default:
@@ -138,14 +138,14 @@ void WS28xxMulti::SetLED8x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint
 				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
 			}
 			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
+				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
 			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
+				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
 			}
 			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
+				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
 			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
+				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
 			}
 			break;
 		case RGB_MAPPING_BRG:
@@ -172,14 +172,14 @@ void WS28xxMulti::SetLED8x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint
 				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
 			}
 			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
+				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
 			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
+				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
 			}
 			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
+				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
 			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
+				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
 			}
 			break;
 		default:
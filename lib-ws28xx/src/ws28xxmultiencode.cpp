@@ -0,0 +1,294 @@
+/**
+ * @file ws28xxmultiencode.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <cassert>
+
+#include "ws28xxmulti.h"
+#include "ws28xxreplicate.h"
+
+#include "debug.h"
+
+/**
+ * The staging buffer is read as 64-bit words with the byte of port n at bits [8n + 7 : 8n] (little-endian).
+ */
+
+void WS28xxMulti::SetupPortData() {
+	DEBUG_ENTRY
+
+	switch (m_tRGBMapping) {
+	case RGB_MAPPING_RBG:
+		m_aColourOffset[0] = 0; m_aColourOffset[1] = 2; m_aColourOffset[2] = 1;
+		break;
+	case RGB_MAPPING_GRB:
+		m_aColourOffset[0] = 1; m_aColourOffset[1] = 0; m_aColourOffset[2] = 2;
+		break;
+	case RGB_MAPPING_GBR:
+		m_aColourOffset[0] = 2; m_aColourOffset[1] = 0; m_aColourOffset[2] = 1;
+		break;
+	case RGB_MAPPING_BRG:
+		m_aColourOffset[0] = 1; m_aColourOffset[1] = 2; m_aColourOffset[2] = 0;
+		break;
+	case RGB_MAPPING_BGR:
+		m_aColourOffset[0] = 2; m_aColourOffset[1] = 1; m_aColourOffset[2] = 0;
+		break;
+	default:  // RGB
+		m_aColourOffset[0] = 0; m_aColourOffset[1] = 1; m_aColourOffset[2] = 2;
+		break;
+	}
+
+	m_nPortDataSize = static_cast<uint32_t>(m_nLedCount * (m_tWS28xxType == SK6812W ? 4 : 3));
+
+	delete[] m_pPortData;
+	m_pPortData = new uint64_t[m_nPortDataSize];
+	assert(m_pPortData != 0);
+
+	memset(m_pPortData, 0, m_nPortDataSize * sizeof(uint64_t));
+
+	SetInterpolation(0);
+
+	DEBUG_PRINTF("m_nPortDataSize=%d", m_nPortDataSize);
+	DEBUG_EXIT
+}
+
+void WS28xxMulti::SetPortData(uint8_t nPort, uint32_t nLedIndex, const uint8_t *pData, uint32_t nLeds) {
+	assert(nPort < 8);
+	assert(pData != 0);
+	assert(m_pPortData != 0);
+
+	if (nLedIndex >= m_nLedCount) {
+		return;
+	}
+
+	if (nLeds > (m_nLedCount - nLedIndex)) {
+		nLeds = m_nLedCount - nLedIndex;
+	}
+
+	auto *pPortData = reinterpret_cast<uint8_t *>(m_pPortData) + nPort;
+
+	if (m_tWS28xxType == SK6812W) {
+		pPortData += nLedIndex * 4 * 8;
+
+		for (uint32_t i = 0; i < nLeds; i++) {
+			// GRBW
+			pPortData[0] = pData[1];
+			pPortData[8] = pData[0];
+			pPortData[16] = pData[2];
+			pPortData[24] = pData[3];
+			pPortData += 32;
+			pData += 4;
+		}
+
+		return;
+	}
+
+	pPortData += nLedIndex * 3 * 8;
+
+	const uint32_t nRed = m_aColourOffset[0] * 8;
+	const uint32_t nGreen = m_aColourOffset[1] * 8;
+	const uint32_t nBlue = m_aColourOffset[2] * 8;
+
+	for (uint32_t i = 0; i < nLeds; i++) {
+		pPortData[nRed] = pData[0];
+		pPortData[nGreen] = pData[1];
+		pPortData[nBlue] = pData[2];
+		pPortData += 24;
+		pData += 3;
+	}
+}
+
+void WS28xxMulti::SetPortData(uint8_t nPort, uint32_t nLedIndex, const uint8_t *pData, uint32_t nLeds, const uint16_t *pMap) {
+	assert(nPort < 8);
+	assert(pData != 0);
+	assert(pMap != 0);
+	assert(m_pPortData != 0);
+
+	if (nLedIndex >= m_nLedCount) {
+		return;
+	}
+
+	if (nLeds > (m_nLedCount - nLedIndex)) {
+		nLeds = m_nLedCount - nLedIndex;
+	}
+
+	auto *pPortData = reinterpret_cast<uint8_t *>(m_pPortData) + nPort;
+	pMap += nLedIndex;
+
+	if (m_tWS28xxType == SK6812W) {
+		for (uint32_t i = 0; i < nLeds; i++) {
+			const uint32_t nLed = pMap[i];
+
+			if (nLed < m_nLedCount) {
+				// GRBW
+				auto *p = pPortData + (nLed * 32);
+				p[0] = pData[1];
+				p[8] = pData[0];
+				p[16] = pData[2];
+				p[24] = pData[3];
+			}
+
+			pData += 4;
+		}
+
+		return;
+	}
+
+	const uint32_t nRed = m_aColourOffset[0] * 8;
+	const uint32_t nGreen = m_aColourOffset[1] * 8;
+	const uint32_t nBlue = m_aColourOffset[2] * 8;
+
+	for (uint32_t i = 0; i < nLeds; i++) {
+		const uint32_t nLed = pMap[i];
+
+		if (nLed < m_nLedCount) {
+			auto *p = pPortData + (nLed * 24);
+			p[nRed] = pData[0];
+			p[nGreen] = pData[1];
+			p[nBlue] = pData[2];
+		}
+
+		pData += 3;
+	}
+}
+
+void WS28xxMulti::SetLEDGroupCount(uint32_t nLedGroupCount) {
+	DEBUG_PRINTF("nLedGroupCount=%d", static_cast<int>(nLedGroupCount));
+
+	if ((nLedGroupCount == 0) || (nLedGroupCount > m_nLedCount)) {
+		nLedGroupCount = m_nLedCount;
+	}
+
+	m_nLedGroupCount = nLedGroupCount;
+}
+
+void WS28xxMulti::SetPortGroupData(uint8_t nPort, uint32_t nGroupIndex, const uint8_t *pData, uint32_t nGroups) {
+	const uint32_t nChannels = (m_tWS28xxType == SK6812W) ? 4 : 3;
+
+	for (uint32_t i = 0; i < nGroups; i++) {
+		// Only the first LED of the group is staged
+		SetPortData(nPort, (nGroupIndex + i) * m_nLedGroupCount, pData, 1);
+		pData += nChannels;
+	}
+}
+
+/**
+ * 8x8 bit matrix transpose, bit [8r + c] moves to bit [8c + r]
+ * Hacker's Delight, 7-3 Transposing a Bit Matrix
+ */
+static inline uint64_t Transpose8x8(uint64_t x) {
+	uint64_t t;
+
+	t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+	x = x ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+	x = x ^ t ^ (t << 14);
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+	x = x ^ t ^ (t << 28);
+
+	return x;
+}
+
+void WS28xxMulti::Encode() {
+	assert(m_pEncodeData != 0);
+
+	if (m_nLedGroupCount > 1) {
+		EncodeGroups();
+		return;
+	}
+
+	/*
+	 * After the transpose, byte n holds bit n of the colour byte of each port.
+	 * The colour bits are sent MSB first, so the byte order is reversed.
+	 */
+
+	if (m_tBoard == WS28XXMULTI_BOARD_8X) {
+		assert(m_pBuffer8x != 0);
+		assert((reinterpret_cast<uintptr_t>(m_pBuffer8x) & 3) == 0);
+
+		// The DMA buffer is only 4-byte aligned
+		auto *pBuffer = reinterpret_cast<uint32_t *>(m_pBuffer8x);
+
+		for (uint32_t i = 0; i < m_nPortDataSize; i++) {
+			const uint64_t nBits = __builtin_bswap64(Transpose8x8(m_pEncodeData[i]));
+			pBuffer[0] = static_cast<uint32_t>(nBits);
+			pBuffer[1] = static_cast<uint32_t>(nBits >> 32);
+			pBuffer += 2;
+		}
+
+		return;
+	}
+
+	assert(m_pBuffer4x != 0);
+
+	// Only the port bits [3:0] are changed, the other bits are the clock pattern
+	for (uint32_t i = 0; i < m_nPortDataSize; i++) {
+		const uint64_t nBits = Transpose8x8(m_pEncodeData[i]);
+		uint32_t *pBuffer = &m_pBuffer4x[i * 8];
+
+		for (uint32_t j = 0; j < 8; j++) {
+			const auto nPorts = static_cast<uint32_t>(nBits >> (56 - (j * 8))) & 0x0F;
+			pBuffer[j] = (pBuffer[j] & ~0x0FU) | nPorts;
+		}
+	}
+}
+
+void WS28xxMulti::EncodeGroups() {
+	const uint32_t nWords = (m_tWS28xxType == SK6812W) ? 4 : 3;	// Staged words per LED
+
+	for (uint32_t nLed = 0; nLed < m_nLedCount; nLed += m_nLedGroupCount) {
+		const uint32_t nLeds = ((m_nLedCount - nLed) < m_nLedGroupCount) ? (m_nLedCount - nLed) : m_nLedGroupCount;
+		const uint64_t *pPortData = &m_pEncodeData[nLed * nWords];
+
+		if (m_tBoard == WS28XXMULTI_BOARD_8X) {
+			auto *pFirst = &m_pBuffer8x[nLed * nWords * 8];
+			auto *pBuffer = reinterpret_cast<uint32_t *>(pFirst);
+
+			for (uint32_t i = 0; i < nWords; i++) {
+				const uint64_t nBits = __builtin_bswap64(Transpose8x8(pPortData[i]));
+				pBuffer[0] = static_cast<uint32_t>(nBits);
+				pBuffer[1] = static_cast<uint32_t>(nBits >> 32);
+				pBuffer += 2;
+			}
+
+			ws28xx::replicate(pFirst, nWords * 8, nLeds);
+			continue;
+		}
+
+		// 4x: the clock pattern bits are kept, so the port bits are written for each LED of the group
+		for (uint32_t i = 0; i < nWords; i++) {
+			const uint64_t nBits = Transpose8x8(pPortData[i]);
+
+			for (uint32_t k = 0; k < nLeds; k++) {
+				uint32_t *pBuffer = &m_pBuffer4x[((nLed + k) * nWords + i) * 8];
+
+				for (uint32_t j = 0; j < 8; j++) {
+					const auto nPorts = static_cast<uint32_t>(nBits >> (56 - (j * 8))) & 0x0F;
+					pBuffer[j] = (pBuffer[j] & ~0x0FU) | nPorts;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,190 @@
+/**
+ * @file ws28xxmultiinterpolate.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <cassert>
+#if defined (__ARM_NEON)
+ #include <arm_neon.h>
+#endif
+
+#include "ws28xxmulti.h"
+
+#include "debug.h"
+
+/**
+ * The staged data of a received frame is latched as the target. The output is blended from the
+ * displayed frame to the target, reaching the target after the measured interval between the frames.
+ * Byte n of each staged word belongs to port n, so a port is excluded by its byte in the mask.
+ */
+
+namespace interpolate {
+static constexpr uint32_t INTERVAL_MILLIS_DEFAULT = 25;	///< 40 Hz
+static constexpr uint32_t INTERVAL_MILLIS_MIN = 4;
+static constexpr uint32_t INTERVAL_MILLIS_MAX = 100;	///< Longer is a pause, not a frame interval
+static constexpr uint32_t PHASE_END = 256;
+}  // namespace interpolate
+
+/**
+ * pOut = ((256 - nPhase) * pFrom + nPhase * pTo) >> 8, for the bytes in nMask, else pTo.
+ * nPhase is 1..255
+ */
+static void Blend(const uint64_t *pFrom, const uint64_t *pTo, uint64_t *pOut, uint32_t nWords, uint32_t nPhase, uint64_t nMask) {
+	uint32_t i = 0;
+
+#if defined (__ARM_NEON)
+	const uint8x8_t nWeightFrom = vdup_n_u8(static_cast<uint8_t>(256 - nPhase));
+	const uint8x8_t nWeightTo = vdup_n_u8(static_cast<uint8_t>(nPhase));
+	const uint8x16_t nMask128 = vcombine_u8(vcreate_u8(nMask), vcreate_u8(nMask));
+
+	for (; (i + 2) <= nWords; i += 2) {
+		const uint8x16_t nFrom = vld1q_u8(reinterpret_cast<const uint8_t *>(&pFrom[i]));
+		const uint8x16_t nTo = vld1q_u8(reinterpret_cast<const uint8_t *>(&pTo[i]));
+
+		uint16x8_t nLow = vmull_u8(vget_low_u8(nFrom), nWeightFrom);
+		nLow = vmlal_u8(nLow, vget_low_u8(nTo), nWeightTo);
+		uint16x8_t nHigh = vmull_u8(vget_high_u8(nFrom), nWeightFrom);
+		nHigh = vmlal_u8(nHigh, vget_high_u8(nTo), nWeightTo);
+
+		const uint8x16_t nBlend = vcombine_u8(vshrn_n_u16(nLow, 8), vshrn_n_u16(nHigh, 8));
+
+		vst1q_u8(reinterpret_cast<uint8_t *>(&pOut[i]), vbslq_u8(nMask128, nBlend, nTo));
+	}
+#endif
+
+	// SWAR: the even and the odd bytes are blended in 16-bit lanes, a lane is at most 255 * 256
+	const uint64_t nEven = 0x00FF00FF00FF00FFULL;
+	const uint64_t nWeightFrom = 256 - nPhase;
+	const uint64_t nWeightTo = nPhase;
+
+	for (; i < nWords; i++) {
+		const uint64_t nFrom = pFrom[i];
+		const uint64_t nTo = pTo[i];
+
+		const uint64_t nLow = ((((nFrom & nEven) * nWeightFrom) + ((nTo & nEven) * nWeightTo)) >> 8) & nEven;
+		const uint64_t nHigh = ((((nFrom >> 8) & nEven) * nWeightFrom) + (((nTo >> 8) & nEven) * nWeightTo)) & ~nEven;
+
+		pOut[i] = ((nLow | nHigh) & nMask) | (nTo & ~nMask);
+	}
+}
+
+void WS28xxMulti::SetInterpolation(uint8_t nPortMask) {
+	DEBUG_PRINTF("nPortMask=0x%.2x", nPortMask);
+
+	delete[] m_pInterpolateFrom;
+	m_pInterpolateFrom = 0;
+	delete[] m_pInterpolateTo;
+	m_pInterpolateTo = 0;
+	delete[] m_pInterpolateOut;
+	m_pInterpolateOut = 0;
+
+	m_nInterpolateMask = 0;
+	m_pEncodeData = m_pPortData;
+
+	if ((nPortMask == 0) || (m_nPortDataSize == 0)) {
+		return;
+	}
+
+	for (uint32_t nPort = 0; nPort < 8; nPort++) {
+		if ((nPortMask & (1U << nPort)) != 0) {
+			m_nInterpolateMask |= (0xFFULL << (nPort * 8));
+		}
+	}
+
+	m_pInterpolateFrom = new uint64_t[m_nPortDataSize];
+	assert(m_pInterpolateFrom != 0);
+	m_pInterpolateTo = new uint64_t[m_nPortDataSize];
+	assert(m_pInterpolateTo != 0);
+	m_pInterpolateOut = new uint64_t[m_nPortDataSize];
+	assert(m_pInterpolateOut != 0);
+
+	memset(m_pInterpolateFrom, 0, m_nPortDataSize * sizeof(uint64_t));
+	memset(m_pInterpolateTo, 0, m_nPortDataSize * sizeof(uint64_t));
+	memset(m_pInterpolateOut, 0, m_nPortDataSize * sizeof(uint64_t));
+
+	m_pEncodeData = m_pInterpolateOut;
+	m_nInterpolateIntervalMillis = interpolate::INTERVAL_MILLIS_DEFAULT;
+	m_nInterpolatePhase = interpolate::PHASE_END;
+	m_bInterpolateOutput = false;
+}
+
+void WS28xxMulti::Latch(uint32_t nMillis) {
+	assert(m_nInterpolateMask != 0);
+
+	// The frame on the LEDs is the start of the next blend
+	if (m_bInterpolateOutput) {
+		uint64_t *pTmp = m_pInterpolateFrom;
+		m_pInterpolateFrom = m_pInterpolateOut;
+		m_pInterpolateOut = pTmp;
+		m_pEncodeData = m_pInterpolateOut;
+	}
+
+	memcpy(m_pInterpolateTo, m_pPortData, m_nPortDataSize * sizeof(uint64_t));
+
+	const uint32_t nInterval = nMillis - m_nLatchMillis;
+
+	if ((nInterval >= interpolate::INTERVAL_MILLIS_MIN) && (nInterval <= interpolate::INTERVAL_MILLIS_MAX)) {
+		m_nInterpolateIntervalMillis = ((m_nInterpolateIntervalMillis * 3) + nInterval) / 4;
+	}
+
+	m_nLatchMillis = nMillis;
+	m_nInterpolatePhase = 0;
+	m_bInterpolateOutput = false;
+}
+
+bool WS28xxMulti::Interpolate(uint32_t nMillis) {
+	assert(m_nInterpolateMask != 0);
+
+	if (m_bInterpolateOutput && (m_nInterpolatePhase == interpolate::PHASE_END)) {
+		return false;
+	}
+
+	const uint32_t nElapsed = nMillis - m_nLatchMillis;
+	uint32_t nPhase = interpolate::PHASE_END;
+
+	if (nElapsed < m_nInterpolateIntervalMillis) {
+		nPhase = (nElapsed * interpolate::PHASE_END) / m_nInterpolateIntervalMillis;
+
+		// The ports which are not interpolated are at the target right away
+		if (nPhase == 0) {
+			nPhase = 1;
+		}
+	}
+
+	if (m_bInterpolateOutput && (nPhase == m_nInterpolatePhase)) {
+		return false;
+	}
+
+	if (nPhase == interpolate::PHASE_END) {
+		memcpy(m_pInterpolateOut, m_pInterpolateTo, m_nPortDataSize * sizeof(uint64_t));
+	} else {
+		Blend(m_pInterpolateFrom, m_pInterpolateTo, m_pInterpolateOut, m_nPortDataSize, nPhase, m_nInterpolateMask);
+	}
+
+	m_nInterpolatePhase = nPhase;
+	m_bInterpolateOutput = true;
+
+	return true;
+}
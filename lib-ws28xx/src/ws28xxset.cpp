@@ -24,113 +24,278 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include <cassert>
 
 #include "ws28xx.h"
+#include "ws28xxreplicate.h"
 #include "rgbmapping.h"
 
 
-void WS28xx::SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+/*
+ * The encoders are specialised at compile time on the chip family and (RTZ) the colour order,
+ * the constructor selects the instantiation once with SetupEncoder.
+ */
+
+template<uint32_t nRedOffset, uint32_t nGreenOffset, uint32_t nBlueOffset>
+void WS28xx::SetLEDRTZ(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
 	assert(m_pBuffer != 0);
 	assert(nLEDIndex < m_nLedCount);
 
-	if (__builtin_expect((m_bIsRTZProtocol), 1)) {
-		uint32_t nOffset = nLEDIndex * 3;
-		nOffset *= 8;
+	const uint32_t nOffset = nLEDIndex * 3 * 8;
 
-		switch (m_tRGBMapping) {
-		case RGB_MAPPING_RGB:
-			SetColorWS28xx(nOffset, nRed);
-			SetColorWS28xx(nOffset + 8, nGreen);
-			SetColorWS28xx(nOffset + 16, nBlue);
-			break;
-		case RGB_MAPPING_RBG:
-			SetColorWS28xx(nOffset, nRed);
-			SetColorWS28xx(nOffset + 8, nBlue);
-			SetColorWS28xx(nOffset + 16, nGreen);
-			break;
-		case RGB_MAPPING_GRB:
-			SetColorWS28xx(nOffset, nGreen);
-			SetColorWS28xx(nOffset + 8, nRed);
-			SetColorWS28xx(nOffset + 16, nBlue);
-			break;
-		case RGB_MAPPING_GBR:
-			SetColorWS28xx(nOffset, nGreen);
-			SetColorWS28xx(nOffset + 8, nBlue);
-			SetColorWS28xx(nOffset + 16, nRed);
-			break;
-		case RGB_MAPPING_BRG:
-			SetColorWS28xx(nOffset, nBlue);
-			SetColorWS28xx(nOffset + 8, nRed);
-			SetColorWS28xx(nOffset + 16, nGreen);
-			break;
-		case RGB_MAPPING_BGR:
-			SetColorWS28xx(nOffset, nBlue);
-			SetColorWS28xx(nOffset + 8, nGreen);
-			SetColorWS28xx(nOffset + 16, nRed);
-			break;
-		default:  // RGB
-			SetColorWS28xx(nOffset, nRed);
-			SetColorWS28xx(nOffset + 8, nGreen);
-			SetColorWS28xx(nOffset + 16, nBlue);
-			break;
-		}
+	SetColorWS28xx(nOffset + nRedOffset, nRed);
+	SetColorWS28xx(nOffset + nGreenOffset, nGreen);
+	SetColorWS28xx(nOffset + nBlueOffset, nBlue);
+}
 
-		return;
-	}
+template<TWS28XXType tLEDType>
+void WS28xx::SetLEDClocked(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+	assert(m_pBuffer != 0);
+	assert(nLEDIndex < m_nLedCount);
 
-	if (m_tLEDType == APA102) {
-		uint32_t nOffset = 4 + (nLEDIndex * 4);
+	if (tLEDType == APA102) {
+		const uint32_t nOffset = 4 + (nLEDIndex * 4);
 		assert(nOffset + 3 < m_nBufSize);
 
 		m_pBuffer[nOffset] = m_nGlobalBrightness;
 		m_pBuffer[nOffset + 1] = nRed;
 		m_pBuffer[nOffset + 2] = nGreen;
 		m_pBuffer[nOffset + 3] = nBlue;
+	} else if (tLEDType == P9813) {
+		const uint32_t nOffset = 4 + (nLEDIndex * 4);
+		assert(nOffset + 3 < m_nBufSize);
 
-		return;
-	}
+		const uint8_t nFlag = 0xC0 | ((~nBlue & 0xC0) >> 2) | ((~nGreen & 0xC0) >> 4) | ((~nRed & 0xC0) >> 6);
 
-	if (m_tLEDType == WS2801) {
-		uint32_t nOffset = nLEDIndex * 3;
+		m_pBuffer[nOffset] = nFlag;
+		m_pBuffer[nOffset + 1] = nBlue;
+		m_pBuffer[nOffset + 2] = nGreen;
+		m_pBuffer[nOffset + 3] = nRed;
+	} else {
+		// WS2801
+		const uint32_t nOffset = nLEDIndex * 3;
 		assert(nOffset + 2 < m_nBufSize);
 
 		m_pBuffer[nOffset] = nRed;
 		m_pBuffer[nOffset + 1] = nGreen;
 		m_pBuffer[nOffset + 2] = nBlue;
+	}
+}
+
+void WS28xx::SetLEDRGBW(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+	// SK6812W: the RGB colour with the white LED off
+	SetLEDSK6812W(nLEDIndex, nRed, nGreen, nBlue, 0);
+}
+
+template<void (WS28xx::*pSetLED)(uint32_t, uint8_t, uint8_t, uint8_t)>
+void WS28xx::SetLEDsRGB(uint32_t nLEDIndex, const uint8_t *pData, uint32_t nLEDs) {
+	assert(nLEDIndex + nLEDs <= m_nLedCount);
+
+	// pSetLED is a compile-time constant, so it is inlined
+	for (uint32_t i = 0; i < nLEDs; i++) {
+		(this->*pSetLED)(nLEDIndex + i, pData[0], pData[1], pData[2]);
+		pData += 3;
+	}
+}
+
+void WS28xx::SetLEDsRGBW(uint32_t nLEDIndex, const uint8_t *pData, uint32_t nLEDs) {
+	assert(nLEDIndex + nLEDs <= m_nLedCount);
+
+	for (uint32_t i = 0; i < nLEDs; i++) {
+		SetLEDSK6812W(nLEDIndex + i, pData[0], pData[1], pData[2], pData[3]);
+		pData += 4;
+	}
+}
+
+template<void (WS28xx::*pSetLED)(uint32_t, uint8_t, uint8_t, uint8_t)>
+void WS28xx::SelectEncoder() {
+	m_pSetLED = pSetLED;
+	m_pSetLEDs = &WS28xx::SetLEDsRGB<pSetLED>;
+}
 
+uint8_t WS28xx::s_aHDRBrightness[256];
+uint16_t WS28xx::s_aHDRScale[32];
+
+void WS28xx::SetupHDR() {
+	if (s_aHDRScale[31] != 0) {
 		return;
 	}
 
-	if (m_tLEDType == P9813) {
-		uint32_t nOffset = 4 + (nLEDIndex * 4);
-		assert(nOffset + 3 < m_nBufSize);
+	// The output is (brightness / 31) * (PWM / 255), full scale is 0xFF00
+	for (uint32_t i = 0; i < 256; i++) {
+		const uint32_t nMax = (i << 8) | 0xFF;
+		uint32_t nBrightness = ((nMax * 31) + 0xFEFF) / 0xFF00;
 
-		const uint8_t nFlag = 0xC0 | ((~nBlue & 0xC0) >> 2) | ((~nGreen & 0xC0) >> 4) | ((~nRed & 0xC0) >> 6);
+		if (nBrightness == 0) {
+			nBrightness = 1;
+		} else if (nBrightness > 31) {
+			nBrightness = 31;
+		}
 
-		m_pBuffer[nOffset] = nFlag;
-		m_pBuffer[nOffset + 1] = nBlue;
-		m_pBuffer[nOffset + 2] = nGreen;
-		m_pBuffer[nOffset + 3] = nRed;
+		s_aHDRBrightness[i] = static_cast<uint8_t>(nBrightness);
+	}
+
+	s_aHDRScale[0] = 0;
+
+	for (uint32_t i = 1; i < 32; i++) {
+		s_aHDRScale[i] = static_cast<uint16_t>(((31 * 256 * 2) + i) / (2 * i));
+	}
+}
+
+void WS28xx::SetLED16(uint32_t nLEDIndex, uint16_t nRed, uint16_t nGreen, uint16_t nBlue) {
+	assert(m_pBuffer != 0);
+	assert(nLEDIndex < m_nLedCount);
+	assert(m_tLEDType == APA102);
+
+	SetDirty(nLEDIndex, 1);
+
+	uint32_t nMax = nRed > nGreen ? nRed : nGreen;
+	nMax = nMax > nBlue ? nMax : nBlue;
+
+	const uint32_t nBrightness = s_aHDRBrightness[nMax >> 8];
+	const uint32_t nScale = s_aHDRScale[nBrightness];
+
+	const uint32_t nOffset = 4 + (nLEDIndex * 4);
+	assert(nOffset + 3 < m_nBufSize);
+
+	const uint32_t nPwmRed = (nRed * nScale) >> 16;
+	const uint32_t nPwmGreen = (nGreen * nScale) >> 16;
+	const uint32_t nPwmBlue = (nBlue * nScale) >> 16;
+
+	m_pBuffer[nOffset] = static_cast<uint8_t>(0xE0 | nBrightness);
+	m_pBuffer[nOffset + 1] = static_cast<uint8_t>(nPwmRed > 0xFF ? 0xFF : nPwmRed);
+	m_pBuffer[nOffset + 2] = static_cast<uint8_t>(nPwmGreen > 0xFF ? 0xFF : nPwmGreen);
+	m_pBuffer[nOffset + 3] = static_cast<uint8_t>(nPwmBlue > 0xFF ? 0xFF : nPwmBlue);
+}
+
+void WS28xx::SetLEDGroup16(uint32_t nLEDIndex, uint32_t nLEDCount, uint16_t nRed, uint16_t nGreen, uint16_t nBlue) {
+	assert(nLEDCount != 0);
+	assert(nLEDIndex + nLEDCount <= m_nLedCount);
+
+	SetDirty(nLEDIndex, nLEDCount);
+	SetLED16(nLEDIndex, nRed, nGreen, nBlue);
+	ReplicateLED(nLEDIndex, nLEDCount);
+}
+
+void WS28xx::SetupEncoder() {
+	if (m_tLEDType == SK6812W) {
+		m_pSetLED = &WS28xx::SetLEDRGBW;
+		m_pSetLEDs = &WS28xx::SetLEDsRGBW;
+		return;
+	}
+
+	if (m_bIsRTZProtocol) {
+		// The offset (in SPI bytes) of the Red, Green and Blue within a LED
+		switch (m_tRGBMapping) {
+		case RGB_MAPPING_RBG:
+			SelectEncoder<&WS28xx::SetLEDRTZ<0, 16, 8>>();
+			break;
+		case RGB_MAPPING_GRB:
+			SelectEncoder<&WS28xx::SetLEDRTZ<8, 0, 16>>();
+			break;
+		case RGB_MAPPING_GBR:
+			SelectEncoder<&WS28xx::SetLEDRTZ<16, 0, 8>>();
+			break;
+		case RGB_MAPPING_BRG:
+			SelectEncoder<&WS28xx::SetLEDRTZ<8, 16, 0>>();
+			break;
+		case RGB_MAPPING_BGR:
+			SelectEncoder<&WS28xx::SetLEDRTZ<16, 8, 0>>();
+			break;
+		default:  // RGB
+			SelectEncoder<&WS28xx::SetLEDRTZ<0, 8, 16>>();
+			break;
+		}
 
 		return;
 	}
+
+	switch (m_tLEDType) {
+	case APA102:
+		SelectEncoder<&WS28xx::SetLEDClocked<APA102>>();
+		SetupHDR();
+		break;
+	case P9813:
+		SelectEncoder<&WS28xx::SetLEDClocked<P9813>>();
+		break;
+	default:
+		SelectEncoder<&WS28xx::SetLEDClocked<WS2801>>();
+		break;
+	}
 }
 
 void WS28xx::SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
+	assert(m_tLEDType == SK6812W);
+
+	if (m_tLEDType == SK6812W) {
+		SetDirty(nLEDIndex, 1);
+		SetLEDSK6812W(nLEDIndex, nRed, nGreen, nBlue, nWhite);
+	}
+}
+
+void WS28xx::SetLEDSK6812W(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
 	assert(m_pBuffer != 0);
 	assert(nLEDIndex < m_nLedCount);
+
+	const uint32_t nOffset = nLEDIndex * 4 * 8;
+
+	SetColorWS28xx(nOffset, nGreen);
+	SetColorWS28xx(nOffset + 8, nRed);
+	SetColorWS28xx(nOffset + 16, nBlue);
+	SetColorWS28xx(nOffset + 24, nWhite);
+}
+
+void WS28xx::SetLEDGroup(uint32_t nLEDIndex, uint32_t nLEDCount, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+	assert(nLEDCount != 0);
+	assert(nLEDIndex + nLEDCount <= m_nLedCount);
+
+	SetDirty(nLEDIndex, nLEDCount);
+	(this->*m_pSetLED)(nLEDIndex, nRed, nGreen, nBlue);
+	ReplicateLED(nLEDIndex, nLEDCount);
+}
+
+void WS28xx::SetLEDGroup(uint32_t nLEDIndex, uint32_t nLEDCount, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
+	assert(nLEDCount != 0);
+	assert(nLEDIndex + nLEDCount <= m_nLedCount);
 	assert(m_tLEDType == SK6812W);
 
-	uint32_t nOffset = nLEDIndex * 4;
+	SetDirty(nLEDIndex, nLEDCount);
+	SetLEDSK6812W(nLEDIndex, nRed, nGreen, nBlue, nWhite);
+	ReplicateLED(nLEDIndex, nLEDCount);
+}
 
-	if (m_tLEDType == SK6812W) {
-		nOffset *= 8;
+void WS28xx::ReplicateLED(uint32_t nLEDIndex, uint32_t nLEDCount) {
+	uint32_t nOffset = 0;
+	uint32_t nStride;
+
+	if (m_bIsRTZProtocol) {
+		nStride = (m_tLEDType == SK6812W) ? (4 * 8) : (3 * 8);
+	} else if ((m_tLEDType == APA102) || (m_tLEDType == P9813)) {
+		nOffset = 4;
+		nStride = 4;
+	} else {
+		nStride = 3;
+	}
+
+	nOffset += nLEDIndex * nStride;
+
+	assert(nOffset + (nLEDCount * nStride) <= m_nBufSize);
+
+	ws28xx::replicate(&m_pBuffer[nOffset], nStride, nLEDCount);
+}
+
+void WS28xx::SetupRTZ() {
+	// Each bit is sent as one SPI byte, MSB first. Build the byte sequence in memory order,
+	// so that a single 64-bit store gives the same result on any endianness.
+	for (uint32_t nValue = 0; nValue < 256; nValue++) {
+		uint8_t aCodes[8];
+
+		for (uint32_t nBit = 0; nBit < 8; nBit++) {
+			aCodes[nBit] = (nValue & (0x80U >> nBit)) ? m_nHighCode : m_nLowCode;
+		}
 
-		SetColorWS28xx(nOffset, nGreen);
-		SetColorWS28xx(nOffset + 8, nRed);
-		SetColorWS28xx(nOffset + 16, nBlue);
-		SetColorWS28xx(nOffset + 24, nWhite);
+		memcpy(&m_aRTZTable[nValue], aCodes, 8);
 	}
 }
 
@@ -138,14 +303,8 @@ void WS28xx::SetColorWS28xx(uint32_t nOffset, uint8_t nValue) {
 	assert(m_tLEDType != WS2801);
 	assert(nOffset + 7 < m_nBufSize);
 
-	for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
-		if (nValue & mask) {
-			m_pBuffer[nOffset] = m_nHighCode;
-		} else {
-			m_pBuffer[nOffset] = m_nLowCode;
-		}
-		nOffset++;
-	}
+	// A single (unaligned) 64-bit store, without breaking the aliasing rules
+	memcpy(&m_pBuffer[nOffset], &m_aRTZTable[nValue], sizeof(uint64_t));
 }
 
 void WS28xx::SetGlobalBrightness(uint8_t nGlobalBrightness) {
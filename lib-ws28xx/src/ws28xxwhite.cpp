@@ -0,0 +1,130 @@
+/**
+ * @file ws28xxwhite.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <cassert>
+#if defined (__ARM_NEON)
+ #include <arm_neon.h>
+#endif
+
+#include "ws28xxwhite.h"
+
+#include "debug.h"
+
+WS28xxWhite::WS28xxWhite() {
+	SetWhitePoint(0xFF, 0xFF, 0xFF);
+}
+
+void WS28xxWhite::SetWhitePoint(uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+	DEBUG_PRINTF("nRed=%d, nGreen=%d, nBlue=%d", nRed, nGreen, nBlue);
+
+	m_aWhitePoint[0] = nRed;
+	m_aWhitePoint[1] = nGreen;
+	m_aWhitePoint[2] = nBlue;
+
+	for (uint32_t i = 0; i < 3; i++) {
+		// A colour which is not in the white LED does not limit W
+		m_aScale[i] = (m_aWhitePoint[i] == 0) ? 0xFFFF : static_cast<uint16_t>((255U << 8) / m_aWhitePoint[i]);
+	}
+}
+
+/*
+ * The scale is rounded down, so W * Wr / 255 is at most R. It is rounded to nearest
+ * with x / 255 = (x + 128 + ((x + 128) >> 8)) >> 8, and R' (G', B') cannot become negative.
+ */
+
+static inline uint32_t Extract(uint32_t nColour, uint32_t nScale) {
+	const uint32_t nWhite = (nColour * nScale) >> 8;
+	return nWhite > 0xFF ? 0xFF : nWhite;
+}
+
+static inline uint32_t Remove(uint32_t nColour, uint32_t nWhite, uint32_t nWhitePoint) {
+	const uint32_t x = (nWhite * nWhitePoint) + 128;
+	return nColour - ((x + (x >> 8)) >> 8);
+}
+
+void WS28xxWhite::Convert(const uint8_t *pIn, uint8_t *pOut, uint32_t nPixels) const {
+	assert(pIn != nullptr);
+	assert(pOut != nullptr);
+
+	uint32_t i = 0;
+
+#if defined (__ARM_NEON)
+	const uint16x4_t aScale[3] = { vdup_n_u16(m_aScale[0]), vdup_n_u16(m_aScale[1]), vdup_n_u16(m_aScale[2]) };
+	const uint8x8_t aWhitePoint[3] = { vdup_n_u8(m_aWhitePoint[0]), vdup_n_u8(m_aWhitePoint[1]), vdup_n_u8(m_aWhitePoint[2]) };
+	const uint16x8_t nHalf = vdupq_n_u16(128);
+
+	// 8 pixels for each iteration, vld3 and vst4 (de)interleave the colours
+	for (; (i + 8) <= nPixels; i += 8) {
+		const uint8x8x3_t nRGB = vld3_u8(pIn);
+		uint8x8_t aWhite[3];
+
+		for (uint32_t c = 0; c < 3; c++) {
+			const uint16x8_t nColour = vmovl_u8(nRGB.val[c]);
+			const uint32x4_t nLow = vshrq_n_u32(vmull_u16(vget_low_u16(nColour), aScale[c]), 8);
+			const uint32x4_t nHigh = vshrq_n_u32(vmull_u16(vget_high_u16(nColour), aScale[c]), 8);
+			aWhite[c] = vqmovn_u16(vcombine_u16(vqmovn_u32(nLow), vqmovn_u32(nHigh)));
+		}
+
+		const uint8x8_t nWhite = vmin_u8(vmin_u8(aWhite[0], aWhite[1]), aWhite[2]);
+
+		uint8x8x4_t nRGBW;
+
+		for (uint32_t c = 0; c < 3; c++) {
+			const uint16x8_t x = vaddq_u16(vmull_u8(nWhite, aWhitePoint[c]), nHalf);
+			nRGBW.val[c] = vsub_u8(nRGB.val[c], vshrn_n_u16(vsraq_n_u16(x, x, 8), 8));
+		}
+
+		nRGBW.val[3] = nWhite;
+
+		vst4_u8(pOut, nRGBW);
+
+		pIn += 24;
+		pOut += 32;
+	}
+#endif
+
+	for (; i < nPixels; i++) {
+		uint32_t nWhite = Extract(pIn[0], m_aScale[0]);
+		const uint32_t nGreen = Extract(pIn[1], m_aScale[1]);
+		const uint32_t nBlue = Extract(pIn[2], m_aScale[2]);
+
+		nWhite = nGreen < nWhite ? nGreen : nWhite;
+		nWhite = nBlue < nWhite ? nBlue : nWhite;
+
+		pOut[0] = static_cast<uint8_t>(Remove(pIn[0], nWhite, m_aWhitePoint[0]));
+		pOut[1] = static_cast<uint8_t>(Remove(pIn[1], nWhite, m_aWhitePoint[1]));
+		pOut[2] = static_cast<uint8_t>(Remove(pIn[2], nWhite, m_aWhitePoint[2]));
+		pOut[3] = static_cast<uint8_t>(nWhite);
+
+		pIn += 3;
+		pOut += 4;
+	}
+}
+
+void WS28xxWhite::Print() const {
+	printf(" White : R=%d G=%d B=%d\n", m_aWhitePoint[0], m_aWhitePoint[1], m_aWhitePoint[2]);
+}
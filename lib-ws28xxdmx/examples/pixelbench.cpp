@@ -0,0 +1,201 @@
+/**
+ * @file pixelbench.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Drives WS28xxDmx, WS28xxDmxGrouping and WS28xxDmxMulti with synthetic DMX universes,
+ * as they are received with Art-Net or sACN, for every LED type.
+ * The encoded frames are written to the WS28xx sink: memory (default), a file or spidev.
+ *
+ * Usage: pixelbench [memory | file <path> | spidev <path>]
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "hardware.h"
+
+#include "ws28xxdmx.h"
+#include "ws28xxdmxgrouping.h"
+#include "ws28xxdmxmulti.h"
+#include "ws28xx.h"
+#include "linux/ws28xxsink.h"
+
+static constexpr uint32_t FRAMES = 1000;
+static constexpr uint32_t MULTI_OUTPUTS = 8;
+static constexpr uint32_t GROUP_COUNT = 4;
+
+static uint64_t Nanos() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/*
+ * Every slot changes for every frame
+ */
+static void FillUniverse(uint8_t *pData, uint32_t nFrame, uint32_t nUniverse) {
+	for (uint32_t i = 0; i < DMX_UNIVERSE_SIZE; i++) {
+		pData[i] = static_cast<uint8_t>(i + (nUniverse * 7) + nFrame);
+	}
+}
+
+static void Print(const char *pDriver, TWS28XXType tType, uint32_t nPixels, uint32_t nUniverses, uint64_t nTotalNanos, uint64_t nFillNanos) {
+	const uint64_t nOutputNanos = WS28xxSink::GetWriteNanos();
+	const uint64_t nEncodeNanos = nTotalNanos - nFillNanos - nOutputNanos;
+	const uint64_t nNanos = nTotalNanos - nFillNanos;
+
+	printf("%-9s %-8s %5u %3u %9.0f %8.1f %9.1f %9.1f %6u\n", pDriver, WS28xx::GetLedTypeString(tType),
+			nPixels, nUniverses,
+			nNanos == 0 ? 0.0 : (static_cast<double>(FRAMES) * 1e9) / static_cast<double>(nNanos),
+			static_cast<double>(nNanos) / (static_cast<double>(FRAMES) * nPixels),
+			static_cast<double>(nEncodeNanos) / (FRAMES * 1000.0),
+			static_cast<double>(nOutputNanos) / (FRAMES * 1000.0),
+			WS28xxSink::GetFrames());
+}
+
+static void BenchmarkDmx(TWS28XXType tType) {
+	WS28xxDmx pixelDmx;
+	pixelDmx.SetLEDType(tType);
+	pixelDmx.SetLEDCount(static_cast<uint16_t>(4 * (DMX_UNIVERSE_SIZE / ((tType == SK6812W) ? 4 : 3))));
+	pixelDmx.Start(0);
+
+	const uint32_t nUniverses = pixelDmx.GetUniverses();
+	uint8_t aData[DMX_UNIVERSE_SIZE];
+	uint64_t nFillNanos = 0;
+
+	WS28xxSink::ResetCounters();
+	const uint64_t nStart = Nanos();
+
+	for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+		for (uint32_t nUniverse = 0; nUniverse < nUniverses; nUniverse++) {
+			const uint64_t nFillStart = Nanos();
+			FillUniverse(aData, nFrame, nUniverse);
+			nFillNanos += Nanos() - nFillStart;
+
+			pixelDmx.SetData(static_cast<uint8_t>(nUniverse), aData, DMX_UNIVERSE_SIZE);
+		}
+	}
+
+	Print("Dmx", tType, pixelDmx.GetLEDCount(), nUniverses, Nanos() - nStart, nFillNanos);
+}
+
+static void BenchmarkGrouping(TWS28XXType tType) {
+	WS28xxDmxGrouping pixelDmx;
+	pixelDmx.SetLEDType(tType);
+	pixelDmx.SetLEDCount(static_cast<uint16_t>(4 * (DMX_UNIVERSE_SIZE / ((tType == SK6812W) ? 4 : 3))));
+	pixelDmx.SetLEDGroupCount(GROUP_COUNT);
+	pixelDmx.Start(0);
+
+	uint8_t aData[DMX_UNIVERSE_SIZE];
+	uint64_t nFillNanos = 0;
+
+	WS28xxSink::ResetCounters();
+	const uint64_t nStart = Nanos();
+
+	for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+		const uint64_t nFillStart = Nanos();
+		FillUniverse(aData, nFrame, 0);
+		nFillNanos += Nanos() - nFillStart;
+
+		pixelDmx.SetData(0, aData, DMX_UNIVERSE_SIZE);
+	}
+
+	Print("Grouping", tType, pixelDmx.GetLEDCount(), 1, Nanos() - nStart, nFillNanos);
+}
+
+static void BenchmarkMulti(TWS28XXType tType) {
+	WS28xxDmxMulti pixelDmxMulti(WS28XXDMXMULTI_SRC_E131);
+	pixelDmxMulti.SetLEDType(tType);
+	pixelDmxMulti.SetLEDCount(static_cast<uint16_t>(4 * (DMX_UNIVERSE_SIZE / ((tType == SK6812W) ? 4 : 3))));
+	pixelDmxMulti.SetActivePorts(MULTI_OUTPUTS);
+	pixelDmxMulti.Initialize();
+
+	if (pixelDmxMulti.GetLEDType() != tType) {
+		// Not supported by the multi output boards
+		return;
+	}
+
+	pixelDmxMulti.Start(0);
+
+	const uint32_t nUniverses = pixelDmxMulti.GetUniverses() * pixelDmxMulti.GetActivePorts();
+	uint8_t aData[DMX_UNIVERSE_SIZE];
+	uint64_t nFillNanos = 0;
+
+	WS28xxSink::ResetCounters();
+	const uint64_t nStart = Nanos();
+
+	for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+		for (uint32_t nUniverse = 0; nUniverse < nUniverses; nUniverse++) {
+			const uint64_t nFillStart = Nanos();
+			FillUniverse(aData, nFrame, nUniverse);
+			nFillNanos += Nanos() - nFillStart;
+
+			pixelDmxMulti.SetData(static_cast<uint8_t>(nUniverse), aData, DMX_UNIVERSE_SIZE);
+		}
+	}
+
+	Print("Multi 8x", tType, pixelDmxMulti.GetLEDCount() * pixelDmxMulti.GetActivePorts(), nUniverses, Nanos() - nStart, nFillNanos);
+}
+
+int main(int argc, char **argv) {
+	Hardware hw;
+
+	bool bIsOpen = true;
+
+	if ((argc == 3) && (strcmp(argv[1], "file") == 0)) {
+		bIsOpen = WS28xxSink::Open(WS28xxSinkType::FILE, argv[2]);
+	} else if ((argc == 3) && (strcmp(argv[1], "spidev") == 0)) {
+		bIsOpen = WS28xxSink::Open(WS28xxSinkType::SPIDEV, argv[2]);
+	} else if ((argc == 1) || ((argc == 2) && (strcmp(argv[1], "memory") == 0))) {
+		bIsOpen = WS28xxSink::Open(WS28xxSinkType::MEMORY);
+	} else {
+		printf("Usage: %s [memory | file <path> | spidev <path>]\n", argv[0]);
+		return 1;
+	}
+
+	if (!bIsOpen) {
+		return 1;
+	}
+
+	printf("%u frames, all the slots change for every frame\n", FRAMES);
+	printf("%-9s %-8s %5s %3s %9s %8s %9s %9s %6s\n", "Driver", "Type", "LEDs", "U", "frames/s", "ns/LED", "encode us", "output us", "writes");
+
+	for (uint32_t i = 0; i < WS28XX_UNDEFINED; i++) {
+		const auto tType = static_cast<TWS28XXType>(i);
+
+		BenchmarkDmx(tType);
+		BenchmarkGrouping(tType);
+		BenchmarkMulti(tType);
+	}
+
+	printf("\n'encode us' is the time per frame in SetData without the sink, 'output us' is the time per frame in the sink\n");
+
+	WS28xxSink::Print();
+	WS28xxSink::Close();
+
+	return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file frameassembler.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef FRAMEASSEMBLER_H_
+#define FRAMEASSEMBLER_H_
+
+#include <stdint.h>
+
+struct FrameAssemblerConst {
+	static constexpr uint32_t MAX_OUTPUTS = 8;
+	static constexpr uint32_t MAX_UNIVERSES = 4;
+	static constexpr uint32_t TIMEOUT_MILLIS_DEFAULT = 20;
+};
+
+/**
+ * Collects the universes of all outputs into one frame.
+ * A frame is output when all universes are received, on a sync, when a universe is received again
+ * before the frame is complete, or when the frame is not completed within the timeout.
+ * The output rate is limited to the maximum refresh rate, a deferred frame is output with Run.
+ */
+class FrameAssembler {
+public:
+	FrameAssembler();
+
+	void Setup(uint32_t nOutputs, uint32_t nUniverses);
+
+	void SetMaxFps(uint32_t nMaxFps);
+	uint32_t GetMaxFps() const {
+		return m_nMaxFps;
+	}
+
+	void SetTimeout(uint32_t nTimeoutMillis) {
+		m_nTimeoutMillis = nTimeoutMillis;
+	}
+	uint32_t GetTimeout() const {
+		return m_nTimeoutMillis;
+	}
+
+	/**
+	 * The functions return true when the frame must be output now
+	 */
+	bool Received(uint32_t nOutput, uint32_t nUniverse, uint32_t nMillis);
+	bool Sync(uint32_t nMillis);
+	bool Run(uint32_t nMillis);
+
+	/**
+	 * No universe is received for the next frame, and no frame is waiting for its output
+	 */
+	bool IsIdle() const {
+		return !m_bHasData && !m_bOutputPending;
+	}
+
+	uint32_t GetFramesAssembled() const {
+		return m_nFramesAssembled;
+	}
+	uint32_t GetFramesPartial() const {
+		return m_nFramesPartial;
+	}
+	uint32_t GetFramesTimedOut() const {
+		return m_nFramesTimedOut;
+	}
+
+	void Print();
+
+private:
+	void Close();
+	bool Output(uint32_t nMillis);
+
+private:
+	uint32_t m_nOutputs{1};
+	uint32_t m_nCompleteMask{1};
+	uint32_t m_nOutputsComplete{0};
+	uint8_t m_aReceived[FrameAssemblerConst::MAX_OUTPUTS];
+	bool m_bHasData{false};
+	bool m_bOutputPending{false};
+	uint32_t m_nFirstMillis{0};
+	uint32_t m_nLastOutputMillis{0};
+	uint32_t m_nMaxFps{0};
+	uint32_t m_nMinIntervalMillis{0};
+	uint32_t m_nTimeoutMillis{FrameAssemblerConst::TIMEOUT_MILLIS_DEFAULT};
+	uint32_t m_nFramesAssembled{0};
+	uint32_t m_nFramesPartial{0};
+	uint32_t m_nFramesTimedOut{0};
+};
+
+#endif /* FRAMEASSEMBLER_H_ */
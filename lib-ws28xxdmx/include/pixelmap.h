@@ -0,0 +1,113 @@
+/**
+ * @file pixelmap.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PIXELMAP_H_
+#define PIXELMAP_H_
+
+#include <stdint.h>
+
+enum class PixelMapStart: uint8_t {
+	TOP_LEFT,
+	TOP_RIGHT,
+	BOTTOM_LEFT,
+	BOTTOM_RIGHT
+};
+
+struct PixelMapConst {
+	static constexpr uint32_t MAX_OUTPUTS = 8;
+	static constexpr uint16_t SKIP = 0xFFFF;	///< Logical pixel is not wired
+};
+
+/**
+ * Maps the pixels as sent by the console (row by row, starting top left) onto the LEDs as wired.
+ *
+ * pixelmap.txt, the keys before the first "output=" line apply to all outputs:
+ *  width=16, height=16, start=top_left|top_right|bottom_left|bottom_right,
+ *  vertical=1 (wired by column), serpentine=1, offset=<first LED>, reverse=1
+ *  map=0-15,31-16,x,32	Arbitrary map (LED index, range, or x for a skipped pixel), the lines are appended
+ *  output=1..8
+ *
+ * The map is compiled into an index table per output (logical pixel -> LED).
+ * Outputs without a map have no table, so the linear path is unchanged.
+ */
+class PixelMap {
+public:
+	PixelMap();
+	~PixelMap();
+
+	bool Load();
+	void Load(const char *pBuffer, uint32_t nLength);
+
+	void Compile(uint32_t nOutputs, uint32_t nLedCount);
+
+	const uint16_t *GetTable(uint32_t nOutput) const {
+		return nOutput < PixelMapConst::MAX_OUTPUTS ? m_pTable[nOutput] : nullptr;
+	}
+
+	void Dump();
+	void Print();
+
+	static PixelMap *Get() {
+		return s_pThis;
+	}
+
+public:
+	static void staticCallbackFunction(void *p, const char *s);
+
+private:
+	void callbackFunction(const char *pLine);
+	void Reset();
+	void AddEntries(const char *pList);
+	void AddEntry(uint16_t nLed);
+	void CompileLayout(uint32_t nSlot, uint16_t *pTable);
+
+private:
+	static constexpr uint32_t ALL_OUTPUTS = PixelMapConst::MAX_OUTPUTS;
+	static constexpr uint32_t SLOTS = PixelMapConst::MAX_OUTPUTS + 1;
+
+	struct TLayout {
+		uint16_t nWidth;
+		uint16_t nHeight;
+		uint16_t nOffset;
+		PixelMapStart tStart;
+		bool bVertical;
+		bool bSerpentine;
+		bool bReverse;
+		bool bIsSet;
+	};
+
+	TLayout m_aLayout[SLOTS];
+	uint16_t *m_pEntries[SLOTS];	///< Arbitrary map as loaded
+	uint16_t m_aEntriesCount[SLOTS];
+	uint16_t *m_pSlotTable[SLOTS];
+	const uint16_t *m_pTable[PixelMapConst::MAX_OUTPUTS];
+	uint32_t m_nSlot;			///< Target of the keys being parsed
+	uint32_t m_nOutputs;
+	uint32_t m_nLedCount;
+
+	static PixelMap *s_pThis;
+};
+
+#endif /* PIXELMAP_H_ */
@@ -31,6 +31,8 @@
 #include "lightset.h"
 
 #include "ws28xx.h"
+#include "ws28xxcolour.h"
+#include "ws28xxwhite.h"
 #include "ws28xxdmxstore.h"
 
 class WS28xxDmx: public LightSet {
@@ -83,6 +85,58 @@ public:
 		return m_nGlobalBrightness;
 	}
 
+	void SetGamma(uint32_t nChannel, float fGamma) {
+		m_Colour.SetGamma(nChannel, fGamma);
+	}
+
+	virtual void Set16Bit(bool b16Bit);
+	bool Is16Bit(void) const {
+		return m_Colour.Is16Bit();
+	}
+
+	void SetDithering(bool bDithering) {
+		m_Colour.SetDithering(bDithering);
+	}
+
+	/**
+	 * APA102 only, the colour is output with the per-pixel 5-bit brightness
+	 */
+	void SetHDR(bool bHDR) {
+		m_bHDR = bHDR;
+	}
+	bool IsHDR(void) const {
+		return m_bHDR && (m_tLedType == APA102);
+	}
+
+	/**
+	 * SK6812W only, the DMX data is RGB and W is derived on the node (170 LEDs per universe)
+	 */
+	virtual void SetRgbwFromRgb(bool bRgbwFromRgb);
+	bool IsRgbwFromRgb(void) const {
+		return m_bRgbwFromRgb && (m_tLedType == SK6812W);
+	}
+
+	void SetWhitePoint(uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+		m_White.SetWhitePoint(nRed, nGreen, nBlue);
+	}
+
+	/**
+	 * Starts the pending frame or blackout as soon as the previous transfer has completed, call it from the main loop.
+	 * With dithering, the last DMX frame is output again with the next dithering phase each time the LEDs are idle.
+	 */
+	void Run(void);
+
+	uint32_t GetUniverses(void) const {
+		return m_nPortIdLast + 1;
+	}
+
+	uint32_t GetFramesDropped(void) {
+		if (m_pLEDStripe != 0) {
+			return m_pLEDStripe->GetFramesDropped();
+		}
+		return 0;
+	}
+
 	void SetWS28xxDmxStore(WS28xxDmxStore *pWS28xxDmxStore) {
 		m_pWS28xxDmxStore = pWS28xxDmxStore;
 	}
@@ -102,8 +156,15 @@ public: // RDM
 
 	virtual bool GetSlotInfo(uint16_t nSlotOffset, struct TLightSetSlotInfo &tSlotInfo);
 
+protected:
+	/**
+	 * Sets the LEDs again from the last DMX frame, for the dithering refresh
+	 */
+	virtual void Refresh(void);
+
 private:
 	void UpdateMembers(void);
+	void SetLEDs(uint32_t nLEDIndex, const uint8_t *pData, uint32_t nLEDs);
 
 protected:
 	TWS28XXType m_tLedType;
@@ -116,21 +177,30 @@ protected:
 	uint16_t m_nDmxStartAddress;
 	uint16_t m_nDmxFootprint;
 
-	WS28xx* m_pLEDStripe;
+	WS28xx *m_pLEDStripe;	///< WS28xxDMA on the H3
 	bool m_bIsStarted;
 	bool m_bBlackout;
 
 	WS28xxDmxStore *m_pWS28xxDmxStore;
 
+	WS28xxColour m_Colour;
+	bool m_bHDR;
+	WS28xxWhite m_White;
+	bool m_bRgbwFromRgb;
+	bool m_bRefresh;	///< A complete DMX frame is output, it can be refreshed
+
 private:
 	uint32_t m_nClockSpeedHz;
 	uint8_t m_nGlobalBrightness;
 	uint32_t m_nBeginIndexPortId1;
 	uint32_t m_nBeginIndexPortId2;
 	uint32_t m_nBeginIndexPortId3;
-	uint32_t m_nChannelsPerLed;
+	uint32_t m_nChannelsPerLed;	///< DMX channels, twice the colours with 16-bit input
+	uint32_t m_nColours;
 
 	uint32_t m_nPortIdLast;
+
+	uint8_t *m_pDitherData;	///< The DMX data for each LED, kept for the dithering refresh
 };
 
 #endif /* WS28XXDMX_H_ */
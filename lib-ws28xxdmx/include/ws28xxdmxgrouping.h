@@ -42,6 +42,8 @@ public:
 
 	void SetLEDType(TWS28XXType tLedType);
 	void SetLEDCount(uint16_t nLedCount);
+	void Set16Bit(bool b16Bit);
+	void SetRgbwFromRgb(bool bRgbwFromRgb);
 	void SetLEDGroupCount(uint16_t nLedGroupCount);
 	uint32_t GetLEDGroupCount(void) {
 		return m_nLEDGroupCount;
@@ -53,6 +55,9 @@ public: // RDM
 	bool SetDmxStartAddress(uint16_t nDmxStartAddress);
 	bool GetSlotInfo(uint16_t nSlotOffset, struct TLightSetSlotInfo &tSlotInfo);
 
+protected:
+	void Refresh(void);
+
 private:
 	void UpdateMembers(void);
 
@@ -31,6 +31,10 @@
 #include "lightset.h"
 
 #include "ws28xxmulti.h"
+#include "ws28xxcolour.h"
+#include "ws28xxwhite.h"
+#include "pixelmap.h"
+#include "frameassembler.h"
 
 #include "rgbmapping.h"
 
@@ -50,6 +54,9 @@ public:
 	void Stop(uint8_t nPort);
 
 	void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLength);
+	void Sync(void);
+
+	void Run(void);
 
 	void Blackout(bool bBlackout);
 
@@ -78,6 +85,14 @@ public:
 		return m_nLedCount;
 	}
 
+	/**
+	 * Grouped mode, the DMX data holds one colour per group of LEDs
+	 */
+	void SetLEDGroupCount(uint16_t nLedGroupCount);
+	uint32_t GetLEDGroupCount(void) {
+		return m_nLedGroupCount;
+	}
+
 	void SetActivePorts(uint8_t nActiveOutputs);
 	uint32_t GetActivePorts(void) {
 		return m_nActiveOutputs;
@@ -101,10 +116,74 @@ public:
 		return WS28XXMULTI_BOARD_UNKNOWN;
 	}
 
+	void SetGamma(uint32_t nChannel, float fGamma) {
+		m_Colour.SetGamma(nChannel, fGamma);
+	}
+
+	/**
+	 * The DMX data holds coarse/fine channel pairs (85 LEDs per universe, 64 for RGBW)
+	 */
+	void Set16Bit(bool b16Bit);
+	bool Is16Bit(void) const {
+		return m_Colour.Is16Bit();
+	}
+
+	void SetDithering(bool bDithering) {
+		m_Colour.SetDithering(bDithering);
+	}
+
+	/**
+	 * SK6812W only, the DMX data is RGB and W is derived on the node (170 LEDs per universe)
+	 */
+	void SetRgbwFromRgb(bool bRgbwFromRgb);
+	bool IsRgbwFromRgb(void) const {
+		return m_bRgbwFromRgb && (m_tLedType == SK6812W);
+	}
+
+	void SetWhitePoint(uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+		m_White.SetWhitePoint(nRed, nGreen, nBlue);
+	}
+
+	void SetPixelMap(PixelMap *pPixelMap) {
+		m_pPixelMap = pPixelMap;
+	}
+
+	void SetMaxFps(uint32_t nMaxFps) {
+		m_FrameAssembler.SetMaxFps(nMaxFps);
+	}
+
+	void SetFrameTimeout(uint32_t nTimeoutMillis) {
+		m_FrameAssembler.SetTimeout(nTimeoutMillis);
+	}
+
+	/**
+	 * Bit n of nOutputMask interpolates output n + 1, the other outputs snap to the received frame
+	 */
+	void SetInterpolation(uint8_t nOutputMask) {
+		m_nInterpolationMask = nOutputMask;
+	}
+	uint8_t GetInterpolation(void) {
+		return m_nInterpolationMask;
+	}
+
+	const FrameAssembler& GetFrameAssembler(void) {
+		return m_FrameAssembler;
+	}
+
+	uint32_t GetFramesDropped(void) {
+		if (m_pLEDStripe != 0) {
+			return m_pLEDStripe->GetFramesDropped();
+		}
+		return 0;
+	}
+
 	void Print(void);
 
 private:
 	void UpdateMembers(void);
+	void SetUniverse(uint32_t nOutIndex, uint32_t nUniverse, const uint8_t *pData, uint16_t nLength);
+	void Output(void);
+	void Refresh(void);
 
 private:
 	TWS28xxDmxMultiSrc m_tSrc;
@@ -115,6 +194,8 @@ private:
 	uint8_t m_nHighCode;
 
 	uint32_t m_nLedCount;
+	uint32_t m_nLedGroupCount;
+	uint32_t m_nPixels;	///< Pixels per output in the DMX data, LEDs or groups
 	uint32_t m_nActiveOutputs;
 
 	WS28xxMulti *m_pLEDStripe;
@@ -127,10 +208,20 @@ private:
 	uint32_t m_nBeginIndexPortId1;
 	uint32_t m_nBeginIndexPortId2;
 	uint32_t m_nBeginIndexPortId3;
-	uint32_t m_nChannelsPerLed;
+	uint32_t m_nChannelsPerLed;	///< DMX channels, twice the colours with 16-bit input
+	uint32_t m_nColours;
 
-	uint32_t m_nPortIdLast;
 	bool m_bUseSI5351A;
+
+	WS28xxColour m_Colour;
+	WS28xxWhite m_White;
+	bool m_bRgbwFromRgb;
+	PixelMap *m_pPixelMap;
+	FrameAssembler m_FrameAssembler;
+	uint8_t m_nInterpolationMask;
+	uint8_t *m_pDitherData;	///< The DMX data of each universe, kept for the dithering refresh
+	uint16_t m_aDitherLength[FrameAssemblerConst::MAX_OUTPUTS * FrameAssemblerConst::MAX_UNIVERSES];
+	bool m_bRefresh;	///< A complete frame is output, it can be refreshed
 };
 
 #endif /* WS28XXDMXMULTI_H_ */
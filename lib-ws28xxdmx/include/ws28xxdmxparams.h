@@ -48,6 +48,15 @@ struct TWS28xxDmxParams {
 	uint8_t nRgbMapping;
 	uint8_t nLowCode;
 	uint8_t nHighCode;
+	uint8_t aGamma[4];	///< Gamma * 10, R, G, B, W
+	bool b16Bit;
+	bool bDithering;
+	uint8_t nMaxFps;
+	uint16_t nFrameTimeout;	///< Milliseconds
+	bool bHDR;
+	uint8_t nInterpolation;	///< Bit n is output n + 1
+	bool bRgbwFromRgb;
+	uint8_t aWhitePoint[3];	///< R, G, B of the white LED
 };
 
 struct WS28xxDmxParamsMask {
@@ -63,6 +72,15 @@ struct WS28xxDmxParamsMask {
 	static constexpr auto RGB_MAPPING = (1U << 9);
 	static constexpr auto LOW_CODE = (1U << 10);
 	static constexpr auto HIGH_CODE = (1U << 11);
+	static constexpr auto GAMMA = (1U << 12);
+	static constexpr auto PIXEL_16BIT = (1U << 13);
+	static constexpr auto DITHERING = (1U << 14);
+	static constexpr auto MAX_FPS = (1U << 15);
+	static constexpr auto FRAME_TIMEOUT = (1U << 16);
+	static constexpr auto APA102_HDR = (1U << 17);
+	static constexpr auto INTERPOLATION = (1U << 18);
+	static constexpr auto RGBW_FROM_RGB = (1U << 19);
+	static constexpr auto WHITE_POINT = (1U << 20);
 };
 
 class WS28xxDmxParamsStore {
@@ -138,11 +156,41 @@ public:
 		return WS28xx::ConvertTxH(m_tWS28xxParams.nHighCode);
 	}
 
+	float GetGamma(uint32_t nChannel) {
+		return static_cast<float>(m_tWS28xxParams.aGamma[nChannel]) / 10;
+	}
+
+	bool IsRgbwFromRgb() {
+		return m_tWS28xxParams.bRgbwFromRgb;
+	}
+
+	bool Is16Bit() {
+		return m_tWS28xxParams.b16Bit;
+	}
+
+	bool IsDithering() {
+		return m_tWS28xxParams.bDithering;
+	}
+
+	uint8_t GetMaxFps() {
+		return m_tWS28xxParams.nMaxFps;
+	}
+
+	uint16_t GetFrameTimeout() {
+		return m_tWS28xxParams.nFrameTimeout;
+	}
+
+	bool IsHDR() {
+		return m_tWS28xxParams.bHDR;
+	}
+
 public:
 	static void staticCallbackFunction(void *p, const char *s);
 
 private:
     void callbackFunction(const char *pLine);
+    void SetGamma(uint32_t nFirst, uint32_t nLast, float fGamma);
+    void SetWhitePoint(uint32_t nChannel, uint8_t nValue);
     bool isMaskSet(uint32_t nMask) {
     	return (m_tWS28xxParams.nSetList & nMask) == nMask;
     }
@@ -0,0 +1,140 @@
+/**
+ * @file frameassembler.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cassert>
+
+#include "frameassembler.h"
+
+#include "debug.h"
+
+FrameAssembler::FrameAssembler() {
+	memset(m_aReceived, 0, sizeof(m_aReceived));
+}
+
+void FrameAssembler::Setup(uint32_t nOutputs, uint32_t nUniverses) {
+	DEBUG_PRINTF("nOutputs=%d, nUniverses=%d", static_cast<int>(nOutputs), static_cast<int>(nUniverses));
+
+	assert(nOutputs <= FrameAssemblerConst::MAX_OUTPUTS);
+	assert(nUniverses != 0);
+	assert(nUniverses <= FrameAssemblerConst::MAX_UNIVERSES);
+
+	m_nOutputs = (nOutputs == 0) ? 1 : nOutputs;
+	m_nCompleteMask = (1U << nUniverses) - 1;
+	m_bOutputPending = false;
+
+	Close();
+}
+
+void FrameAssembler::SetMaxFps(uint32_t nMaxFps) {
+	if (nMaxFps > 1000) {
+		nMaxFps = 1000;
+	}
+
+	m_nMaxFps = nMaxFps;
+	m_nMinIntervalMillis = (nMaxFps == 0) ? 0 : (1000 / nMaxFps);
+}
+
+void FrameAssembler::Close() {
+	memset(m_aReceived, 0, sizeof(m_aReceived));
+	m_nOutputsComplete = 0;
+	m_bHasData = false;
+}
+
+bool FrameAssembler::Output(uint32_t nMillis) {
+	if ((m_nMinIntervalMillis != 0) && ((nMillis - m_nLastOutputMillis) < m_nMinIntervalMillis)) {
+		// Deferred, the staged data is updated until the frame is output
+		return false;
+	}
+
+	m_nLastOutputMillis = nMillis;
+	m_bOutputPending = false;
+
+	return true;
+}
+
+bool FrameAssembler::Received(uint32_t nOutput, uint32_t nUniverse, uint32_t nMillis) {
+	if ((nOutput >= m_nOutputs) || (((1U << nUniverse) & m_nCompleteMask) == 0)) {
+		return Run(nMillis);
+	}
+
+	const auto nMask = static_cast<uint8_t>(1U << nUniverse);
+
+	if ((m_aReceived[nOutput] & nMask) == nMask) {
+		// The next frame has started, the last universe(s) of the current frame are lost
+		m_nFramesPartial++;
+		Close();
+		m_bOutputPending = true;
+	}
+
+	if (!m_bHasData) {
+		m_bHasData = true;
+		m_nFirstMillis = nMillis;
+	}
+
+	m_aReceived[nOutput] |= nMask;
+
+	if (m_aReceived[nOutput] == m_nCompleteMask) {
+		if (++m_nOutputsComplete == m_nOutputs) {
+			m_nFramesAssembled++;
+			Close();
+			m_bOutputPending = true;
+		}
+	}
+
+	return Run(nMillis);
+}
+
+bool FrameAssembler::Sync(uint32_t nMillis) {
+	if (m_bHasData) {
+		m_nFramesPartial++;
+		Close();
+		m_bOutputPending = true;
+	}
+
+	return Run(nMillis);
+}
+
+bool FrameAssembler::Run(uint32_t nMillis) {
+	if (m_bHasData && (m_nTimeoutMillis != 0) && ((nMillis - m_nFirstMillis) >= m_nTimeoutMillis)) {
+		m_nFramesTimedOut++;
+		Close();
+		m_bOutputPending = true;
+	}
+
+	if (m_bOutputPending) {
+		return Output(nMillis);
+	}
+
+	return false;
+}
+
+void FrameAssembler::Print() {
+	printf(" Max FPS : %d\n", static_cast<int>(m_nMaxFps));
+	printf(" Timeout : %d ms\n", static_cast<int>(m_nTimeoutMillis));
+	printf(" Frames  : %d assembled, %d partial, %d timed out\n", static_cast<int>(m_nFramesAssembled), static_cast<int>(m_nFramesPartial), static_cast<int>(m_nFramesTimedOut));
+}
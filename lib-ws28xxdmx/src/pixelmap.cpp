@@ -0,0 +1,224 @@
+/**
+ * @file pixelmap.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <cassert>
+
+#include "pixelmap.h"
+
+#include "debug.h"
+
+PixelMap *PixelMap::s_pThis = nullptr;
+
+PixelMap::PixelMap(): m_nSlot(ALL_OUTPUTS), m_nOutputs(0), m_nLedCount(0) {
+	DEBUG_ENTRY
+
+	assert(s_pThis == nullptr);
+	s_pThis = this;
+
+	for (uint32_t i = 0; i < SLOTS; i++) {
+		m_pEntries[i] = nullptr;
+		m_pSlotTable[i] = nullptr;
+	}
+
+	for (uint32_t i = 0; i < PixelMapConst::MAX_OUTPUTS; i++) {
+		m_pTable[i] = nullptr;
+	}
+
+	Reset();
+
+	DEBUG_EXIT
+}
+
+PixelMap::~PixelMap() {
+	for (uint32_t i = 0; i < SLOTS; i++) {
+		delete[] m_pEntries[i];
+		m_pEntries[i] = nullptr;
+
+		delete[] m_pSlotTable[i];
+		m_pSlotTable[i] = nullptr;
+	}
+
+	s_pThis = nullptr;
+}
+
+void PixelMap::Reset() {
+	for (uint32_t i = 0; i < SLOTS; i++) {
+		m_aLayout[i].nWidth = 0;
+		m_aLayout[i].nHeight = 1;
+		m_aLayout[i].nOffset = 0;
+		m_aLayout[i].tStart = PixelMapStart::TOP_LEFT;
+		m_aLayout[i].bVertical = false;
+		m_aLayout[i].bSerpentine = false;
+		m_aLayout[i].bReverse = false;
+		m_aLayout[i].bIsSet = false;
+
+		m_aEntriesCount[i] = 0;
+	}
+
+	m_nSlot = ALL_OUTPUTS;
+}
+
+/*
+ * (x, y) is the position as sent by the console, row by row, starting top left.
+ */
+void PixelMap::CompileLayout(uint32_t nSlot, uint16_t *pTable) {
+	const TLayout &Layout = m_aLayout[nSlot];
+
+	uint32_t nWidth = Layout.nWidth;
+	uint32_t nHeight = Layout.nHeight;
+
+	if (nWidth == 0) {
+		// A single strip
+		nWidth = (m_nLedCount > Layout.nOffset) ? (m_nLedCount - Layout.nOffset) : 0;
+		nHeight = 1;
+	}
+
+	const uint32_t nPixels = nWidth * nHeight;
+	const bool bRight = (Layout.tStart == PixelMapStart::TOP_RIGHT) || (Layout.tStart == PixelMapStart::BOTTOM_RIGHT);
+	const bool bBottom = (Layout.tStart == PixelMapStart::BOTTOM_LEFT) || (Layout.tStart == PixelMapStart::BOTTOM_RIGHT);
+
+	for (uint32_t nPixel = 0; nPixel < m_nLedCount; nPixel++) {
+		if (nPixel >= nPixels) {
+			pTable[nPixel] = PixelMapConst::SKIP;
+			continue;
+		}
+
+		uint32_t x = nPixel % nWidth;
+		uint32_t y = nPixel / nWidth;
+
+		if (bRight) {
+			x = nWidth - 1 - x;
+		}
+
+		if (bBottom) {
+			y = nHeight - 1 - y;
+		}
+
+		uint32_t nMajor, nMinor, nMinorLength;
+
+		if (Layout.bVertical) {
+			nMajor = x;
+			nMinor = y;
+			nMinorLength = nHeight;
+		} else {
+			nMajor = y;
+			nMinor = x;
+			nMinorLength = nWidth;
+		}
+
+		if (Layout.bSerpentine && (nMajor & 0x1)) {
+			nMinor = nMinorLength - 1 - nMinor;
+		}
+
+		uint32_t nLed = (nMajor * nMinorLength) + nMinor;
+
+		if (Layout.bReverse) {
+			nLed = nPixels - 1 - nLed;
+		}
+
+		nLed += Layout.nOffset;
+
+		pTable[nPixel] = (nLed < m_nLedCount) ? static_cast<uint16_t>(nLed) : PixelMapConst::SKIP;
+	}
+}
+
+void PixelMap::Compile(uint32_t nOutputs, uint32_t nLedCount) {
+	DEBUG_ENTRY
+	DEBUG_PRINTF("nOutputs=%d, nLedCount=%d", static_cast<int>(nOutputs), static_cast<int>(nLedCount));
+
+	assert(nOutputs <= PixelMapConst::MAX_OUTPUTS);
+
+	if (nLedCount != m_nLedCount) {
+		for (uint32_t i = 0; i < SLOTS; i++) {
+			delete[] m_pSlotTable[i];
+			m_pSlotTable[i] = nullptr;
+		}
+	}
+
+	m_nOutputs = nOutputs;
+	m_nLedCount = nLedCount;
+
+	bool aIsCompiled[SLOTS] = {false};
+
+	for (uint32_t nOutput = 0; nOutput < PixelMapConst::MAX_OUTPUTS; nOutput++) {
+		m_pTable[nOutput] = nullptr;
+
+		if (nOutput >= m_nOutputs) {
+			continue;
+		}
+
+		uint32_t nSlot = nOutput;
+
+		if (!m_aLayout[nSlot].bIsSet && (m_aEntriesCount[nSlot] == 0)) {
+			nSlot = ALL_OUTPUTS;
+
+			if (!m_aLayout[nSlot].bIsSet && (m_aEntriesCount[nSlot] == 0)) {
+				// Linear
+				continue;
+			}
+		}
+
+		if (!aIsCompiled[nSlot]) {
+			if (m_pSlotTable[nSlot] == nullptr) {
+				m_pSlotTable[nSlot] = new uint16_t[m_nLedCount];
+				assert(m_pSlotTable[nSlot] != nullptr);
+			}
+
+			uint16_t *pTable = m_pSlotTable[nSlot];
+
+			if (m_aEntriesCount[nSlot] != 0) {
+				for (uint32_t nPixel = 0; nPixel < m_nLedCount; nPixel++) {
+					if ((nPixel < m_aEntriesCount[nSlot]) && (m_pEntries[nSlot][nPixel] < m_nLedCount)) {
+						pTable[nPixel] = m_pEntries[nSlot][nPixel];
+					} else {
+						pTable[nPixel] = PixelMapConst::SKIP;
+					}
+				}
+			} else {
+				CompileLayout(nSlot, pTable);
+			}
+
+			aIsCompiled[nSlot] = true;
+		}
+
+		m_pTable[nOutput] = m_pSlotTable[nSlot];
+	}
+
+	DEBUG_EXIT
+}
+
+void PixelMap::Print() {
+	printf("Pixel map\n");
+
+	for (uint32_t nOutput = 0; nOutput < m_nOutputs; nOutput++) {
+		if (m_pTable[nOutput] == nullptr) {
+			printf(" %d: Linear\n", static_cast<int>(nOutput + 1));
+		} else {
+			printf(" %d: Mapped, first LED %d\n", static_cast<int>(nOutput + 1), m_pTable[nOutput][0]);
+		}
+	}
+}
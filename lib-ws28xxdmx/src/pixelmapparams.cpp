@@ -0,0 +1,261 @@
+/**
+ * @file pixelmapparams.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if !defined(__clang__)	// Needed for compiling on MacOS
+ #pragma GCC push_options
+ #pragma GCC optimize ("Os")
+#endif
+
+#include <stdint.h>
+#include <string.h>
+#ifndef NDEBUG
+ #include <stdio.h>
+#endif
+#include <cassert>
+
+#include "pixelmap.h"
+
+#include "ws28xx.h"
+
+#include "readconfigfile.h"
+#include "sscan.h"
+
+namespace pixelmap {
+static constexpr char FILE_NAME[] = "pixelmap.txt";
+static constexpr char OUTPUT[] = "output";
+static constexpr char WIDTH[] = "width";
+static constexpr char HEIGHT[] = "height";
+static constexpr char START[] = "start";
+static constexpr char VERTICAL[] = "vertical";
+static constexpr char SERPENTINE[] = "serpentine";
+static constexpr char OFFSET[] = "offset";
+static constexpr char REVERSE[] = "reverse";
+static constexpr char MAP[] = "map";
+static constexpr const char *START_NAMES[] = { "top_left", "top_right", "bottom_left", "bottom_right" };
+}  // namespace pixelmap
+
+bool PixelMap::Load() {
+	Reset();
+
+	ReadConfigFile configfile(PixelMap::staticCallbackFunction, this);
+
+	if (!configfile.Read(pixelmap::FILE_NAME)) {
+		return false;
+	}
+
+	if (m_nLedCount != 0) {
+		Compile(m_nOutputs, m_nLedCount);
+	}
+
+	return true;
+}
+
+void PixelMap::Load(const char *pBuffer, uint32_t nLength) {
+	assert(pBuffer != nullptr);
+	assert(nLength != 0);
+
+	Reset();
+
+	ReadConfigFile config(PixelMap::staticCallbackFunction, this);
+
+	config.Read(pBuffer, nLength);
+
+	if (m_nLedCount != 0) {
+		Compile(m_nOutputs, m_nLedCount);
+	}
+}
+
+void PixelMap::AddEntry(uint16_t nLed) {
+	if (m_pEntries[m_nSlot] == nullptr) {
+		m_pEntries[m_nSlot] = new uint16_t[LEDCOUNT_RGB_MAX];
+		assert(m_pEntries[m_nSlot] != nullptr);
+	}
+
+	if (m_aEntriesCount[m_nSlot] < LEDCOUNT_RGB_MAX) {
+		m_pEntries[m_nSlot][m_aEntriesCount[m_nSlot]++] = nLed;
+	}
+}
+
+/*
+ * Comma separated: LED index, range (ascending or descending) or x for a skipped pixel.
+ * Example: 0-15,31-16,x,32
+ */
+void PixelMap::AddEntries(const char *pList) {
+	while (*pList != '\0') {
+		if ((*pList == 'x') || (*pList == 'X')) {
+			AddEntry(PixelMapConst::SKIP);
+			pList++;
+		} else if ((*pList >= '0') && (*pList <= '9')) {
+			uint32_t nFirst = 0;
+
+			while ((*pList >= '0') && (*pList <= '9')) {
+				nFirst = (nFirst * 10) + static_cast<uint32_t>(*pList++ - '0');
+			}
+
+			uint32_t nLast = nFirst;
+
+			if (*pList == '-') {
+				pList++;
+				nLast = 0;
+
+				while ((*pList >= '0') && (*pList <= '9')) {
+					nLast = (nLast * 10) + static_cast<uint32_t>(*pList++ - '0');
+				}
+			}
+
+			if ((nFirst >= LEDCOUNT_RGB_MAX) || (nLast >= LEDCOUNT_RGB_MAX)) {
+				AddEntry(PixelMapConst::SKIP);
+			} else if (nFirst <= nLast) {
+				for (uint32_t i = nFirst; i <= nLast; i++) {
+					AddEntry(static_cast<uint16_t>(i));
+				}
+			} else {
+				for (uint32_t i = nFirst + 1; i > nLast; i--) {
+					AddEntry(static_cast<uint16_t>(i - 1));
+				}
+			}
+		} else {
+			// Separator or white space
+			pList++;
+		}
+	}
+}
+
+void PixelMap::callbackFunction(const char *pLine) {
+	assert(pLine != nullptr);
+
+	uint8_t nValue8;
+	uint16_t nValue16;
+	char aBuffer[16];
+
+	if (Sscan::Uint8(pLine, pixelmap::OUTPUT, nValue8) == Sscan::OK) {
+		if ((nValue8 != 0) && (nValue8 <= PixelMapConst::MAX_OUTPUTS)) {
+			m_nSlot = static_cast<uint32_t>(nValue8 - 1);
+		} else {
+			m_nSlot = ALL_OUTPUTS;
+		}
+		return;
+	}
+
+	TLayout &Layout = m_aLayout[m_nSlot];
+
+	if (Sscan::Uint16(pLine, pixelmap::WIDTH, nValue16) == Sscan::OK) {
+		if (nValue16 <= LEDCOUNT_RGB_MAX) {
+			Layout.nWidth = nValue16;
+			Layout.bIsSet = true;
+		}
+		return;
+	}
+
+	if (Sscan::Uint16(pLine, pixelmap::HEIGHT, nValue16) == Sscan::OK) {
+		if ((nValue16 != 0) && (nValue16 <= LEDCOUNT_RGB_MAX)) {
+			Layout.nHeight = nValue16;
+			Layout.bIsSet = true;
+		}
+		return;
+	}
+
+	uint32_t nLength = sizeof(aBuffer) - 1;
+	if (Sscan::Char(pLine, pixelmap::START, aBuffer, nLength) == Sscan::OK) {
+		aBuffer[nLength] = '\0';
+
+		for (uint32_t i = 0; i < sizeof(pixelmap::START_NAMES) / sizeof(pixelmap::START_NAMES[0]); i++) {
+			if (strcmp(aBuffer, pixelmap::START_NAMES[i]) == 0) {
+				Layout.tStart = static_cast<PixelMapStart>(i);
+				Layout.bIsSet = true;
+				break;
+			}
+		}
+		return;
+	}
+
+	if (Sscan::Uint8(pLine, pixelmap::VERTICAL, nValue8) == Sscan::OK) {
+		Layout.bVertical = (nValue8 != 0);
+		Layout.bIsSet = true;
+		return;
+	}
+
+	if (Sscan::Uint8(pLine, pixelmap::SERPENTINE, nValue8) == Sscan::OK) {
+		Layout.bSerpentine = (nValue8 != 0);
+		Layout.bIsSet = true;
+		return;
+	}
+
+	if (Sscan::Uint16(pLine, pixelmap::OFFSET, nValue16) == Sscan::OK) {
+		if (nValue16 < LEDCOUNT_RGB_MAX) {
+			Layout.nOffset = nValue16;
+			Layout.bIsSet = true;
+		}
+		return;
+	}
+
+	if (Sscan::Uint8(pLine, pixelmap::REVERSE, nValue8) == Sscan::OK) {
+		Layout.bReverse = (nValue8 != 0);
+		Layout.bIsSet = true;
+		return;
+	}
+
+	const auto nMapLength = sizeof(pixelmap::MAP) - 1;
+
+	if ((strncmp(pLine, pixelmap::MAP, nMapLength) == 0) && (pLine[nMapLength] == '=')) {
+		AddEntries(&pLine[nMapLength + 1]);
+		return;
+	}
+}
+
+void PixelMap::Dump() {
+#ifndef NDEBUG
+	printf("%s::%s \'%s\':\n", __FILE__, __FUNCTION__, pixelmap::FILE_NAME);
+
+	for (uint32_t i = 0; i < SLOTS; i++) {
+		const TLayout &Layout = m_aLayout[i];
+
+		if (!Layout.bIsSet && (m_aEntriesCount[i] == 0)) {
+			continue;
+		}
+
+		if (i == ALL_OUTPUTS) {
+			printf(" All outputs\n");
+		} else {
+			printf(" %s=%d\n", pixelmap::OUTPUT, static_cast<int>(i + 1));
+		}
+
+		if (m_aEntriesCount[i] != 0) {
+			printf("  %s: %d entries\n", pixelmap::MAP, static_cast<int>(m_aEntriesCount[i]));
+			continue;
+		}
+
+		printf("  %s=%d, %s=%d, %s=%s\n", pixelmap::WIDTH, Layout.nWidth, pixelmap::HEIGHT, Layout.nHeight, pixelmap::START, pixelmap::START_NAMES[static_cast<uint32_t>(Layout.tStart)]);
+		printf("  %s=%d, %s=%d, %s=%d, %s=%d\n", pixelmap::VERTICAL, static_cast<int>(Layout.bVertical), pixelmap::SERPENTINE, static_cast<int>(Layout.bSerpentine), pixelmap::OFFSET, Layout.nOffset, pixelmap::REVERSE, static_cast<int>(Layout.bReverse));
+	}
+#endif
+}
+
+void PixelMap::staticCallbackFunction(void *p, const char *s) {
+	assert(p != nullptr);
+	assert(s != nullptr);
+
+	(static_cast<PixelMap*>(p))->callbackFunction(s);
+}
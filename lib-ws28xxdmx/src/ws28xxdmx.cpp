@@ -24,6 +24,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include <cassert>
 
 #ifndef NDEBUG
@@ -34,6 +35,9 @@
 
 #include "ws28xxdmx.h"
 #include "ws28xx.h"
+#if defined (H3)
+ #include "h3/ws28xxdma.h"
+#endif
 
 #include "lightset.h"
 #include "lightsetdisplay.h"
@@ -54,13 +58,18 @@ WS28xxDmx::WS28xxDmx(void) :
 	m_bIsStarted(false),
 	m_bBlackout(false),
 	m_pWS28xxDmxStore(0),
+	m_bHDR(false),
+	m_bRgbwFromRgb(false),
+	m_bRefresh(false),
 	m_nClockSpeedHz(0),
 	m_nGlobalBrightness(0xFF),
 	m_nBeginIndexPortId1(170),
 	m_nBeginIndexPortId2(340),
 	m_nBeginIndexPortId3(510),
 	m_nChannelsPerLed(3),
-	m_nPortIdLast(3)
+	m_nColours(3),
+	m_nPortIdLast(3),
+	m_pDitherData(0)
 {
 	UpdateMembers();
 }
@@ -68,6 +77,9 @@ WS28xxDmx::WS28xxDmx(void) :
 WS28xxDmx::~WS28xxDmx(void) {
 	delete m_pLEDStripe;
 	m_pLEDStripe = 0;
+
+	delete [] m_pDitherData;
+	m_pDitherData = 0;
 }
 
 void WS28xxDmx::Start(__attribute__((unused)) uint8_t nPort) {
@@ -78,14 +90,15 @@ void WS28xxDmx::Start(__attribute__((unused)) uint8_t nPort) {
 	m_bIsStarted = true;
 
 	if (m_pLEDStripe == 0) {
+#if defined (H3)
+		m_pLEDStripe = new WS28xxDMA(m_tLedType, m_nLedCount, m_tRGBMapping, m_nLowCode, m_nHighCode, m_nClockSpeedHz);
+#else
 		m_pLEDStripe = new WS28xx(m_tLedType, m_nLedCount, m_tRGBMapping, m_nLowCode, m_nHighCode, m_nClockSpeedHz);
+#endif
 		assert(m_pLEDStripe != 0);
 		m_pLEDStripe->SetGlobalBrightness(m_nGlobalBrightness);
 		m_pLEDStripe->Initialize();
 	} else {
-		while (m_pLEDStripe->IsUpdating()) {
-			// wait for completion
-		}
 		m_pLEDStripe->Update();
 	}
 }
@@ -98,9 +111,6 @@ void WS28xxDmx::Stop(__attribute__((unused)) uint8_t nPort) {
 	m_bIsStarted = false;
 
 	if (m_pLEDStripe != 0) {
-		while (m_pLEDStripe->IsUpdating()) {
-			// wait for completion
-		}
 		m_pLEDStripe->Blackout();
 	}
 }
@@ -147,42 +157,116 @@ void WS28xxDmx::SetData(uint8_t nPortId, const uint8_t *pData, uint16_t nLength)
 #endif
 #endif
 
-	while (m_pLEDStripe->IsUpdating()) {
-		// wait for completion
-	}
+	// The LEDs are set in the back buffer, while the previous frame can still be sent
+	m_pLEDStripe->Run();
 
-	for (uint32_t j = beginIndex; j < endIndex; j++) {
-		__builtin_prefetch(&pData[i]);
-		if (m_tLedType == SK6812W) {
-			if (i + 3 > nLength) {
-				break;
-			}
-			m_pLEDStripe->SetLED(j, pData[i], pData[i + 1], pData[i + 2], pData[i + 3]);
-			i = i + 4;
-		} else {
-			if (i + 2 > nLength) {
-				break;
+	if ((endIndex > beginIndex) && (i < nLength)) {
+		const uint32_t nLEDs = MIN((endIndex - beginIndex), ((nLength - i) / m_nChannelsPerLed));
+
+		if (m_Colour.IsDithering() && !IsHDR()) {
+			if (m_pDitherData == 0) {
+				m_pDitherData = new uint8_t[m_nLedCount * m_nChannelsPerLed]();
+				assert(m_pDitherData != 0);
 			}
-			m_pLEDStripe->SetLED(j, pData[i], pData[i + 1], pData[i + 2]);
-			i = i + 3;
+
+			memcpy(&m_pDitherData[beginIndex * m_nChannelsPerLed], &pData[i], nLEDs * m_nChannelsPerLed);
 		}
+
+		SetLEDs(beginIndex, &pData[i], nLEDs);
 	}
 
+	// Not refreshed before the last universe, that would output a partial frame
+	m_bRefresh = (nPortId == m_nPortIdLast);
+
 	if (nPortId == m_nPortIdLast) {
 		m_pLEDStripe->Update();
 	}
 }
 
+/*
+ * The dithering phase is advanced for each LED refresh, not for each DMX frame:
+ * at 44 Hz DMX the 8 phases would cycle at about 5.5 Hz, which is visible as flicker.
+ * The refresh rate is the rate at which the strip can be sent.
+ */
+void WS28xxDmx::Run(void) {
+	if (m_pLEDStripe == 0) {
+		return;
+	}
+
+	if (!m_bRefresh || !m_bIsStarted || m_bBlackout || !m_Colour.IsDithering() || IsHDR()) {
+		m_pLEDStripe->Run();
+		return;
+	}
+
+	if (!m_pLEDStripe->IsUpdating()) {
+		m_Colour.NextFrame();
+		Refresh();
+		m_pLEDStripe->Update();
+	}
+}
+
+void WS28xxDmx::Refresh(void) {
+	if (m_pDitherData == 0) {
+		return;
+	}
+
+	const uint32_t nLEDs = MIN(m_nLedCount, ((m_nPortIdLast + 1) * m_nBeginIndexPortId1));
+
+	// One universe at the time, as SetData
+	for (uint32_t nLEDIndex = 0; nLEDIndex < nLEDs; nLEDIndex += m_nBeginIndexPortId1) {
+		SetLEDs(nLEDIndex, &m_pDitherData[nLEDIndex * m_nChannelsPerLed], MIN(m_nBeginIndexPortId1, (nLEDs - nLEDIndex)));
+	}
+}
+
+/*
+ * Converts the DMX data of nLEDs pixels into the LED colours: 16-bit input, gamma, dithering,
+ * the white derived from RGB, and the APA102 HDR brightness. Without conversion the data is set as is.
+ */
+void WS28xxDmx::SetLEDs(uint32_t nLEDIndex, const uint8_t *pData, uint32_t nLEDs) {
+	if (IsHDR()) {
+		uint16_t aColour[3];
+
+		for (uint32_t j = 0; j < nLEDs; j++) {
+			m_Colour.Convert16(&pData[j * m_nChannelsPerLed], aColour, 3);
+			m_pLEDStripe->SetLED16(nLEDIndex + j, aColour[0], aColour[1], aColour[2]);
+		}
+
+		return;
+	}
+
+	uint8_t aColour[DMX_UNIVERSE_SIZE];
+	uint8_t aRGBW[(DMX_UNIVERSE_SIZE / 3) * 4];
+
+	if (m_Colour.IsEnabled()) {
+		for (uint32_t j = 0; j < nLEDs; j++) {
+			m_Colour.Convert(&pData[j * m_nChannelsPerLed], &aColour[j * m_nColours], m_nColours, nLEDIndex + j);
+		}
+
+		pData = aColour;
+	}
+
+	if (IsRgbwFromRgb()) {
+		m_White.Convert(pData, aRGBW, nLEDs);
+		pData = aRGBW;
+	}
+
+	m_pLEDStripe->SetLEDs(nLEDIndex, pData, nLEDs);
+}
+
 void WS28xxDmx::SetLEDType(TWS28XXType type) {
 	m_tLedType = type;
 
-	if (type == SK6812W) {
-		m_nBeginIndexPortId1 = 128;
-		m_nBeginIndexPortId2 = 256;
-		m_nBeginIndexPortId3 = 384;
+	UpdateMembers();
+}
 
-		m_nChannelsPerLed = 4;
-	}
+void WS28xxDmx::SetRgbwFromRgb(bool bRgbwFromRgb) {
+	m_bRgbwFromRgb = bRgbwFromRgb;
+
+	UpdateMembers();
+}
+
+void WS28xxDmx::Set16Bit(bool b16Bit) {
+	m_Colour.Set16Bit(b16Bit);
 
 	UpdateMembers();
 }
@@ -194,22 +278,39 @@ void WS28xxDmx::SetLEDCount(uint16_t nCount) {
 }
 
 void WS28xxDmx::UpdateMembers(void) {
+	m_nColours = ((m_tLedType == SK6812W) && !m_bRgbwFromRgb) ? 4 : 3;
+	m_nChannelsPerLed = m_nColours;
+
+	if (m_Colour.Is16Bit()) {
+		m_nChannelsPerLed *= 2;
+	}
+
+	m_nBeginIndexPortId1 = DMX_UNIVERSE_SIZE / m_nChannelsPerLed;
+	m_nBeginIndexPortId2 = 2 * m_nBeginIndexPortId1;
+	m_nBeginIndexPortId3 = 3 * m_nBeginIndexPortId1;
+
 	m_nDmxFootprint = m_nLedCount * m_nChannelsPerLed;
 
 	if (m_nDmxFootprint > DMX_UNIVERSE_SIZE) {
 		m_nDmxFootprint = DMX_UNIVERSE_SIZE;
 	}
 
-	m_nPortIdLast = m_nLedCount / (1 + m_nBeginIndexPortId1);
+	m_nPortIdLast = (m_nLedCount == 0) ? 0 : (m_nLedCount - 1U) / m_nBeginIndexPortId1;
+
+	if (m_nPortIdLast > 3) {
+		// 16-bit input, the LEDs after the 4th universe are not addressed
+		m_nPortIdLast = 3;
+	}
+
+	// The size depends on the members, it is allocated again with the next DMX data
+	delete [] m_pDitherData;
+	m_pDitherData = 0;
+	m_bRefresh = false;
 }
 
 void WS28xxDmx::Blackout(bool bBlackout) {
 	m_bBlackout = bBlackout;
 
-	while (m_pLEDStripe->IsUpdating()) {
-		// wait for completion
-	}
-
 	if (bBlackout) {
 		m_pLEDStripe->Blackout();
 	} else {
@@ -252,7 +353,7 @@ bool WS28xxDmx::GetSlotInfo(uint16_t nSlotOffset, struct TLightSetSlotInfo& tSlo
 		return false;
 	}
 
-	if (m_tLedType == SK6812W) {
+	if ((m_tLedType == SK6812W) && !IsRgbwFromRgb()) {
 		nIndex = MOD(nSlotOffset, 4);
 	} else {
 		nIndex = MOD(nSlotOffset, 3);
@@ -61,9 +61,8 @@ void WS28xxDmxGrouping::SetData(__attribute__((unused)) uint8_t nPort, const uin
 		Start();
 	}
 
-	while (m_pLEDStripe->IsUpdating()) {
-		// wait for completion
-	}
+	// The LEDs are set in the back buffer, while the previous frame can still be sent
+	m_pLEDStripe->Run();
 
 	bool bIsChanged = false;
 
@@ -74,33 +73,65 @@ void WS28xxDmxGrouping::SetData(__attribute__((unused)) uint8_t nPort, const uin
 		}
 	}
 
-	if (bIsChanged) {
-		uint32_t i = 0;
-		uint32_t d = 0;
+	if (!bIsChanged) {
+		return;
+	}
+
+	Refresh();
+
+	m_bRefresh = true;
+
+	if (!m_bBlackout) {
+		m_pLEDStripe->Update();
+	}
+}
+
+void WS28xxDmxGrouping::Refresh(void) {
+	if (IsHDR()) {
+		const uint32_t nChannels = m_Colour.Is16Bit() ? 6 : 3;
+		uint16_t aColour[3];
+
+		for (uint32_t g = 0, i = 0, d = 0; g < m_nGroups; g++, i += m_nLEDGroupCount, d += nChannels) {
+			m_Colour.Convert16(&m_pDmxData[d], aColour, 3);
+			m_pLEDStripe->SetLEDGroup16(i, m_nLEDGroupCount, aColour[0], aColour[1], aColour[2]);
+		}
+
+		return;
+	}
+
+	uint32_t i = 0;
+	uint32_t d = 0;
+
+	const bool bRgbwFromRgb = IsRgbwFromRgb();
+	const uint32_t nColours = ((m_tLedType == SK6812W) && !bRgbwFromRgb) ? 4 : 3;
+	const uint32_t nChannels = m_Colour.Is16Bit() ? (2 * nColours) : nColours;
+	const bool bColour = m_Colour.IsEnabled();
+	uint8_t aColour[4];
+	uint8_t aRGBW[4];
+
+	for (uint32_t g = 0; g < m_nGroups; g++) {
+		__builtin_prefetch(&m_pDmxData[d]);
+
+		const uint8_t *pColour = &m_pDmxData[d];
+
+		if (bColour) {
+			m_Colour.Convert(pColour, aColour, nColours, g);
+			pColour = aColour;
+		}
+
+		if (bRgbwFromRgb) {
+			m_White.Convert(pColour, aRGBW, 1);
+			pColour = aRGBW;
+		}
 
 		if (m_tLedType == SK6812W) {
-			for (uint32_t g = 0; g < m_nGroups; g++) {
-				__builtin_prefetch(&m_pDmxData[d]);
-				for (uint32_t k = 0; k < m_nLEDGroupCount; k++) {
-					m_pLEDStripe->SetLED(k + i, m_pDmxData[d + 0], m_pDmxData[d + 1], m_pDmxData[d + 2], m_pDmxData[d + 3]);
-				}
-				i = i + m_nLEDGroupCount;
-				d = d + 4;
-			}
+			m_pLEDStripe->SetLEDGroup(i, m_nLEDGroupCount, pColour[0], pColour[1], pColour[2], pColour[3]);
 		} else {
-			for (uint32_t g = 0; g < m_nGroups; g++) {
-				__builtin_prefetch(&m_pDmxData[d]);
-				for (uint32_t k = 0; k < m_nLEDGroupCount; k++) {
-					m_pLEDStripe->SetLED(k + i, m_pDmxData[d + 0], m_pDmxData[d + 1], m_pDmxData[d + 2]);
-				}
-				i = i + m_nLEDGroupCount;
-				d = d + 3;
-			}
+			m_pLEDStripe->SetLEDGroup(i, m_nLEDGroupCount, pColour[0], pColour[1], pColour[2]);
 		}
 
-		if (!m_bBlackout) {
-			m_pLEDStripe->Update();
-		}
+		i = i + m_nLEDGroupCount;
+		d = d + nChannels;
 	}
 }
 
@@ -120,6 +151,22 @@ void WS28xxDmxGrouping::SetLEDCount(uint16_t nLedCount) {
 	UpdateMembers();
 }
 
+void WS28xxDmxGrouping::Set16Bit(bool b16Bit) {
+	DEBUG_PRINTF("b16Bit=%d", static_cast<int>(b16Bit));
+
+	m_Colour.Set16Bit(b16Bit);
+
+	UpdateMembers();
+}
+
+void WS28xxDmxGrouping::SetRgbwFromRgb(bool bRgbwFromRgb) {
+	DEBUG_PRINTF("bRgbwFromRgb=%d", static_cast<int>(bRgbwFromRgb));
+
+	m_bRgbwFromRgb = bRgbwFromRgb;
+
+	UpdateMembers();
+}
+
 void WS28xxDmxGrouping::SetLEDGroupCount(uint16_t nLedGroupCount) {
 	DEBUG_PRINTF("nLedGroupCount=%d", static_cast<int>(nLedGroupCount));
 
@@ -157,18 +204,18 @@ void WS28xxDmxGrouping::UpdateMembers(void) {
 
 	m_nGroups = m_nLedCount / m_nLEDGroupCount;
 
-	if (m_tLedType == SK6812W) {
-		if (m_nGroups > (DMX_UNIVERSE_SIZE / 4)) {
-			m_nGroups = DMX_UNIVERSE_SIZE / 4;
-		}
-		m_nDmxFootprint = m_nGroups * 4;
-	} else {
-		if (m_nGroups > (DMX_UNIVERSE_SIZE / 3)) {
-			m_nGroups = DMX_UNIVERSE_SIZE / 3;
-		}
-		m_nDmxFootprint = m_nGroups * 3;
+	uint32_t nChannels = ((m_tLedType == SK6812W) && !IsRgbwFromRgb()) ? 4 : 3;
+
+	if (m_Colour.Is16Bit()) {
+		nChannels *= 2;
+	}
+
+	if (m_nGroups > (DMX_UNIVERSE_SIZE / nChannels)) {
+		m_nGroups = DMX_UNIVERSE_SIZE / nChannels;
 	}
 
+	m_nDmxFootprint = static_cast<uint16_t>(m_nGroups * nChannels);
+
 	DEBUG_PRINTF("m_nLEDGroupCount=%d, m_nGroups=%d, m_nDmxFootprint=%d", static_cast<int>(m_nLEDGroupCount), static_cast<int>(m_nGroups), static_cast<int>(m_nDmxFootprint));
 }
 
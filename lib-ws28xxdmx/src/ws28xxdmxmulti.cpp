@@ -25,6 +25,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <cassert>
 
 #include "ws28xxdmxmulti.h"
@@ -34,6 +35,8 @@
 
 #include "rgbmapping.h"
 
+#include "hardware.h"
+
 #include "debug.h"
 
 #ifndef MIN
@@ -47,6 +50,8 @@ WS28xxDmxMulti::WS28xxDmxMulti(TWS28xxDmxMultiSrc tSrc):
 	m_nLowCode(0),
 	m_nHighCode(0),
 	m_nLedCount(170),
+	m_nLedGroupCount(1),
+	m_nPixels(170),
 	m_nActiveOutputs(1),
 	m_pLEDStripe(0),
 	m_bIsStarted(false),
@@ -56,8 +61,13 @@ WS28xxDmxMulti::WS28xxDmxMulti(TWS28xxDmxMultiSrc tSrc):
 	m_nBeginIndexPortId2(340),
 	m_nBeginIndexPortId3(510),
 	m_nChannelsPerLed(3),
-	m_nPortIdLast(3), // -> (m_nActiveOutputs * m_nUniverses) -1;
-	m_bUseSI5351A(false)
+	m_nColours(3),
+	m_bUseSI5351A(false),
+	m_bRgbwFromRgb(false),
+	m_pPixelMap(0),
+	m_nInterpolationMask(0),
+	m_pDitherData(0),
+	m_bRefresh(false)
 {
 	DEBUG_ENTRY
 
@@ -71,15 +81,20 @@ WS28xxDmxMulti::WS28xxDmxMulti(TWS28xxDmxMultiSrc tSrc):
 WS28xxDmxMulti::~WS28xxDmxMulti(void) {
 	delete m_pLEDStripe;
 	m_pLEDStripe = 0;
+
+	delete [] m_pDitherData;
+	m_pDitherData = 0;
 }
 
 void WS28xxDmxMulti::Initialize(void) {
 	assert(m_pLEDStripe != 0);
 
 	m_pLEDStripe->Initialize(m_tLedType, m_nLedCount, m_tRGBMapping, m_nLowCode, m_nHighCode, m_bUseSI5351A);
+	m_pLEDStripe->SetLEDGroupCount(m_nLedGroupCount);
+	m_pLEDStripe->SetInterpolation(static_cast<uint8_t>(m_nInterpolationMask & ((1U << m_nActiveOutputs) - 1)));
 
-	while (m_pLEDStripe->IsUpdating()) {
-		// wait for completion
+	if ((m_pPixelMap != 0) && (m_nLedGroupCount == 1)) {
+		m_pPixelMap->Compile(m_nActiveOutputs, m_pLEDStripe->GetLEDCount());
 	}
 
 	m_pLEDStripe->Blackout();
@@ -96,10 +111,6 @@ void WS28xxDmxMulti::Start(__attribute__((unused)) uint8_t nPort) {
 
 	m_bIsStarted = true;
 
-	while (m_pLEDStripe->IsUpdating()) {
-		// wait for completion
-	}
-
 	m_pLEDStripe->Update();
 }
 
@@ -114,10 +125,6 @@ void WS28xxDmxMulti::Stop(__attribute__((unused)) uint8_t nPort) {
 
 	m_bIsStarted = false;
 
-	while (m_pLEDStripe->IsUpdating()) {
-		// wait for completion
-	}
-
 	m_pLEDStripe->Blackout();
 }
 
@@ -126,76 +133,174 @@ void WS28xxDmxMulti::SetData(uint8_t nPortId, const uint8_t* pData, uint16_t nLe
 	assert(nLength <= DMX_UNIVERSE_SIZE);
 	assert(m_pLEDStripe != 0);
 
-	uint32_t i = 0;
+	uint32_t nOutIndex, nUniverse;
+
+	if (m_tSrc == WS28XXDMXMULTI_SRC_E131) {
+		nOutIndex = nPortId / m_nUniverses;
+		nUniverse = nPortId - (nOutIndex * m_nUniverses);
+	} else {
+		nOutIndex = nPortId / 4;
+		nUniverse = nPortId & 0x03;
+	}
+
+	m_pLEDStripe->Run();
+
+	if (m_Colour.IsDithering() && (nOutIndex < m_nActiveOutputs) && (nUniverse < m_nUniverses)) {
+		if (m_pDitherData == 0) {
+			m_pDitherData = new uint8_t[m_nActiveOutputs * m_nUniverses * DMX_UNIVERSE_SIZE];
+			assert(m_pDitherData != 0);
+		}
+
+		// Kept for the dithering refresh
+		const uint32_t nIndex = (nOutIndex * m_nUniverses) + nUniverse;
+		memcpy(&m_pDitherData[nIndex * DMX_UNIVERSE_SIZE], pData, nLength);
+		m_aDitherLength[nIndex] = nLength;
+	}
+
+	SetUniverse(nOutIndex, nUniverse, pData, nLength);
+
+	if (m_FrameAssembler.Received(nOutIndex, nUniverse, Hardware::Get()->Millis())) {
+		Output();
+	}
+}
+
+/*
+ * Converts the DMX data of one universe and stages it, Encode writes it into the back buffer
+ */
+void WS28xxDmxMulti::SetUniverse(uint32_t nOutIndex, uint32_t nUniverse, const uint8_t *pData, uint16_t nLength) {
 	uint32_t beginIndex, endIndex;
 
-	switch (nPortId & ~static_cast<uint8_t>(m_nUniverses) & 0x03) {
+	switch (nUniverse & 0x03) {
 	case 0:
 		beginIndex = 0;
-		endIndex = MIN(m_nLedCount, (nLength / m_nChannelsPerLed));
+		endIndex = MIN(m_nPixels, (nLength / m_nChannelsPerLed));
 		break;
 	case 1:
 		beginIndex = m_nBeginIndexPortId1;
-		endIndex = MIN(m_nLedCount, (beginIndex + (nLength / m_nChannelsPerLed)));
+		endIndex = MIN(m_nPixels, (beginIndex + (nLength / m_nChannelsPerLed)));
 		break;
 	case 2:
 		beginIndex = m_nBeginIndexPortId2;
-		endIndex = MIN(m_nLedCount, (beginIndex + (nLength / m_nChannelsPerLed)));
+		endIndex = MIN(m_nPixels, (beginIndex + (nLength / m_nChannelsPerLed)));
 		break;
 	case 3:
 		beginIndex = m_nBeginIndexPortId3;
-		endIndex = MIN(m_nLedCount, (beginIndex + (nLength / m_nChannelsPerLed)));
+		endIndex = MIN(m_nPixels, (beginIndex + (nLength / m_nChannelsPerLed)));
 		break;
 	default:
 		__builtin_unreachable();
 		break;
 	}
 
-	uint32_t nOutIndex;
+	DEBUG_PRINTF("nLength=%d, nOutIndex=%d, nUniverse=%d, beginIndex=%d, endIndex=%d",
+			static_cast<int>(nLength), static_cast<int>(nOutIndex),
+			static_cast<int>(nUniverse), static_cast<int>(beginIndex), static_cast<int>(endIndex));
 
-	if (m_tSrc == WS28XXDMXMULTI_SRC_E131) {
-		nOutIndex = nPortId / m_nUniverses;
-	} else {
-		nOutIndex = nPortId / 4;
+	if (endIndex > beginIndex) {
+		const uint32_t nLeds = endIndex - beginIndex;
+		uint8_t aCorrected[DMX_UNIVERSE_SIZE];
+		uint8_t aRGBW[(DMX_UNIVERSE_SIZE / 3) * 4];
+
+		// With 16-bit input the pairs are reduced to one byte per colour
+		if (m_Colour.IsEnabled()) {
+			for (uint32_t i = 0; i < nLeds; i++) {
+				m_Colour.Convert(&pData[i * m_nChannelsPerLed], &aCorrected[i * m_nColours], m_nColours, beginIndex + i);
+			}
+
+			pData = aCorrected;
+		}
+
+		if (IsRgbwFromRgb()) {
+			m_White.Convert(pData, aRGBW, nLeds);
+			pData = aRGBW;
+		}
+
+		const uint16_t *pMap = (m_pPixelMap != 0) ? m_pPixelMap->GetTable(nOutIndex) : 0;
+
+		// Staged only, Encode writes into the back buffer
+		if (m_nLedGroupCount > 1) {
+			m_pLEDStripe->SetPortGroupData(static_cast<uint8_t>(nOutIndex), beginIndex, pData, nLeds);
+		} else if (pMap == 0) {
+			m_pLEDStripe->SetPortData(static_cast<uint8_t>(nOutIndex), beginIndex, pData, nLeds);
+		} else {
+			m_pLEDStripe->SetPortData(static_cast<uint8_t>(nOutIndex), beginIndex, pData, nLeds, pMap);
+		}
 	}
+}
 
-	DEBUG_PRINTF("nPort=%d, nLength=%d, nOutIndex=%d, nPortId=%d, beginIndex=%d, endIndex=%d",
-			static_cast<int>(nPortId), static_cast<int>(nLength), static_cast<int>(nOutIndex),
-			static_cast<int>(nPortId) & ~m_nUniverses & 0x03, static_cast<int>(beginIndex), static_cast<int>(endIndex));
+void WS28xxDmxMulti::Sync(void) {
+	if (m_FrameAssembler.Sync(Hardware::Get()->Millis())) {
+		Output();
+	}
+}
 
-	while (m_pLEDStripe->IsUpdating()) {
-		// wait for completion
+/**
+ * Outputs the timed out and the deferred (max FPS) frames.
+ * When interpolating, the next blend is output as soon as the previous one is sent.
+ * With dithering (8x), the last frame is output again with the next dithering phase as soon as the previous one is sent,
+ * the phase is advanced for each LED refresh and not for each DMX frame. The 4x output is blocking, it is not refreshed.
+ */
+void WS28xxDmxMulti::Run(void) {
+	m_pLEDStripe->Run();
+
+	const uint32_t nMillis = Hardware::Get()->Millis();
+
+	if (m_FrameAssembler.Run(nMillis)) {
+		Output();
 	}
 
-	for (uint32_t j = beginIndex; j < endIndex; j++) {
-		__builtin_prefetch(&pData[i]);
-		if (m_tLedType == SK6812W) {
-			if (i + 3 > nLength) {
-				break;
-			}
-			m_pLEDStripe->SetLED(nOutIndex, j, pData[i], pData[i + 1], pData[i + 2], pData[i + 3]);
-			i = i + 4;
-		} else {
-			if (i + 2 > nLength) {
-				break;
+	if (!m_bIsStarted || m_bBlackout) {
+		return;
+	}
+
+	if (m_pLEDStripe->IsInterpolation()) {
+		if (!m_pLEDStripe->IsFramePending() && m_pLEDStripe->Interpolate(nMillis)) {
+			m_pLEDStripe->Encode();
+			m_pLEDStripe->Update();
+		}
+		return;
+	}
+
+	if (m_bRefresh && m_Colour.IsDithering() && (m_pLEDStripe->GetBoard() == WS28XXMULTI_BOARD_8X)
+			&& m_FrameAssembler.IsIdle() && !m_pLEDStripe->IsUpdating()) {
+		m_Colour.NextFrame();
+		Refresh();
+		m_pLEDStripe->Encode();
+		m_pLEDStripe->Update();
+	}
+}
+
+void WS28xxDmxMulti::Refresh(void) {
+	if (m_pDitherData == 0) {
+		return;
+	}
+
+	for (uint32_t nOutIndex = 0; nOutIndex < m_nActiveOutputs; nOutIndex++) {
+		for (uint32_t nUniverse = 0; nUniverse < m_nUniverses; nUniverse++) {
+			const uint32_t nIndex = (nOutIndex * m_nUniverses) + nUniverse;
+
+			if (m_aDitherLength[nIndex] != 0) {
+				SetUniverse(nOutIndex, nUniverse, &m_pDitherData[nIndex * DMX_UNIVERSE_SIZE], m_aDitherLength[nIndex]);
 			}
-			m_pLEDStripe->SetLED(nOutIndex, j, pData[i], pData[i + 1], pData[i + 2]);
-			i = i + 3;
 		}
 	}
+}
 
-	if (nPortId == m_nPortIdLast) {
+void WS28xxDmxMulti::Output(void) {
+	if (m_pLEDStripe->IsInterpolation()) {
+		// The blend towards the new frame is output by Run
+		m_pLEDStripe->Latch(Hardware::Get()->Millis());
+	} else {
+		m_pLEDStripe->Encode();
 		m_pLEDStripe->Update();
 	}
+
+	m_bRefresh = true;
 }
 
 void WS28xxDmxMulti::Blackout(bool bBlackout) {
 	m_bBlackout = bBlackout;
 
-	while (m_pLEDStripe->IsUpdating()) {
-		// wait for completion
-	}
-
 	if (bBlackout) {
 		m_pLEDStripe->Blackout();
 	} else {
@@ -208,13 +313,25 @@ void WS28xxDmxMulti::SetLEDType(TWS28XXType tWS28xxMultiType) {
 
 	m_tLedType = tWS28xxMultiType;
 
-	if (tWS28xxMultiType == SK6812W) {
-		m_nBeginIndexPortId1 = 128;
-		m_nBeginIndexPortId2 = 256;
-		m_nBeginIndexPortId3 = 384;
+	UpdateMembers();
 
-		m_nChannelsPerLed = 4;
-	}
+	DEBUG_EXIT
+}
+
+void WS28xxDmxMulti::SetRgbwFromRgb(bool bRgbwFromRgb) {
+	DEBUG_ENTRY
+
+	m_bRgbwFromRgb = bRgbwFromRgb;
+
+	UpdateMembers();
+
+	DEBUG_EXIT
+}
+
+void WS28xxDmxMulti::Set16Bit(bool b16Bit) {
+	DEBUG_ENTRY
+
+	m_Colour.Set16Bit(b16Bit);
 
 	UpdateMembers();
 
@@ -231,6 +348,16 @@ void WS28xxDmxMulti::SetLEDCount(uint16_t nLedCount) {
 	DEBUG_EXIT
 }
 
+void WS28xxDmxMulti::SetLEDGroupCount(uint16_t nLedGroupCount) {
+	DEBUG_ENTRY
+
+	m_nLedGroupCount = nLedGroupCount;
+
+	UpdateMembers();
+
+	DEBUG_EXIT
+}
+
 void WS28xxDmxMulti::SetActivePorts(uint8_t nActiveOutputs) {
 	DEBUG_ENTRY
 
@@ -244,15 +371,39 @@ void WS28xxDmxMulti::SetActivePorts(uint8_t nActiveOutputs) {
 }
 
 void WS28xxDmxMulti::UpdateMembers(void) {
-	m_nUniverses = 1 + (m_nLedCount / (1 + m_nBeginIndexPortId1));
+	m_nColours = ((m_tLedType == SK6812W) && !m_bRgbwFromRgb) ? 4 : 3;
+	m_nChannelsPerLed = m_nColours;
 
-	if (m_tSrc == WS28XXDMXMULTI_SRC_E131) {
-		m_nPortIdLast = (m_nActiveOutputs * m_nUniverses)  - 1;
-	} else {
-		m_nPortIdLast = ((m_nActiveOutputs - 1) * 4) + m_nUniverses - 1;
+	if (m_Colour.Is16Bit()) {
+		m_nChannelsPerLed *= 2;
+	}
+
+	// 170 LEDs per universe, 128 for RGBW, half of it with 16-bit input
+	m_nBeginIndexPortId1 = DMX_UNIVERSE_SIZE / m_nChannelsPerLed;
+	m_nBeginIndexPortId2 = 2 * m_nBeginIndexPortId1;
+	m_nBeginIndexPortId3 = 3 * m_nBeginIndexPortId1;
+
+	if ((m_nLedGroupCount == 0) || (m_nLedGroupCount > m_nLedCount)) {
+		m_nLedGroupCount = m_nLedCount;
+	}
+
+	m_nPixels = (m_nLedCount + m_nLedGroupCount - 1) / m_nLedGroupCount;
+	m_nUniverses = 1 + ((m_nPixels - 1) / m_nBeginIndexPortId1);
+
+	if (m_nUniverses > 4) {
+		// 16-bit input, the pixels after the 4th universe are not addressed
+		m_nUniverses = 4;
 	}
 
-	DEBUG_PRINTF("m_tLedType=%d, m_nLedCount=%d, m_nUniverses=%d, m_nPortIndexLast=%d", static_cast<int>(m_tLedType), static_cast<int>(m_nLedCount), static_cast<int>(m_nUniverses), static_cast<int>(m_nPortIdLast));
+	m_FrameAssembler.Setup(m_nActiveOutputs, m_nUniverses);
+
+	// The size depends on the members, it is allocated again with the next DMX data
+	delete [] m_pDitherData;
+	m_pDitherData = 0;
+	memset(m_aDitherLength, 0, sizeof(m_aDitherLength));
+	m_bRefresh = false;
+
+	DEBUG_PRINTF("m_tLedType=%d, m_nLedCount=%d, m_nUniverses=%d", static_cast<int>(m_tLedType), static_cast<int>(m_nLedCount), static_cast<int>(m_nUniverses));
 }
 
 void WS28xxDmxMulti::Print(void) {
@@ -264,9 +415,33 @@ void WS28xxDmxMulti::Print(void) {
 	printf(" T0H     : %.2f [0x%X]\n", WS28xx::ConvertTxH(m_pLEDStripe->GetLowCode()), m_pLEDStripe->GetLowCode());
 	printf(" T1H     : %.2f [0x%X]\n", WS28xx::ConvertTxH(m_pLEDStripe->GetHighCode()), m_pLEDStripe->GetHighCode());
 	printf(" Count   : %d\n", m_nLedCount);
+	if (m_nLedGroupCount > 1) {
+		printf(" Group   : %d [%d groups]\n", static_cast<int>(m_nLedGroupCount), static_cast<int>(m_nPixels));
+	}
 	printf(" Outputs : %d\n", m_nActiveOutputs);
 	printf(" Board   : %dx\n", m_pLEDStripe->GetBoard() == WS28XXMULTI_BOARD_4X ? 4 : 8);
 	if (m_pLEDStripe->GetBoard() == WS28XXMULTI_BOARD_4X) {
 		printf("  SI5351A : %c\n", m_bUseSI5351A ? 'Y' : 'N');
 	}
+
+	if (Is16Bit()) {
+		printf(" Input   : 16-bit\n");
+	}
+
+	if (IsRgbwFromRgb()) {
+		printf(" Input   : RGB, W is derived\n");
+		m_White.Print();
+	}
+
+	m_Colour.Print();
+
+	m_FrameAssembler.Print();
+
+	if (m_pLEDStripe->IsInterpolation()) {
+		printf(" Interpolation : 0x%.2x\n", m_nInterpolationMask);
+	}
+
+	if (m_pPixelMap != 0) {
+		m_pPixelMap->Print();
+	}
 }
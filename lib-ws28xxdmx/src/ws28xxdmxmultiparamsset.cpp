@@ -51,6 +51,10 @@ void WS28xxDmxParams::Set(WS28xxDmxMulti *pWS28xxDmxMulti) {
 		pWS28xxDmxMulti->SetLEDCount(m_tWS28xxParams.nLedCount);
 	}
 
+	if (isMaskSet(WS28xxDmxParamsMask::LED_GROUPING) && m_tWS28xxParams.bLedGrouping) {
+		pWS28xxDmxMulti->SetLEDGroupCount(m_tWS28xxParams.nLedGroupCount);
+	}
+
 	if (isMaskSet(WS28xxDmxParamsMask::ACTIVE_OUT)) {
 		pWS28xxDmxMulti->SetActivePorts(m_tWS28xxParams.nActiveOutputs);
 	}
@@ -58,4 +62,38 @@ void WS28xxDmxParams::Set(WS28xxDmxMulti *pWS28xxDmxMulti) {
 	if (isMaskSet(WS28xxDmxParamsMask::USE_SI5351A)) {
 		pWS28xxDmxMulti->SetUseSI5351A(m_tWS28xxParams.bUseSI5351A);
 	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::RGBW_FROM_RGB)) {
+		pWS28xxDmxMulti->SetRgbwFromRgb(m_tWS28xxParams.bRgbwFromRgb);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::WHITE_POINT)) {
+		pWS28xxDmxMulti->SetWhitePoint(m_tWS28xxParams.aWhitePoint[WS28xxColourChannel::RED], m_tWS28xxParams.aWhitePoint[WS28xxColourChannel::GREEN], m_tWS28xxParams.aWhitePoint[WS28xxColourChannel::BLUE]);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::GAMMA)) {
+		for (uint32_t i = 0; i < WS28xxColourChannel::MAX; i++) {
+			pWS28xxDmxMulti->SetGamma(i, GetGamma(i));
+		}
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::PIXEL_16BIT)) {
+		pWS28xxDmxMulti->Set16Bit(m_tWS28xxParams.b16Bit);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::DITHERING)) {
+		pWS28xxDmxMulti->SetDithering(m_tWS28xxParams.bDithering);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::MAX_FPS)) {
+		pWS28xxDmxMulti->SetMaxFps(m_tWS28xxParams.nMaxFps);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::FRAME_TIMEOUT)) {
+		pWS28xxDmxMulti->SetFrameTimeout(m_tWS28xxParams.nFrameTimeout);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::INTERPOLATION)) {
+		pWS28xxDmxMulti->SetInterpolation(m_tWS28xxParams.nInterpolation);
+	}
 }
@@ -44,6 +44,7 @@
 #include "ws28xx.h"
 #include "ws28xxconst.h"
 #include "ws28xxdmx.h"
+#include "frameassembler.h"
 
 #include "rgbmapping.h"
 
@@ -69,6 +70,15 @@ WS28xxDmxParams::WS28xxDmxParams(WS28xxDmxParamsStore *pWS28XXStripeParamsStore)
 	m_tWS28xxParams.nRgbMapping = RGB_MAPPING_UNDEFINED;
 	m_tWS28xxParams.nLowCode = 0;
 	m_tWS28xxParams.nHighCode = 0;
+	memset(m_tWS28xxParams.aGamma, 10, sizeof(m_tWS28xxParams.aGamma));
+	m_tWS28xxParams.b16Bit = false;
+	m_tWS28xxParams.bDithering = false;
+	m_tWS28xxParams.nMaxFps = 0;
+	m_tWS28xxParams.nFrameTimeout = FrameAssemblerConst::TIMEOUT_MILLIS_DEFAULT;
+	m_tWS28xxParams.bHDR = false;
+	m_tWS28xxParams.nInterpolation = 0;
+	m_tWS28xxParams.bRgbwFromRgb = false;
+	memset(m_tWS28xxParams.aWhitePoint, 0xFF, sizeof(m_tWS28xxParams.aWhitePoint));
 }
 
 WS28xxDmxParams::~WS28xxDmxParams() {
@@ -185,6 +195,97 @@ void WS28xxDmxParams::callbackFunction(const char *pLine) {
 		return;
 	}
 
+	if (Sscan::Float(pLine, DevicesParamsConst::LED_GAMMA, fValue) == Sscan::OK) {
+		SetGamma(WS28xxColourChannel::RED, WS28xxColourChannel::WHITE, fValue);
+		return;
+	}
+
+	if (Sscan::Float(pLine, DevicesParamsConst::LED_GAMMA_RED, fValue) == Sscan::OK) {
+		SetGamma(WS28xxColourChannel::RED, WS28xxColourChannel::RED, fValue);
+		return;
+	}
+
+	if (Sscan::Float(pLine, DevicesParamsConst::LED_GAMMA_GREEN, fValue) == Sscan::OK) {
+		SetGamma(WS28xxColourChannel::GREEN, WS28xxColourChannel::GREEN, fValue);
+		return;
+	}
+
+	if (Sscan::Float(pLine, DevicesParamsConst::LED_GAMMA_BLUE, fValue) == Sscan::OK) {
+		SetGamma(WS28xxColourChannel::BLUE, WS28xxColourChannel::BLUE, fValue);
+		return;
+	}
+
+	if (Sscan::Float(pLine, DevicesParamsConst::LED_GAMMA_WHITE, fValue) == Sscan::OK) {
+		SetGamma(WS28xxColourChannel::WHITE, WS28xxColourChannel::WHITE, fValue);
+		return;
+	}
+
+	if (Sscan::Uint8(pLine, DevicesParamsConst::LED_RGBW_FROM_RGB, nValue8) == Sscan::OK) {
+		m_tWS28xxParams.bRgbwFromRgb = (nValue8 != 0);
+		m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::RGBW_FROM_RGB;
+		return;
+	}
+
+	if (Sscan::Uint8(pLine, DevicesParamsConst::LED_WHITE_POINT_RED, nValue8) == Sscan::OK) {
+		SetWhitePoint(WS28xxColourChannel::RED, nValue8);
+		return;
+	}
+
+	if (Sscan::Uint8(pLine, DevicesParamsConst::LED_WHITE_POINT_GREEN, nValue8) == Sscan::OK) {
+		SetWhitePoint(WS28xxColourChannel::GREEN, nValue8);
+		return;
+	}
+
+	if (Sscan::Uint8(pLine, DevicesParamsConst::LED_WHITE_POINT_BLUE, nValue8) == Sscan::OK) {
+		SetWhitePoint(WS28xxColourChannel::BLUE, nValue8);
+		return;
+	}
+
+	if (Sscan::Uint8(pLine, DevicesParamsConst::LED_16BIT, nValue8) == Sscan::OK) {
+		m_tWS28xxParams.b16Bit = (nValue8 != 0);
+		m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::PIXEL_16BIT;
+		return;
+	}
+
+	if (Sscan::Uint8(pLine, DevicesParamsConst::LED_DITHERING, nValue8) == Sscan::OK) {
+		m_tWS28xxParams.bDithering = (nValue8 != 0);
+		m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::DITHERING;
+		return;
+	}
+
+	if (Sscan::Uint8(pLine, DevicesParamsConst::LED_MAX_FPS, nValue8) == Sscan::OK) {
+		m_tWS28xxParams.nMaxFps = nValue8;
+
+		if (nValue8 != 0) {
+			m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::MAX_FPS;
+		} else {
+			m_tWS28xxParams.nSetList &= ~WS28xxDmxParamsMask::MAX_FPS;
+		}
+		return;
+	}
+
+	if (Sscan::Uint8(pLine, DevicesParamsConst::LED_INTERPOLATION, nValue8) == Sscan::OK) {
+		m_tWS28xxParams.nInterpolation = nValue8;
+
+		if (nValue8 != 0) {
+			m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::INTERPOLATION;
+		} else {
+			m_tWS28xxParams.nSetList &= ~WS28xxDmxParamsMask::INTERPOLATION;
+		}
+		return;
+	}
+
+	if (Sscan::Uint16(pLine, DevicesParamsConst::LED_FRAME_TIMEOUT, nValue16) == Sscan::OK) {
+		m_tWS28xxParams.nFrameTimeout = nValue16;
+
+		if (nValue16 != FrameAssemblerConst::TIMEOUT_MILLIS_DEFAULT) {
+			m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::FRAME_TIMEOUT;
+		} else {
+			m_tWS28xxParams.nSetList &= ~WS28xxDmxParamsMask::FRAME_TIMEOUT;
+		}
+		return;
+	}
+
 	if (Sscan::Uint8(pLine, DevicesParamsConst::ACTIVE_OUT, nValue8) == Sscan::OK) {
 		m_tWS28xxParams.nActiveOutputs = nValue8;
 		m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::ACTIVE_OUT;
@@ -223,6 +324,12 @@ void WS28xxDmxParams::callbackFunction(const char *pLine) {
 		return;
 	}
 
+	if (Sscan::Uint8(pLine, DevicesParamsConst::APA102_HDR, nValue8) == Sscan::OK) {
+		m_tWS28xxParams.bHDR = (nValue8 != 0);
+		m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::APA102_HDR;
+		return;
+	}
+
 	if (Sscan::Uint16(pLine, LightSetConst::PARAMS_DMX_START_ADDRESS, nValue16) == Sscan::OK) {
 		if (nValue16 != 0 && nValue16 <= DMX_UNIVERSE_SIZE) {
 			m_tWS28xxParams.nDmxStartAddress = nValue16;
@@ -232,6 +339,46 @@ void WS28xxDmxParams::callbackFunction(const char *pLine) {
 	}
 }
 
+void WS28xxDmxParams::SetGamma(uint32_t nFirst, uint32_t nLast, float fGamma) {
+	uint8_t nGamma = 10;
+
+	if ((fGamma >= 0.1f) && (fGamma <= 5.0f)) {
+		nGamma = static_cast<uint8_t>((fGamma * 10) + 0.5f);
+	}
+
+	for (uint32_t i = nFirst; i <= nLast; i++) {
+		m_tWS28xxParams.aGamma[i] = nGamma;
+	}
+
+	bool bIsLinear = true;
+
+	for (uint32_t i = 0; i < sizeof(m_tWS28xxParams.aGamma); i++) {
+		bIsLinear &= (m_tWS28xxParams.aGamma[i] == 10);
+	}
+
+	if (bIsLinear) {
+		m_tWS28xxParams.nSetList &= ~WS28xxDmxParamsMask::GAMMA;
+	} else {
+		m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::GAMMA;
+	}
+}
+
+void WS28xxDmxParams::SetWhitePoint(uint32_t nChannel, uint8_t nValue) {
+	m_tWS28xxParams.aWhitePoint[nChannel] = nValue;
+
+	bool bIsDefault = true;
+
+	for (uint32_t i = 0; i < sizeof(m_tWS28xxParams.aWhitePoint); i++) {
+		bIsDefault &= (m_tWS28xxParams.aWhitePoint[i] == 0xFF);
+	}
+
+	if (bIsDefault) {
+		m_tWS28xxParams.nSetList &= ~WS28xxDmxParamsMask::WHITE_POINT;
+	} else {
+		m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::WHITE_POINT;
+	}
+}
+
 void WS28xxDmxParams::Dump() {
 #ifndef NDEBUG
 	if (m_tWS28xxParams.nSetList == 0) {
@@ -260,10 +407,47 @@ void WS28xxDmxParams::Dump() {
 		printf(" %s=%d\n", DevicesParamsConst::LED_COUNT, m_tWS28xxParams.nLedCount);
 	}
 
+	if (isMaskSet(WS28xxDmxParamsMask::GAMMA)) {
+		printf(" %s=%.1f\n", DevicesParamsConst::LED_GAMMA_RED, GetGamma(WS28xxColourChannel::RED));
+		printf(" %s=%.1f\n", DevicesParamsConst::LED_GAMMA_GREEN, GetGamma(WS28xxColourChannel::GREEN));
+		printf(" %s=%.1f\n", DevicesParamsConst::LED_GAMMA_BLUE, GetGamma(WS28xxColourChannel::BLUE));
+		printf(" %s=%.1f\n", DevicesParamsConst::LED_GAMMA_WHITE, GetGamma(WS28xxColourChannel::WHITE));
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::PIXEL_16BIT)) {
+		printf(" %s=%d [%s]\n", DevicesParamsConst::LED_16BIT, static_cast<int>(m_tWS28xxParams.b16Bit), BOOL2STRING::Get(m_tWS28xxParams.b16Bit));
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::DITHERING)) {
+		printf(" %s=%d [%s]\n", DevicesParamsConst::LED_DITHERING, static_cast<int>(m_tWS28xxParams.bDithering), BOOL2STRING::Get(m_tWS28xxParams.bDithering));
+	}
+
 	if (isMaskSet(WS28xxDmxParamsMask::ACTIVE_OUT)) {
 		printf(" %s=%d\n", DevicesParamsConst::ACTIVE_OUT, m_tWS28xxParams.nActiveOutputs);
 	}
 
+	if (isMaskSet(WS28xxDmxParamsMask::MAX_FPS)) {
+		printf(" %s=%d\n", DevicesParamsConst::LED_MAX_FPS, m_tWS28xxParams.nMaxFps);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::FRAME_TIMEOUT)) {
+		printf(" %s=%d\n", DevicesParamsConst::LED_FRAME_TIMEOUT, m_tWS28xxParams.nFrameTimeout);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::RGBW_FROM_RGB)) {
+		printf(" %s=%d [%s]\n", DevicesParamsConst::LED_RGBW_FROM_RGB, static_cast<int>(m_tWS28xxParams.bRgbwFromRgb), BOOL2STRING::Get(m_tWS28xxParams.bRgbwFromRgb));
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::WHITE_POINT)) {
+		printf(" %s=%d\n", DevicesParamsConst::LED_WHITE_POINT_RED, m_tWS28xxParams.aWhitePoint[WS28xxColourChannel::RED]);
+		printf(" %s=%d\n", DevicesParamsConst::LED_WHITE_POINT_GREEN, m_tWS28xxParams.aWhitePoint[WS28xxColourChannel::GREEN]);
+		printf(" %s=%d\n", DevicesParamsConst::LED_WHITE_POINT_BLUE, m_tWS28xxParams.aWhitePoint[WS28xxColourChannel::BLUE]);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::INTERPOLATION)) {
+		printf(" %s=%d [0x%.2x]\n", DevicesParamsConst::LED_INTERPOLATION, m_tWS28xxParams.nInterpolation, m_tWS28xxParams.nInterpolation);
+	}
+
 	if(isMaskSet(WS28xxDmxParamsMask::LED_GROUPING)) {
 		printf(" %s=%d [%s]\n", DevicesParamsConst::LED_GROUPING, static_cast<int>(m_tWS28xxParams.bLedGrouping), BOOL2STRING::Get(m_tWS28xxParams.bLedGrouping));
 	}
@@ -280,6 +464,10 @@ void WS28xxDmxParams::Dump() {
 		printf(" %s=%d\n", DevicesParamsConst::GLOBAL_BRIGHTNESS, m_tWS28xxParams.nGlobalBrightness);
 	}
 
+	if (isMaskSet(WS28xxDmxParamsMask::APA102_HDR)) {
+		printf(" %s=%d [%s]\n", DevicesParamsConst::APA102_HDR, static_cast<int>(m_tWS28xxParams.bHDR), BOOL2STRING::Get(m_tWS28xxParams.bHDR));
+	}
+
 	if (isMaskSet(WS28xxDmxParamsMask::DMX_START_ADDRESS)) {
 		printf(" %s=%d\n", LightSetConst::PARAMS_DMX_START_ADDRESS, m_tWS28xxParams.nDmxStartAddress);
 	}
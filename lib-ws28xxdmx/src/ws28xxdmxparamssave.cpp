@@ -79,6 +79,20 @@ void WS28xxDmxParams::Builder(const struct TWS28xxDmxParams *ptWS28xxParams, cha
 	builder.Add(DevicesParamsConst::LED_T0H, WS28xx::ConvertTxH(m_tWS28xxParams.nLowCode), isMaskSet(WS28xxDmxParamsMask::LOW_CODE), 2);
 	builder.Add(DevicesParamsConst::LED_T1H, WS28xx::ConvertTxH(m_tWS28xxParams.nHighCode), isMaskSet(WS28xxDmxParamsMask::HIGH_CODE), 2);
 
+	builder.AddComment("Colour correction");
+	builder.Add(DevicesParamsConst::LED_GAMMA_RED, GetGamma(WS28xxColourChannel::RED), isMaskSet(WS28xxDmxParamsMask::GAMMA), 1);
+	builder.Add(DevicesParamsConst::LED_GAMMA_GREEN, GetGamma(WS28xxColourChannel::GREEN), isMaskSet(WS28xxDmxParamsMask::GAMMA), 1);
+	builder.Add(DevicesParamsConst::LED_GAMMA_BLUE, GetGamma(WS28xxColourChannel::BLUE), isMaskSet(WS28xxDmxParamsMask::GAMMA), 1);
+	builder.Add(DevicesParamsConst::LED_GAMMA_WHITE, GetGamma(WS28xxColourChannel::WHITE), isMaskSet(WS28xxDmxParamsMask::GAMMA), 1);
+	builder.Add(DevicesParamsConst::LED_16BIT, m_tWS28xxParams.b16Bit, isMaskSet(WS28xxDmxParamsMask::PIXEL_16BIT));
+	builder.Add(DevicesParamsConst::LED_DITHERING, m_tWS28xxParams.bDithering, isMaskSet(WS28xxDmxParamsMask::DITHERING));
+
+	builder.AddComment("SK6812W with RGB input");
+	builder.Add(DevicesParamsConst::LED_RGBW_FROM_RGB, m_tWS28xxParams.bRgbwFromRgb, isMaskSet(WS28xxDmxParamsMask::RGBW_FROM_RGB));
+	builder.Add(DevicesParamsConst::LED_WHITE_POINT_RED, m_tWS28xxParams.aWhitePoint[WS28xxColourChannel::RED], isMaskSet(WS28xxDmxParamsMask::WHITE_POINT));
+	builder.Add(DevicesParamsConst::LED_WHITE_POINT_GREEN, m_tWS28xxParams.aWhitePoint[WS28xxColourChannel::GREEN], isMaskSet(WS28xxDmxParamsMask::WHITE_POINT));
+	builder.Add(DevicesParamsConst::LED_WHITE_POINT_BLUE, m_tWS28xxParams.aWhitePoint[WS28xxColourChannel::BLUE], isMaskSet(WS28xxDmxParamsMask::WHITE_POINT));
+
 	builder.AddComment("Grouping");
 	builder.Add(DevicesParamsConst::LED_GROUPING, m_tWS28xxParams.bLedGrouping, isMaskSet(WS28xxDmxParamsMask::LED_GROUPING));
 	builder.Add(DevicesParamsConst::LED_GROUP_COUNT, m_tWS28xxParams.nLedGroupCount, isMaskSet(WS28xxDmxParamsMask::LED_GROUP_COUNT));
@@ -91,10 +105,14 @@ void WS28xxDmxParams::Builder(const struct TWS28xxDmxParams *ptWS28xxParams, cha
 
 	builder.AddComment("APA102");
 	builder.Add(DevicesParamsConst::GLOBAL_BRIGHTNESS, m_tWS28xxParams.nGlobalBrightness, isMaskSet(WS28xxDmxParamsMask::GLOBAL_BRIGHTNESS));
+	builder.Add(DevicesParamsConst::APA102_HDR, m_tWS28xxParams.bHDR, isMaskSet(WS28xxDmxParamsMask::APA102_HDR));
 
 	builder.AddComment("Multi port");
 	builder.Add(DevicesParamsConst::ACTIVE_OUT, m_tWS28xxParams.nActiveOutputs, isMaskSet(WS28xxDmxParamsMask::ACTIVE_OUT));
 	builder.Add(DevicesParamsConst::USE_SI5351A, m_tWS28xxParams.bUseSI5351A, isMaskSet(WS28xxDmxParamsMask::USE_SI5351A));
+	builder.Add(DevicesParamsConst::LED_MAX_FPS, m_tWS28xxParams.nMaxFps, isMaskSet(WS28xxDmxParamsMask::MAX_FPS));
+	builder.Add(DevicesParamsConst::LED_FRAME_TIMEOUT, m_tWS28xxParams.nFrameTimeout, isMaskSet(WS28xxDmxParamsMask::FRAME_TIMEOUT));
+	builder.Add(DevicesParamsConst::LED_INTERPOLATION, m_tWS28xxParams.nInterpolation, isMaskSet(WS28xxDmxParamsMask::INTERPOLATION));
 
 	nSize = builder.GetSize();
 
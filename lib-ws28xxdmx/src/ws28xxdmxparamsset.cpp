@@ -62,4 +62,30 @@ void WS28xxDmxParams::Set(WS28xxDmx *pWS28xxDmx) {
 	if (isMaskSet(WS28xxDmxParamsMask::GLOBAL_BRIGHTNESS)) {
 		pWS28xxDmx->SetGlobalBrightness(m_tWS28xxParams.nGlobalBrightness);
 	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::APA102_HDR)) {
+		pWS28xxDmx->SetHDR(m_tWS28xxParams.bHDR);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::RGBW_FROM_RGB)) {
+		pWS28xxDmx->SetRgbwFromRgb(m_tWS28xxParams.bRgbwFromRgb);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::WHITE_POINT)) {
+		pWS28xxDmx->SetWhitePoint(m_tWS28xxParams.aWhitePoint[WS28xxColourChannel::RED], m_tWS28xxParams.aWhitePoint[WS28xxColourChannel::GREEN], m_tWS28xxParams.aWhitePoint[WS28xxColourChannel::BLUE]);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::GAMMA)) {
+		for (uint32_t i = 0; i < WS28xxColourChannel::MAX; i++) {
+			pWS28xxDmx->SetGamma(i, GetGamma(i));
+		}
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::PIXEL_16BIT)) {
+		pWS28xxDmx->Set16Bit(m_tWS28xxParams.b16Bit);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::DITHERING)) {
+		pWS28xxDmx->SetDithering(m_tWS28xxParams.bDithering);
+	}
 }
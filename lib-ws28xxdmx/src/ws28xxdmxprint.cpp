@@ -41,7 +41,18 @@ void WS28xxDmx::Print(void) {
 			printf(" Clock : %d Hz %s {Default: %d Hz, Maximum %d Hz}\n", m_nClockSpeedHz, (m_nClockSpeedHz == 0 ? "Default" : ""), spi::speed::ws2801::default_hz, spi::speed::ws2801::max_hz);
 		}
 		if (m_tLedType == APA102) {
-			printf(" GlbBr : %d\n", m_nGlobalBrightness);
+			if (m_bHDR) {
+				printf(" HDR   : 5-bit brightness per pixel\n");
+			} else {
+				printf(" GlbBr : %d\n", m_nGlobalBrightness);
+			}
 		}
 	}
+
+	if (IsRgbwFromRgb()) {
+		printf(" Input : RGB, W is derived\n");
+		m_White.Print();
+	}
+
+	m_Colour.Print();
 }
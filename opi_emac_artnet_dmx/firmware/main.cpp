@@ -171,6 +171,10 @@ void notmain(void) {
 			if (artnetparams.IsRdmDiscovery()) {
 				display.TextStatus(ArtNetMsgConst::RDM_RUN, Display7SegmentMessage::INFO_RDM_RUN, CONSOLE_YELLOW);
 				discovery.Full();
+
+				node.SetRdmPoll(true);
+			} else {
+				node.SetRdmDiscoveryInterval(0);
 			}
 
 			node.SetRdmHandler(&discovery);
@@ -229,6 +229,10 @@ void notmain(void) {
 						pDiscovery->Full(i);
 					}
 				}
+
+				node.SetRdmPoll(true);
+			} else {
+				node.SetRdmDiscoveryInterval(0);
 			}
 
 			node.SetRdmHandler(pDiscovery);
@@ -0,0 +1,264 @@
+/**
+ * @file main.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "hardware.h"
+#include "networkh3emac.h"
+#include "networkconst.h"
+#include "ledblink.h"
+
+#include "displayudf.h"
+#include "displayudfparams.h"
+#include "storedisplayudf.h"
+
+#include "artnetnode.h"
+#include "artnetparams.h"
+#include "storeartnet.h"
+#include "artnetmsgconst.h"
+
+#include "e131controller.h"
+#include "e131params.h"
+#include "storee131.h"
+
+#include "e131output.h"
+
+#include "reboot.h"
+
+#include "remoteconfig.h"
+#include "remoteconfigparams.h"
+#include "storeremoteconfig.h"
+
+#include "rdm_e120.h"
+#include "rdmnetdevice.h"
+#include "rdmpersonality.h"
+#include "rdmdeviceparams.h"
+#include "storerdmdevice.h"
+
+#include "identify.h"
+#include "factorydefaults.h"
+
+#include "spiflashinstall.h"
+#include "spiflashstore.h"
+
+#include "firmwareversion.h"
+#include "software_version.h"
+
+#include "displayudfhandler.h"
+#include "displayhandler.h"
+
+extern "C" {
+
+void notmain(void) {
+	Hardware hw;
+	NetworkH3emac nw;
+	LedBlink lb;
+	DisplayUdf display;
+	DisplayUdfHandler displayUdfHandler;
+	FirmwareVersion fw(SOFTWARE_VERSION, __DATE__, __TIME__);
+
+	SpiFlashInstall spiFlashInstall;
+	SpiFlashStore spiFlashStore;
+
+	fw.Print();
+
+	console_puts("Art-Net -> sACN E1.31\n");
+
+	hw.SetLed(HARDWARE_LED_ON);
+	hw.SetRebootHandler(new Reboot);
+
+	lb.SetLedBlinkDisplay(new DisplayHandler);
+
+	display.TextStatus(NetworkConst::MSG_NETWORK_INIT, Display7SegmentMessage::INFO_NETWORK_INIT, CONSOLE_YELLOW);
+
+	nw.SetNetworkStore(StoreNetwork::Get());
+	nw.SetNetworkDisplay(&displayUdfHandler);
+	nw.Init(StoreNetwork::Get());
+	nw.Print();
+
+	display.TextStatus(ArtNetMsgConst::PARAMS, Display7SegmentMessage::INFO_NODE_PARMAMS, CONSOLE_YELLOW);
+
+	StoreArtNet storeArtNet;
+	ArtNetParams artnetparams(&storeArtNet);
+
+	ArtNetNode node;
+
+	if (artnetparams.Load()) {
+		artnetparams.Set(&node);
+		artnetparams.Dump();
+	}
+
+	node.SetArtNetDisplay(&displayUdfHandler);
+	node.SetArtNetStore(StoreArtNet::Get());
+	// sACN receivers need the refresh, also when the data is not changed
+	node.SetDirectUpdate(true);
+
+	StoreE131 storeE131;
+	E131Params e131params(&storeE131);
+
+	if (e131params.Load()) {
+		e131params.Dump();
+	}
+
+	E131Controller controller;
+	E131Output e131Output;
+
+	bool bIsSetIndividual = false;
+	bool bIsSet;
+
+	for (uint32_t i = 0; i < artnet::MAX_PORTS; i++) {
+		const uint8_t nAddress = artnetparams.GetUniverse(i, bIsSet);
+
+		if (bIsSet) {
+			node.SetUniverseSwitch(i, ARTNET_OUTPUT_PORT, nAddress);
+			bIsSetIndividual = true;
+		}
+	}
+
+	if (!bIsSetIndividual) {
+		for (uint32_t i = 0; i < artnet::MAX_PORTS; i++) {
+			node.SetUniverseSwitch(i, ARTNET_OUTPUT_PORT, i + artnetparams.GetUniverse());
+		}
+	}
+
+	// Mapping table, the Art-Net output port -> sACN universe with its own priority
+	bIsSetIndividual = false;
+
+	uint16_t nUniverse[E131_PARAMS::MAX_PORTS];
+
+	for (uint32_t i = 0; i < E131_PARAMS::MAX_PORTS; i++) {
+		nUniverse[i] = e131params.GetUniverse(i, bIsSet);
+
+		for (uint32_t j = 0; j < i; j++) {
+			if (nUniverse[i] == nUniverse[j]) {
+				bIsSet = false;
+				break;
+			}
+		}
+
+		if (bIsSet) {
+			controller.SetPort(i, nUniverse[i], e131params.GetPriority(i));
+			bIsSetIndividual = true;
+		}
+	}
+
+	if (!bIsSetIndividual) {
+		const uint16_t nUniverse = e131params.GetUniverse();
+
+		for (uint32_t i = 0; i < E131_PARAMS::MAX_PORTS; i++) {
+			controller.SetPort(i, i + nUniverse, e131params.GetPriority(i));
+		}
+	}
+
+	node.SetOutput(&e131Output);
+
+	node.Print();
+	controller.Print();
+	e131Output.Print();
+
+	display.SetTitle("Art-Net sACN E1.31 %d", node.GetActiveOutputPorts());
+	display.Set(2, DISPLAY_UDF_LABEL_NODE_NAME);
+	display.Set(3, DISPLAY_UDF_LABEL_IP);
+	display.Set(4, DISPLAY_UDF_LABEL_UNIVERSE_PORT_A);
+	display.Set(5, DISPLAY_UDF_LABEL_UNIVERSE_PORT_B);
+	display.Set(6, DISPLAY_UDF_LABEL_UNIVERSE_PORT_C);
+
+	StoreDisplayUdf storeDisplayUdf;
+	DisplayUdfParams displayUdfParams(&storeDisplayUdf);
+
+	if(displayUdfParams.Load()) {
+		displayUdfParams.Set(&display);
+		displayUdfParams.Dump();
+	}
+
+	display.Show(&node);
+
+	RemoteConfig remoteConfig(REMOTE_CONFIG_ARTNET, REMOTE_CONFIG_MODE_DMX, node.GetActiveOutputPorts());
+
+	StoreRemoteConfig storeRemoteConfig;
+
+	RemoteConfigParams remoteConfigParams(&storeRemoteConfig);
+
+	if (remoteConfigParams.Load()) {
+		remoteConfigParams.Set(&remoteConfig);
+		remoteConfigParams.Dump();
+	}
+
+	Identify identify;
+
+	RDMNetDevice device(new RDMPersonality("RDMNet LLRP device only", 0));
+
+	StoreRDMDevice storeRdmDevice;
+
+	RDMDeviceParams rdmDeviceParams(&storeRdmDevice);
+
+	device.SetRDMDeviceStore(&storeRdmDevice);
+
+	const char aLabel[] = "Art-Net to sACN E1.31";
+	device.SetLabel(RDM_ROOT_DEVICE, aLabel, (sizeof(aLabel) / sizeof(aLabel[0])) - 1);
+
+	device.SetRDMFactoryDefaults(new FactoryDefaults);
+
+	if (rdmDeviceParams.Load()) {
+		rdmDeviceParams.Set(&device);
+		rdmDeviceParams.Dump();
+	}
+
+	while (spiFlashStore.Flash())
+		;
+
+	device.SetProductCategory(E120_PRODUCT_CATEGORY_DATA_DISTRIBUTION);
+	device.SetProductDetail(E120_PRODUCT_DETAIL_ETHERNET_NODE);
+
+	device.Init();
+	device.Print();
+
+	display.TextStatus(ArtNetMsgConst::START, Display7SegmentMessage::INFO_NODE_START, CONSOLE_YELLOW);
+
+	controller.Start();
+	node.Start();
+	device.Start();
+
+	display.TextStatus(ArtNetMsgConst::STARTED, Display7SegmentMessage::INFO_NODE_STARTED, CONSOLE_GREEN);
+
+	hw.WatchdogInit();
+
+	for (;;) {
+		hw.WatchdogFeed();
+		nw.Run();
+		//
+		node.Run();
+		controller.Run();
+		//
+		device.Run();
+		remoteConfig.Run();
+		spiFlashStore.Flash();
+		lb.Run();
+		display.Run();
+	}
+}
+
+}
@@ -0,0 +1,68 @@
+/**
+ * @file e131output.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef E131OUTPUT_H_
+#define E131OUTPUT_H_
+
+#include <stdint.h>
+
+#include "lightset.h"
+
+#include "e131.h"
+
+struct E131OutputConst {
+	static constexpr uint32_t SYNC_TIMEOUT_MILLIS = 4000;	///< Same as the Art-Net node, back to asynchronous output
+};
+
+/**
+ * The Art-Net output ports are sent as sACN E1.31 with the prebuilt packets of E131Controller.
+ * While ArtSync is received, the data packets carry the synchronization address
+ * and every ArtSync is sent as an E1.31 Synchronization packet.
+ */
+class E131Output: public LightSet {
+public:
+	E131Output(void);
+	~E131Output(void);
+
+	void Start(uint8_t nPortIndex);
+	void Stop(uint8_t nPortIndex);
+
+	void SetData(uint8_t nPortIndex, const uint8_t *pDmxData, uint16_t nLength);
+
+	void Sync(void);
+
+	void Print(void);
+
+private:
+	bool IsSynchronous(void);
+
+private:
+	bool m_bIsStarted[E131_MAX_PORTS];
+	bool m_bHasSync;
+	uint32_t m_nSyncMillis;
+	uint32_t m_nSyncs;
+};
+
+#endif /* E131OUTPUT_H_ */
@@ -0,0 +1,118 @@
+/**
+ * @file e131output.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <cassert>
+
+#include "e131output.h"
+
+#include "e131controller.h"
+
+#include "hardware.h"
+
+#include "debug.h"
+
+E131Output::E131Output(void) : m_bHasSync(false), m_nSyncMillis(0), m_nSyncs(0) {
+	DEBUG_ENTRY
+
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		m_bIsStarted[i] = false;
+	}
+
+	DEBUG_EXIT
+}
+
+E131Output::~E131Output(void) {
+	DEBUG_ENTRY
+
+	DEBUG_EXIT
+}
+
+void E131Output::Start(uint8_t nPortIndex) {
+	DEBUG_ENTRY
+	DEBUG_PRINTF("nPortIndex=%d", static_cast<int>(nPortIndex));
+
+	if (nPortIndex < E131_MAX_PORTS) {
+		m_bIsStarted[nPortIndex] = true;
+	}
+
+	DEBUG_EXIT
+}
+
+void E131Output::Stop(uint8_t nPortIndex) {
+	DEBUG_ENTRY
+	DEBUG_PRINTF("nPortIndex=%d", static_cast<int>(nPortIndex));
+
+	if (nPortIndex < E131_MAX_PORTS) {
+		m_bIsStarted[nPortIndex] = false;
+	}
+
+	DEBUG_EXIT
+}
+
+void E131Output::SetData(uint8_t nPortIndex, const uint8_t *pDmxData, uint16_t nLength) {
+	assert(nPortIndex < E131_MAX_PORTS);
+
+	E131Controller::Get()->HandlePortDmxOut(nPortIndex, pDmxData, nLength, IsSynchronous());
+}
+
+/*
+ * ArtSync -> E1.31 Synchronization Packet
+ */
+void E131Output::Sync(void) {
+	m_bHasSync = true;
+	m_nSyncMillis = Hardware::Get()->Millis();
+	m_nSyncs++;
+
+	E131Controller::Get()->HandleSync();
+}
+
+bool E131Output::IsSynchronous(void) {
+	if (!m_bHasSync) {
+		return false;
+	}
+
+	if ((Hardware::Get()->Millis() - m_nSyncMillis) >= E131OutputConst::SYNC_TIMEOUT_MILLIS) {
+		m_bHasSync = false;
+		return false;
+	}
+
+	return true;
+}
+
+void E131Output::Print(void) {
+	printf("Art-Net -> sACN E1.31\n");
+
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		uint16_t nUniverse;
+
+		if (E131Controller::Get()->GetPort(i, nUniverse)) {
+			printf(" Port %2d -> Universe %d%s\n", static_cast<int>(i), static_cast<int>(nUniverse), m_bIsStarted[i] ? " [Running]" : "");
+		}
+	}
+
+	printf(" ArtSync -> Synchronization : %d\n", static_cast<int>(m_nSyncs));
+}
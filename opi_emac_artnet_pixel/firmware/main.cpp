@@ -128,6 +128,7 @@ void notmain(void) {
 	node.SetUniverseSwitch(0, ARTNET_OUTPUT_PORT, nUniverse);
 
 	LightSet *pSpi;
+	WS28xxDmx *pPixelDmx = 0;
 
 	bool isLedTypeSet = false;
 
@@ -160,38 +161,22 @@ void notmain(void) {
 			ws28xxparms.Set(pWS28xxDmxGrouping);
 			pWS28xxDmxGrouping->SetLEDGroupCount(ws28xxparms.GetLedGroupCount());
 			pSpi = pWS28xxDmxGrouping;
+			pPixelDmx = pWS28xxDmxGrouping;
 			display.Printf(7, "%s:%d G%d", WS28xx::GetLedTypeString(pWS28xxDmxGrouping->GetLEDType()), pWS28xxDmxGrouping->GetLEDCount(), pWS28xxDmxGrouping->GetLEDGroupCount());
 		} else  {
 			WS28xxDmx *pWS28xxDmx = new WS28xxDmx;
 			assert(pWS28xxDmx != 0);
 			ws28xxparms.Set(pWS28xxDmx);
 			pSpi = pWS28xxDmx;
+			pPixelDmx = pWS28xxDmx;
 			display.Printf(7, "%s:%d", WS28xx::GetLedTypeString(pWS28xxDmx->GetLEDType()), pWS28xxDmx->GetLEDCount());
 
-			const uint16_t nLedCount = pWS28xxDmx->GetLEDCount();
-
-			if (pWS28xxDmx->GetLEDType() == SK6812W) {
-				if (nLedCount > 128) {
-					node.SetDirectUpdate(true);
-					node.SetUniverseSwitch(1, ARTNET_OUTPUT_PORT, nUniverse + 1U);
-				}
-				if (nLedCount > 256) {
-					node.SetUniverseSwitch(2, ARTNET_OUTPUT_PORT, nUniverse + 2U);
-				}
-				if (nLedCount > 384) {
-					node.SetUniverseSwitch(3, ARTNET_OUTPUT_PORT, nUniverse + 3U);
-				}
-			} else {
-				if (nLedCount > 170) {
-					node.SetDirectUpdate(true);
-					node.SetUniverseSwitch(1, ARTNET_OUTPUT_PORT, nUniverse + 1U);
-				}
-				if (nLedCount > 340) {
-					node.SetUniverseSwitch(2, ARTNET_OUTPUT_PORT, nUniverse + 2U);
-				}
-				if (nLedCount > 510) {
-					node.SetUniverseSwitch(3, ARTNET_OUTPUT_PORT, nUniverse + 3U);
-				}
+			if (pWS28xxDmx->GetUniverses() > 1) {
+				node.SetDirectUpdate(true);
+			}
+
+			for (uint32_t nPortIndex = 1; nPortIndex < pWS28xxDmx->GetUniverses(); nPortIndex++) {
+				node.SetUniverseSwitch(static_cast<uint8_t>(nPortIndex), ARTNET_OUTPUT_PORT, static_cast<uint8_t>(nUniverse + nPortIndex));
 			}
 		}
 	}
@@ -243,6 +228,9 @@ void notmain(void) {
 		hw.WatchdogFeed();
 		nw.Run();
 		node.Run();
+		if (pPixelDmx != 0) {
+			pPixelDmx->Run();
+		}
 		remoteConfig.Run();
 		spiFlashStore.Flash();
 		lb.Run();
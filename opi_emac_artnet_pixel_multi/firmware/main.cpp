@@ -48,6 +48,7 @@
 
 #include "ws28xxdmxparams.h"
 #include "ws28xxdmxmulti.h"
+#include "pixelmap.h"
 #include "ws28xx.h"
 #include "storews28xxdmx.h"
 
@@ -107,6 +108,15 @@ void notmain(void) {
 		ws28xxparms.Dump();
 	}
 
+	PixelMap pixelMap;
+
+	if (pixelMap.Load()) {
+		pixelMap.Dump();
+	}
+
+	// Also when there is no pixelmap.txt yet, it can be uploaded with TFTP
+	ws28xxDmxMulti.SetPixelMap(&pixelMap);
+
 	ws28xxDmxMulti.Initialize();
 
 	const uint8_t nActivePorts = ws28xxDmxMulti.GetActivePorts();
@@ -129,7 +139,6 @@ void notmain(void) {
 	node.SetDirectUpdate(true);
 	node.SetOutput(&ws28xxDmxMulti);
 
-	const uint16_t nLedCount = ws28xxDmxMulti.GetLEDCount();
 	const uint8_t nUniverseStart = artnetparams.GetUniverse();
 
 	uint8_t nPortIndex = 0;
@@ -139,30 +148,8 @@ void notmain(void) {
 
 		node.SetUniverseSwitch(nPortIndex, ARTNET_OUTPUT_PORT,  nUniverseStart);
 
-		if (ws28xxDmxMulti.GetLEDType() == SK6812W) {
-			if (nLedCount > 128) {
-				node.SetUniverseSwitch(nPortIndex + 1, ARTNET_OUTPUT_PORT, nUniverseStart + 1);
-			}
-
-			if (nLedCount > 256) {
-				node.SetUniverseSwitch(nPortIndex + 2, ARTNET_OUTPUT_PORT, nUniverseStart + 2);
-			}
-
-			if (nLedCount > 384) {
-				node.SetUniverseSwitch(nPortIndex + 3, ARTNET_OUTPUT_PORT, nUniverseStart + 3);
-			}
-		} else {
-			if (nLedCount > 170) {
-				node.SetUniverseSwitch(nPortIndex + 1, ARTNET_OUTPUT_PORT, nUniverseStart + 1);
-			}
-
-			if (nLedCount > 340) {
-				node.SetUniverseSwitch(nPortIndex + 2, ARTNET_OUTPUT_PORT, nUniverseStart + 2);
-			}
-
-			if (nLedCount > 510) {
-				node.SetUniverseSwitch(nPortIndex + 3, ARTNET_OUTPUT_PORT, nUniverseStart + 3);
-			}
+		for (uint32_t nUniverse = 1; nUniverse < ws28xxDmxMulti.GetUniverses(); nUniverse++) {
+			node.SetUniverseSwitch(static_cast<uint8_t>(nPortIndex + nUniverse), ARTNET_OUTPUT_PORT, static_cast<uint8_t>(nUniverseStart + nUniverse));
 		}
 
 		if (nPage < artnet::MAX_PAGES) {
@@ -227,6 +214,7 @@ void notmain(void) {
 		hw.WatchdogFeed();
 		nw.Run();
 		node.Run();;
+		ws28xxDmxMulti.Run();
 		remoteConfig.Run();
 		spiFlashStore.Flash();
 		lb.Run();
@@ -116,6 +116,7 @@ void notmain(void) {
 
 	bridge.SetOutput(&artnetOutput);
 	bridge.SetE131Sync(&artnetOutput);
+	bridge.SetE131Forward(&artnetOutput);
 
 	bool bIsSetIndividual = false;
 
@@ -32,13 +32,15 @@
 
 #include "e131.h"
 #include "e131sync.h"
+#include "e131forward.h"
 
-class ArtNetOutput: public E131Sync, public LightSet {
+class ArtNetOutput: public E131Sync, public E131Forward, public LightSet {
 public:
 	ArtNetOutput(void);
 	~ArtNetOutput(void);
 
 	void Handler(void);
+	void Handler(uint8_t nPortIndex, uint8_t *pData, uint16_t nLength);
 
 	void Start(uint8_t nPortIndex);
 	void Stop(uint8_t nPortIndex);
@@ -24,11 +24,13 @@
  */
 
 #include <stdint.h>
+#include <stddef.h>
 
 #include "artnetoutput.h"
 
 #include "e131bridge.h"
 #include "artnetcontroller.h"
+#include "packets.h"
 
 #include "debug.h"
 
@@ -56,6 +58,18 @@ void ArtNetOutput::Handler(void) {
 	DEBUG_EXIT
 }
 
+/**
+ * Zero copy, the ArtDmx header replaces the E1.31 layers in front of the slots
+ */
+void ArtNetOutput::Handler(uint8_t nPortIndex, uint8_t *pData, uint16_t nLength) {
+	static_assert(offsetof(struct TArtDmx, Data) <= E131ForwardConst::HEADROOM, "There is no room for the ArtDmx header");
+	assert(nPortIndex < E131_MAX_PORTS);
+
+	if (m_nUniverse[nPortIndex] != 0) {
+		ArtNetController::Get()->HandleDmxOutInPlace(m_nUniverse[nPortIndex], pData, nLength, nPortIndex);
+	}
+}
+
 void ArtNetOutput::Start(uint8_t nPortIndex) {
 	DEBUG_ENTRY
 	DEBUG_PRINTF("nPortIndex=%d", static_cast<int>(nPortIndex));
@@ -118,6 +118,7 @@ void notmain(void) {
 	bridge.SetUniverse(0, E131_OUTPUT_PORT, nUniverse);
 
 	LightSet *pSpi;
+	WS28xxDmx *pPixelDmx = 0;
 
 	bool isLedTypeSet = false;
 
@@ -150,38 +151,22 @@ void notmain(void) {
 			ws28xxparms.Set(pWS28xxDmxGrouping);
 			pWS28xxDmxGrouping->SetLEDGroupCount(ws28xxparms.GetLedGroupCount());
 			pSpi = pWS28xxDmxGrouping;
+			pPixelDmx = pWS28xxDmxGrouping;
 			display.Printf(7, "%s:%d G%d", WS28xx::GetLedTypeString(pWS28xxDmxGrouping->GetLEDType()), pWS28xxDmxGrouping->GetLEDCount(), pWS28xxDmxGrouping->GetLEDGroupCount());
 		} else  {
 			WS28xxDmx *pWS28xxDmx = new WS28xxDmx;
 			assert(pWS28xxDmx != 0);
 			ws28xxparms.Set(pWS28xxDmx);
 			pSpi = pWS28xxDmx;
+			pPixelDmx = pWS28xxDmx;
 			display.Printf(7, "%s:%d", WS28xx::GetLedTypeString(pWS28xxDmx->GetLEDType()), pWS28xxDmx->GetLEDCount());
 
-			const uint16_t nLedCount = pWS28xxDmx->GetLEDCount();
-
-			if (pWS28xxDmx->GetLEDType() == SK6812W) {
-				if (nLedCount > 128) {
-					bridge.SetDirectUpdate(true);
-					bridge.SetUniverse(1, E131_OUTPUT_PORT, nUniverse + 1);
-				}
-				if (nLedCount > 256) {
-					bridge.SetUniverse(2, E131_OUTPUT_PORT, nUniverse + 2);
-				}
-				if (nLedCount > 384) {
-					bridge.SetUniverse(3, E131_OUTPUT_PORT, nUniverse + 3);
-				}
-			} else {
-				if (nLedCount > 170) {
-					bridge.SetDirectUpdate(true);
-					bridge.SetUniverse(1, E131_OUTPUT_PORT, nUniverse + 1);
-				}
-				if (nLedCount > 340) {
-					bridge.SetUniverse(2, E131_OUTPUT_PORT, nUniverse + 2);
-				}
-				if (nLedCount > 510) {
-					bridge.SetUniverse(3, E131_OUTPUT_PORT, nUniverse + 3);
-				}
+			if (pWS28xxDmx->GetUniverses() > 1) {
+				bridge.SetDirectUpdate(true);
+			}
+
+			for (uint32_t nPortIndex = 1; nPortIndex < pWS28xxDmx->GetUniverses(); nPortIndex++) {
+				bridge.SetUniverse(static_cast<uint8_t>(nPortIndex), E131_OUTPUT_PORT, static_cast<uint16_t>(nUniverse + nPortIndex));
 			}
 		}
 	}
@@ -232,6 +217,9 @@ void notmain(void) {
 		hw.WatchdogFeed();
 		nw.Run();
 		bridge.Run();
+		if (pPixelDmx != 0) {
+			pPixelDmx->Run();
+		}
 		remoteConfig.Run();
 		spiFlashStore.Flash();
 		lb.Run();
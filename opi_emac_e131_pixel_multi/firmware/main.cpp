@@ -47,6 +47,7 @@
 
 #include "ws28xxdmxparams.h"
 #include "ws28xxdmxmulti.h"
+#include "pixelmap.h"
 #include "ws28xx.h"
 #include "storews28xxdmx.h"
 
@@ -114,12 +115,20 @@ void notmain(void) {
 		ws28xxparms.Dump();
 	}
 
+	PixelMap pixelMap;
+
+	if (pixelMap.Load()) {
+		pixelMap.Dump();
+	}
+
+	// Also when there is no pixelmap.txt yet, it can be uploaded with TFTP
+	ws28xxDmxMulti.SetPixelMap(&pixelMap);
+
 	ws28xxDmxMulti.Initialize();
 
 	bridge.SetDirectUpdate(true);
 	bridge.SetOutput(&ws28xxDmxMulti);
 
-	const uint16_t nLedCount = ws28xxDmxMulti.GetLEDCount();
 	const uint8_t nActivePorts = ws28xxDmxMulti.GetActivePorts();
 	const uint8_t nUniverseStart = e131params.GetUniverse();
 
@@ -128,30 +137,8 @@ void notmain(void) {
 	for (uint32_t i = 0; i < nActivePorts; i++) {
 		bridge.SetUniverse(nPortIndex, E131_OUTPUT_PORT, nPortIndex + nUniverseStart);
 
-		if (ws28xxDmxMulti.GetLEDType() == SK6812W) {
-			if (nLedCount > 128) {
-				bridge.SetUniverse(nPortIndex + 1, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 1);
-			}
-
-			if (nLedCount > 256) {
-				bridge.SetUniverse(nPortIndex + 2, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 2);
-			}
-
-			if (nLedCount > 384) {
-				bridge.SetUniverse(nPortIndex + 3, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 3);
-			}
-		} else {
-			if (nLedCount > 170) {
-				bridge.SetUniverse(nPortIndex + 1, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 1);
-			}
-
-			if (nLedCount > 340) {
-				bridge.SetUniverse(nPortIndex + 2, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 2);
-			}
-
-			if (nLedCount > 510) {
-				bridge.SetUniverse(nPortIndex + 3, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 3);
-			}
+		for (uint32_t nUniverse = 1; nUniverse < ws28xxDmxMulti.GetUniverses(); nUniverse++) {
+			bridge.SetUniverse(static_cast<uint8_t>(nPortIndex + nUniverse), E131_OUTPUT_PORT, static_cast<uint16_t>(nUniverseStart + nPortIndex + nUniverse));
 		}
 
 		nPortIndex += ws28xxDmxMulti.GetUniverses();
@@ -206,6 +193,7 @@ void notmain(void) {
 		hw.WatchdogFeed();
 		nw.Run();
 		bridge.Run();
+		ws28xxDmxMulti.Run();
 		remoteConfig.Run();
 		spiFlashStore.Flash();
 		lb.Run();
@@ -114,6 +114,7 @@ void notmain(void) {
 	display.TextStatus(OscServerMsgConst::PARAMS, Display7SegmentMessage::INFO_BRIDGE_PARMAMS, CONSOLE_YELLOW);
 
 	LightSet *pSpi;
+	WS28xxDmx *pPixelDmx = 0;
 	OscServerHandler *pHandler;
 
 	bool isLedTypeSet = false;
@@ -150,6 +151,7 @@ void notmain(void) {
 			assert(pWS28xxDmxGrouping != 0);
 			ws28xxparms.Set(pWS28xxDmxGrouping);
 			pSpi = pWS28xxDmxGrouping;
+			pPixelDmx = pWS28xxDmxGrouping;
 
 			display.Printf(7, "%s:%d G", WS28xx::GetLedTypeString(ws28xxparms.GetLedType()), ws28xxparms.GetLedCount());
 
@@ -160,6 +162,7 @@ void notmain(void) {
 			assert(pWS28xxDmx != 0);
 			ws28xxparms.Set(pWS28xxDmx);
 			pSpi = pWS28xxDmx;
+			pPixelDmx = pWS28xxDmx;
 
 			const uint16_t nLedCount = pWS28xxDmx->GetLEDCount();
 
@@ -226,6 +229,9 @@ void notmain(void) {
 		hw.WatchdogFeed();
 		nw.Run();
 		server.Run();
+		if (pPixelDmx != 0) {
+			pPixelDmx->Run();
+		}
 		remoteConfig.Run();
 		spiFlashStore.Flash();
 		mDns.Run();
@@ -265,6 +265,10 @@ void notmain(void) {
 				console_status(CONSOLE_YELLOW, RUN_RDM);
 				display.TextStatus(RUN_RDM);
 				discovery.Full();
+
+				node.SetRdmPoll(true);
+			} else {
+				node.SetRdmDiscoveryInterval(0);
 			}
 
 			node.SetRdmHandler((ArtNetRdm *)&discovery);